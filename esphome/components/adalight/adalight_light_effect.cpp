@@ -8,6 +8,7 @@ static const char *const TAG = "adalight_light_effect";
 
 static const uint32_t ADALIGHT_ACK_INTERVAL = 1000;
 static const uint32_t ADALIGHT_RECEIVE_TIMEOUT = 1000;
+static const int LEDS_PER_CHUNK = 32;
 
 AdalightLightEffect::AdalightLightEffect(const std::string &name) : AddressableLightEffect(name) {}
 
@@ -40,11 +41,7 @@ void AdalightLightEffect::reset_frame_(light::AddressableLight &it) {
   frame_.reserve(buffer_capacity);
 }
 
-void AdalightLightEffect::blank_all_leds_(light::AddressableLight &it) {
-  for (int led = it.size(); led-- > 0;) {
-    it[led].set(Color::BLACK);
-  }
-}
+void AdalightLightEffect::blank_all_leds_(light::AddressableLight &it) { it.all() = Color::BLACK; }
 
 void AdalightLightEffect::apply(light::AddressableLight &it, const Color &current_color) {
   const uint32_t now = millis();
@@ -127,10 +124,15 @@ AdalightLightEffect::Frame AdalightLightEffect::parse_frame_(light::AddressableL
   auto accepted_led_count = std::min<int>(led_count, it.size());
   uint8_t *led_data = &frame_[6];
 
-  for (int led = 0; led < accepted_led_count; led++, led_data += 3) {
-    auto white = std::min(std::min(led_data[0], led_data[1]), led_data[2]);
-
-    it[led].set(Color(led_data[0], led_data[1], led_data[2], white));
+  // Convert the LEDs in chunks and write them in bulk
+  Color chunk[LEDS_PER_CHUNK];
+  for (int led = 0; led < accepted_led_count; led += LEDS_PER_CHUNK) {
+    const int count = std::min(LEDS_PER_CHUNK, accepted_led_count - led);
+    for (int i = 0; i < count; i++, led_data += 3) {
+      auto white = std::min(std::min(led_data[0], led_data[1]), led_data[2]);
+      chunk[i] = Color(led_data[0], led_data[1], led_data[2], white);
+    }
+    it.write(led, chunk, count);
   }
 
   return CONSUMED;
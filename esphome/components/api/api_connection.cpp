@@ -1,4 +1,5 @@
 #include "api_connection.h"
+#include "esphome/core/application.h"
 #include "esphome/core/log.h"
 #include "esphome/core/util.h"
 #include "esphome/core/version.h"
@@ -17,9 +18,50 @@ namespace esphome {
 namespace api {
 
 static const char *const TAG = "api.connection";
+/// Room for the largest message header: preamble byte and two 32bit VarInts (size and type).
+static const size_t API_HEADER_PADDING = 1 + 5 + 5;
+/// Size of the messages that can be queued while the TCP buffer is full, only responses may exceed it.
+static const size_t API_SEND_QUEUE_SIZE = 4096;
+/// Time without traffic after which the client is pinged, it's disconnected if it doesn't respond within 2.5 times
+/// this.
+static const uint32_t KEEPALIVE_INTERVAL = 60000;
+
+/// Priority classes of queued messages, messages of lower classes are dropped first when the queue is full.
+enum SendPriority : uint8_t {
+  SEND_PRIORITY_LOG = 0,
+  SEND_PRIORITY_STATE = 1,
+  SEND_PRIORITY_RESPONSE = 2,
+};
+
+static SendPriority get_send_priority(uint32_t message_type) {
+  switch (message_type) {
+    case 29:  // SubscribeLogsResponse
+      return SEND_PRIORITY_LOG;
+    case 21:  // BinarySensorStateResponse
+    case 22:  // CoverStateResponse
+    case 23:  // FanStateResponse
+    case 24:  // LightStateResponse
+    case 25:  // SensorStateResponse
+    case 26:  // SwitchStateResponse
+    case 27:  // TextSensorStateResponse
+    case 47:  // ClimateStateResponse
+    case 50:  // NumberStateResponse
+    case 53:  // SelectStateResponse
+      return SEND_PRIORITY_STATE;
+    default:
+      return SEND_PRIORITY_RESPONSE;
+  }
+}
+/// All state responses start with "fixed32 key = 1", unless the key is 0.
+static uint32_t get_state_key(const uint8_t *msg, uint32_t msg_size) {
+  if (msg_size < 5 || msg[0] != ((1 << 3) | 5))
+    return 0;
+  return encode_uint32(msg[4], msg[3], msg[2], msg[1]);
+}
 
 APIConnection::APIConnection(AsyncClient *client, APIServer *parent)
     : client_(client), parent_(parent), initial_state_iterator_(parent, this), list_entities_iterator_(parent, this) {
+  this->recv_buffer_.init(this->parent_->get_max_frame_size());
   this->client_->onError([](void *s, AsyncClient *c, int8_t error) { ((APIConnection *) s)->on_error_(error); }, this);
   this->client_->onDisconnect([](void *s, AsyncClient *c) { ((APIConnection *) s)->on_disconnect_(); }, this);
   this->client_->onTimeout([](void *s, AsyncClient *c, uint32_t time) { ((APIConnection *) s)->on_timeout_(time); },
@@ -27,59 +69,82 @@ APIConnection::APIConnection(AsyncClient *client, APIServer *parent)
   this->client_->onData([](void *s, AsyncClient *c, void *buf,
                            size_t len) { ((APIConnection *) s)->on_data_(reinterpret_cast<uint8_t *>(buf), len); },
                         this);
+  this->client_->onAck([](void *s, AsyncClient *c, size_t len, uint32_t time) { ((APIConnection *) s)->on_ack_(); },
+                       this);
 
-  this->send_buffer_.reserve(64);
-  this->recv_buffer_.reserve(32);
+  this->send_buffer_.reserve(256);
   this->client_info_ = this->client_->remoteIP().toString().c_str();
   this->last_traffic_ = millis();
 }
 APIConnection::~APIConnection() { delete this->client_; }
-void APIConnection::on_error_(int8_t error) { this->remove_ = true; }
-void APIConnection::on_disconnect_() { this->remove_ = true; }
+void APIConnection::on_error_(int8_t error) {
+  this->remove_ = true;
+  App.wake_loop();
+}
+void APIConnection::on_disconnect_() {
+  this->remove_ = true;
+  App.wake_loop();
+}
 void APIConnection::on_timeout_(uint32_t time) { this->on_fatal_error(); }
 void APIConnection::on_data_(uint8_t *buf, size_t len) {
   if (len == 0 || buf == nullptr)
     return;
-  this->recv_buffer_.insert(this->recv_buffer_.end(), buf, buf + len);
+  // Don't log here, this can be called from the TCP task
+  if (!this->recv_buffer_.write(buf, len)) {
+    this->recv_overflow_ = true;
+  } else if (!this->recv_buffer_.should_ack()) {
+    // Throttle the peer: acknowledge this data only once loop() has made room for a full window again
+    this->client_->ackLater();
+    this->recv_unacked_ += len;
+  }
+  App.wake_loop();
+}
+void APIConnection::on_ack_() {
+  // Called from the TCP task, only loop() touches the queue
+  this->send_space_available_ = true;
+  App.wake_loop();
+}
+void APIConnection::ack_recv_buffer_() {
+  if (this->remove_ || this->recv_unacked_ == 0)
+    return;
+  // Take the count before checking the free space, data counted in it is already in the ring
+  const size_t unacked = this->recv_unacked_.exchange(0);
+  // The client acknowledges at most what it has held back so far, the rest is acknowledged on a later loop()
+  const size_t acked = this->recv_buffer_.should_ack() ? this->client_->ack(unacked) : 0;
+  this->recv_unacked_ += unacked - acked;
 }
 void APIConnection::parse_recv_buffer_() {
-  if (this->recv_buffer_.empty() || this->remove_)
+  if (this->remove_)
+    return;
+
+  if (this->recv_overflow_) {
+    ESP_LOGW(TAG, "Receive buffer of %s overflowed (%zu bytes), disconnecting", this->client_info_.c_str(),
+             this->recv_buffer_.get_capacity());
+    this->on_fatal_error();
     return;
+  }
 
-  while (!this->recv_buffer_.empty()) {
-    if (this->recv_buffer_[0] != 0x00) {
+  APIFrameBuffer::Frame frame{};
+  while (true) {
+    auto status = this->recv_buffer_.next_frame(&frame);
+    if (status == APIFrameBuffer::FrameStatus::NEED_MORE_DATA)
+      return;
+    if (status == APIFrameBuffer::FrameStatus::INVALID_FRAME) {
       ESP_LOGW(TAG, "Invalid preamble from %s", this->client_info_.c_str());
       this->on_fatal_error();
       return;
     }
-    uint32_t i = 1;
-    const uint32_t size = this->recv_buffer_.size();
-    uint32_t consumed;
-    auto msg_size_varint = ProtoVarInt::parse(&this->recv_buffer_[i], size - i, &consumed);
-    if (!msg_size_varint.has_value())
-      // not enough data there yet
-      return;
-    i += consumed;
-    uint32_t msg_size = msg_size_varint->as_uint32();
-
-    auto msg_type_varint = ProtoVarInt::parse(&this->recv_buffer_[i], size - i, &consumed);
-    if (!msg_type_varint.has_value())
-      // not enough data there yet
-      return;
-    i += consumed;
-    uint32_t msg_type = msg_type_varint->as_uint32();
-
-    if (size - i < msg_size)
-      // message body not fully received
-      return;
+    if (status == APIFrameBuffer::FrameStatus::FRAME_TOO_LARGE) {
+      ESP_LOGW(TAG, "Message type %u from %s is too large (%u > %zu bytes), skipping it", frame.type,
+               this->client_info_.c_str(), frame.size, this->recv_buffer_.get_max_frame_size());
+      this->last_traffic_ = millis();
+      continue;
+    }
 
-    uint8_t *msg = &this->recv_buffer_[i];
-    this->read_message(msg_size, msg_type, msg);
+    this->read_message(frame.size, frame.type, frame.data);
     if (this->remove_)
       return;
-    // pop front
-    uint32_t total = i + msg_size;
-    this->recv_buffer_.erase(this->recv_buffer_.begin(), this->recv_buffer_.begin() + total);
+    this->recv_buffer_.consume_frame();
     this->last_traffic_ = millis();
   }
 }
@@ -110,29 +175,37 @@ void APIConnection::loop() {
     return;
   }
   this->parse_recv_buffer_();
+  this->ack_recv_buffer_();
+  this->send_queued_messages_();
 
+  this->send_deferrable_ = true;
   this->list_entities_iterator_.advance();
   this->initial_state_iterator_.advance();
+#ifdef USE_PROFILER
+  this->advance_profiler_stats_();
+#endif
+  if (!this->pending_states_.empty() && millis() - this->last_batch_ >= this->parent_->get_batch_delay())
+    this->flush_pending_states_();
+  this->send_deferrable_ = false;
 
-  const uint32_t keepalive = 60000;
   if (this->sent_ping_) {
     // Disconnect if not responded within 2.5*keepalive
-    if (millis() - this->last_traffic_ > (keepalive * 5) / 2) {
+    if (millis() - this->last_traffic_ > (KEEPALIVE_INTERVAL * 5) / 2) {
       ESP_LOGW(TAG, "'%s' didn't respond to ping request in time. Disconnecting...", this->client_info_.c_str());
       this->disconnect_client();
     }
-  } else if (millis() - this->last_traffic_ > keepalive) {
+  } else if (millis() - this->last_traffic_ > KEEPALIVE_INTERVAL) {
     this->sent_ping_ = true;
     this->send_ping_request(PingRequest());
   }
 
 #ifdef USE_ESP32_CAMERA
-  if (this->image_reader_.available()) {
+  if (this->image_reader_.available() && this->send_queue_.empty()) {
     uint32_t space = this->client_->space();
     // reserve 15 bytes for metadata, and at least 64 bytes of data
     if (space >= 15 + 64) {
       uint32_t to_send = std::min(space - 15, this->image_reader_.available());
-      auto buffer = this->create_buffer();
+      auto buffer = this->create_buffer(15 + to_send);
       // fixed32 key = 1;
       buffer.encode_fixed32(1, esp32_camera::global_esp32_camera->get_object_id_hash());
       // bytes data = 2;
@@ -153,6 +226,36 @@ void APIConnection::loop() {
 #endif
 }
 
+optional<uint32_t> APIConnection::get_wake_hint_(uint32_t now) const {
+  if (this->remove_ || this->next_close_)
+    return 0;
+  // Sending the entity list and the initial states as the TCP buffer frees up
+  if (!this->list_entities_iterator_.completed() || !this->initial_state_iterator_.completed())
+    return {};
+  // Queued messages are sent when the TCP buffer has room again, which is signaled by an ack
+  if (!this->send_queue_.empty() && this->send_space_available_)
+    return 0;
+#ifdef USE_PROFILER
+  if (this->profiler_stats_active_)
+    return {};
+#endif
+#ifdef USE_ESP32_CAMERA
+  if (this->image_reader_.available())
+    return {};
+#endif
+
+  // Received data wakes the loop, otherwise it only has to run for the keepalive and the next batch of states
+  const uint32_t keepalive = this->sent_ping_ ? (KEEPALIVE_INTERVAL * 5) / 2 : KEEPALIVE_INTERVAL;
+  const uint32_t since_traffic = now - this->last_traffic_;
+  uint32_t hint = since_traffic >= keepalive ? 0 : keepalive - since_traffic;
+  if (!this->pending_states_.empty()) {
+    const uint32_t since_batch = now - this->last_batch_;
+    const uint32_t batch_delay = this->parent_->get_batch_delay();
+    hint = std::min<uint32_t>(hint, since_batch >= batch_delay ? 0 : batch_delay - since_batch);
+  }
+  return hint;
+}
+
 std::string get_default_unique_id(const std::string &component_type, Nameable *nameable) {
   return App.get_name() + component_type + nameable->get_object_id();
 }
@@ -387,7 +490,7 @@ void APIConnection::light_command(const LightCommandRequest &msg) {
   if (msg.has_flash_length)
     call.set_flash_length(msg.flash_length);
   if (msg.has_effect)
-    call.set_effect(msg.effect);
+    call.set_effect(msg.effect.data(), msg.effect.size());
   call.perform();
 }
 #endif
@@ -567,11 +670,11 @@ void APIConnection::climate_command(const ClimateCommandRequest &msg) {
   if (msg.has_fan_mode)
     call.set_fan_mode(static_cast<climate::ClimateFanMode>(msg.fan_mode));
   if (msg.has_custom_fan_mode)
-    call.set_fan_mode(msg.custom_fan_mode);
+    call.set_fan_mode(msg.custom_fan_mode.str());
   if (msg.has_preset)
     call.set_preset(static_cast<climate::ClimatePreset>(msg.preset));
   if (msg.has_custom_preset)
-    call.set_preset(msg.custom_preset);
+    call.set_preset(msg.custom_preset.str());
   if (msg.has_swing_mode)
     call.set_swing_mode(static_cast<climate::ClimateSwingMode>(msg.swing_mode));
   call.perform();
@@ -646,7 +749,7 @@ void APIConnection::select_command(const SelectCommandRequest &msg) {
     return;
 
   auto call = select->make_call();
-  call.set_option(msg.state);
+  call.set_option(msg.state.str());
   call.perform();
 }
 #endif
@@ -686,20 +789,146 @@ void APIConnection::on_get_time_response(const GetTimeResponse &value) {
 }
 #endif
 
+#ifdef USE_PROFILER
+void APIConnection::advance_profiler_stats_() {
+  if (!this->profiler_stats_active_)
+    return;
+
+  const auto &entries = App.profiler.get_entries();
+  while (this->profiler_stats_index_ < entries.size()) {
+    const ProfilerEntry *entry = entries[this->profiler_stats_index_];
+    ProfilerStatsResponse msg;
+    if (entry->component != nullptr)
+      msg.component_source = entry->component->get_component_source();
+    msg.kind = static_cast<enums::ProfilerStatsKind>(entry->kind);
+    msg.name = entry->name;
+    msg.count = entry->stats.get_count();
+    msg.min_us = entry->stats.get_min();
+    msg.average_us = entry->stats.get_average();
+    msg.max_us = entry->stats.get_max();
+    msg.p99_us = entry->stats.get_percentile(0.99f);
+    if (!this->send_profiler_stats_response(msg))
+      // Send buffer full, continue in the next loop()
+      return;
+    this->profiler_stats_index_++;
+  }
+
+  if (!this->send_profiler_stats_done_response(ProfilerStatsDoneResponse()))
+    return;
+  if (this->profiler_stats_reset_)
+    App.profiler.reset();
+  this->profiler_stats_active_ = false;
+}
+#endif
+
+void APIConnection::queue_state(PendingStateType type, Nameable *entity) {
+  if (!this->state_subscription_)
+    return;
+  if (!this->pending_entities_.insert(entity).second)
+    // Already queued, its latest state is read when the batch is sent
+    return;
+  if (this->pending_states_.empty()) {
+    // Start the batch delay with the first update, not with the last batch sent
+    this->last_batch_ = millis();
+    // The server may already have declared its wake hint in this loop iteration
+    App.wake_loop();
+  }
+  this->pending_states_.push_back(PendingState{type, entity});
+}
+void APIConnection::flush_pending_states_() {
+  this->corked_ = true;
+  size_t sent = 0;
+  for (auto &pending : this->pending_states_) {
+    if (!this->send_pending_state_(pending.type, pending.entity))
+      // TCP buffer full, keep the rest (and their order) for the next batch
+      break;
+    this->pending_entities_.erase(pending.entity);
+    sent++;
+  }
+  this->corked_ = false;
+  if (sent != 0)
+    this->client_->send();
+  this->pending_states_.erase(this->pending_states_.begin(), this->pending_states_.begin() + sent);
+  this->last_batch_ = millis();
+}
+bool APIConnection::send_pending_state_(PendingStateType type, Nameable *entity) {
+  switch (type) {
+#ifdef USE_BINARY_SENSOR
+    case PendingStateType::BINARY_SENSOR: {
+      auto *obj = static_cast<binary_sensor::BinarySensor *>(entity);
+      return this->send_binary_sensor_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_COVER
+    case PendingStateType::COVER:
+      return this->send_cover_state(static_cast<cover::Cover *>(entity));
+#endif
+#ifdef USE_FAN
+    case PendingStateType::FAN:
+      return this->send_fan_state(static_cast<fan::FanState *>(entity));
+#endif
+#ifdef USE_LIGHT
+    case PendingStateType::LIGHT:
+      return this->send_light_state(static_cast<light::LightState *>(entity));
+#endif
+#ifdef USE_SENSOR
+    case PendingStateType::SENSOR: {
+      auto *obj = static_cast<sensor::Sensor *>(entity);
+      return this->send_sensor_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_SWITCH
+    case PendingStateType::SWITCH: {
+      auto *obj = static_cast<switch_::Switch *>(entity);
+      return this->send_switch_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_TEXT_SENSOR
+    case PendingStateType::TEXT_SENSOR: {
+      auto *obj = static_cast<text_sensor::TextSensor *>(entity);
+      return this->send_text_sensor_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_CLIMATE
+    case PendingStateType::CLIMATE:
+      return this->send_climate_state(static_cast<climate::Climate *>(entity));
+#endif
+#ifdef USE_NUMBER
+    case PendingStateType::NUMBER: {
+      auto *obj = static_cast<number::Number *>(entity);
+      return this->send_number_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_SELECT
+    case PendingStateType::SELECT: {
+      auto *obj = static_cast<select::Select *>(entity);
+      return this->send_select_state(obj, obj->state);
+    }
+#endif
+    default:
+      // Entity type not compiled in, drop it
+      return true;
+  }
+}
+
 bool APIConnection::send_log_message(int level, const char *tag, const char *line) {
   if (this->log_subscription_ < level)
     return false;
 
   // Send raw so that we don't copy too much
-  auto buffer = this->create_buffer();
+  const size_t line_len = strlen(line);
+  uint32_t msg_size = 0;
+  ProtoSize::add_uint32_field(msg_size, 1, static_cast<uint32_t>(level));
+  ProtoSize::add_string_field(msg_size, 3, line_len);
+  auto buffer = this->create_buffer(msg_size);
   // LogLevel level = 1;
   buffer.encode_uint32(1, static_cast<uint32_t>(level));
   // string message = 3;
-  buffer.encode_string(3, line, strlen(line));
+  buffer.encode_string(3, line, line_len);
   // SubscribeLogsResponse - 29
   bool success = this->send_buffer(buffer, 29);
   if (!success) {
-    buffer = this->create_buffer();
+    buffer = this->create_buffer(2);
     // bool send_failed = 4;
     buffer.encode_bool(4, true);
     return this->send_buffer(buffer, 29);
@@ -785,35 +1014,140 @@ void APIConnection::subscribe_home_assistant_states(const SubscribeHomeAssistant
     }
   }
 }
+ProtoWriteBuffer APIConnection::create_buffer(uint32_t reserve_size) {
+  // Messages are encoded after room for the largest possible header, so that send_buffer() can put the
+  // header in front of them without moving the message. The capacity of send_buffer_ is kept between
+  // messages, so once it has grown to the size of the largest message, encoding does not allocate.
+  this->send_buffer_.clear();
+  this->send_buffer_.reserve(API_HEADER_PADDING + reserve_size);
+  this->send_buffer_.resize(API_HEADER_PADDING);
+  return {&this->send_buffer_};
+}
 bool APIConnection::send_buffer(ProtoWriteBuffer buffer, uint32_t message_type) {
   if (this->remove_)
     return false;
 
-  std::vector<uint8_t> header;
-  header.push_back(0x00);
-  ProtoVarInt(buffer.get_buffer()->size()).encode(header);
-  ProtoVarInt(message_type).encode(header);
+  std::vector<uint8_t> *raw = buffer.get_buffer();
+  const uint32_t msg_size = raw->size() - API_HEADER_PADDING;
+  // Preamble (zero byte), VarInt message size and VarInt message type
+  const uint32_t header_size = 1 + ProtoSize::varint(msg_size) + ProtoSize::varint(message_type);
+  uint8_t *header = raw->data() + API_HEADER_PADDING - header_size;
+  header[0] = 0x00;
+  ProtoVarInt(message_type).encode(ProtoVarInt(msg_size).encode(header + 1));
 
-  size_t needed_space = buffer.get_buffer()->size() + header.size();
+  size_t needed_space = header_size + msg_size;
 
-  if (needed_space > this->client_->space()) {
-    delay(0);
-    if (needed_space > this->client_->space()) {
-      // SubscribeLogsResponse
-      if (message_type != 29) {
-        ESP_LOGV(TAG, "Cannot send message because of TCP buffer space");
-      }
+  if (this->send_queue_.empty()) {
+    if (needed_space > this->client_->space())
       delay(0);
+    if (needed_space <= this->client_->space()) {
+      this->client_->add(reinterpret_cast<char *>(header), needed_space, ASYNC_WRITE_FLAG_COPY);
+      if (this->corked_)
+        return true;
+      return this->client_->send();
+    }
+  }
+
+  const SendPriority priority = get_send_priority(message_type);
+  if (this->send_deferrable_ && priority != SEND_PRIORITY_LOG)
+    // The caller tries again in the next loop(), with the then current state
+    return false;
+  const uint32_t key = get_state_key(header + header_size, msg_size);
+  return this->queue_message_(priority, message_type, key, header, needed_space);
+}
+bool APIConnection::queue_message_(uint8_t priority, uint32_t message_type, uint32_t key, const uint8_t *data,
+                                   size_t len) {
+  if (priority == SEND_PRIORITY_STATE) {
+    // The front message may be partially sent already
+    for (auto it = this->send_queue_.begin() + (this->send_queue_offset_ != 0); it != this->send_queue_.end(); ++it) {
+      auto &queued = *it;
+      if (queued.message_type == message_type && queued.key == key) {
+        // Only the latest state of an entity is of interest
+        this->send_queue_bytes_ = this->send_queue_bytes_ - queued.data.size() + len;
+        queued.data.assign(data, data + len);
+        this->send_stats_.states_replaced++;
+        return true;
+      }
+    }
+  }
+
+  if (!this->make_room_(priority, len)) {
+    if (priority == SEND_PRIORITY_LOG) {
+      this->send_stats_.logs_dropped++;
       return false;
     }
+    if (priority == SEND_PRIORITY_STATE) {
+      this->send_stats_.states_dropped++;
+      return false;
+    }
+    // Responses are never dropped, the queue grows beyond its size instead
   }
 
-  this->client_->add(reinterpret_cast<char *>(header.data()), header.size(),
-                     ASYNC_WRITE_FLAG_COPY | ASYNC_WRITE_FLAG_MORE);
-  this->client_->add(reinterpret_cast<char *>(buffer.get_buffer()->data()), buffer.get_buffer()->size(),
-                     ASYNC_WRITE_FLAG_COPY);
-  bool ret = this->client_->send();
-  return ret;
+  this->send_queue_.push_back(QueuedMessage{priority, message_type, key, std::vector<uint8_t>(data, data + len)});
+  this->send_queue_bytes_ += len;
+  if (this->send_queue_bytes_ > this->send_stats_.max_queued_bytes)
+    this->send_stats_.max_queued_bytes = this->send_queue_bytes_;
+  return true;
+}
+bool APIConnection::make_room_(uint8_t priority, size_t len) {
+  for (uint8_t drop = SEND_PRIORITY_LOG; drop < priority; drop++) {
+    // A partially sent message can't be dropped anymore
+    for (auto it = this->send_queue_.begin() + (this->send_queue_offset_ != 0); it != this->send_queue_.end();) {
+      if (this->send_queue_bytes_ + len <= API_SEND_QUEUE_SIZE)
+        return true;
+      if (it->priority != drop) {
+        ++it;
+        continue;
+      }
+      // Oldest first
+      this->send_queue_bytes_ -= it->data.size();
+      if (drop == SEND_PRIORITY_LOG) {
+        this->send_stats_.logs_dropped++;
+      } else {
+        this->send_stats_.states_dropped++;
+      }
+      it = this->send_queue_.erase(it);
+    }
+  }
+  return this->send_queue_bytes_ + len <= API_SEND_QUEUE_SIZE;
+}
+void APIConnection::send_queued_messages_() {
+  this->send_space_available_ = false;
+  bool added = false;
+  while (!this->send_queue_.empty()) {
+    auto &front = this->send_queue_.front();
+    const size_t remaining = front.data.size() - this->send_queue_offset_;
+    const size_t space = this->client_->space();
+    if (remaining > space) {
+      // Send the part that fits, a message larger than the TCP window would never fit as a whole. The rest follows
+      // once the next ack frees up space.
+      if (space != 0) {
+        this->client_->add(reinterpret_cast<char *>(&front.data[this->send_queue_offset_]), space,
+                           ASYNC_WRITE_FLAG_COPY);
+        this->send_queue_offset_ += space;
+        added = true;
+      }
+      break;
+    }
+    this->client_->add(reinterpret_cast<char *>(&front.data[this->send_queue_offset_]), remaining,
+                       ASYNC_WRITE_FLAG_COPY);
+    this->send_queue_bytes_ -= front.data.size();
+    this->send_queue_.pop_front();
+    this->send_queue_offset_ = 0;
+    added = true;
+  }
+  if (added)
+    this->client_->send();
+}
+ConnectionStatsResponse APIConnection::connection_stats(const ConnectionStatsRequest &msg) {
+  ConnectionStatsResponse resp;
+  resp.queued_messages = this->send_queue_.size();
+  resp.queued_bytes = this->send_queue_bytes_;
+  resp.max_queued_bytes = this->send_stats_.max_queued_bytes;
+  resp.states_replaced = this->send_stats_.states_replaced;
+  resp.states_dropped = this->send_stats_.states_dropped;
+  resp.logs_dropped = this->send_stats_.logs_dropped;
+  return resp;
 }
 void APIConnection::on_unauthenticated_access() {
   ESP_LOGD(TAG, "'%s' tried to access without authentication.", this->client_info_.c_str());
@@ -2,13 +2,31 @@
 
 #include "esphome/core/component.h"
 #include "esphome/core/application.h"
+#include "api_frame_buffer.h"
 #include "api_pb2.h"
 #include "api_pb2_service.h"
 #include "api_server.h"
 
+#include <atomic>
+#include <deque>
+#include <set>
+
 namespace esphome {
 namespace api {
 
+enum class PendingStateType : uint8_t {
+  BINARY_SENSOR,
+  COVER,
+  FAN,
+  LIGHT,
+  SENSOR,
+  SWITCH,
+  TEXT_SENSOR,
+  CLIMATE,
+  NUMBER,
+  SELECT,
+};
+
 class APIConnection : public APIServerConnection {
  public:
   APIConnection(AsyncClient *client, APIServer *parent);
@@ -73,6 +91,19 @@ class APIConnection : public APIServerConnection {
   bool send_select_info(select::Select *select);
   void select_command(const SelectCommandRequest &msg) override;
 #endif
+#ifdef USE_PROFILER
+  void profiler_stats(const ProfilerStatsRequest &msg) override {
+    this->profiler_stats_index_ = 0;
+    this->profiler_stats_reset_ = msg.reset;
+    this->profiler_stats_active_ = true;
+  }
+#endif
+  /** Queue a state update to be sent with the next batch, instead of sending it immediately.
+   *
+   * Only the entity is remembered, its current state is read when the batch is sent. An entity that is already
+   * queued is not queued again, so only its latest state is sent.
+   */
+  void queue_state(PendingStateType type, Nameable *entity);
   bool send_log_message(int level, const char *tag, const char *line);
   void send_homeassistant_service_call(const HomeassistantServiceResponse &call) {
     if (!this->service_call_subscription_)
@@ -127,6 +158,7 @@ class APIConnection : public APIServerConnection {
     return {};
   }
   void execute_service(const ExecuteServiceRequest &msg) override;
+  ConnectionStatsResponse connection_stats(const ConnectionStatsRequest &msg) override;
   bool is_authenticated() override { return this->connection_state_ == ConnectionState::AUTHENTICATED; }
   bool is_connection_setup() override {
     return this->connection_state_ == ConnectionState ::CONNECTED || this->is_authenticated();
@@ -134,10 +166,7 @@ class APIConnection : public APIServerConnection {
   void on_fatal_error() override;
   void on_unauthenticated_access() override;
   void on_no_setup_connection() override;
-  ProtoWriteBuffer create_buffer() override {
-    this->send_buffer_.clear();
-    return {&this->send_buffer_};
-  }
+  ProtoWriteBuffer create_buffer(uint32_t reserve_size) override;
   bool send_buffer(ProtoWriteBuffer buffer, uint32_t message_type) override;
 
  protected:
@@ -147,7 +176,25 @@ class APIConnection : public APIServerConnection {
   void on_disconnect_();
   void on_timeout_(uint32_t time);
   void on_data_(uint8_t *buf, size_t len);
+  void on_ack_();
+  /// The time in ms until loop() has work to do, empty if it has to run every loop interval (for tickless idle).
+  optional<uint32_t> get_wake_hint_(uint32_t now) const;
   void parse_recv_buffer_();
+  /// Acknowledge the received data held back by on_data_() once there is room for it again.
+  void ack_recv_buffer_();
+  /// Queue a message that doesn't fit into the TCP buffer, returns false if it (or its priority class) is dropped.
+  bool queue_message_(uint8_t priority, uint32_t message_type, uint32_t key, const uint8_t *data, size_t len);
+  /// Drop queued messages of a lower priority than priority until len bytes fit into the queue.
+  bool make_room_(uint8_t priority, size_t len);
+  /// Move as many queued bytes as fit into the TCP buffer, splitting the front message if it doesn't fit as a whole.
+  void send_queued_messages_();
+#ifdef USE_PROFILER
+  /// Send the pending profiler statistics, as many as fit into the send buffer.
+  void advance_profiler_stats_();
+#endif
+  /// Send the state of all queued entities, keeping those that don't fit into the TCP buffer for the next batch.
+  void flush_pending_states_();
+  bool send_pending_state_(PendingStateType type, Nameable *entity);
 
   enum class ConnectionState {
     WAITING_FOR_HELLO,
@@ -158,7 +205,51 @@ class APIConnection : public APIServerConnection {
   bool remove_{false};
 
   std::vector<uint8_t> send_buffer_;
-  std::vector<uint8_t> recv_buffer_;
+  /** Messages that didn't fit into the TCP buffer, in the order they have to be sent.
+   *
+   * While messages are queued, new messages are queued behind them. Messages sent by the iterators (and other
+   * callers that retry in the next loop()) are not queued, send_buffer() returns false for them instead.
+   */
+  struct QueuedMessage {
+    uint8_t priority;
+    uint32_t message_type;
+    /// Key of the entity of a state update.
+    uint32_t key;
+    /// The complete frame, including its header.
+    std::vector<uint8_t> data;
+  };
+  std::deque<QueuedMessage> send_queue_;
+  size_t send_queue_bytes_{0};
+  /// Bytes of the front message that are already in the TCP buffer.
+  size_t send_queue_offset_{0};
+  /// Set from the TCP callback when an ack freed up space in the TCP buffer.
+  std::atomic<bool> send_space_available_{false};
+  /// Set while sending messages that are retried by the caller when send_buffer() returns false (logs are queued
+  /// regardless).
+  bool send_deferrable_{false};
+  struct {
+    uint32_t max_queued_bytes;
+    uint32_t states_replaced;
+    uint32_t states_dropped;
+    uint32_t logs_dropped;
+  } send_stats_{};
+  APIFrameBuffer recv_buffer_;
+  /// Set from the TCP callback when received data did not fit into recv_buffer_.
+  std::atomic<bool> recv_overflow_{false};
+  /// Bytes received but not yet acknowledged to the peer, to keep it from sending more than recv_buffer_ can hold.
+  std::atomic<size_t> recv_unacked_{0};
+
+  struct PendingState {
+    PendingStateType type;
+    Nameable *entity;
+  };
+  std::vector<PendingState> pending_states_;
+  /// The entities in pending_states_, so that an update of an entity that is already queued is found quickly.
+  std::set<Nameable *> pending_entities_;
+  uint32_t last_batch_{0};
+  /// While set, send_buffer() only queues data in the TCP buffer so that a batch is sent in as few segments as
+  /// possible.
+  bool corked_{false};
 
   std::string client_info_;
 #ifdef USE_ESP32_CAMERA
@@ -172,6 +263,11 @@ class APIConnection : public APIServerConnection {
   bool service_call_subscription_{false};
   bool current_nodelay_{false};
   bool next_close_{false};
+#ifdef USE_PROFILER
+  bool profiler_stats_active_{false};
+  bool profiler_stats_reset_{false};
+  size_t profiler_stats_index_{0};
+#endif
   AsyncClient *client_;
   APIServer *parent_;
   InitialStateIterator initial_state_iterator_;
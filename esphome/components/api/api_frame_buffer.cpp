@@ -0,0 +1,150 @@
+#include "api_frame_buffer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+#include "lwip/opt.h"
+#endif
+
+namespace esphome {
+namespace api {
+
+/// Preamble byte and two 32bit VarInts.
+static const size_t MAX_HEADER_SIZE = 1 + 5 + 5;
+static const size_t MAX_VARINT_SIZE = 5;
+
+#ifdef TCP_WND
+const size_t APIFrameBuffer::RECEIVE_WINDOW = TCP_WND;
+#else
+// Default window of lwIP, four segments of 1460 bytes
+const size_t APIFrameBuffer::RECEIVE_WINDOW = 4 * 1460;
+#endif
+
+void APIFrameBuffer::init(size_t max_frame_size) {
+  this->max_frame_size_ = max_frame_size;
+  // The rest of a partially received frame plus a full TCP window: the peer may send a whole window before the next
+  // loop(), and with the acknowledgements held back by the connection it can't send more than that.
+  const size_t frame_size = max_frame_size + MAX_HEADER_SIZE;
+  this->capacity_ = std::max(2 * frame_size, frame_size + RECEIVE_WINDOW);
+  this->buffer_.reset(new uint8_t[this->capacity_]);  // NOLINT(cppcoreguidelines-owning-memory)
+  this->frame_copy_.reset();
+  this->read_pos_.store(0, std::memory_order_relaxed);
+  this->write_pos_.store(0, std::memory_order_relaxed);
+  this->skip_remaining_ = 0;
+  this->frame_length_ = 0;
+}
+bool APIFrameBuffer::write(const uint8_t *data, size_t len) {
+  const size_t write_pos = this->write_pos_.load(std::memory_order_relaxed);
+  // Acquire: the consumer is done with the bytes before the read position
+  const size_t read_pos = this->read_pos_.load(std::memory_order_acquire);
+  if (len > this->capacity_ - this->distance_(read_pos, write_pos))
+    return false;
+
+  const size_t index = this->index_(write_pos);
+  const size_t first = std::min(len, this->capacity_ - index);
+  memcpy(&this->buffer_[index], data, first);
+  memcpy(&this->buffer_[0], data + first, len - first);
+  // Release: publish the data together with the new write position
+  this->write_pos_.store(this->advance_(write_pos, len), std::memory_order_release);
+  return true;
+}
+size_t APIFrameBuffer::available() const {
+  return this->distance_(this->read_pos_.load(std::memory_order_relaxed),
+                         this->write_pos_.load(std::memory_order_acquire));
+}
+size_t APIFrameBuffer::get_free() const {
+  return this->capacity_ - this->distance_(this->read_pos_.load(std::memory_order_acquire),
+                                           this->write_pos_.load(std::memory_order_acquire));
+}
+size_t APIFrameBuffer::advance_(size_t pos, size_t len) const {
+  pos += len;
+  return pos >= 2 * this->capacity_ ? pos - 2 * this->capacity_ : pos;
+}
+uint8_t APIFrameBuffer::peek_(size_t offset) const {
+  return this->buffer_[this->index_(this->advance_(this->read_pos_.load(std::memory_order_relaxed), offset))];
+}
+size_t APIFrameBuffer::parse_varint_(size_t offset, size_t size, uint32_t *value, bool *invalid) const {
+  uint32_t result = 0;
+  for (size_t i = 0; i < MAX_VARINT_SIZE; i++) {
+    if (offset + i >= size)
+      // not enough data there yet
+      return 0;
+    const uint8_t val = this->peek_(offset + i);
+    result |= uint32_t(val & 0x7F) << (7 * i);
+    if ((val & 0x80) == 0) {
+      *value = result;
+      return i + 1;
+    }
+  }
+  // Longer than any 32bit value
+  *invalid = true;
+  return 0;
+}
+void APIFrameBuffer::skip_(size_t len) {
+  // Release: the producer may only overwrite the bytes once they're no longer read
+  this->read_pos_.store(this->advance_(this->read_pos_.load(std::memory_order_relaxed), len),
+                        std::memory_order_release);
+}
+APIFrameBuffer::FrameStatus APIFrameBuffer::next_frame(Frame *frame) {
+  size_t size = this->available();
+  if (this->skip_remaining_ != 0) {
+    const size_t skip = std::min(this->skip_remaining_, size);
+    this->skip_(skip);
+    this->skip_remaining_ -= skip;
+    size -= skip;
+    if (this->skip_remaining_ != 0)
+      return FrameStatus::NEED_MORE_DATA;
+  }
+
+  if (size == 0)
+    return FrameStatus::NEED_MORE_DATA;
+  if (this->peek_(0) != 0x00)
+    return FrameStatus::INVALID_FRAME;
+
+  bool invalid = false;
+  uint32_t msg_size;
+  const size_t size_len = this->parse_varint_(1, size, &msg_size, &invalid);
+  if (size_len == 0)
+    return invalid ? FrameStatus::INVALID_FRAME : FrameStatus::NEED_MORE_DATA;
+  uint32_t msg_type;
+  const size_t type_len = this->parse_varint_(1 + size_len, size, &msg_type, &invalid);
+  if (type_len == 0)
+    return invalid ? FrameStatus::INVALID_FRAME : FrameStatus::NEED_MORE_DATA;
+  const size_t header_len = 1 + size_len + type_len;
+
+  if (msg_size > this->max_frame_size_) {
+    this->skip_(header_len);
+    this->skip_remaining_ = msg_size;
+    frame->type = msg_type;
+    frame->size = msg_size;
+    frame->data = nullptr;
+    return FrameStatus::FRAME_TOO_LARGE;
+  }
+  if (size - header_len < msg_size)
+    // message body not fully received
+    return FrameStatus::NEED_MORE_DATA;
+
+  const size_t index = this->index_(this->advance_(this->read_pos_.load(std::memory_order_relaxed), header_len));
+  frame->type = msg_type;
+  frame->size = msg_size;
+  frame->data = &this->buffer_[index];
+  if (index + msg_size > this->capacity_) {
+    // The message wraps around the end of the ring, the producer may be writing right behind it so it can't be
+    // moved in place
+    if (!this->frame_copy_)
+      this->frame_copy_.reset(new uint8_t[this->max_frame_size_]);  // NOLINT(cppcoreguidelines-owning-memory)
+    const size_t first = this->capacity_ - index;
+    memcpy(&this->frame_copy_[0], &this->buffer_[index], first);
+    memcpy(&this->frame_copy_[first], &this->buffer_[0], msg_size - first);
+    frame->data = &this->frame_copy_[0];
+  }
+  this->frame_length_ = header_len + msg_size;
+  return FrameStatus::FRAME_READY;
+}
+void APIFrameBuffer::consume_frame() {
+  this->skip_(this->frame_length_);
+  this->frame_length_ = 0;
+}
+
+}  // namespace api
+}  // namespace esphome
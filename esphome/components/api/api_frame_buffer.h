@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace esphome {
+namespace api {
+
+/** Receive buffer of an API connection: a ring buffer with a fixed capacity that frames are parsed from in place.
+ *
+ * Each frame is a zero byte, a VarInt with the size of the message, a VarInt with the message type and the
+ * message itself. The header is parsed directly from the ring. A message is decoded from the ring as well, only a
+ * message that wraps around the end of the ring is copied into a separate buffer so that it is contiguous.
+ *
+ * The ring is single producer, single consumer: write() may be called from the TCP task while the main loop parses
+ * frames. Only write() advances the write position and only the parsing advances the read position, data is never
+ * moved in the ring.
+ *
+ * The ring always has room for a full TCP receive window, the connection holds back the acknowledgement of received
+ * data while it doesn't (see should_ack()), so the peer can't send more than fits.
+ *
+ * Messages larger than the maximum frame size are skipped (their bytes are dropped as they arrive) instead of
+ * growing the buffer, the stream stays in sync and the connection can continue.
+ */
+class APIFrameBuffer {
+ public:
+  enum class FrameStatus {
+    /// No complete frame in the buffer yet.
+    NEED_MORE_DATA,
+    /// A frame was parsed, call consume_frame() after handling it.
+    FRAME_READY,
+    /// The frame announced a message larger than the maximum frame size, it is being skipped.
+    FRAME_TOO_LARGE,
+    /// The data is not a valid frame, the stream cannot be recovered.
+    INVALID_FRAME,
+  };
+
+  struct Frame {
+    uint32_t type;
+    uint32_t size;
+    uint8_t *data;
+  };
+
+  /// Receive window of the TCP stack, the most data the peer sends without an acknowledgement.
+  static const size_t RECEIVE_WINDOW;
+
+  /** Allocate the ring, with room for a frame of max_frame_size plus a TCP receive window.
+   *
+   * Must not be called while write() may run.
+   */
+  void init(size_t max_frame_size);
+
+  /** Append received data, only called by the producer.
+   *
+   * @return false if the data does not fit, in which case nothing is appended.
+   */
+  bool write(const uint8_t *data, size_t len);
+
+  /** Parse the next frame, only called by the consumer.
+   *
+   * frame->data points into the buffer and stays valid until consume_frame() is called.
+   */
+  FrameStatus next_frame(Frame *frame);
+  /// Remove the frame returned by the last successful next_frame() call.
+  void consume_frame();
+
+  /// The number of unread bytes, as seen by the consumer.
+  size_t available() const;
+  /// The free space, may be called from either side.
+  size_t get_free() const;
+  /** Whether received data can be acknowledged to the peer.
+   *
+   * Only while a full receive window still fits into the ring, the acknowledgement of data received after that is
+   * delayed until the consumer has made room again.
+   */
+  bool should_ack() const { return this->get_free() >= RECEIVE_WINDOW; }
+  size_t get_capacity() const { return this->capacity_; }
+  size_t get_max_frame_size() const { return this->max_frame_size_; }
+
+ protected:
+  /// Positions run through [0, 2 * capacity), so that a full ring can be told apart from an empty one.
+  size_t advance_(size_t pos, size_t len) const;
+  /// Map a position into the ring.
+  size_t index_(size_t pos) const { return pos >= this->capacity_ ? pos - this->capacity_ : pos; }
+  size_t distance_(size_t from, size_t to) const { return to >= from ? to - from : to + 2 * this->capacity_ - from; }
+  uint8_t peek_(size_t offset) const;
+  /// Parse a 32bit VarInt at offset (relative to the read position), returns the number of bytes or 0.
+  size_t parse_varint_(size_t offset, size_t size, uint32_t *value, bool *invalid) const;
+  void skip_(size_t len);
+
+  std::unique_ptr<uint8_t[]> buffer_;
+  /// Contiguous copy of a message that wraps around the end of the ring.
+  std::unique_ptr<uint8_t[]> frame_copy_;
+  size_t capacity_{0};
+  size_t max_frame_size_{0};
+  /// Written by the consumer only.
+  std::atomic<size_t> read_pos_{0};
+  /// Written by the producer only.
+  std::atomic<size_t> write_pos_{0};
+  /// Bytes of an oversized message that still have to be dropped.
+  size_t skip_remaining_{0};
+  /// Length of header and message of the frame returned by next_frame().
+  size_t frame_length_{0};
+};
+
+}  // namespace api
+}  // namespace esphome
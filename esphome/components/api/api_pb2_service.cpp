@@ -282,6 +282,30 @@ bool APIServerConnectionBase::send_select_state_response(const SelectStateRespon
 #endif
 #ifdef USE_SELECT
 #endif
+#ifdef USE_PROFILER
+#endif
+#ifdef USE_PROFILER
+bool APIServerConnectionBase::send_profiler_stats_response(const ProfilerStatsResponse &msg) {
+#ifdef HAS_PROTO_MESSAGE_DUMP
+  ESP_LOGVV(TAG, "send_profiler_stats_response: %s", msg.dump().c_str());
+#endif
+  return this->send_message_<ProfilerStatsResponse>(msg, 56);
+}
+#endif
+#ifdef USE_PROFILER
+bool APIServerConnectionBase::send_profiler_stats_done_response(const ProfilerStatsDoneResponse &msg) {
+#ifdef HAS_PROTO_MESSAGE_DUMP
+  ESP_LOGVV(TAG, "send_profiler_stats_done_response: %s", msg.dump().c_str());
+#endif
+  return this->send_message_<ProfilerStatsDoneResponse>(msg, 57);
+}
+#endif
+bool APIServerConnectionBase::send_connection_stats_response(const ConnectionStatsResponse &msg) {
+#ifdef HAS_PROTO_MESSAGE_DUMP
+  ESP_LOGVV(TAG, "send_connection_stats_response: %s", msg.dump().c_str());
+#endif
+  return this->send_message_<ConnectionStatsResponse>(msg, 59);
+}
 bool APIServerConnectionBase::read_message(uint32_t msg_size, uint32_t msg_type, uint8_t *msg_data) {
   switch (msg_type) {
     case 1: {
@@ -516,6 +540,26 @@ bool APIServerConnectionBase::read_message(uint32_t msg_size, uint32_t msg_type,
 #endif
       break;
     }
+    case 55: {
+#ifdef USE_PROFILER
+      ProfilerStatsRequest msg;
+      msg.decode(msg_data, msg_size);
+#ifdef HAS_PROTO_MESSAGE_DUMP
+      ESP_LOGVV(TAG, "on_profiler_stats_request: %s", msg.dump().c_str());
+#endif
+      this->on_profiler_stats_request(msg);
+#endif
+      break;
+    }
+    case 58: {
+      ConnectionStatsRequest msg;
+      msg.decode(msg_data, msg_size);
+#ifdef HAS_PROTO_MESSAGE_DUMP
+      ESP_LOGVV(TAG, "on_connection_stats_request: %s", msg.dump().c_str());
+#endif
+      this->on_connection_stats_request(msg);
+      break;
+    }
     default:
       return false;
   }
@@ -737,6 +781,33 @@ void APIServerConnection::on_select_command_request(const SelectCommandRequest &
   this->select_command(msg);
 }
 #endif
+#ifdef USE_PROFILER
+void APIServerConnection::on_profiler_stats_request(const ProfilerStatsRequest &msg) {
+  if (!this->is_connection_setup()) {
+    this->on_no_setup_connection();
+    return;
+  }
+  if (!this->is_authenticated()) {
+    this->on_unauthenticated_access();
+    return;
+  }
+  this->profiler_stats(msg);
+}
+#endif
+void APIServerConnection::on_connection_stats_request(const ConnectionStatsRequest &msg) {
+  if (!this->is_connection_setup()) {
+    this->on_no_setup_connection();
+    return;
+  }
+  if (!this->is_authenticated()) {
+    this->on_unauthenticated_access();
+    return;
+  }
+  ConnectionStatsResponse ret = this->connection_stats(msg);
+  if (!this->send_connection_stats_response(ret)) {
+    this->on_fatal_error();
+  }
+}
 
 }  // namespace api
 }  // namespace esphome
@@ -130,6 +130,17 @@ class APIServerConnectionBase : public ProtoService {
 #ifdef USE_SELECT
   virtual void on_select_command_request(const SelectCommandRequest &value){};
 #endif
+#ifdef USE_PROFILER
+  virtual void on_profiler_stats_request(const ProfilerStatsRequest &value){};
+#endif
+#ifdef USE_PROFILER
+  bool send_profiler_stats_response(const ProfilerStatsResponse &msg);
+#endif
+#ifdef USE_PROFILER
+  bool send_profiler_stats_done_response(const ProfilerStatsDoneResponse &msg);
+#endif
+  virtual void on_connection_stats_request(const ConnectionStatsRequest &value){};
+  bool send_connection_stats_response(const ConnectionStatsResponse &msg);
  protected:
   bool read_message(uint32_t msg_size, uint32_t msg_type, uint8_t *msg_data) override;
 };
@@ -172,6 +183,10 @@ class APIServerConnection : public APIServerConnectionBase {
 #ifdef USE_SELECT
   virtual void select_command(const SelectCommandRequest &msg) = 0;
 #endif
+#ifdef USE_PROFILER
+  virtual void profiler_stats(const ProfilerStatsRequest &msg) = 0;
+#endif
+  virtual ConnectionStatsResponse connection_stats(const ConnectionStatsRequest &msg) = 0;
  protected:
   void on_hello_request(const HelloRequest &msg) override;
   void on_connect_request(const ConnectRequest &msg) override;
@@ -209,6 +224,10 @@ class APIServerConnection : public APIServerConnectionBase {
 #ifdef USE_SELECT
   void on_select_command_request(const SelectCommandRequest &msg) override;
 #endif
+#ifdef USE_PROFILER
+  void on_profiler_stats_request(const ProfilerStatsRequest &msg) override;
+#endif
+  void on_connection_stats_request(const ConnectionStatsRequest &msg) override;
 };
 
 }  // namespace api
@@ -33,6 +33,7 @@ void APIServer::setup() {
         // ESP_LOGD(TAG, "New client connected from %s", client->remoteIP().toString().c_str());
         auto *a_this = (APIServer *) s;
         a_this->clients_.push_back(new APIConnection(client, a_this));
+        App.wake_loop();
       },
       this);
 #ifdef USE_LOGGER
@@ -77,8 +78,8 @@ void APIServer::loop() {
     client->loop();
   }
 
+  const uint32_t now = millis();
   if (this->reboot_timeout_ != 0) {
-    const uint32_t now = millis();
     if (!this->is_connected()) {
       if (now - this->last_connected_ > this->reboot_timeout_) {
         ESP_LOGE(TAG, "No client connected to API. Rebooting...");
@@ -90,10 +91,27 @@ void APIServer::loop() {
       this->status_clear_warning();
     }
   }
+
+  // New clients, received data and disconnects wake the loop
+  uint32_t wake_hint = WAKE_HINT_ON_EVENT;
+  for (auto *client : this->clients_) {
+    auto hint = client->get_wake_hint_(now);
+    if (!hint.has_value())
+      return;
+    wake_hint = std::min(wake_hint, *hint);
+  }
+  if (this->reboot_timeout_ != 0 && !this->is_connected()) {
+    const uint32_t elapsed = now - this->last_connected_;
+    wake_hint = std::min<uint32_t>(wake_hint, elapsed >= this->reboot_timeout_ ? 0 : this->reboot_timeout_ - elapsed);
+  }
+  this->set_loop_wake_hint(wake_hint);
 }
 void APIServer::dump_config() {
   ESP_LOGCONFIG(TAG, "API Server:");
   ESP_LOGCONFIG(TAG, "  Address: %s:%u", network_get_address().c_str(), this->port_);
+  ESP_LOGCONFIG(TAG, "  Max Frame Size: %u bytes", this->max_frame_size_);
+  if (this->batch_states_)
+    ESP_LOGCONFIG(TAG, "  Batch Delay: %u ms", this->batch_delay_);
 }
 bool APIServer::uses_password() const { return !this->password_.empty(); }
 bool APIServer::check_password(const std::string &password) const {
@@ -129,8 +147,13 @@ void APIServer::handle_disconnect(APIConnection *conn) {}
 void APIServer::on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_binary_sensor_state(obj, state);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::BINARY_SENSOR, obj);
+    } else {
+      c->send_binary_sensor_state(obj, state);
+    }
+  }
 }
 #endif
 
@@ -138,8 +161,13 @@ void APIServer::on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool s
 void APIServer::on_cover_update(cover::Cover *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_cover_state(obj);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::COVER, obj);
+    } else {
+      c->send_cover_state(obj);
+    }
+  }
 }
 #endif
 
@@ -147,8 +175,13 @@ void APIServer::on_cover_update(cover::Cover *obj) {
 void APIServer::on_fan_update(fan::FanState *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_fan_state(obj);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::FAN, obj);
+    } else {
+      c->send_fan_state(obj);
+    }
+  }
 }
 #endif
 
@@ -156,8 +189,13 @@ void APIServer::on_fan_update(fan::FanState *obj) {
 void APIServer::on_light_update(light::LightState *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_light_state(obj);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::LIGHT, obj);
+    } else {
+      c->send_light_state(obj);
+    }
+  }
 }
 #endif
 
@@ -165,8 +203,13 @@ void APIServer::on_light_update(light::LightState *obj) {
 void APIServer::on_sensor_update(sensor::Sensor *obj, float state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_sensor_state(obj, state);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::SENSOR, obj);
+    } else {
+      c->send_sensor_state(obj, state);
+    }
+  }
 }
 #endif
 
@@ -174,8 +217,13 @@ void APIServer::on_sensor_update(sensor::Sensor *obj, float state) {
 void APIServer::on_switch_update(switch_::Switch *obj, bool state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_switch_state(obj, state);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::SWITCH, obj);
+    } else {
+      c->send_switch_state(obj, state);
+    }
+  }
 }
 #endif
 
@@ -183,8 +231,13 @@ void APIServer::on_switch_update(switch_::Switch *obj, bool state) {
 void APIServer::on_text_sensor_update(text_sensor::TextSensor *obj, const std::string &state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_text_sensor_state(obj, state);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::TEXT_SENSOR, obj);
+    } else {
+      c->send_text_sensor_state(obj, state);
+    }
+  }
 }
 #endif
 
@@ -192,8 +245,13 @@ void APIServer::on_text_sensor_update(text_sensor::TextSensor *obj, const std::s
 void APIServer::on_climate_update(climate::Climate *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_climate_state(obj);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::CLIMATE, obj);
+    } else {
+      c->send_climate_state(obj);
+    }
+  }
 }
 #endif
 
@@ -201,8 +259,13 @@ void APIServer::on_climate_update(climate::Climate *obj) {
 void APIServer::on_number_update(number::Number *obj, float state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_number_state(obj, state);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::NUMBER, obj);
+    } else {
+      c->send_number_state(obj, state);
+    }
+  }
 }
 #endif
 
@@ -210,8 +273,13 @@ void APIServer::on_number_update(number::Number *obj, float state) {
 void APIServer::on_select_update(select::Select *obj, const std::string &state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_select_state(obj, state);
+  for (auto *c : this->clients_) {
+    if (this->batch_states_) {
+      c->queue_state(PendingStateType::SELECT, obj);
+    } else {
+      c->send_select_state(obj, state);
+    }
+  }
 }
 #endif
 
@@ -35,6 +35,14 @@ class APIServer : public Component, public Controller {
   void set_port(uint16_t port);
   void set_password(const std::string &password);
   void set_reboot_timeout(uint32_t reboot_timeout);
+  void set_max_frame_size(uint32_t max_frame_size) { this->max_frame_size_ = max_frame_size; }
+  uint32_t get_max_frame_size() const { return this->max_frame_size_; }
+  /// Batch state updates and send them at most every batch_delay ms (0 = once per loop()).
+  void set_batch_delay(uint32_t batch_delay) {
+    this->batch_states_ = true;
+    this->batch_delay_ = batch_delay;
+  }
+  uint32_t get_batch_delay() const { return this->batch_delay_; }
   void handle_disconnect(APIConnection *conn);
 #ifdef USE_BINARY_SENSOR
   void on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool state) override;
@@ -89,6 +97,9 @@ class APIServer : public Component, public Controller {
   AsyncServer server_{0};
   uint16_t port_{6053};
   uint32_t reboot_timeout_{300000};
+  uint32_t max_frame_size_{1024};
+  bool batch_states_{false};
+  uint32_t batch_delay_{0};
   uint32_t last_connected_{0};
   std::vector<APIConnection *> clients_;
   std::string password_;
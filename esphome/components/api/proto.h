@@ -4,6 +4,8 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 
+#include <cstring>
+
 #ifdef ESPHOME_LOG_HAS_VERY_VERBOSE
 #define HAS_PROTO_MESSAGE_DUMP
 #endif
@@ -83,15 +85,54 @@ class ProtoVarInt {
       }
     }
   }
+  /** Encode into a raw buffer, which must have room for ProtoSize::varint() bytes.
+   *
+   * @return A pointer just past the encoded bytes.
+   */
+  uint8_t *encode(uint8_t *out) const {
+    uint32_t val = this->value_;
+    do {
+      uint8_t temp = val & 0x7F;
+      val >>= 7;
+      *out++ = val ? temp | 0x80 : temp;
+    } while (val);
+    return out;
+  }
 
  protected:
   uint64_t value_;
 };
 
+/** A string field decoded without copying it: a reference to the string in the buffer the message was decoded from.
+ *
+ * Used for the fields of messages with the decode_views option, so that decoding them doesn't allocate. The view
+ * is only valid while the message is being handled, it is not null terminated.
+ */
+class ProtoStringView {
+ public:
+  ProtoStringView() = default;
+  ProtoStringView(const char *data, size_t size) : data_(data), size_(size) {}
+
+  const char *data() const { return this->data_; }
+  size_t size() const { return this->size_; }
+  bool empty() const { return this->size_ == 0; }
+  std::string str() const { return std::string(this->data_, this->size_); }
+  bool operator==(const std::string &other) const {
+    return this->size_ == other.size() && memcmp(this->data_, other.data(), this->size_) == 0;
+  }
+
+ protected:
+  const char *data_{nullptr};
+  size_t size_{0};
+};
+
 class ProtoLengthDelimited {
  public:
   explicit ProtoLengthDelimited(const uint8_t *value, size_t length) : value_(value), length_(length) {}
   std::string as_string() const { return std::string(reinterpret_cast<const char *>(this->value_), this->length_); }
+  ProtoStringView as_string_view() const {
+    return ProtoStringView(reinterpret_cast<const char *>(this->value_), this->length_);
+  }
   template<class C> C as_message() const {
     auto msg = C();
     msg.decode(this->value_, this->length_);
@@ -156,12 +197,14 @@ class ProtoWriteBuffer {
     this->encode_field_raw(field_id, 2);
     this->encode_varint_raw(len);
     auto *data = reinterpret_cast<const uint8_t *>(string);
-    for (size_t i = 0; i < len; i++)
-      this->write(data[i]);
+    this->buffer_->insert(this->buffer_->end(), data, data + len);
   }
   void encode_string(uint32_t field_id, const std::string &value, bool force = false) {
     this->encode_string(field_id, value.data(), value.size());
   }
+  void encode_string(uint32_t field_id, const ProtoStringView &value, bool force = false) {
+    this->encode_string(field_id, value.data(), value.size());
+  }
   void encode_bytes(uint32_t field_id, const uint8_t *data, size_t len, bool force = false) {
     this->encode_string(field_id, reinterpret_cast<const char *>(data), len, force);
   }
@@ -228,15 +271,11 @@ class ProtoWriteBuffer {
   }
   template<class C> void encode_message(uint32_t field_id, const C &value, bool force = false) {
     this->encode_field_raw(field_id, 2);
-    size_t begin = this->buffer_->size();
-
+    // The length prefix comes first, calculate it instead of moving the encoded message afterwards
+    uint32_t nested_length = 0;
+    value.calculate_size(nested_length);
+    this->encode_varint_raw(nested_length);
     value.encode(*this);
-
-    const uint32_t nested_length = this->buffer_->size() - begin;
-    // add size varint
-    std::vector<uint8_t> var;
-    ProtoVarInt(nested_length).encode(var);
-    this->buffer_->insert(this->buffer_->begin() + begin, var.begin(), var.end());
   }
   std::vector<uint8_t> *get_buffer() const { return buffer_; }
 
@@ -244,9 +283,109 @@ class ProtoWriteBuffer {
   std::vector<uint8_t> *buffer_;
 };
 
+/** Calculates the encoded size of messages, before they are written with ProtoWriteBuffer.
+ *
+ * Every add_*_field() method mirrors the encode_*() method of ProtoWriteBuffer with the same name (including the
+ * rules for when a field is skipped), so that buffers can be sized and length prefixes written up front.
+ */
+class ProtoSize {
+ public:
+  /// Encoded size of a varint, values are encoded as 32bit like ProtoVarInt::encode() does.
+  static uint32_t varint(uint32_t value) {
+    if (value < (1UL << 7))
+      return 1;
+    if (value < (1UL << 14))
+      return 2;
+    if (value < (1UL << 21))
+      return 3;
+    if (value < (1UL << 28))
+      return 4;
+    return 5;
+  }
+  static uint32_t field(uint32_t field_id, uint32_t type) { return varint((field_id << 3) | (type & 0b111)); }
+
+  static void add_string_field(uint32_t &total_size, uint32_t field_id, size_t len, bool force = false) {
+    if (len == 0 && !force)
+      return;
+    total_size += field(field_id, 2) + varint(len) + len;
+  }
+  static void add_string_field(uint32_t &total_size, uint32_t field_id, const std::string &value, bool force = false) {
+    // Like ProtoWriteBuffer::encode_string(), empty strings are never encoded
+    add_string_field(total_size, field_id, value.size());
+  }
+  static void add_string_field(uint32_t &total_size, uint32_t field_id, const ProtoStringView &value,
+                               bool force = false) {
+    add_string_field(total_size, field_id, value.size());
+  }
+  static void add_bytes_field(uint32_t &total_size, uint32_t field_id, size_t len, bool force = false) {
+    add_string_field(total_size, field_id, len, force);
+  }
+  static void add_uint32_field(uint32_t &total_size, uint32_t field_id, uint32_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 0) + varint(value);
+  }
+  static void add_uint64_field(uint32_t &total_size, uint32_t field_id, uint64_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 0) + varint(static_cast<uint32_t>(value));
+  }
+  static void add_bool_field(uint32_t &total_size, uint32_t field_id, bool value, bool force = false) {
+    if (!value && !force)
+      return;
+    total_size += field(field_id, 0) + 1;
+  }
+  static void add_fixed32_field(uint32_t &total_size, uint32_t field_id, uint32_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 5) + 4;
+  }
+  template<typename T>
+  static void add_enum_field(uint32_t &total_size, uint32_t field_id, T value, bool force = false) {
+    add_uint32_field(total_size, field_id, static_cast<uint32_t>(value), force);
+  }
+  static void add_float_field(uint32_t &total_size, uint32_t field_id, float value, bool force = false) {
+    if (value == 0.0f && !force)
+      return;
+    // encode_float() does not pass force on, a forced 0.0f is still skipped
+    union {
+      float value;
+      uint32_t raw;
+    } val{};
+    val.value = value;
+    add_fixed32_field(total_size, field_id, val.raw);
+  }
+  static void add_int32_field(uint32_t &total_size, uint32_t field_id, int32_t value, bool force = false) {
+    if (value < 0) {
+      add_int64_field(total_size, field_id, value, force);
+      return;
+    }
+    add_uint32_field(total_size, field_id, static_cast<uint32_t>(value), force);
+  }
+  static void add_int64_field(uint32_t &total_size, uint32_t field_id, int64_t value, bool force = false) {
+    add_uint64_field(total_size, field_id, static_cast<uint64_t>(value), force);
+  }
+  static void add_sint32_field(uint32_t &total_size, uint32_t field_id, int32_t value, bool force = false) {
+    uint32_t uvalue;
+    if (value < 0)
+      uvalue = ~(value << 1);
+    else
+      uvalue = value << 1;
+    add_uint32_field(total_size, field_id, uvalue, force);
+  }
+  template<class C>
+  static void add_message_field(uint32_t &total_size, uint32_t field_id, const C &value, bool force = false) {
+    uint32_t nested_length = 0;
+    value.calculate_size(nested_length);
+    total_size += field(field_id, 2) + varint(nested_length) + nested_length;
+  }
+};
+
 class ProtoMessage {
  public:
   virtual void encode(ProtoWriteBuffer buffer) const = 0;
+  /// Add the size of this message when encoded with encode() to total_size.
+  virtual void calculate_size(uint32_t &total_size) const = 0;
   void decode(const uint8_t *buffer, size_t length);
 #ifdef HAS_PROTO_MESSAGE_DUMP
   std::string dump() const;
@@ -270,12 +409,18 @@ class ProtoService {
   virtual void on_fatal_error() = 0;
   virtual void on_unauthenticated_access() = 0;
   virtual void on_no_setup_connection() = 0;
-  virtual ProtoWriteBuffer create_buffer() = 0;
+  /** Start a new message in the send buffer.
+   *
+   * @param reserve_size The encoded size of the message, if known, so that encoding it does not reallocate.
+   */
+  virtual ProtoWriteBuffer create_buffer(uint32_t reserve_size) = 0;
   virtual bool send_buffer(ProtoWriteBuffer buffer, uint32_t message_type) = 0;
   virtual bool read_message(uint32_t msg_size, uint32_t msg_type, uint8_t *msg_data) = 0;
 
   template<class C> bool send_message_(const C &msg, uint32_t message_type) {
-    auto buffer = this->create_buffer();
+    uint32_t msg_size = 0;
+    msg.calculate_size(msg_size);
+    auto buffer = this->create_buffer(msg_size);
     msg.encode(buffer);
     return this->send_buffer(buffer, message_type);
   }
@@ -100,6 +100,8 @@ void CaptivePortal::start() {
 
   this->initialized_ = true;
   this->active_ = true;
+  // loop() may already have declared that it has nothing to do in this iteration
+  App.wake_loop();
 }
 
 const char STYLESHEET_CSS[] PROGMEM =
@@ -16,8 +16,12 @@ class CaptivePortal : public AsyncWebHandler, public Component {
   void setup() override;
   void dump_config() override;
   void loop() override {
-    if (this->dns_server_ != nullptr)
+    if (this->dns_server_ != nullptr) {
       this->dns_server_->processNextRequest();
+    } else {
+      // Nothing to do until start() is called
+      this->set_loop_wake_hint(WAKE_HINT_ON_EVENT);
+    }
   }
   float get_setup_priority() const override;
   void start();
@@ -27,6 +31,7 @@ class CaptivePortal : public AsyncWebHandler, public Component {
     this->base_->deinit();
     this->dns_server_->stop();
     delete this->dns_server_;
+    this->dns_server_ = nullptr;
   }
 
   bool canHandle(AsyncWebServerRequest *request) override {
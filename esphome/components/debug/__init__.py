@@ -1,15 +1,25 @@
 import esphome.config_validation as cv
 import esphome.codegen as cg
-from esphome.const import CONF_ID
+from esphome.const import CONF_ID, CONF_UPDATE_INTERVAL
 
 CODEOWNERS = ["@OttoWinter"]
 DEPENDENCIES = ["logger"]
 
+CONF_DEBUG_ID = "debug_id"
+CONF_PROFILER = "profiler"
+
 debug_ns = cg.esphome_ns.namespace("debug")
 DebugComponent = debug_ns.class_("DebugComponent", cg.Component)
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(DebugComponent),
+        cv.Optional(CONF_PROFILER): cv.Schema(
+            {
+                cv.Optional(
+                    CONF_UPDATE_INTERVAL, default="60s"
+                ): cv.positive_time_period_milliseconds,
+            }
+        ),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
@@ -17,3 +27,8 @@ CONFIG_SCHEMA = cv.Schema(
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
+
+    if CONF_PROFILER in config:
+        conf = config[CONF_PROFILER]
+        cg.add_define("USE_PROFILER")
+        cg.add(var.set_profiler_update_interval(conf[CONF_UPDATE_INTERVAL]))
@@ -1,8 +1,10 @@
 #include "debug_component.h"
+#include "esphome/core/application.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/version.h"
+#include <algorithm>
 
 #ifdef ARDUINO_ARCH_ESP32
 #include <rom/rtc.h>
@@ -13,6 +15,17 @@ namespace debug {
 
 static const char *const TAG = "debug";
 
+#ifdef USE_PROFILER
+/// Home Assistant rejects states longer than 255 characters.
+static const size_t MAX_PROFILER_SUMMARY_LENGTH = 255;
+#endif
+
+void DebugComponent::setup() {
+#ifdef USE_PROFILER
+  this->set_interval("profiler", this->profiler_update_interval_, [this]() { this->update_profiler_(); });
+#endif
+}
+
 void DebugComponent::dump_config() {
 #ifndef ESPHOME_LOG_HAS_DEBUG
   ESP_LOGE(TAG, "Debug Component requires debug log level!");
@@ -207,5 +220,42 @@ void DebugComponent::loop() {
 }
 float DebugComponent::get_setup_priority() const { return setup_priority::LATE; }
 
+#ifdef USE_PROFILER
+void DebugComponent::update_profiler_() {
+  std::vector<std::pair<uint32_t, ProfilerEntry *>> sorted;
+  for (auto *entry : App.profiler.get_entries()) {
+    if (entry->stats.get_count() != 0)
+      sorted.emplace_back(entry->stats.get_percentile(0.99f), entry);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const std::pair<uint32_t, ProfilerEntry *> &a, const std::pair<uint32_t, ProfilerEntry *> &b) {
+                     return a.first > b.first;
+                   });
+
+  ESP_LOGD(TAG, "Profiler statistics (us):");
+  std::string summary;
+  for (auto &it : sorted) {
+    const ProfilerEntry *entry = it.second;
+    const char *source = entry->component == nullptr ? "<null>" : entry->component->get_component_source();
+    const char *kind = profiler_kind_to_string(entry->kind);
+    const TimingStats &stats = entry->stats;
+    ESP_LOGD(TAG, "  %s %s '%s': count=%u min=%u avg=%u max=%u p99=%u", source, kind, entry->name.c_str(),
+             stats.get_count(), stats.get_min(), stats.get_average(), stats.get_max(), it.first);
+
+    std::string part = std::string(source) + " " + kind;
+    if (!entry->name.empty())
+      part += " '" + entry->name + "'";
+    part += " " + to_string(it.first) + "us";
+    if (summary.size() + part.size() + 2 <= MAX_PROFILER_SUMMARY_LENGTH)
+      summary += (summary.empty() ? "" : ", ") + part;
+  }
+
+#ifdef USE_TEXT_SENSOR
+  if (this->profiler_text_sensor_ != nullptr)
+    this->profiler_text_sensor_->publish_state(summary);
+#endif
+}
+#endif
+
 }  // namespace debug
 }  // namespace esphome
@@ -1,18 +1,46 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+
+#if defined(USE_PROFILER) && defined(USE_TEXT_SENSOR)
+#include "esphome/components/text_sensor/text_sensor.h"
+#endif
 
 namespace esphome {
 namespace debug {
 
 class DebugComponent : public Component {
  public:
+  void setup() override;
   void loop() override;
   float get_setup_priority() const override;
   void dump_config() override;
 
+#ifdef USE_PROFILER
+  void set_profiler_update_interval(uint32_t profiler_update_interval) {
+    this->profiler_update_interval_ = profiler_update_interval;
+  }
+#ifdef USE_TEXT_SENSOR
+  void set_profiler_text_sensor(text_sensor::TextSensor *profiler_text_sensor) {
+    this->profiler_text_sensor_ = profiler_text_sensor;
+  }
+#endif
+#endif
+
  protected:
+#ifdef USE_PROFILER
+  /// Log the statistics of all profiled functions, slowest (by p99) first.
+  void update_profiler_();
+#endif
+
   uint32_t free_heap_{};
+#ifdef USE_PROFILER
+  uint32_t profiler_update_interval_{60000};
+#ifdef USE_TEXT_SENSOR
+  text_sensor::TextSensor *profiler_text_sensor_{nullptr};
+#endif
+#endif
 };
 
 }  // namespace debug
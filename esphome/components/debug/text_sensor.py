@@ -0,0 +1,31 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import text_sensor
+from esphome.const import CONF_ID, CONF_ICON
+from . import CONF_DEBUG_ID, CONF_PROFILER, DebugComponent
+
+DEPENDENCIES = ["debug"]
+
+ICON_PROFILER = "mdi:timer-outline"
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_DEBUG_ID): cv.use_id(DebugComponent),
+        cv.Optional(CONF_PROFILER): text_sensor.TEXT_SENSOR_SCHEMA.extend(
+            {
+                cv.GenerateID(): cv.declare_id(text_sensor.TextSensor),
+                cv.Optional(CONF_ICON, default=ICON_PROFILER): cv.icon,
+            }
+        ),
+    }
+)
+
+
+async def to_code(config):
+    debug = await cg.get_variable(config[CONF_DEBUG_ID])
+    if CONF_PROFILER in config:
+        conf = config[CONF_PROFILER]
+        sens = cg.new_Pvariable(conf[CONF_ID])
+        await text_sensor.register_text_sensor(sens, conf)
+        cg.add_define("USE_PROFILER")
+        cg.add(debug.set_profiler_text_sensor(sens))
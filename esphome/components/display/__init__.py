@@ -36,6 +36,7 @@ DisplayOnPageChangeTrigger = display_ns.class_(
 )
 
 CONF_ON_PAGE_CHANGE = "on_page_change"
+CONF_AUTO_CLEAR_ENABLED = "auto_clear_enabled"
 
 DISPLAY_ROTATIONS = {
     0: display_ns.DISPLAY_ROTATION_0_DEGREES,
@@ -61,6 +62,7 @@ BASIC_DISPLAY_SCHEMA = cv.Schema(
 FULL_DISPLAY_SCHEMA = BASIC_DISPLAY_SCHEMA.extend(
     {
         cv.Optional(CONF_ROTATION): validate_rotation,
+        cv.Optional(CONF_AUTO_CLEAR_ENABLED): cv.boolean,
         cv.Optional(CONF_PAGES): cv.All(
             cv.ensure_list(
                 {
@@ -86,6 +88,8 @@ FULL_DISPLAY_SCHEMA = BASIC_DISPLAY_SCHEMA.extend(
 async def setup_display_core_(var, config):
     if CONF_ROTATION in config:
         cg.add(var.set_rotation(DISPLAY_ROTATIONS[config[CONF_ROTATION]]))
+    if CONF_AUTO_CLEAR_ENABLED in config:
+        cg.add(var.set_auto_clear(config[CONF_AUTO_CLEAR_ENABLED]))
     if CONF_PAGES in config:
         pages = []
         for conf in config[CONF_PAGES]:
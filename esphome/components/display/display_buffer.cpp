@@ -3,6 +3,7 @@
 #include "esphome/core/application.h"
 #include "esphome/core/color.h"
 #include "esphome/core/log.h"
+#include <algorithm>
 #include <utility>
 
 namespace esphome {
@@ -87,14 +88,10 @@ void HOT DisplayBuffer::line(int x1, int y1, int x2, int y2, Color color) {
   }
 }
 void HOT DisplayBuffer::horizontal_line(int x, int y, int width, Color color) {
-  // Future: Could be made more efficient by manipulating buffer directly in certain rotations.
-  for (int i = x; i < x + width; i++)
-    this->draw_pixel_at(i, y, color);
+  this->filled_rectangle(x, y, width, 1, color);
 }
 void HOT DisplayBuffer::vertical_line(int x, int y, int height, Color color) {
-  // Future: Could be made more efficient by manipulating buffer directly in certain rotations.
-  for (int i = y; i < y + height; i++)
-    this->draw_pixel_at(x, i, color);
+  this->filled_rectangle(x, y, 1, height, color);
 }
 void DisplayBuffer::rectangle(int x1, int y1, int width, int height, Color color) {
   this->horizontal_line(x1, y1, width, color);
@@ -102,12 +99,148 @@ void DisplayBuffer::rectangle(int x1, int y1, int width, int height, Color color
   this->vertical_line(x1, y1, height, color);
   this->vertical_line(x1 + width - 1, y1, height, color);
 }
-void DisplayBuffer::filled_rectangle(int x1, int y1, int width, int height, Color color) {
-  // Future: Use vertical_line and horizontal_line methods depending on rotation to reduce memory accesses.
-  for (int i = y1; i < y1 + height; i++) {
-    this->horizontal_line(x1, i, width, color);
+void HOT DisplayBuffer::filled_rectangle(int x1, int y1, int width, int height, Color color) {
+  if (!this->clip_rect_(&x1, &y1, &width, &height))
+    return;
+  this->fill_clipped_rect_(this->get_transform_(), x1, y1, width, height, color);
+  App.feed_wdt();
+}
+void HOT DisplayBuffer::fill_span(int x, int y, int width, Color color) {
+  this->filled_rectangle(x, y, width, 1, color);
+}
+void HOT DisplayBuffer::blit_row(int x, int y, const Color *colors, int width) {
+  int height = 1;
+  const int x_unclipped = x;
+  if (!this->clip_rect_(&x, &y, &width, &height))
+    return;
+  const Transform transform = this->get_transform_();
+  this->draw_pixels_internal_(transform.map_x(x, y), transform.map_y(x, y), transform.x_step_x, transform.x_step_y,
+                              colors + (x - x_unclipped), width);
+  App.feed_wdt();
+}
+void DisplayBuffer::blit_bitmap_1bpp(int x, int y, const uint8_t *data, int width, int height, Color color) {
+  this->blit_bitmap_1bpp_(x, y, data, width, height, color, nullptr);
+}
+void DisplayBuffer::blit_bitmap_1bpp(int x, int y, const uint8_t *data, int width, int height, Color color_on,
+                                     Color color_off) {
+  this->blit_bitmap_1bpp_(x, y, data, width, height, color_on, &color_off);
+}
+void HOT DisplayBuffer::blit_bitmap_1bpp_(int x, int y, const uint8_t *data, int width, int height, Color color_on,
+                                          const Color *color_off) {
+  int clip_x = x, clip_y = y, clip_width = width, clip_height = height;
+  if (!this->clip_rect_(&clip_x, &clip_y, &clip_width, &clip_height))
+    return;
+  const Transform transform = this->get_transform_();
+  const int stride = (width + 7) / 8;
+  const int col_begin = clip_x - x, col_end = clip_x - x + clip_width;
+  for (int row = clip_y - y; row < clip_y - y + clip_height; row++) {
+    const uint8_t *row_data = data + row * stride;
+    auto get_bit = [row_data](int col) -> bool { return pgm_read_byte(row_data + col / 8) & (0x80 >> (col % 8)); };
+    // Draw runs of equal bits with one fill each
+    int run_start = col_begin;
+    bool run_on = get_bit(col_begin);
+    for (int col = col_begin + 1; col <= col_end; col++) {
+      if (col < col_end && get_bit(col) == run_on)
+        continue;
+      if (run_on) {
+        this->fill_clipped_rect_(transform, x + run_start, y + row, col - run_start, 1, color_on);
+      } else if (color_off != nullptr) {
+        this->fill_clipped_rect_(transform, x + run_start, y + row, col - run_start, 1, *color_off);
+      }
+      run_start = col;
+      run_on = !run_on;
+    }
+  }
+  App.feed_wdt();
+}
+void HOT DisplayBuffer::draw_glyph_(const Transform &transform, int x, int y, const GlyphData *glyph, Color color) {
+  int clip_x = x, clip_y = y, clip_width = glyph->width, clip_height = glyph->height;
+  if (!this->clip_rect_(&clip_x, &clip_y, &clip_width, &clip_height))
+    return;
+  // Only clip the single spans if the glyph is partially outside
+  const bool clipped = clip_width != glyph->width || clip_height != glyph->height;
+  const int row_end = clip_y - y + clip_height;
+  const uint8_t *data = glyph->data;
+  for (int row = 0; row < row_end; row++) {
+    bool on = false;
+    for (int col = 0; col < glyph->width; on = !on) {
+      const uint8_t run = pgm_read_byte(data++);
+      if (on && run != 0) {
+        int span_x = x + col, span_y = y + row, span_width = run, span_height = 1;
+        if (!clipped || this->clip_rect_(&span_x, &span_y, &span_width, &span_height))
+          this->fill_clipped_rect_(transform, span_x, span_y, span_width, 1, color);
+      }
+      col += run;
+    }
+  }
+}
+DisplayBuffer::Transform DisplayBuffer::get_transform_() {
+  const int width = this->get_width_internal();
+  const int height = this->get_height_internal();
+  switch (this->rotation_) {
+    case DISPLAY_ROTATION_90_DEGREES:
+      return Transform{width - 1, 0, 0, 1, -1, 0};
+    case DISPLAY_ROTATION_180_DEGREES:
+      return Transform{width - 1, height - 1, -1, 0, 0, -1};
+    case DISPLAY_ROTATION_270_DEGREES:
+      return Transform{0, height - 1, 0, -1, 1, 0};
+    case DISPLAY_ROTATION_0_DEGREES:
+    default:
+      return Transform{0, 0, 1, 0, 0, 1};
+  }
+}
+DisplayBuffer::Transform DisplayBuffer::get_inverse_transform_() {
+  const int width = this->get_width_internal();
+  const int height = this->get_height_internal();
+  switch (this->rotation_) {
+    case DISPLAY_ROTATION_90_DEGREES:
+      return Transform{0, width - 1, 0, -1, 1, 0};
+    case DISPLAY_ROTATION_180_DEGREES:
+      return Transform{width - 1, height - 1, -1, 0, 0, -1};
+    case DISPLAY_ROTATION_270_DEGREES:
+      return Transform{height - 1, 0, 0, 1, -1, 0};
+    case DISPLAY_ROTATION_0_DEGREES:
+    default:
+      return Transform{0, 0, 1, 0, 0, 1};
   }
 }
+bool DisplayBuffer::clip_rect_(int *x, int *y, int *width, int *height) {
+  int min_x = 0, min_y = 0, max_x = this->get_clip_width_(), max_y = this->get_height();
+  if (this->strip_clip_) {
+    min_x = this->strip_clip_x_;
+    min_y = this->strip_clip_y_;
+    max_x = min_x + this->strip_clip_width_;
+    max_y = min_y + this->strip_clip_height_;
+  }
+  if (*x < min_x) {
+    *width -= min_x - *x;
+    *x = min_x;
+  }
+  if (*y < min_y) {
+    *height -= min_y - *y;
+    *y = min_y;
+  }
+  *width = std::min(*width, max_x - *x);
+  *height = std::min(*height, max_y - *y);
+  return *width > 0 && *height > 0;
+}
+void HOT DisplayBuffer::fill_clipped_rect_(const Transform &transform, int x, int y, int width, int height,
+                                           Color color) {
+  // A rectangle stays a rectangle in every rotation, map two opposite corners
+  const int x1 = transform.map_x(x, y), y1 = transform.map_y(x, y);
+  const int x2 = transform.map_x(x + width - 1, y + height - 1), y2 = transform.map_y(x + width - 1, y + height - 1);
+  this->fill_rect_internal_(std::min(x1, x2), std::min(y1, y2), abs(x2 - x1) + 1, abs(y2 - y1) + 1, color);
+}
+void DisplayBuffer::fill_rect_internal_(int x, int y, int width, int height, Color color) {
+  for (int j = y; j < y + height; j++) {
+    for (int i = x; i < x + width; i++)
+      this->draw_absolute_pixel_internal(i, j, color);
+  }
+}
+void DisplayBuffer::draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) {
+  for (int i = 0; i < length; i++)
+    this->draw_absolute_pixel_internal(x + i * step_x, y + i * step_y, colors[i]);
+}
 void HOT DisplayBuffer::circle(int center_x, int center_xy, int radius, Color color) {
   int dx = -radius;
   int dy = 0;
@@ -161,8 +294,17 @@ void DisplayBuffer::filled_circle(int center_x, int center_y, int radius, Color
 void DisplayBuffer::print(int x, int y, Font *font, Color color, TextAlign align, const char *text) {
   int x_start, y_start;
   int width, height;
-  this->get_text_bounds(x, y, text, font, align, &x_start, &y_start, &width, &height);
+  const auto y_align = TextAlign(int(align) & 0x07);
+  if ((int(align) & 0x18) == int(TextAlign::LEFT) && (y_align == TextAlign::TOP || y_align == TextAlign::BASELINE)) {
+    // The position does not depend on the width of the text, no need to measure it first
+    x_start = x;
+    y_start = y_align == TextAlign::BASELINE ? y - font->get_baseline() : y;
+    height = font->get_height();
+  } else {
+    this->get_text_bounds(x, y, text, font, align, &x_start, &y_start, &width, &height);
+  }
 
+  const Transform transform = this->get_transform_();
   int i = 0;
   int x_at = x_start;
   while (text[i] != '\0') {
@@ -173,9 +315,7 @@ void DisplayBuffer::print(int x, int y, Font *font, Color color, TextAlign align
       ESP_LOGW(TAG, "Encountered character without representation in font: '%c'", text[i]);
       if (!font->get_glyphs().empty()) {
         uint8_t glyph_width = font->get_glyphs()[0].glyph_data_->width;
-        for (int glyph_x = 0; glyph_x < glyph_width; glyph_x++)
-          for (int glyph_y = 0; glyph_y < height; glyph_y++)
-            this->draw_pixel_at(glyph_x + x_at, glyph_y + y_start, color);
+        this->filled_rectangle(x_at, y_start, glyph_width, height, color);
         x_at += glyph_width;
       }
 
@@ -183,22 +323,14 @@ void DisplayBuffer::print(int x, int y, Font *font, Color color, TextAlign align
       continue;
     }
 
-    const Glyph &glyph = font->get_glyphs()[glyph_n];
-    int scan_x1, scan_y1, scan_width, scan_height;
-    glyph.scan_area(&scan_x1, &scan_y1, &scan_width, &scan_height);
+    const GlyphData *data = font->get_glyphs()[glyph_n].glyph_data_;
+    this->draw_glyph_(transform, x_at + data->offset_x, y_start + data->offset_y, data, color);
 
-    for (int glyph_x = scan_x1; glyph_x < scan_x1 + scan_width; glyph_x++) {
-      for (int glyph_y = scan_y1; glyph_y < scan_y1 + scan_height; glyph_y++) {
-        if (glyph.get_pixel(glyph_x, glyph_y)) {
-          this->draw_pixel_at(glyph_x + x_at, glyph_y + y_start, color);
-        }
-      }
-    }
-
-    x_at += glyph.glyph_data_->width + glyph.glyph_data_->offset_x;
+    x_at += data->width + data->offset_x;
 
     i += match_length;
   }
+  App.feed_wdt();
 }
 void DisplayBuffer::vprintf_(int x, int y, Font *font, Color color, TextAlign align, const char *format, va_list arg) {
   char buffer[256];
@@ -208,28 +340,34 @@ void DisplayBuffer::vprintf_(int x, int y, Font *font, Color color, TextAlign al
 }
 
 void DisplayBuffer::image(int x, int y, Image *image, Color color_on, Color color_off) {
+  const uint8_t *data = image->get_frame_data();
+  const int width = image->get_width();
   switch (image->get_type()) {
     case IMAGE_TYPE_BINARY:
-      for (int img_x = 0; img_x < image->get_width(); img_x++) {
-        for (int img_y = 0; img_y < image->get_height(); img_y++) {
-          this->draw_pixel_at(x + img_x, y + img_y, image->get_pixel(img_x, img_y) ? color_on : color_off);
-        }
-      }
+      this->blit_bitmap_1bpp(x, y, data, width, image->get_height(), color_on, color_off);
       break;
     case IMAGE_TYPE_GRAYSCALE:
-      for (int img_x = 0; img_x < image->get_width(); img_x++) {
-        for (int img_y = 0; img_y < image->get_height(); img_y++) {
-          this->draw_pixel_at(x + img_x, y + img_y, image->get_grayscale_pixel(img_x, img_y));
-        }
-      }
-      break;
-    case IMAGE_TYPE_RGB24:
-      for (int img_x = 0; img_x < image->get_width(); img_x++) {
-        for (int img_y = 0; img_y < image->get_height(); img_y++) {
-          this->draw_pixel_at(x + img_x, y + img_y, image->get_color_pixel(img_x, img_y));
+    case IMAGE_TYPE_RGB24: {
+      const int bytes_per_pixel = image->get_type() == IMAGE_TYPE_RGB24 ? 3 : 1;
+      // Convert the rows in chunks, to not need a buffer for a whole row
+      Color colors[32];
+      for (int img_y = 0; img_y < image->get_height(); img_y++) {
+        for (int img_x = 0; img_x < width; img_x += 32) {
+          const int length = std::min(32, width - img_x);
+          const uint8_t *src = data + (img_x + img_y * width) * bytes_per_pixel;
+          for (int i = 0; i < length; i++, src += bytes_per_pixel) {
+            if (bytes_per_pixel == 3) {
+              colors[i] = Color(pgm_read_byte(src + 0), pgm_read_byte(src + 1), pgm_read_byte(src + 2));
+            } else {
+              const uint8_t gray = pgm_read_byte(src);
+              colors[i] = Color(gray, gray, gray, gray);
+            }
+          }
+          this->blit_row(x + img_x, y + img_y, colors, length);
         }
       }
       break;
+    }
   }
 }
 
@@ -328,13 +466,96 @@ void DisplayBuffer::show_page(DisplayPage *page) {
 void DisplayBuffer::show_next_page() { this->page_->show_next(); }
 void DisplayBuffer::show_prev_page() { this->page_->show_prev(); }
 void DisplayBuffer::do_update_() {
-  this->clear();
+  if (this->auto_clear_enabled_)
+    this->clear();
+  this->call_writer_();
+}
+void DisplayBuffer::do_update_strips_(int strip_height) {
+  const int width = this->get_width_internal();
+  const int height = this->get_height_internal();
+  const Transform inverse = this->get_inverse_transform_();
+  for (int y = 0; y < height; y += strip_height) {
+    const int rows = std::min(strip_height, height - y);
+    // The strip is a rectangle with rotation applied as well
+    const int x1 = inverse.map_x(0, y), y1 = inverse.map_y(0, y);
+    const int x2 = inverse.map_x(width - 1, y + rows - 1), y2 = inverse.map_y(width - 1, y + rows - 1);
+    this->strip_clip_x_ = std::min(x1, x2);
+    this->strip_clip_y_ = std::min(y1, y2);
+    this->strip_clip_width_ = abs(x2 - x1) + 1;
+    this->strip_clip_height_ = abs(y2 - y1) + 1;
+    this->strip_clip_ = true;
+
+    this->begin_strip_(y, rows);
+    this->clear();
+    this->call_writer_();
+    this->end_strip_(y, rows);
+  }
+  this->strip_clip_ = false;
+}
+void DisplayBuffer::call_writer_() {
   if (this->page_ != nullptr) {
     this->page_->get_writer()(*this);
   } else if (this->writer_.has_value()) {
     (*this->writer_)(*this);
   }
 }
+void DisplayBuffer::init_dirty_area_() {
+  const int height = this->get_height_internal();
+  this->dirty_bands_.resize((height + DIRTY_BAND_HEIGHT - 1) / DIRTY_BAND_HEIGHT);
+  this->mark_all_dirty_();
+}
+void DisplayBuffer::mark_all_dirty_() {
+  for (auto &band : this->dirty_bands_) {
+    band.x_min = 0;
+    band.x_max = this->get_width_internal() - 1;
+  }
+}
+void DisplayBuffer::reset_dirty_area_() {
+  for (auto &band : this->dirty_bands_) {
+    band.x_min = UINT16_MAX;
+    band.x_max = 0;
+  }
+}
+bool DisplayBuffer::is_dirty_() const {
+  for (auto &band : this->dirty_bands_) {
+    if (band.x_min <= band.x_max)
+      return true;
+  }
+  return false;
+}
+void DisplayBuffer::flush_dirty_() {
+  const int height = this->get_height_internal();
+  // The window that is being extended, empty if x1 > x2
+  int x1 = 1, x2 = 0, y1 = 0, y2 = 0;
+  for (size_t i = 0; i < this->dirty_bands_.size(); i++) {
+    const DirtyBand &band = this->dirty_bands_[i];
+    if (band.x_min > band.x_max)
+      continue;
+    const int band_y1 = i * DIRTY_BAND_HEIGHT;
+    const int band_y2 = std::min<int>(band_y1 + DIRTY_BAND_HEIGHT, height);
+    if (x1 <= x2 && y2 == band_y1) {
+      const int merged_x1 = std::min<int>(x1, band.x_min);
+      const int merged_x2 = std::max<int>(x2, band.x_max);
+      const int merged = (merged_x2 - merged_x1 + 1) * (band_y2 - y1);
+      const int separate = (x2 - x1 + 1) * (y2 - y1) + (band.x_max - band.x_min + 1) * (band_y2 - band_y1);
+      if (merged <= separate) {
+        x1 = merged_x1;
+        x2 = merged_x2;
+        y2 = band_y2;
+        continue;
+      }
+    }
+    if (x1 <= x2)
+      this->flush_window_(x1, y1, x2 - x1 + 1, y2 - y1);
+    x1 = band.x_min;
+    x2 = band.x_max;
+    y1 = band_y1;
+    y2 = band_y2;
+  }
+  if (x1 <= x2)
+    this->flush_window_(x1, y1, x2 - x1 + 1, y2 - y1);
+  this->reset_dirty_area_();
+}
 void DisplayOnPageChangeTrigger::process(DisplayPage *from, DisplayPage *to) {
   if ((this->from_ == nullptr || this->from_ == from) && (this->to_ == nullptr || this->to_ == to))
     this->trigger(from, to);
@@ -363,9 +584,17 @@ bool Glyph::get_pixel(int x, int y) const {
   const int y_data = y - this->glyph_data_->offset_y;
   if (x_data < 0 || x_data >= this->glyph_data_->width || y_data < 0 || y_data >= this->glyph_data_->height)
     return false;
-  const uint32_t width_8 = ((this->glyph_data_->width + 7u) / 8u) * 8u;
-  const uint32_t pos = x_data + y_data * width_8;
-  return pgm_read_byte(this->glyph_data_->data + (pos / 8u)) & (0x80 >> (pos % 8u));
+  const uint8_t *data = this->glyph_data_->data;
+  for (int row = 0; row <= y_data; row++) {
+    bool on = false;
+    for (int col = 0; col < this->glyph_data_->width; on = !on) {
+      const uint8_t run = pgm_read_byte(data++);
+      if (row == y_data && x_data < col + run)
+        return on;
+      col += run;
+    }
+  }
+  return false;
 }
 const char *Glyph::get_char() const { return this->glyph_data_->a_char; }
 bool Glyph::compare_to(const char *str) const {
@@ -400,7 +629,60 @@ void Glyph::scan_area(int *x1, int *y1, int *width, int *height) const {
   *width = this->glyph_data_->width;
   *height = this->glyph_data_->height;
 }
+/// Decode the UTF-8 sequence at str, returns its length or 0 if it is not a valid sequence.
+static int decode_utf8(const char *str, uint32_t *codepoint) {
+  const auto lead = uint8_t(str[0]);
+  int length;
+  if (lead < 0x80) {
+    *codepoint = lead;
+    return 1;
+  } else if ((lead & 0xE0) == 0xC0) {
+    *codepoint = lead & 0x1F;
+    length = 2;
+  } else if ((lead & 0xF0) == 0xE0) {
+    *codepoint = lead & 0x0F;
+    length = 3;
+  } else if ((lead & 0xF8) == 0xF0) {
+    *codepoint = lead & 0x07;
+    length = 4;
+  } else {
+    return 0;
+  }
+  for (int i = 1; i < length; i++) {
+    const auto cont = uint8_t(str[i]);
+    // also stops at the terminating zero
+    if ((cont & 0xC0) != 0x80)
+      return 0;
+    *codepoint = (*codepoint << 6) | (cont & 0x3F);
+  }
+  return length;
+}
+int Font::find_codepoint_(uint32_t codepoint) const {
+  int lo = 0;
+  int hi = int(this->glyphs_.size()) - 1;
+  while (lo <= hi) {
+    const int mid = (lo + hi) / 2;
+    const uint32_t mid_codepoint = this->glyphs_[mid].glyph_data_->codepoint;
+    if (mid_codepoint == codepoint)
+      return mid;
+    if (mid_codepoint < codepoint) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return -1;
+}
 int Font::match_next_glyph(const char *str, int *match_length) {
+  if (this->codepoint_index_) {
+    uint32_t codepoint;
+    *match_length = decode_utf8(str, &codepoint);
+    if (*match_length == 0)
+      return -1;
+    return this->find_codepoint_(codepoint);
+  }
+
+  // Some glyphs consist of several code points, match the longest glyph that is a prefix of str
   int lo = 0;
   int hi = this->glyphs_.size() - 1;
   while (lo != hi) {
@@ -448,8 +730,11 @@ void Font::measure(const char *str, int *width, int *x_offset, int *baseline, in
 }
 const std::vector<Glyph> &Font::get_glyphs() const { return this->glyphs_; }
 Font::Font(const GlyphData *data, int data_nr, int baseline, int bottom) : baseline_(baseline), bottom_(bottom) {
-  for (int i = 0; i < data_nr; ++i)
+  for (int i = 0; i < data_nr; ++i) {
     glyphs_.emplace_back(data + i);
+    if (data[i].codepoint == 0)
+      this->codepoint_index_ = false;
+  }
 }
 
 bool Image::get_pixel(int x, int y) const {
@@ -475,6 +760,7 @@ Color Image::get_grayscale_pixel(int x, int y) const {
   const uint8_t gray = pgm_read_byte(this->data_start_ + pos);
   return Color(gray | gray << 8 | gray << 16 | gray << 24);
 }
+const uint8_t *Image::get_frame_data() const { return this->data_start_; }
 int Image::get_width() const { return this->width_; }
 int Image::get_height() const { return this->height_; }
 ImageType Image::get_type() const { return this->type_; }
@@ -517,6 +803,17 @@ Animation::Animation(const uint8_t *data_start, int width, int height, uint32_t
     : Image(data_start, width, height, type), animation_frame_count_(animation_frame_count) {
   current_frame_ = 0;
 }
+const uint8_t *Animation::get_frame_data() const {
+  switch (this->type_) {
+    case IMAGE_TYPE_BINARY:
+      return this->data_start_ + ((this->width_ + 7) / 8) * this->height_ * this->current_frame_;
+    case IMAGE_TYPE_GRAYSCALE:
+      return this->data_start_ + this->width_ * this->height_ * this->current_frame_;
+    case IMAGE_TYPE_RGB24:
+    default:
+      return this->data_start_ + this->width_ * this->height_ * 3 * this->current_frame_;
+  }
+}
 int Animation::get_animation_frame_count() const { return this->animation_frame_count_; }
 int Animation::get_current_frame() const { return this->current_frame_; }
 void Animation::next_frame() {
@@ -78,6 +78,7 @@ enum DisplayRotation {
 };
 
 class Font;
+struct GlyphData;
 class Image;
 class DisplayBuffer;
 class DisplayPage;
@@ -128,6 +129,27 @@ class DisplayBuffer {
   /// Fill a circle centered around [center_x,center_y] with the radius radius with the given color.
   void filled_circle(int center_x, int center_y, int radius, Color color = COLOR_ON);
 
+  /// Fill `width` pixels to the right of [x,y] (including it) with the given color.
+  void fill_span(int x, int y, int width, Color color = COLOR_ON);
+
+  /// Draw `width` pixels to the right of [x,y] (including it) with the given colors.
+  void blit_row(int x, int y, const Color *colors, int width);
+
+  /** Draw a bitmap with one bit per pixel with the top left at [x,y], only the set bits are drawn.
+   *
+   * @param x The x coordinate of the upper left corner.
+   * @param y The y coordinate of the upper left corner.
+   * @param data The bitmap, each row starts at a new byte, the most significant bit is the leftmost pixel. May be
+   * stored in PROGMEM.
+   * @param width The width of the bitmap in pixels.
+   * @param height The height of the bitmap in pixels.
+   * @param color The color to draw the set bits with.
+   */
+  void blit_bitmap_1bpp(int x, int y, const uint8_t *data, int width, int height, Color color = COLOR_ON);
+
+  /// Draw a bitmap with one bit per pixel with the top left at [x,y], the cleared bits are drawn with `color_off`.
+  void blit_bitmap_1bpp(int x, int y, const uint8_t *data, int width, int height, Color color_on, Color color_off);
+
   /** Print `text` with the anchor point at [x,y] with `font`.
    *
    * @param x The x coordinate of the text alignment anchor point.
@@ -304,11 +326,73 @@ class DisplayBuffer {
   /// Internal method to set the display rotation with.
   void set_rotation(DisplayRotation rotation);
 
+  /** Set whether the screen is cleared before each update (default true).
+   *
+   * With auto clear disabled the writer only has to draw what changed, so that drivers that transfer only the
+   * changed area of the buffer (see flush_dirty_()) send as little as possible.
+   */
+  void set_auto_clear(bool auto_clear_enabled) { this->auto_clear_enabled_ = auto_clear_enabled; }
+
  protected:
+  /// Rows per band of the dirty area, the height of an SSD1306 page.
+  static const uint8_t DIRTY_BAND_HEIGHT = 8;
+
+  /// Horizontal extent of the changed pixels in a band, empty if x_min > x_max.
+  struct DirtyBand {
+    uint16_t x_min;
+    uint16_t x_max;
+  };
+
+  /** Maps coordinates with rotation applied to internal coordinates, so that the rotation is evaluated once per
+   * primitive: internal = [x0 + x * x_step_x + y * y_step_x, y0 + x * x_step_y + y * y_step_y].
+   */
+  struct Transform {
+    int x0;
+    int y0;
+    int x_step_x;
+    int x_step_y;
+    int y_step_x;
+    int y_step_y;
+
+    int map_x(int x, int y) const { return this->x0 + x * this->x_step_x + y * this->y_step_x; }
+    int map_y(int x, int y) const { return this->y0 + x * this->x_step_y + y * this->y_step_y; }
+  };
+
   void vprintf_(int x, int y, Font *font, Color color, TextAlign align, const char *format, va_list arg);
 
+  Transform get_transform_();
+  /// The inverse of get_transform_(), maps internal coordinates to ones with rotation applied.
+  Transform get_inverse_transform_();
+  /// Clip a rectangle (with rotation applied) to the screen or current strip, returns false if nothing is left.
+  bool clip_rect_(int *x, int *y, int *width, int *height);
+  /** The width (with rotation applied) drawing is clipped to, the width of the screen by default.
+   *
+   * Drivers with a buffer that grows beyond the screen (to scroll text wider than the display) return a larger
+   * width, their draw_absolute_pixel_internal() then gets the pixels right of the screen too.
+   */
+  virtual int get_clip_width_() { return this->get_width(); }
+  /// Fill a rectangle (with rotation applied) that is already clipped to the screen.
+  void fill_clipped_rect_(const Transform &transform, int x, int y, int width, int height, Color color);
+  void blit_bitmap_1bpp_(int x, int y, const uint8_t *data, int width, int height, Color color_on,
+                         const Color *color_off);
+  /// Draw the spans of a glyph with its top left corner at x/y (with rotation applied).
+  void draw_glyph_(const Transform &transform, int x, int y, const GlyphData *glyph, Color color);
+
   virtual void draw_absolute_pixel_internal(int x, int y, Color color) = 0;
 
+  /** Fill a rectangle in internal coordinates, which is already clipped to the screen.
+   *
+   * Drivers override this to write directly to their buffer, the default draws each pixel.
+   */
+  virtual void fill_rect_internal_(int x, int y, int width, int height, Color color);
+
+  /** Draw `length` pixels in internal coordinates, already clipped to the screen.
+   *
+   * The pixels start at [x,y], for each following pixel [step_x,step_y] is added, one of which is 0 and the other
+   * 1 or -1. Drivers override this to write directly to their buffer, the default draws each pixel.
+   */
+  virtual void draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length);
+
   virtual int get_height_internal() = 0;
 
   virtual int get_width_internal() = 0;
@@ -317,7 +401,57 @@ class DisplayBuffer {
 
   void do_update_();
 
+  /** Render the page once per horizontal strip of `strip_height` rows (in internal coordinates).
+   *
+   * For drivers that do not keep a buffer of the whole screen: for each strip, begin_strip_() is called, the strip
+   * is cleared, the writer draws the page with everything outside of the strip clipped away and end_strip_()
+   * transfers the result. Single pixels are not clipped, draw_absolute_pixel_internal() has to ignore the ones
+   * outside of the strip. Auto clear does not apply, every strip starts out cleared. Note that the writer is
+   * called for every strip.
+   */
+  void do_update_strips_(int strip_height);
+  /// Prepare the buffer for the strip of rows [y, y + height) in internal coordinates.
+  virtual void begin_strip_(int y, int height) {}
+  /// Transfer the rendered strip to the display.
+  virtual void end_strip_(int y, int height) {}
+  void call_writer_();
+
+  /** Start tracking which area of the buffer changed, for drivers that can transfer a part of the screen.
+   *
+   * Must be called once the internal width and height are known. The whole screen starts out dirty.
+   */
+  void init_dirty_area_();
+  /// Mark a pixel (in internal coordinates) as changed, drivers call this when a pixel gets a different value.
+  void mark_dirty_(int x, int y) {
+    if (this->dirty_bands_.empty())
+      return;
+    DirtyBand &band = this->dirty_bands_[unsigned(y) / DIRTY_BAND_HEIGHT];
+    if (x < band.x_min)
+      band.x_min = x;
+    if (x > band.x_max)
+      band.x_max = x;
+  }
+  void mark_all_dirty_();
+  void reset_dirty_area_();
+  bool is_dirty_() const;
+  /** Transfer the changed area of the buffer with flush_window_() calls and start tracking from scratch.
+   *
+   * Each band with changes becomes a window, consecutive bands are combined into one window when it is not larger
+   * than the separate ones.
+   */
+  void flush_dirty_();
+  /// Transfer a window (in internal coordinates) of the buffer to the display.
+  virtual void flush_window_(int x, int y, int width, int height) {}
+
   uint8_t *buffer_{nullptr};
+  /// Area (with rotation applied) that is drawn to while rendering a strip.
+  bool strip_clip_{false};
+  int strip_clip_x_{0};
+  int strip_clip_y_{0};
+  int strip_clip_width_{0};
+  int strip_clip_height_{0};
+  std::vector<DirtyBand> dirty_bands_;
+  bool auto_clear_enabled_{true};
   DisplayRotation rotation_{DISPLAY_ROTATION_0_DEGREES};
   optional<display_writer_t> writer_{};
   DisplayPage *page_{nullptr};
@@ -345,6 +479,9 @@ class DisplayPage {
 
 struct GlyphData {
   const char *a_char;
+  /// Unicode code point of a_char, 0 if a_char consists of several code points.
+  uint32_t codepoint;
+  /// Run length encoded pixel rows, see Glyph.
   const uint8_t *data;
   int offset_x;
   int offset_y;
@@ -352,6 +489,12 @@ struct GlyphData {
   int height;
 };
 
+/** A glyph of a font, the pixels are stored as run lengths row by row.
+ *
+ * Each row is a sequence of byte sized run lengths that alternate between pixels that are off and on, starting
+ * with off. The runs of a row add up to the width of the glyph, longer runs are split by a run of length zero.
+ * Drawing a glyph therefore directly yields horizontal spans instead of single pixels.
+ */
 class Glyph {
  public:
   Glyph(const GlyphData *data) : glyph_data_(data) {}
@@ -389,10 +532,18 @@ class Font {
 
   const std::vector<Glyph> &get_glyphs() const;
 
+  int get_baseline() const { return this->baseline_; }
+  int get_height() const { return this->bottom_; }
+
  protected:
+  /// Binary search for the glyph of a code point, only valid if codepoint_index_ is set.
+  int find_codepoint_(uint32_t codepoint) const;
+
   std::vector<Glyph> glyphs_;
   int baseline_;
   int bottom_;
+  /// All glyphs are single code points, so they can be looked up by their (sorted) code point.
+  bool codepoint_index_{true};
 };
 
 class Image {
@@ -401,6 +552,8 @@ class Image {
   virtual bool get_pixel(int x, int y) const;
   virtual Color get_color_pixel(int x, int y) const;
   virtual Color get_grayscale_pixel(int x, int y) const;
+  /// The pixel data of the current frame, rows of width pixels in the format of the image type.
+  virtual const uint8_t *get_frame_data() const;
   int get_width() const;
   int get_height() const;
   ImageType get_type() const;
@@ -418,6 +571,7 @@ class Animation : public Image {
   bool get_pixel(int x, int y) const override;
   Color get_color_pixel(int x, int y) const override;
   Color get_grayscale_pixel(int x, int y) const override;
+  const uint8_t *get_frame_data() const override;
 
   int get_animation_frame_count() const;
   int get_current_frame() const;
@@ -2,6 +2,9 @@
 #include "e131_addressable_light_effect.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+#include <cstring>
+
 #ifdef ARDUINO_ARCH_ESP32
 #include <WiFi.h>
 #endif
@@ -16,6 +19,11 @@ namespace e131 {
 
 static const char *const TAG = "e131";
 static const int PORT = 5568;
+/// Held data is applied without synchronization after this time (E1.31 network data loss timeout).
+static const uint32_t SYNC_TIMEOUT = 2500;
+static const uint32_t STATS_INTERVAL = 60000;
+/// Packets with a sequence number up to this much behind the last one arrived out of order (E1.31 6.7.2).
+static const int8_t SEQUENCE_LATE_WINDOW = 20;
 
 E131Component::E131Component() {}
 
@@ -35,22 +43,47 @@ void E131Component::setup() {
   }
 
   join_igmp_groups_();
+
+  this->set_interval("stats", STATS_INTERVAL, [this]() { this->log_stats_(); });
+}
+
+void E131Component::dump_config() {
+  ESP_LOGCONFIG(TAG, "E1.31:");
+  ESP_LOGCONFIG(TAG, "  Method: %s", listen_method_ == E131_MULTICAST ? "Multicast" : "Unicast");
 }
 
 void E131Component::loop() {
-  std::vector<uint8_t> payload;
   E131Packet packet;
   int universe = 0;
 
   while (uint16_t packet_size = udp_->parsePacket()) {
-    payload.resize(packet_size);
+    // Larger packets are no valid E1.31 packets, the rest is discarded by the next parsePacket()
+    const size_t size = std::min<size_t>(packet_size, sizeof(receive_buffer_));
+    if (!udp_->read(receive_buffer_, size)) {
+      continue;
+    }
 
-    if (!udp_->read(&payload[0], payload.size())) {
+    int sync_address;
+    if (sync_packet_(receive_buffer_, size, sync_address)) {
+      release_(sync_address);
       continue;
     }
 
-    if (!packet_(payload, universe, packet)) {
-      ESP_LOGV(TAG, "Invalid packet received of size %zu.", payload.size());
+    if (packet_size > sizeof(receive_buffer_) || !packet_(receive_buffer_, size, universe, packet)) {
+      ESP_LOGV(TAG, "Invalid packet received of size %u.", packet_size);
+      continue;
+    }
+
+    auto it = universes_.find(universe);
+    if (it == universes_.end() || it->second.consumers == 0) {
+      ESP_LOGV(TAG, "Ignored packet for %d universe of size %d.", universe, packet.count);
+      continue;
+    }
+    if (!accept_(it->second, packet))
+      continue;
+
+    if (packet.sync_address != 0) {
+      hold_(universe, it->second, packet);
       continue;
     }
 
@@ -58,6 +91,75 @@ void E131Component::loop() {
       ESP_LOGV(TAG, "Ignored packet for %d universe of size %d.", universe, packet.count);
     }
   }
+
+  // Don't hold data forever if the synchronization packets stopped
+  release_(0);
+}
+
+bool E131Component::accept_(E131Universe &state, const E131Packet &packet) {
+  const auto diff = static_cast<int8_t>(packet.sequence_number - state.last_sequence);
+  if (state.has_sequence && diff <= 0 && diff > -SEQUENCE_LATE_WINDOW) {
+    state.late++;
+    return false;
+  }
+  if (state.has_sequence && diff > 1)
+    state.lost += diff - 1;
+  state.has_sequence = true;
+  state.last_sequence = packet.sequence_number;
+  state.packets++;
+  return true;
+}
+
+void E131Component::hold_(int universe, E131Universe &state, const E131Packet &packet) {
+  if (!state.pending) {
+    // Allocated once per universe and reused for every frame
+    state.pending.reset(new uint8_t[E131_MAX_PROPERTY_VALUES_COUNT]);  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+  if (state.pending_count == 0)
+    state.pending_since = millis();
+
+  memcpy(state.pending.get(), packet.values, packet.count);
+  state.pending_count = packet.count;
+  state.pending_sync_address = packet.sync_address;
+
+  if (listen_method_ == E131_MULTICAST && !sync_addresses_.count(packet.sync_address)) {
+    // The synchronization packets are sent to the multicast group of the sync address
+    sync_addresses_.insert(packet.sync_address);
+    join_igmp_groups_();
+    ESP_LOGD(TAG, "Joined %d sync universe for E1.31.", packet.sync_address);
+  }
+}
+
+void E131Component::release_(int sync_address) {
+  const uint32_t now = millis();
+  for (auto &entry : universes_) {
+    auto &state = entry.second;
+    if (state.pending_count == 0)
+      continue;
+    if (sync_address == 0 ? now - state.pending_since < SYNC_TIMEOUT : state.pending_sync_address != sync_address)
+      continue;
+
+    E131Packet packet{};
+    packet.count = state.pending_count;
+    packet.values = state.pending.get();
+    process_(entry.first, packet);
+    state.pending_count = 0;
+  }
+}
+
+void E131Component::log_stats_() {
+  for (auto &entry : universes_) {
+    auto &state = entry.second;
+    if (state.consumers == 0)
+      continue;
+
+    const uint32_t packets = state.packets - state.reported_packets;
+    if (packets == 0)
+      continue;
+    state.reported_packets = state.packets;
+    ESP_LOGD(TAG, "Universe %d: %.1f packets/s, %u lost, %u late in total.", entry.first,
+             packets * 1000.0f / STATS_INTERVAL, state.lost, state.late);
+  }
 }
 
 void E131Component::add_effect(E131AddressableLightEffect *light_effect) {
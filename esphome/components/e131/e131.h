@@ -16,10 +16,33 @@ class E131AddressableLightEffect;
 enum E131ListenMethod { E131_MULTICAST, E131_UNICAST };
 
 const int E131_MAX_PROPERTY_VALUES_COUNT = 513;
+/// Size of a data packet with the maximum number of property values.
+const int E131_MAX_PACKET_SIZE = 638;
 
 struct E131Packet {
   uint16_t count;
-  uint8_t values[E131_MAX_PROPERTY_VALUES_COUNT];
+  /// The start code followed by the channel values, points into the receive buffer.
+  const uint8_t *values;
+  uint8_t sequence_number;
+  /// Universe of the synchronization packet that releases the data, 0 if the data is applied right away.
+  uint16_t sync_address;
+};
+
+/// State and statistics of a universe.
+struct E131Universe {
+  int consumers{0};
+  bool has_sequence{false};
+  uint8_t last_sequence{0};
+  /// Data packets received, lost (gaps in the sequence numbers) and discarded because they arrived out of order.
+  uint32_t packets{0};
+  uint32_t lost{0};
+  uint32_t late{0};
+  uint32_t reported_packets{0};
+  /// Property values waiting for a synchronization packet, allocated on first use.
+  std::unique_ptr<uint8_t[]> pending;
+  uint16_t pending_count{0};
+  uint16_t pending_sync_address{0};
+  uint32_t pending_since{0};
 };
 
 class E131Component : public esphome::Component {
@@ -29,6 +52,7 @@ class E131Component : public esphome::Component {
 
   void setup() override;
   void loop() override;
+  void dump_config() override;
   float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
 
  public:
@@ -39,8 +63,16 @@ class E131Component : public esphome::Component {
   void set_method(E131ListenMethod listen_method) { this->listen_method_ = listen_method; }
 
  protected:
-  bool packet_(const std::vector<uint8_t> &data, int &universe, E131Packet &packet);
+  bool packet_(const uint8_t *data, size_t size, int &universe, E131Packet &packet);
+  bool sync_packet_(const uint8_t *data, size_t size, int &sync_address);
+  /// Check the sequence number and update the statistics, returns false if the packet is discarded.
+  bool accept_(E131Universe &state, const E131Packet &packet);
+  /// Keep the data of a packet until the synchronization packet for its sync address arrives.
+  void hold_(int universe, E131Universe &state, const E131Packet &packet);
+  /// Apply the held data of all universes waiting for sync_address, or all that waited too long if it is 0.
+  void release_(int sync_address);
   bool process_(int universe, const E131Packet &packet);
+  void log_stats_();
   bool join_igmp_groups_();
   void join_(int universe);
   void leave_(int universe);
@@ -49,8 +81,10 @@ class E131Component : public esphome::Component {
   E131ListenMethod listen_method_{E131_MULTICAST};
   std::unique_ptr<UDP> udp_;
   std::set<E131AddressableLightEffect *> light_effects_;
-  std::map<int, int> universe_consumers_;
-  std::map<int, E131Packet> universe_packets_;
+  std::map<int, E131Universe> universes_;
+  /// Sync addresses whose multicast group was joined.
+  std::set<int> sync_addresses_;
+  uint8_t receive_buffer_[E131_MAX_PACKET_SIZE];
 };
 
 }  // namespace e131
@@ -6,7 +6,8 @@ namespace esphome {
 namespace e131 {
 
 static const char *const TAG = "e131_addressable_light_effect";
-static const int MAX_DATA_SIZE = (sizeof(E131Packet::values) - 1);
+static const int MAX_DATA_SIZE = E131_MAX_PROPERTY_VALUES_COUNT - 1;
+static const int LIGHTS_PER_CHUNK = 32;
 
 E131AddressableLightEffect::E131AddressableLightEffect(const std::string &name) : AddressableLightEffect(name) {}
 
@@ -60,28 +61,25 @@ bool E131AddressableLightEffect::process_(int universe, const E131Packet &packet
   ESP_LOGV(TAG, "Applying data for '%s' on %d universe, for %d-%d.", get_name().c_str(), universe, output_offset,
            output_end);
 
-  switch (channels_) {
-    case E131_MONO:
-      for (; output_offset < output_end; output_offset++, input_data++) {
-        auto output = (*it)[output_offset];
-        output.set(Color(input_data[0], input_data[0], input_data[0], input_data[0]));
-      }
-      break;
-
-    case E131_RGB:
-      for (; output_offset < output_end; output_offset++, input_data += 3) {
-        auto output = (*it)[output_offset];
-        output.set(
-            Color(input_data[0], input_data[1], input_data[2], (input_data[0] + input_data[1] + input_data[2]) / 3));
-      }
-      break;
+  if (this->channels_ == E131_RGBW) {
+    it->write_rgbw(output_offset, input_data, output_end - output_offset);
+    return true;
+  }
 
-    case E131_RGBW:
-      for (; output_offset < output_end; output_offset++, input_data += 4) {
-        auto output = (*it)[output_offset];
-        output.set(Color(input_data[0], input_data[1], input_data[2], input_data[3]));
+  // Convert the channels in chunks and write them in bulk
+  Color chunk[LIGHTS_PER_CHUNK];
+  while (output_offset < output_end) {
+    const int count = std::min(LIGHTS_PER_CHUNK, output_end - output_offset);
+    for (int i = 0; i < count; i++, input_data += this->channels_) {
+      if (this->channels_ == E131_MONO) {
+        chunk[i] = Color(input_data[0], input_data[0], input_data[0], input_data[0]);
+      } else {
+        chunk[i] =
+            Color(input_data[0], input_data[1], input_data[2], (input_data[0] + input_data[1] + input_data[2]) / 3);
       }
-      break;
+    }
+    it->write(output_offset, chunk, count);
+    output_offset += count;
   }
 
   return true;
@@ -12,7 +12,9 @@ static const char *const TAG = "e131";
 
 static const uint8_t ACN_ID[12] = {0x41, 0x53, 0x43, 0x2d, 0x45, 0x31, 0x2e, 0x31, 0x37, 0x00, 0x00, 0x00};
 static const uint32_t VECTOR_ROOT = 4;
+static const uint32_t VECTOR_ROOT_EXTENDED = 8;
 static const uint32_t VECTOR_FRAME = 2;
+static const uint32_t VECTOR_FRAME_SYNCHRONIZATION = 1;
 static const uint8_t VECTOR_DMP = 2;
 
 // E1.31 Packet Structure
@@ -31,7 +33,7 @@ union E131RawPacket {
     uint32_t frame_vector;
     uint8_t source_name[64];
     uint8_t priority;
-    uint16_t reserved;
+    uint16_t sync_address;
     uint8_t sequence_number;
     uint8_t options;
     uint16_t universe;
@@ -46,9 +48,27 @@ union E131RawPacket {
     uint8_t property_values[E131_MAX_PROPERTY_VALUES_COUNT];
   } __attribute__((packed));
 
-  uint8_t raw[638];
+  uint8_t raw[E131_MAX_PACKET_SIZE];
 };
 
+// E1.31 Synchronization Packet Structure (E1.31-2016)
+struct E131RawSyncPacket {
+  // Root Layer
+  uint16_t preamble_size;
+  uint16_t postamble_size;
+  uint8_t acn_id[12];
+  uint16_t root_flength;
+  uint32_t root_vector;
+  uint8_t cid[16];
+
+  // Frame Layer
+  uint16_t frame_flength;
+  uint32_t frame_vector;
+  uint8_t sequence_number;
+  uint16_t sync_address;
+  uint16_t reserved;
+} __attribute__((packed));
+
 // We need to have at least one `1` value
 // Get the offset of `property_values[1]`
 const size_t E131_MIN_PACKET_SIZE = reinterpret_cast<size_t>(&((E131RawPacket *) nullptr)->property_values[1]);
@@ -59,8 +79,8 @@ bool E131Component::join_igmp_groups_() {
   if (!udp_)
     return false;
 
-  for (auto universe : universe_consumers_) {
-    if (!universe.second)
+  for (auto &universe : universes_) {
+    if (!universe.second.consumers)
       continue;
 
     ip4_addr_t multicast_addr = {
@@ -73,12 +93,20 @@ bool E131Component::join_igmp_groups_() {
     }
   }
 
+  for (auto sync_address : sync_addresses_) {
+    ip4_addr_t multicast_addr = {
+        static_cast<uint32_t>(IPAddress(239, 255, ((sync_address >> 8) & 0xff), ((sync_address >> 0) & 0xff)))};
+
+    if (igmp_joingroup(IP4_ADDR_ANY4, &multicast_addr)) {
+      ESP_LOGW(TAG, "IGMP join for %d sync universe of E1.31 failed.", sync_address);
+    }
+  }
+
   return true;
 }
 
 void E131Component::join_(int universe) {
-  // store only latest received packet for the given universe
-  auto consumers = ++universe_consumers_[universe];
+  auto consumers = ++universes_[universe].consumers;
 
   if (consumers > 1) {
     return;  // we already joined before
@@ -90,12 +118,16 @@ void E131Component::join_(int universe) {
 }
 
 void E131Component::leave_(int universe) {
-  auto consumers = --universe_consumers_[universe];
+  auto &state = universes_[universe];
+  auto consumers = --state.consumers;
 
   if (consumers > 0) {
     return;  // we have other consumers of the given universe
   }
 
+  // drop data still waiting for a synchronization packet
+  state.pending_count = 0;
+
   if (listen_method_ == E131_MULTICAST) {
     ip4_addr_t multicast_addr = {
         static_cast<uint32_t>(IPAddress(239, 255, ((universe >> 8) & 0xff), ((universe >> 0) & 0xff)))};
@@ -106,11 +138,11 @@ void E131Component::leave_(int universe) {
   ESP_LOGD(TAG, "Left %d universe for E1.31.", universe);
 }
 
-bool E131Component::packet_(const std::vector<uint8_t> &data, int &universe, E131Packet &packet) {
-  if (data.size() < E131_MIN_PACKET_SIZE)
+bool E131Component::packet_(const uint8_t *data, size_t size, int &universe, E131Packet &packet) {
+  if (size < E131_MIN_PACKET_SIZE)
     return false;
 
-  auto sbuff = reinterpret_cast<const E131RawPacket *>(&data[0]);
+  auto sbuff = reinterpret_cast<const E131RawPacket *>(data);
 
   if (memcmp(sbuff->acn_id, ACN_ID, sizeof(sbuff->acn_id)) != 0)
     return false;
@@ -127,8 +159,30 @@ bool E131Component::packet_(const std::vector<uint8_t> &data, int &universe, E13
   packet.count = htons(sbuff->property_value_count);
   if (packet.count > E131_MAX_PROPERTY_VALUES_COUNT)
     return false;
+  // the values are not copied, the packet must contain all of them
+  if (size < E131_MIN_PACKET_SIZE - 1 + packet.count)
+    return false;
+
+  packet.values = sbuff->property_values;
+  packet.sequence_number = sbuff->sequence_number;
+  packet.sync_address = htons(sbuff->sync_address);
+  return true;
+}
+
+bool E131Component::sync_packet_(const uint8_t *data, size_t size, int &sync_address) {
+  if (size < sizeof(E131RawSyncPacket))
+    return false;
+
+  auto sbuff = reinterpret_cast<const E131RawSyncPacket *>(data);
+
+  if (memcmp(sbuff->acn_id, ACN_ID, sizeof(sbuff->acn_id)) != 0)
+    return false;
+  if (htonl(sbuff->root_vector) != VECTOR_ROOT_EXTENDED)
+    return false;
+  if (htonl(sbuff->frame_vector) != VECTOR_FRAME_SYNCHRONIZATION)
+    return false;
 
-  memcpy(packet.values, sbuff->property_values, packet.count);
+  sync_address = htons(sbuff->sync_address);
   return true;
 }
 
@@ -14,6 +14,8 @@ FastLEDLightOutput = fastled_base_ns.class_(
     "FastLEDLightOutput", light.AddressableLight
 )
 
+CONF_OUTPUT_TASK = "output_task"
+
 RGB_ORDERS = [
     "RGB",
     "RBG",
@@ -29,6 +31,7 @@ BASE_SCHEMA = light.ADDRESSABLE_LIGHT_SCHEMA.extend(
         cv.Required(CONF_NUM_LEDS): cv.positive_not_null_int,
         cv.Optional(CONF_RGB_ORDER): cv.one_of(*RGB_ORDERS, upper=True),
         cv.Optional(CONF_MAX_REFRESH_RATE): cv.positive_time_period_microseconds,
+        cv.Optional(CONF_OUTPUT_TASK): cv.All(cv.only_on_esp32, cv.boolean),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
@@ -39,6 +42,8 @@ async def new_fastled_light(config):
 
     if CONF_MAX_REFRESH_RATE in config:
         cg.add(var.set_max_refresh_rate(config[CONF_MAX_REFRESH_RATE]))
+    if CONF_OUTPUT_TASK in config:
+        cg.add(var.set_output_task(config[CONF_OUTPUT_TASK]))
 
     await light.register_light(var, config)
     # https://github.com/FastLED/FastLED/blob/master/library.json
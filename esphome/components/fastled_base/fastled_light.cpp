@@ -14,16 +14,42 @@ void FastLEDLightOutput::setup() {
   if (!this->max_refresh_rate_.has_value()) {
     this->set_max_refresh_rate(this->controller_->getMaxRefreshRate());
   }
+#ifdef ARDUINO_ARCH_ESP32
+  if (this->output_task_enabled_) {
+    this->output_task_ = make_unique<light::LightOutputTask>();
+    // The task transmits its front buffer, the LEDs are only written by the loop
+    this->output_task_->init(this->num_leds_ * sizeof(CRGB), *this->max_refresh_rate_, [this](const uint8_t *frame) {
+      this->controller_->setLeds(reinterpret_cast<CRGB *>(const_cast<uint8_t *>(frame)), this->num_leds_);
+      this->controller_->showLeds();
+    });
+    if (!this->output_task_->start_task())
+      this->output_task_.reset();
+  }
+#endif
 }
 void FastLEDLightOutput::dump_config() {
   ESP_LOGCONFIG(TAG, "FastLED light:");
   ESP_LOGCONFIG(TAG, "  Num LEDs: %u", this->num_leds_);
   ESP_LOGCONFIG(TAG, "  Max refresh rate: %u", *this->max_refresh_rate_);
+#ifdef ARDUINO_ARCH_ESP32
+  ESP_LOGCONFIG(TAG, "  Output Task: %s", YESNO(this->output_task_ != nullptr));
+  if (this->output_task_ != nullptr)
+    ESP_LOGCONFIG(TAG, "    Free stack: %u bytes", this->output_task_->get_stack_free());
+#endif
 }
 void FastLEDLightOutput::loop() {
   if (!this->should_show_())
     return;
 
+#ifdef ARDUINO_ARCH_ESP32
+  if (this->output_task_ != nullptr) {
+    // The task does the pacing, frames submitted faster than the refresh rate replace each other
+    this->mark_shown_();
+    this->output_task_->submit(reinterpret_cast<const uint8_t *>(this->leds_));
+    return;
+  }
+#endif
+
   uint32_t now = micros();
   // protect from refreshing too often
   if (*this->max_refresh_rate_ != 0 && (now - this->last_refresh_) < *this->max_refresh_rate_) {
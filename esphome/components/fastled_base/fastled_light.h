@@ -4,6 +4,12 @@
 #include "esphome/core/helpers.h"
 #include "esphome/components/light/addressable_light.h"
 
+#include <algorithm>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include "esphome/components/light/light_output_task.h"
+#endif
+
 #define FASTLED_ESP8266_RAW_PIN_ORDER
 #define FASTLED_ESP32_RAW_PIN_ORDER
 #define FASTLED_RMT_BUILTIN_DRIVER true
@@ -26,6 +32,11 @@ class FastLEDLightOutput : public light::AddressableLight {
   /// Set a maximum refresh rate in µs as some lights do not like being updated too often.
   void set_max_refresh_rate(uint32_t interval_us) { this->max_refresh_rate_ = interval_us; }
 
+#ifdef ARDUINO_ARCH_ESP32
+  /// Transmit the LEDs from a task on the other core instead of blocking the main loop.
+  void set_output_task(bool output_task) { this->output_task_enabled_ = output_task; }
+#endif
+
   /// Add some LEDS, can only be called once.
   CLEDController &add_leds(CLEDController *controller, int num_leds) {
     this->controller_ = controller;
@@ -226,6 +237,17 @@ class FastLEDLightOutput : public light::AddressableLight {
     return {&this->leds_[index].r,      &this->leds_[index].g, &this->leds_[index].b, nullptr,
             &this->effect_data_[index], &this->correction_};
   }
+  void fill_internal_(int32_t index, int32_t count, const Color &corrected) override {
+    std::fill(this->leds_ + index, this->leds_ + index + count, CRGB(corrected.red, corrected.green, corrected.blue));
+  }
+  void write_internal_(int32_t index, const Color *colors, int32_t count, const uint8_t *table) override {
+    CRGB *led = this->leds_ + index;
+    for (int32_t i = 0; i < count; i++, led++) {
+      led->r = table[colors[i].red];
+      led->g = table[256 + colors[i].green];
+      led->b = table[512 + colors[i].blue];
+    }
+  }
 
   CLEDController *controller_{nullptr};
   CRGB *leds_{nullptr};
@@ -233,6 +255,10 @@ class FastLEDLightOutput : public light::AddressableLight {
   int num_leds_{0};
   uint32_t last_refresh_{0};
   optional<uint32_t> max_refresh_rate_{};
+#ifdef ARDUINO_ARCH_ESP32
+  bool output_task_enabled_{false};
+  std::unique_ptr<light::LightOutputTask> output_task_;
+#endif
 };
 
 }  // namespace fastled_base
@@ -92,6 +92,27 @@ FONT_SCHEMA = cv.Schema(
 CONFIG_SCHEMA = cv.All(validate_pillow_installed, FONT_SCHEMA)
 
 
+def encode_glyph_rows(mask, width, height):
+    """Encode each row as byte sized run lengths, alternating between off and on pixels."""
+    data = []
+    for y in range(height):
+        x = 0
+        on = False
+        while x < width:
+            run = 0
+            while (
+                x + run < width
+                and run < 255
+                and bool(mask.getpixel((x + run, y))) == on
+            ):
+                run += 1
+            # A run of 255 is continued after a run of length zero
+            data.append(run)
+            x += run
+            on = not on
+    return data
+
+
 async def to_code(config):
     from PIL import ImageFont
 
@@ -109,16 +130,8 @@ async def to_code(config):
         mask = font.getmask(glyph, mode="1")
         _, (offset_x, offset_y) = font.font.getsize(glyph)
         width, height = mask.size
-        width8 = ((width + 7) // 8) * 8
-        glyph_data = [0] * (height * width8 // 8)
-        for y in range(height):
-            for x in range(width):
-                if not mask.getpixel((x, y)):
-                    continue
-                pos = x + y * width8
-                glyph_data[pos // 8] |= 0x80 >> (pos % 8)
         glyph_args[glyph] = (len(data), offset_x, offset_y, width, height)
-        data += glyph_data
+        data += encode_glyph_rows(mask, width, height)
 
     rhs = [HexInt(x) for x in data]
     prog_arr = cg.progmem_array(config[CONF_RAW_DATA_ID], rhs)
@@ -129,6 +142,8 @@ async def to_code(config):
             cg.StructInitializer(
                 GlyphData,
                 ("a_char", glyph),
+                # Glyphs are sorted by their UTF-8 encoding, which is the code point order
+                ("codepoint", ord(glyph) if len(glyph) == 1 else 0),
                 (
                     "data",
                     cg.RawExpression(str(prog_arr) + " + " + str(glyph_args[glyph][0])),
@@ -14,6 +14,7 @@ from esphome.const import (
 DEPENDENCIES = ["spi"]
 
 CONF_LED_PIN = "led_pin"
+CONF_STRIP_HEIGHT = "strip_height"
 
 ili9341_ns = cg.esphome_ns.namespace("ili9341")
 ili9341 = ili9341_ns.class_(
@@ -39,6 +40,7 @@ CONFIG_SCHEMA = cv.All(
             cv.Required(CONF_DC_PIN): pins.gpio_output_pin_schema,
             cv.Optional(CONF_RESET_PIN): pins.gpio_output_pin_schema,
             cv.Optional(CONF_LED_PIN): pins.gpio_output_pin_schema,
+            cv.Optional(CONF_STRIP_HEIGHT): cv.int_range(min=1, max=320),
         }
     )
     .extend(cv.polling_component_schema("1s"))
@@ -73,3 +75,5 @@ async def to_code(config):
     if CONF_LED_PIN in config:
         led_pin = await cg.gpio_pin_expression(config[CONF_LED_PIN])
         cg.add(var.set_led_pin(led_pin))
+    if CONF_STRIP_HEIGHT in config:
+        cg.add(var.set_strip_height(config[CONF_STRIP_HEIGHT]))
@@ -2,6 +2,7 @@
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
 #include "esphome/core/helpers.h"
+#include <algorithm>
 
 namespace esphome {
 namespace ili9341 {
@@ -28,6 +29,9 @@ void ILI9341Display::setup_pins_() {
 void ILI9341Display::dump_config() {
   LOG_DISPLAY("", "ili9341", this);
   ESP_LOGCONFIG(TAG, "  Width: %d, Height: %d,  Rotation: %d", this->width_, this->height_, this->rotation_);
+  if (this->strip_height_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Strip Height: %u", this->strip_height_);
+  }
   LOG_PIN("  Reset Pin: ", this->reset_pin_);
   LOG_PIN("  DC Pin: ", this->dc_pin_);
   LOG_PIN("  Busy Pin: ", this->busy_pin_);
@@ -79,34 +83,49 @@ uint8_t ILI9341Display::read_command(uint8_t command_byte, uint8_t index) {
 }
 
 void ILI9341Display::update() {
+  if (this->strip_height_ != 0) {
+    this->do_update_strips_(this->strip_height_);
+    return;
+  }
   this->do_update_();
   this->display_();
 }
 
-void ILI9341Display::display_() {
-  // we will only update the changed window to the display
-  int w = this->x_high_ - this->x_low_ + 1;
-  int h = this->y_high_ - this->y_low_ + 1;
+void ILI9341Display::begin_strip_(int y, int height) {
+  this->strip_y_ = y;
+  this->strip_rows_ = height;
+}
 
-  set_addr_window_(this->x_low_, this->y_low_, w, h);
+void ILI9341Display::end_strip_(int y, int height) {
+  this->set_addr_window_(0, y, this->width_, height);
   this->start_data_();
-  uint32_t start_pos = ((this->y_low_ * this->width_) + x_low_);
-  for (uint16_t row = 0; row < h; row++) {
-    for (uint16_t col = 0; col < w; col++) {
-      uint32_t pos = start_pos + (row * width_) + col;
+  this->write_array(this->buffer_, size_t(this->width_) * height * 2);
+  this->end_data_();
+}
+
+uint8_t *ILI9341Display::strip_pixel_(int x, int y) {
+  if (y < this->strip_y_ || y >= this->strip_y_ + this->strip_rows_)
+    return nullptr;
+  return this->buffer_ + ((y - this->strip_y_) * this->width_ + x) * 2;
+}
 
-      uint16_t color = convert_to_16bit_color_(buffer_[pos]);
+void ILI9341Display::display_() {
+  // we will only update the changed windows to the display
+  this->flush_dirty_();
+}
+
+void ILI9341Display::flush_window_(int x, int y, int width, int height) {
+  this->set_addr_window_(x, y, width, height);
+  this->start_data_();
+  for (int row = y; row < y + height; row++) {
+    const uint8_t *src = this->buffer_ + row * this->width_ + x;
+    for (int col = 0; col < width; col++) {
+      uint16_t color = convert_to_16bit_color_(src[col]);
       this->write_byte(color >> 8);
       this->write_byte(color);
     }
   }
   this->end_data_();
-
-  // invalidate watermarks
-  this->x_low_ = this->width_;
-  this->y_low_ = this->height_;
-  this->x_high_ = 0;
-  this->y_high_ = 0;
 }
 
 uint16_t ILI9341Display::convert_to_16bit_color_(uint8_t color_8bit) {
@@ -129,13 +148,62 @@ uint8_t ILI9341Display::convert_to_8bit_color_(uint16_t color_16bit) {
   return ((b / 0x0A) | ((g / 0x09) << 2) | ((r / 0x04) << 5));
 }
 
-void ILI9341Display::fill(Color color) {
+void HOT ILI9341Display::fill_rect_internal_(int x, int y, int width, int height, Color color) {
   auto color565 = display::ColorUtil::color_to_565(color);
-  memset(this->buffer_, convert_to_8bit_color_(color565), this->get_buffer_length_());
-  this->x_low_ = 0;
-  this->y_low_ = 0;
-  this->x_high_ = this->get_width_internal() - 1;
-  this->y_high_ = this->get_height_internal() - 1;
+  if (this->strip_height_ != 0) {
+    for (int row = y; row < y + height; row++) {
+      uint8_t *dst = this->strip_pixel_(x, row);
+      if (dst == nullptr)
+        continue;
+      for (int i = 0; i < width; i++) {
+        *dst++ = color565 >> 8;
+        *dst++ = color565;
+      }
+    }
+    return;
+  }
+
+  const uint8_t color332 = convert_to_8bit_color_(color565);
+  // only the part of each row that actually changes is written and marked dirty
+  for (int row = y; row < y + height; row++) {
+    uint8_t *dst = this->buffer_ + row * this->width_ + x;
+    int x1 = 0;
+    while (x1 < width && dst[x1] == color332)
+      x1++;
+    if (x1 == width)
+      continue;
+    int x2 = width - 1;
+    while (dst[x2] == color332)
+      x2--;
+    memset(dst + x1, color332, x2 - x1 + 1);
+    this->mark_dirty_(x + x1, row);
+    this->mark_dirty_(x + x2, row);
+  }
+}
+
+void HOT ILI9341Display::draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors,
+                                               int length) {
+  if (this->strip_height_ != 0) {
+    for (int i = 0; i < length; i++) {
+      uint8_t *dst = this->strip_pixel_(x + i * step_x, y + i * step_y);
+      if (dst == nullptr)
+        continue;
+      const uint16_t color565 = display::ColorUtil::color_to_565(colors[i]);
+      dst[0] = color565 >> 8;
+      dst[1] = color565;
+    }
+    return;
+  }
+
+  uint8_t *dst = this->buffer_ + y * this->width_ + x;
+  const int step = step_x + step_y * this->width_;
+  for (int i = 0; i < length; i++) {
+    const uint8_t color332 = convert_to_8bit_color_(display::ColorUtil::color_to_565(colors[i]));
+    if (dst[i * step] == color332)
+      continue;
+    dst[i * step] = color332;
+    this->mark_dirty_(x + i * step_x, y + i * step_y);
+  }
 }
 
 void ILI9341Display::fill_internal_(Color color) {
@@ -146,29 +214,43 @@ void ILI9341Display::fill_internal_(Color color) {
   for (uint32_t i = 0; i < (this->get_width_internal()) * (this->get_height_internal()); i++) {
     this->write_byte(color565 >> 8);
     this->write_byte(color565);
-    buffer_[i] = 0;
   }
   this->end_data_();
+  memset(this->buffer_, 0, this->get_buffer_length_());
 }
 
 void HOT ILI9341Display::draw_absolute_pixel_internal(int x, int y, Color color) {
   if (x >= this->get_width_internal() || x < 0 || y >= this->get_height_internal() || y < 0)
     return;
 
-  // low and high watermark may speed up drawing from buffer
-  this->x_low_ = (x < this->x_low_) ? x : this->x_low_;
-  this->y_low_ = (y < this->y_low_) ? y : this->y_low_;
-  this->x_high_ = (x > this->x_high_) ? x : this->x_high_;
-  this->y_high_ = (y > this->y_high_) ? y : this->y_high_;
+  auto color565 = display::ColorUtil::color_to_565(color);
+  if (this->strip_height_ != 0) {
+    uint8_t *dst = this->strip_pixel_(x, y);
+    if (dst != nullptr) {
+      dst[0] = color565 >> 8;
+      dst[1] = color565;
+    }
+    return;
+  }
 
   uint32_t pos = (y * width_) + x;
-  auto color565 = display::ColorUtil::color_to_565(color);
-  buffer_[pos] = convert_to_8bit_color_(color565);
+  const uint8_t color332 = convert_to_8bit_color_(color565);
+  if (buffer_[pos] == color332)
+    return;
+  buffer_[pos] = color332;
+  // only transfer the area with changed pixels to the display
+  this->mark_dirty_(x, y);
 }
 
 // should return the total size: return this->get_width_internal() * this->get_height_internal() * 2 // 16bit color
 // values per bit is huge
-uint32_t ILI9341Display::get_buffer_length_() { return this->get_width_internal() * this->get_height_internal(); }
+uint32_t ILI9341Display::get_buffer_length_() {
+  if (this->strip_height_ != 0) {
+    // 16bit colors, the width of the model is not known yet when the buffer is allocated
+    return std::max(this->width_, this->height_) * this->strip_height_ * 2;
+  }
+  return this->get_width_internal() * this->get_height_internal();
+}
 
 void ILI9341Display::start_command_() {
   this->dc_pin_->digital_write(false);
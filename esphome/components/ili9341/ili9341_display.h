@@ -24,6 +24,12 @@ class ILI9341Display : public PollingComponent,
   void set_reset_pin(GPIOPin *reset) { this->reset_pin_ = reset; }
   void set_led_pin(GPIOPin *led) { this->led_pin_ = led; }
   void set_model(ILI9341Model model) { this->model_ = model; }
+  /** Render in strips of this many rows instead of keeping a buffer of the whole screen.
+   *
+   * Only a strip is kept in memory, with the full 16bit color depth of the display instead of the 8bit colors of
+   * the screen buffer. The page is drawn once per strip and the whole screen is transferred on every update.
+   */
+  void set_strip_height(uint16_t strip_height) { this->strip_height_ = strip_height; }
 
   void command(uint8_t value);
   void data(uint8_t value);
@@ -33,16 +39,21 @@ class ILI9341Display : public PollingComponent,
 
   void update() override;
 
-  void fill(Color color) override;
-
   void dump_config() override;
   void setup() override {
     this->setup_pins_();
     this->initialize();
+    if (this->strip_height_ == 0) {
+      this->init_dirty_area_();
+      // initialize() cleared both the display and the buffer
+      this->reset_dirty_area_();
+    }
   }
 
  protected:
   void draw_absolute_pixel_internal(int x, int y, Color color) override;
+  void fill_rect_internal_(int x, int y, int width, int height, Color color) override;
+  void draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) override;
   void setup_pins_();
 
   void init_lcd_(const uint8_t *init_cmd);
@@ -51,16 +62,20 @@ class ILI9341Display : public PollingComponent,
   void reset_();
   void fill_internal_(Color color);
   void display_();
+  void flush_window_(int x, int y, int width, int height) override;
+  void begin_strip_(int y, int height) override;
+  void end_strip_(int y, int height) override;
+  /// The pixel at [x,y] in the strip buffer, nullptr if the row is not in the current strip.
+  uint8_t *strip_pixel_(int x, int y);
   uint16_t convert_to_16bit_color_(uint8_t color_8bit);
   uint8_t convert_to_8bit_color_(uint16_t color_16bit);
 
   ILI9341Model model_;
   int16_t width_{320};   ///< Display width as modified by current rotation
   int16_t height_{240};  ///< Display height as modified by current rotation
-  uint16_t x_low_{0};
-  uint16_t y_low_{0};
-  uint16_t x_high_{0};
-  uint16_t y_high_{0};
+  uint16_t strip_height_{0};
+  int strip_y_{0};
+  int strip_rows_{0};
 
   uint32_t get_buffer_length_();
   int get_width_internal() override;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esphome/core/helpers.h"
+#include "json_writer.h"
 #include <ArduinoJson.h>
 
 namespace esphome {
@@ -13,6 +14,8 @@ using json_parse_t = std::function<void(JsonObject &)>;
 using json_build_t = std::function<void(JsonObject &)>;
 
 /// Build a JSON string with the provided json build function.
+///
+/// This builds the whole object tree first, prefer write_json() for payloads that are only serialized.
 const char *build_json(const json_build_t &f, size_t *length);
 
 std::string build_json(const json_build_t &f);
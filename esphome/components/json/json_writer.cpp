@@ -0,0 +1,174 @@
+#include "json_writer.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace json {
+
+void JsonWriter::begin_object() {
+  this->write_separator_();
+  this->output_->push_back('{');
+  this->first_ = true;
+}
+void JsonWriter::begin_object(const char *key) {
+  this->write_key_(key);
+  this->output_->push_back('{');
+  this->first_ = true;
+}
+void JsonWriter::end_object() {
+  this->output_->push_back('}');
+  this->first_ = false;
+}
+void JsonWriter::begin_array() {
+  this->write_separator_();
+  this->output_->push_back('[');
+  this->first_ = true;
+}
+void JsonWriter::begin_array(const char *key) {
+  this->write_key_(key);
+  this->output_->push_back('[');
+  this->first_ = true;
+}
+void JsonWriter::end_array() {
+  this->output_->push_back(']');
+  this->first_ = false;
+}
+
+void JsonWriter::set(const char *key, const char *value) {
+  this->write_key_(key);
+  this->write_string_(value, strlen(value));
+}
+void JsonWriter::set(const char *key, const std::string &value) {
+  this->write_key_(key);
+  this->write_string_(value.data(), value.size());
+}
+void JsonWriter::set(const char *key, bool value) {
+  this->write_key_(key);
+  this->output_->append(value ? "true" : "false");
+}
+void JsonWriter::set(const char *key, float value) {
+  this->write_key_(key);
+  this->write_float_(value);
+}
+
+void JsonWriter::add(const char *value) {
+  this->write_separator_();
+  this->write_string_(value, strlen(value));
+}
+void JsonWriter::add(const std::string &value) {
+  this->write_separator_();
+  this->write_string_(value.data(), value.size());
+}
+void JsonWriter::add(bool value) {
+  this->write_separator_();
+  this->output_->append(value ? "true" : "false");
+}
+void JsonWriter::add(float value) {
+  this->write_separator_();
+  this->write_float_(value);
+}
+
+void JsonWriter::write_separator_() {
+  if (!this->first_)
+    this->output_->push_back(',');
+  this->first_ = false;
+}
+void JsonWriter::write_key_(const char *key) {
+  this->write_separator_();
+  this->write_string_(key, strlen(key));
+  this->output_->push_back(':');
+}
+void JsonWriter::write_string_(const char *value, size_t length) {
+  std::string &out = *this->output_;
+  out.push_back('"');
+  const char *end = value + length;
+  while (value != end) {
+    // Copy the run of characters that need no escaping at once
+    const char *run = value;
+    while (run != end && *run != '"' && *run != '\\' && static_cast<uint8_t>(*run) >= 0x20)
+      run++;
+    out.append(value, run - value);
+    if (run == end)
+      break;
+
+    const char c = *run;
+    out.push_back('\\');
+    switch (c) {
+      case '"':
+      case '\\':
+        out.push_back(c);
+        break;
+      case '\b':
+        out.push_back('b');
+        break;
+      case '\f':
+        out.push_back('f');
+        break;
+      case '\n':
+        out.push_back('n');
+        break;
+      case '\r':
+        out.push_back('r');
+        break;
+      case '\t':
+        out.push_back('t');
+        break;
+      default: {
+        static const char *const HEX_DIGITS = "0123456789abcdef";
+        out.append("u00");
+        out.push_back(HEX_DIGITS[(c >> 4) & 0x0F]);
+        out.push_back(HEX_DIGITS[c & 0x0F]);
+        break;
+      }
+    }
+    value = run + 1;
+  }
+  out.push_back('"');
+}
+void JsonWriter::write_float_(float value) {
+  if (std::isnan(value) || std::isinf(value)) {
+    // NaN and infinity can't be represented in JSON
+    this->output_->append("null");
+    return;
+  }
+  // Whole numbers (the most common case for discovery payloads) are written without the float formatting
+  if (std::fabs(value) < 1e9f && value == static_cast<float>(static_cast<int32_t>(value))) {
+    this->write_integer_(static_cast<int32_t>(value));
+    return;
+  }
+  char buffer[24];
+  int length = snprintf(buffer, sizeof(buffer), "%.7g", value);
+  this->output_->append(buffer, length);
+}
+void JsonWriter::write_unsigned_(uint64_t value) {
+  char buffer[20];
+  char *end = buffer + sizeof(buffer);
+  char *begin = end;
+  do {
+    *--begin = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  this->output_->append(begin, end - begin);
+}
+
+static std::string global_json_write_buffer;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+const char *write_json(const json_write_t &f, size_t *length) {
+  global_json_write_buffer.clear();
+  JsonWriter writer(&global_json_write_buffer);
+  writer.begin_object();
+  f(writer);
+  writer.end_object();
+
+  *length = global_json_write_buffer.size();
+  return global_json_write_buffer.c_str();
+}
+std::string write_json(const json_write_t &f) {
+  size_t len;
+  const char *c_str = write_json(f, &len);
+  return std::string(c_str, len);
+}
+
+}  // namespace json
+}  // namespace esphome
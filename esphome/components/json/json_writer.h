@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace esphome {
+namespace json {
+
+/** Serializes JSON directly into an output string while it is written, without building an object tree first.
+ *
+ * Members and elements are written in the order of the calls, nested objects and arrays have to be ended before
+ * the next member of their parent is written. Separators and string escaping are handled by the writer:
+ *
+ * @code
+ * writer.begin_object();
+ * writer.set("name", "Living Room");
+ * writer.begin_array("modes");
+ * writer.add("auto");
+ * writer.end_array();
+ * writer.end_object();
+ * @endcode
+ */
+class JsonWriter {
+ public:
+  explicit JsonWriter(std::string *output) : output_(output) {}
+
+  /// Start an object, as the root value or as an element of an array.
+  void begin_object();
+  /// Start an object as the member key of the current object.
+  void begin_object(const char *key);
+  void end_object();
+  /// Start an array, as the root value or as an element of an array.
+  void begin_array();
+  /// Start an array as the member key of the current object.
+  void begin_array(const char *key);
+  void end_array();
+
+  /// Write the member key of the current object.
+  void set(const char *key, const char *value);
+  void set(const char *key, const std::string &value);
+  void set(const char *key, bool value);
+  /// Non-finite values are written as null.
+  void set(const char *key, float value);
+  template<typename T> typename std::enable_if<std::is_integral<T>::value>::type set(const char *key, T value) {
+    this->write_key_(key);
+    this->write_integer_(value);
+  }
+
+  /// Write an element of the current array.
+  void add(const char *value);
+  void add(const std::string &value);
+  void add(bool value);
+  void add(float value);
+  template<typename T> typename std::enable_if<std::is_integral<T>::value>::type add(T value) {
+    this->write_separator_();
+    this->write_integer_(value);
+  }
+
+ protected:
+  void write_separator_();
+  void write_key_(const char *key);
+  void write_string_(const char *value, size_t length);
+  void write_float_(float value);
+  template<typename T> typename std::enable_if<std::is_signed<T>::value>::type write_integer_(T value) {
+    if (value < 0) {
+      this->output_->push_back('-');
+      this->write_unsigned_(~static_cast<uint64_t>(value) + 1);
+    } else {
+      this->write_unsigned_(static_cast<uint64_t>(value));
+    }
+  }
+  template<typename T> typename std::enable_if<std::is_unsigned<T>::value>::type write_integer_(T value) {
+    this->write_unsigned_(value);
+  }
+  void write_unsigned_(uint64_t value);
+
+  std::string *output_;
+  /// Whether the next member or element is the first one of its object or array, and needs no separator.
+  bool first_{true};
+};
+
+/// Callback function typedef for writing the members of a JSON object.
+using json_write_t = std::function<void(JsonWriter &)>;
+
+/** Serialize the JSON object with the members written by the provided function into a shared buffer.
+ *
+ * The buffer is reused by the next call, so after the first few payloads no memory is allocated. The returned
+ * string is valid until the next call.
+ */
+const char *write_json(const json_write_t &f, size_t *length);
+
+std::string write_json(const json_write_t &f);
+
+}  // namespace json
+}  // namespace esphome
@@ -1,5 +1,6 @@
 #include "addressable_light.h"
 #include "esphome/core/log.h"
+#include <algorithm>
 
 namespace esphome {
 namespace light {
@@ -28,6 +29,51 @@ std::unique_ptr<LightTransformer> AddressableLight::create_default_transition()
   return make_unique<AddressableLightTransformer>(*this);
 }
 
+/// Colors converted from packed channels per write_internal_() call.
+static const int32_t WRITE_CHUNK_SIZE = 32;
+
+void AddressableLight::fill(int32_t from, int32_t to, const Color &color) {
+  if (to > from)
+    this->fill_internal_(from, to - from, this->correction_.color_correct(color));
+}
+void AddressableLight::write(int32_t index, const Color *colors, int32_t count) {
+  if (count > 0)
+    this->write_internal_(index, colors, count, this->correction_.get_table());
+}
+void AddressableLight::write_rgb(int32_t index, const uint8_t *data, int32_t count) {
+  Color chunk[WRITE_CHUNK_SIZE];
+  while (count > 0) {
+    const int32_t len = std::min(count, WRITE_CHUNK_SIZE);
+    for (int32_t i = 0; i < len; i++, data += 3)
+      chunk[i] = Color(data[0], data[1], data[2]);
+    this->write(index, chunk, len);
+    index += len;
+    count -= len;
+  }
+}
+void AddressableLight::write_rgbw(int32_t index, const uint8_t *data, int32_t count) {
+  Color chunk[WRITE_CHUNK_SIZE];
+  while (count > 0) {
+    const int32_t len = std::min(count, WRITE_CHUNK_SIZE);
+    for (int32_t i = 0; i < len; i++, data += 4)
+      chunk[i] = Color(data[0], data[1], data[2], data[3]);
+    this->write(index, chunk, len);
+    index += len;
+    count -= len;
+  }
+}
+void AddressableLight::fill_internal_(int32_t index, int32_t count, const Color &corrected) {
+  for (int32_t i = index; i < index + count; i++)
+    this->get_view_internal(i).set_raw(corrected);
+}
+void AddressableLight::write_internal_(int32_t index, const Color *colors, int32_t count, const uint8_t *table) {
+  for (int32_t i = 0; i < count; i++) {
+    const Color &color = colors[i];
+    this->get_view_internal(index + i)
+        .set_raw(Color(table[color.red], table[256 + color.green], table[512 + color.blue], table[768 + color.white]));
+  }
+}
+
 Color esp_color_from_light_color_values(LightColorValues val) {
   auto r = to_uint8_scale(val.get_color_brightness() * val.get_red());
   auto g = to_uint8_scale(val.get_color_brightness() * val.get_green());
@@ -71,24 +117,21 @@ optional<LightColorValues> AddressableLightTransformer::apply() {
   // Instead, we "fake" the look of the LERP by using an exponential average over time and using
   // dynamically-calculated alpha values to match the look.
 
-  float smoothed_progress = LightTransitionTransformer::smoothed_progress(this->get_progress_());
+  const uint16_t smoothed_progress = LightTransitionTransformer::smoothed_progress_fixed(this->get_progress_fixed_());
 
-  float denom = (1.0f - smoothed_progress);
-  float alpha = denom == 0.0f ? 0.0f : (smoothed_progress - this->last_transition_progress_) / denom;
+  // alpha = (smoothed_progress - last_progress) / (1 - smoothed_progress), scaled to 255 with 8 fractional bits
+  const uint32_t denom = PROGRESS_MAX - smoothed_progress;
+  uint32_t alpha255 = 0;
+  if (denom != 0 && smoothed_progress > this->last_transition_progress_)
+    alpha255 = (uint32_t(smoothed_progress - this->last_transition_progress_) * (255UL << 8)) / denom;
 
   // We need to use a low-resolution alpha here which makes the transition set in only after ~half of the length
   // We solve this by accumulating the fractional part of the alpha over time.
-  float alpha255 = alpha * 255.0f;
-  float alpha255int = floorf(alpha255);
-  float alpha255remainder = alpha255 - alpha255int;
-
-  this->accumulated_alpha_ += alpha255remainder;
-  float alpha_add = floorf(this->accumulated_alpha_);
-  this->accumulated_alpha_ -= alpha_add;
+  this->accumulated_alpha_ += alpha255 & 0xFF;
+  alpha255 = (alpha255 >> 8) + (this->accumulated_alpha_ >> 8);
+  this->accumulated_alpha_ &= 0xFF;
 
-  alpha255 += alpha_add;
-  alpha255 = clamp(alpha255, 0.0f, 255.0f);
-  auto alpha8 = static_cast<uint8_t>(alpha255);
+  auto alpha8 = static_cast<uint8_t>(std::min<uint32_t>(alpha255, 255));
 
   if (alpha8 != 0) {
     uint8_t inv_alpha8 = 255 - alpha8;
@@ -51,6 +51,14 @@ class AddressableLight : public LightOutput, public Component {
       amnt = this->size();
     this->range(amnt, this->size()) = this->range(0, -amnt);
   }
+  /// Set the LEDs [from, to) to a color, the color correction is applied only once.
+  void fill(int32_t from, int32_t to, const Color &color);
+  /// Set count LEDs starting at index to the given colors.
+  void write(int32_t index, const Color *colors, int32_t count);
+  /// Set count LEDs starting at index from packed RGB bytes (for example from a network packet).
+  void write_rgb(int32_t index, const uint8_t *data, int32_t count);
+  /// Set count LEDs starting at index from packed RGBW bytes.
+  void write_rgbw(int32_t index, const uint8_t *data, int32_t count);
   bool is_effect_active() const { return this->effect_active_; }
   void set_effect_active(bool effect_active) { this->effect_active_ = effect_active; }
   void write_state(LightState *state) override;
@@ -88,6 +96,14 @@ class AddressableLight : public LightOutput, public Component {
 #endif
   }
   virtual ESPColorView get_view_internal(int32_t index) const = 0;
+  /** Set count LEDs starting at index to an already corrected color.
+   *
+   * The default implementations of this and write_internal_() go through get_view_internal() for each LED, outputs
+   * override them to write their buffer directly.
+   */
+  virtual void fill_internal_(int32_t index, int32_t count, const Color &corrected);
+  /// Set count LEDs starting at index to the given colors, corrected with the table of ESPColorCorrection::get_table().
+  virtual void write_internal_(int32_t index, const Color *colors, int32_t count, const uint8_t *table);
 
   bool effect_active_{false};
   bool next_show_{true};
@@ -108,8 +124,9 @@ class AddressableLightTransformer : public LightTransitionTransformer {
  protected:
   AddressableLight &light_;
   Color target_color_{};
-  float last_transition_progress_{0.0f};
-  float accumulated_alpha_{0.0f};
+  uint16_t last_transition_progress_{0};
+  /// Fractional part of alpha255 carried over to the next step, with 8 fractional bits.
+  uint16_t accumulated_alpha_{0};
 };
 
 }  // namespace light
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <utility>
 
 #include "esphome/core/component.h"
@@ -82,10 +83,17 @@ class AddressableRainbowLightEffect : public AddressableLightEffect {
     hsv.saturation = 240;
     uint16_t hue = (millis() * this->speed_) % 0xFFFF;
     const uint16_t add = 0xFFFF / this->width_;
-    for (auto var : it) {
-      hsv.hue = hue >> 8;
-      var = hsv;
-      hue += add;
+    // Colors are computed in chunks and written in bulk
+    const int32_t chunk_size = 32;
+    Color chunk[chunk_size];
+    for (int32_t index = 0; index < it.size(); index += chunk_size) {
+      const int32_t count = std::min(chunk_size, it.size() - index);
+      for (int32_t i = 0; i < count; i++) {
+        hsv.hue = hue >> 8;
+        chunk[i] = hsv.to_rgb();
+        hue += add;
+      }
+      it.write(index, chunk, count);
     }
   }
   void set_speed(uint32_t speed) { this->speed_ = speed; }
@@ -152,10 +160,7 @@ class AddressableScanEffect : public AddressableLightEffect {
   void set_scan_width(uint32_t scan_width) { this->scan_width_ = scan_width; }
   void apply(AddressableLight &it, const Color &current_color) override {
     it.all() = Color::BLACK;
-
-    for (auto i = 0; i < this->scan_width_; i++) {
-      it[this->at_led_ + i] = current_color;
-    }
+    it.range(this->at_led_, this->at_led_ + this->scan_width_) = current_color;
 
     const uint32_t now = millis();
     if (now - this->last_move_ > this->move_interval_) {
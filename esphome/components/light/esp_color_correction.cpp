@@ -6,6 +6,7 @@ namespace esphome {
 namespace light {
 
 void ESPColorCorrection::calculate_gamma_table(float gamma) {
+  this->table_valid_ = false;
   for (uint16_t i = 0; i < 256; i++) {
     // corrected = val ^ gamma
     auto corrected = to_uint8_scale(gamma_correct(i / 255.0f, gamma));
@@ -22,6 +23,20 @@ void ESPColorCorrection::calculate_gamma_table(float gamma) {
     this->gamma_reverse_table_[i] = uncorrected;
   }
 }
+const uint8_t *ESPColorCorrection::get_table() const {
+  if (this->table_valid_)
+    return this->table_.get();
+  if (!this->table_)
+    this->table_.reset(new uint8_t[4 * 256]);  // NOLINT(cppcoreguidelines-owning-memory)
+  for (uint16_t i = 0; i < 256; i++) {
+    this->table_[0 * 256 + i] = this->color_correct_red(i);
+    this->table_[1 * 256 + i] = this->color_correct_green(i);
+    this->table_[2 * 256 + i] = this->color_correct_blue(i);
+    this->table_[3 * 256 + i] = this->color_correct_white(i);
+  }
+  this->table_valid_ = true;
+  return this->table_.get();
+}
 
 }  // namespace light
 }  // namespace esphome
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esphome/core/color.h"
+#include <memory>
 
 namespace esphome {
 namespace light {
@@ -8,9 +9,24 @@ namespace light {
 class ESPColorCorrection {
  public:
   ESPColorCorrection() : max_brightness_(255, 255, 255, 255) {}
-  void set_max_brightness(const Color &max_brightness) { this->max_brightness_ = max_brightness; }
-  void set_local_brightness(uint8_t local_brightness) { this->local_brightness_ = local_brightness; }
+  void set_max_brightness(const Color &max_brightness) {
+    this->max_brightness_ = max_brightness;
+    this->table_valid_ = false;
+  }
+  void set_local_brightness(uint8_t local_brightness) {
+    if (local_brightness == this->local_brightness_)
+      return;
+    this->local_brightness_ = local_brightness;
+    this->table_valid_ = false;
+  }
   void calculate_gamma_table(float gamma);
+  /** Get a lookup table that combines max brightness, local brightness and gamma correction.
+   *
+   * The corrected value of channel c (0 = red, 1 = green, 2 = blue, 3 = white) and value v is at c * 256 + v. The
+   * table is built on first use and again after the correction changed, bulk writes then need a single lookup per
+   * channel.
+   */
+  const uint8_t *get_table() const;
   inline Color color_correct(Color color) const ALWAYS_INLINE {
     // corrected = (uncorrected * max_brightness * local_brightness) ^ gamma
     return Color(this->color_correct_red(color.red), this->color_correct_green(color.green),
@@ -71,6 +87,8 @@ class ESPColorCorrection {
   uint8_t gamma_reverse_table_[256];
   Color max_brightness_;
   uint8_t local_brightness_{255};
+  mutable std::unique_ptr<uint8_t[]> table_;
+  mutable bool table_valid_{false};
 };
 
 }  // namespace light
@@ -455,8 +455,9 @@ std::set<ColorMode> LightCall::get_suitable_color_modes_() {
   return {};
 }
 
-LightCall &LightCall::set_effect(const std::string &effect) {
-  if (strcasecmp(effect.c_str(), "none") == 0) {
+LightCall &LightCall::set_effect(const std::string &effect) { return this->set_effect(effect.data(), effect.size()); }
+LightCall &LightCall::set_effect(const char *effect, size_t len) {
+  if (len == 4 && strncasecmp(effect, "none", len) == 0) {
     this->set_effect(0);
     return *this;
   }
@@ -465,14 +466,14 @@ LightCall &LightCall::set_effect(const std::string &effect) {
   for (uint32_t i = 0; i < this->parent_->effects_.size(); i++) {
     LightEffect *e = this->parent_->effects_[i];
 
-    if (strcasecmp(effect.c_str(), e->get_name().c_str()) == 0) {
+    if (e->get_name().size() == len && strncasecmp(effect, e->get_name().c_str(), len) == 0) {
       this->set_effect(i + 1);
       found = true;
       break;
     }
   }
   if (!found) {
-    ESP_LOGW(TAG, "'%s' - No such effect '%s'", this->parent_->get_name().c_str(), effect.c_str());
+    ESP_LOGW(TAG, "'%s' - No such effect '%.*s'", this->parent_->get_name().c_str(), static_cast<int>(len), effect);
   }
   return *this;
 }
@@ -8,6 +8,14 @@ namespace light {
 
 inline static uint8_t to_uint8_scale(float x) { return static_cast<uint8_t>(roundf(x * 255.0f)); }
 
+/// Channel values are stored as fixed point numbers from 0 (0.0) to CHANNEL_MAX (1.0). Every 8 bit value v / 255.0 is
+/// represented exactly as v * 257, so values from 8 bit sources (like Home Assistant) convert back without loss.
+static const uint16_t CHANNEL_MAX = 65535;
+/// Color temperatures are stored in 1/16 mireds, which covers 0 to 4095.9 mireds.
+static const uint16_t MIREDS_SCALE = 16;
+/// Completion of an interpolation as a fixed point number from 0 (start) to PROGRESS_MAX (end).
+static const uint16_t PROGRESS_MAX = 32768;
+
 /** This class represents the color state for a light object.
  *
  * The representation of the color state is dependent on the active color mode. A color mode consists of multiple
@@ -40,22 +48,26 @@ inline static uint8_t to_uint8_scale(float x) { return static_cast<uint8_t>(roun
  * All values (except color temperature) are represented using floats in the range 0.0 (off) to 1.0 (on), and are
  * automatically clamped to this range. Properties not used in the current color mode can still have (invalid) values
  * and must not be accessed by the light output.
+ *
+ * Internally the values are stored as integers (see CHANNEL_MAX and MIREDS_SCALE), so that transitions and the
+ * conversions for the outputs do not need floating point math, which the ESP8266 has to emulate in software. The
+ * float getters and setters convert at the boundary.
  */
 class LightColorValues {
  public:
   /// Construct the LightColorValues with all attributes enabled, but state set to off.
   LightColorValues()
       : color_mode_(ColorMode::UNKNOWN),
-        state_(0.0f),
-        brightness_(1.0f),
-        color_brightness_(1.0f),
-        red_(1.0f),
-        green_(1.0f),
-        blue_(1.0f),
-        white_(1.0f),
-        color_temperature_{0.0f},
-        cold_white_{1.0f},
-        warm_white_{1.0f} {}
+        state_(0),
+        brightness_(CHANNEL_MAX),
+        color_brightness_(CHANNEL_MAX),
+        red_(CHANNEL_MAX),
+        green_(CHANNEL_MAX),
+        blue_(CHANNEL_MAX),
+        white_(CHANNEL_MAX),
+        color_temperature_{0},
+        cold_white_{CHANNEL_MAX},
+        warm_white_{CHANNEL_MAX} {}
 
   LightColorValues(ColorMode color_mode, float state, float brightness, float color_brightness, float red, float green,
                    float blue, float white, float color_temperature, float cold_white, float warm_white) {
@@ -83,18 +95,23 @@ class LightColorValues {
    * @return The linearly interpolated LightColorValues.
    */
   static LightColorValues lerp(const LightColorValues &start, const LightColorValues &end, float completion) {
+    return LightColorValues::lerp_fixed(start, end, to_fixed_(completion, PROGRESS_MAX));
+  }
+
+  /// Linearly interpolate between start and end with the completion as a fixed point value from 0 to PROGRESS_MAX.
+  static LightColorValues lerp_fixed(const LightColorValues &start, const LightColorValues &end, uint16_t completion) {
     LightColorValues v;
-    v.set_color_mode(end.color_mode_);
-    v.set_state(esphome::lerp(completion, start.get_state(), end.get_state()));
-    v.set_brightness(esphome::lerp(completion, start.get_brightness(), end.get_brightness()));
-    v.set_color_brightness(esphome::lerp(completion, start.get_color_brightness(), end.get_color_brightness()));
-    v.set_red(esphome::lerp(completion, start.get_red(), end.get_red()));
-    v.set_green(esphome::lerp(completion, start.get_green(), end.get_green()));
-    v.set_blue(esphome::lerp(completion, start.get_blue(), end.get_blue()));
-    v.set_white(esphome::lerp(completion, start.get_white(), end.get_white()));
-    v.set_color_temperature(esphome::lerp(completion, start.get_color_temperature(), end.get_color_temperature()));
-    v.set_cold_white(esphome::lerp(completion, start.get_cold_white(), end.get_cold_white()));
-    v.set_warm_white(esphome::lerp(completion, start.get_warm_white(), end.get_warm_white()));
+    v.color_mode_ = end.color_mode_;
+    v.state_ = lerp_fixed_(start.state_, end.state_, completion);
+    v.brightness_ = lerp_fixed_(start.brightness_, end.brightness_, completion);
+    v.color_brightness_ = lerp_fixed_(start.color_brightness_, end.color_brightness_, completion);
+    v.red_ = lerp_fixed_(start.red_, end.red_, completion);
+    v.green_ = lerp_fixed_(start.green_, end.green_, completion);
+    v.blue_ = lerp_fixed_(start.blue_, end.blue_, completion);
+    v.white_ = lerp_fixed_(start.white_, end.white_, completion);
+    v.color_temperature_ = lerp_fixed_(start.color_temperature_, end.color_temperature_, completion);
+    v.cold_white_ = lerp_fixed_(start.cold_white_, end.cold_white_, completion);
+    v.warm_white_ = lerp_fixed_(start.warm_white_, end.warm_white_, completion);
     return v;
   }
 
@@ -109,15 +126,13 @@ class LightColorValues {
    */
   void normalize_color() {
     if (this->color_mode_ & ColorCapability::RGB) {
-      float max_value = fmaxf(this->get_red(), fmaxf(this->get_green(), this->get_blue()));
-      if (max_value == 0.0f) {
-        this->set_red(1.0f);
-        this->set_green(1.0f);
-        this->set_blue(1.0f);
+      const uint32_t max_value = std::max(this->red_, std::max(this->green_, this->blue_));
+      if (max_value == 0) {
+        this->red_ = this->green_ = this->blue_ = CHANNEL_MAX;
       } else {
-        this->set_red(this->get_red() / max_value);
-        this->set_green(this->get_green() / max_value);
-        this->set_blue(this->get_blue() / max_value);
+        this->red_ = (this->red_ * uint32_t(CHANNEL_MAX) + max_value / 2) / max_value;
+        this->green_ = (this->green_ * uint32_t(CHANNEL_MAX) + max_value / 2) / max_value;
+        this->blue_ = (this->blue_ * uint32_t(CHANNEL_MAX) + max_value / 2) / max_value;
       }
     }
   }
@@ -126,20 +141,20 @@ class LightColorValues {
   // are always used or necessary. Methods will be deprecated later.
 
   /// Convert these light color values to a binary representation and write them to binary.
-  void as_binary(bool *binary) const { *binary = this->state_ == 1.0f; }
+  void as_binary(bool *binary) const { *binary = this->state_ == CHANNEL_MAX; }
 
   /// Convert these light color values to a brightness-only representation and write them to brightness.
   void as_brightness(float *brightness, float gamma = 0) const {
-    *brightness = gamma_correct(this->state_ * this->brightness_, gamma);
+    *brightness = gamma_correct(from_fixed_(mul_fixed_(this->state_, this->brightness_), CHANNEL_MAX), gamma);
   }
 
   /// Convert these light color values to an RGB representation and write them to red, green, blue.
   void as_rgb(float *red, float *green, float *blue, float gamma = 0, bool color_interlock = false) const {
     if (this->color_mode_ & ColorCapability::RGB) {
-      float brightness = this->state_ * this->brightness_ * this->color_brightness_;
-      *red = gamma_correct(brightness * this->red_, gamma);
-      *green = gamma_correct(brightness * this->green_, gamma);
-      *blue = gamma_correct(brightness * this->blue_, gamma);
+      const uint16_t brightness = mul_fixed_(mul_fixed_(this->state_, this->brightness_), this->color_brightness_);
+      *red = gamma_correct(from_fixed_(mul_fixed_(brightness, this->red_), CHANNEL_MAX), gamma);
+      *green = gamma_correct(from_fixed_(mul_fixed_(brightness, this->green_), CHANNEL_MAX), gamma);
+      *blue = gamma_correct(from_fixed_(mul_fixed_(brightness, this->blue_), CHANNEL_MAX), gamma);
     } else {
       *red = *green = *blue = 0;
     }
@@ -150,7 +165,8 @@ class LightColorValues {
                bool color_interlock = false) const {
     this->as_rgb(red, green, blue, gamma);
     if (this->color_mode_ & ColorCapability::WHITE) {
-      *white = gamma_correct(this->state_ * this->brightness_ * this->white_, gamma);
+      const uint16_t level = mul_fixed_(mul_fixed_(this->state_, this->brightness_), this->white_);
+      *white = gamma_correct(from_fixed_(level, CHANNEL_MAX), gamma);
     } else {
       *white = 0;
     }
@@ -173,9 +189,10 @@ class LightColorValues {
   /// Convert these light color values to an CWWW representation with the given parameters.
   void as_cwww(float *cold_white, float *warm_white, float gamma = 0, bool constant_brightness = false) const {
     if (this->color_mode_ & ColorCapability::COLD_WARM_WHITE) {
-      const float cw_level = gamma_correct(this->cold_white_, gamma);
-      const float ww_level = gamma_correct(this->warm_white_, gamma);
-      const float white_level = gamma_correct(this->state_ * this->brightness_, gamma);
+      const float cw_level = gamma_correct(this->get_cold_white(), gamma);
+      const float ww_level = gamma_correct(this->get_warm_white(), gamma);
+      const float white_level = gamma_correct(from_fixed_(mul_fixed_(this->state_, this->brightness_), CHANNEL_MAX),
+                                              gamma);
       if (!constant_brightness) {
         *cold_white = white_level * cw_level;
         *warm_white = white_level * ww_level;
@@ -197,11 +214,12 @@ class LightColorValues {
   /// Convert these light color values to a CT+BR representation with the given parameters.
   void as_ct(float color_temperature_cw, float color_temperature_ww, float *color_temperature, float *white_brightness,
              float gamma = 0) const {
-    const float white_level = this->color_mode_ & ColorCapability::RGB ? this->white_ : 1;
+    const uint16_t white_level = this->color_mode_ & ColorCapability::RGB ? this->white_ : CHANNEL_MAX;
     if (this->color_mode_ & ColorCapability::COLOR_TEMPERATURE) {
       *color_temperature =
-          (this->color_temperature_ - color_temperature_cw) / (color_temperature_ww - color_temperature_cw);
-      *white_brightness = gamma_correct(this->state_ * this->brightness_ * white_level, gamma);
+          (this->get_color_temperature() - color_temperature_cw) / (color_temperature_ww - color_temperature_cw);
+      const uint16_t level = mul_fixed_(mul_fixed_(this->state_, this->brightness_), white_level);
+      *white_brightness = gamma_correct(from_fixed_(level, CHANNEL_MAX), gamma);
     } else {  // Probably wont get here but put this here anyway.
       *white_brightness = 0;
     }
@@ -222,71 +240,95 @@ class LightColorValues {
   void set_color_mode(ColorMode color_mode) { this->color_mode_ = color_mode; }
 
   /// Get the state of these light color values. In range from 0.0 (off) to 1.0 (on)
-  float get_state() const { return this->state_; }
+  float get_state() const { return from_fixed_(this->state_, CHANNEL_MAX); }
   /// Get the binary true/false state of these light color values.
-  bool is_on() const { return this->get_state() != 0.0f; }
+  bool is_on() const { return this->state_ != 0; }
   /// Set the state of these light color values. In range from 0.0 (off) to 1.0 (on)
-  void set_state(float state) { this->state_ = clamp(state, 0.0f, 1.0f); }
+  void set_state(float state) { this->state_ = to_fixed_(state, CHANNEL_MAX); }
   /// Set the state of these light color values as a binary true/false.
-  void set_state(bool state) { this->state_ = state ? 1.0f : 0.0f; }
+  void set_state(bool state) { this->state_ = state ? CHANNEL_MAX : 0; }
 
   /// Get the brightness property of these light color values. In range 0.0 to 1.0
-  float get_brightness() const { return this->brightness_; }
+  float get_brightness() const { return from_fixed_(this->brightness_, CHANNEL_MAX); }
   /// Set the brightness property of these light color values. In range 0.0 to 1.0
-  void set_brightness(float brightness) { this->brightness_ = clamp(brightness, 0.0f, 1.0f); }
+  void set_brightness(float brightness) { this->brightness_ = to_fixed_(brightness, CHANNEL_MAX); }
 
   /// Get the color brightness property of these light color values. In range 0.0 to 1.0
-  float get_color_brightness() const { return this->color_brightness_; }
+  float get_color_brightness() const { return from_fixed_(this->color_brightness_, CHANNEL_MAX); }
   /// Set the color brightness property of these light color values. In range 0.0 to 1.0
-  void set_color_brightness(float brightness) { this->color_brightness_ = clamp(brightness, 0.0f, 1.0f); }
+  void set_color_brightness(float brightness) { this->color_brightness_ = to_fixed_(brightness, CHANNEL_MAX); }
 
   /// Get the red property of these light color values. In range 0.0 to 1.0
-  float get_red() const { return this->red_; }
+  float get_red() const { return from_fixed_(this->red_, CHANNEL_MAX); }
   /// Set the red property of these light color values. In range 0.0 to 1.0
-  void set_red(float red) { this->red_ = clamp(red, 0.0f, 1.0f); }
+  void set_red(float red) { this->red_ = to_fixed_(red, CHANNEL_MAX); }
 
   /// Get the green property of these light color values. In range 0.0 to 1.0
-  float get_green() const { return this->green_; }
+  float get_green() const { return from_fixed_(this->green_, CHANNEL_MAX); }
   /// Set the green property of these light color values. In range 0.0 to 1.0
-  void set_green(float green) { this->green_ = clamp(green, 0.0f, 1.0f); }
+  void set_green(float green) { this->green_ = to_fixed_(green, CHANNEL_MAX); }
 
   /// Get the blue property of these light color values. In range 0.0 to 1.0
-  float get_blue() const { return this->blue_; }
+  float get_blue() const { return from_fixed_(this->blue_, CHANNEL_MAX); }
   /// Set the blue property of these light color values. In range 0.0 to 1.0
-  void set_blue(float blue) { this->blue_ = clamp(blue, 0.0f, 1.0f); }
+  void set_blue(float blue) { this->blue_ = to_fixed_(blue, CHANNEL_MAX); }
 
   /// Get the white property of these light color values. In range 0.0 to 1.0
-  float get_white() const { return white_; }
+  float get_white() const { return from_fixed_(this->white_, CHANNEL_MAX); }
   /// Set the white property of these light color values. In range 0.0 to 1.0
-  void set_white(float white) { this->white_ = clamp(white, 0.0f, 1.0f); }
+  void set_white(float white) { this->white_ = to_fixed_(white, CHANNEL_MAX); }
 
   /// Get the color temperature property of these light color values in mired.
-  float get_color_temperature() const { return this->color_temperature_; }
+  float get_color_temperature() const { return from_fixed_(this->color_temperature_, MIREDS_SCALE); }
   /// Set the color temperature property of these light color values in mired.
-  void set_color_temperature(float color_temperature) { this->color_temperature_ = color_temperature; }
+  void set_color_temperature(float color_temperature) {
+    const float fixed = color_temperature * MIREDS_SCALE + 0.5f;
+    this->color_temperature_ = fixed >= CHANNEL_MAX ? CHANNEL_MAX : fixed > 0.0f ? static_cast<uint16_t>(fixed) : 0;
+  }
 
   /// Get the cold white property of these light color values. In range 0.0 to 1.0.
-  float get_cold_white() const { return this->cold_white_; }
+  float get_cold_white() const { return from_fixed_(this->cold_white_, CHANNEL_MAX); }
   /// Set the cold white property of these light color values. In range 0.0 to 1.0.
-  void set_cold_white(float cold_white) { this->cold_white_ = clamp(cold_white, 0.0f, 1.0f); }
+  void set_cold_white(float cold_white) { this->cold_white_ = to_fixed_(cold_white, CHANNEL_MAX); }
 
   /// Get the warm white property of these light color values. In range 0.0 to 1.0.
-  float get_warm_white() const { return this->warm_white_; }
+  float get_warm_white() const { return from_fixed_(this->warm_white_, CHANNEL_MAX); }
   /// Set the warm white property of these light color values. In range 0.0 to 1.0.
-  void set_warm_white(float warm_white) { this->warm_white_ = clamp(warm_white, 0.0f, 1.0f); }
+  void set_warm_white(float warm_white) { this->warm_white_ = to_fixed_(warm_white, CHANNEL_MAX); }
 
  protected:
+  /// Convert value (clamped to the range 0.0 to 1.0) to a fixed point value where scale represents 1.0.
+  static uint16_t to_fixed_(float value, uint16_t scale) {
+    if (!(value > 0.0f))  // also catches NaN
+      return 0;
+    if (value >= 1.0f)
+      return scale;
+    return static_cast<uint16_t>(value * scale + 0.5f);
+  }
+  static float from_fixed_(uint16_t value, uint16_t scale) { return value / float(scale); }
+  /// Multiply two channel values, rounded to nearest.
+  static uint16_t mul_fixed_(uint16_t a, uint16_t b) {
+    // x / 65535 computed as (x + x / 65536) / 65536, which is exact for all products of two channel values
+    const uint32_t x = uint32_t(a) * b + CHANNEL_MAX / 2 + 1;
+    return (x + (x >> 16)) >> 16;
+  }
+  static uint16_t lerp_fixed_(uint16_t start, uint16_t end, uint16_t completion) {
+    // |end - start| * completion fits in 31 bits as PROGRESS_MAX is 2^15
+    const int32_t delta = (int32_t(end) - int32_t(start)) * int32_t(completion);
+    return start + ((delta + PROGRESS_MAX / 2) >> 15);
+  }
+
   ColorMode color_mode_;
-  float state_;  ///< ON / OFF, float for transition
-  float brightness_;
-  float color_brightness_;
-  float red_;
-  float green_;
-  float blue_;
-  float white_;
-  float color_temperature_;  ///< Color Temperature in Mired
-  float cold_white_;
-  float warm_white_;
+  uint16_t state_;  ///< ON / OFF, not binary for transitions
+  uint16_t brightness_;
+  uint16_t color_brightness_;
+  uint16_t red_;
+  uint16_t green_;
+  uint16_t blue_;
+  uint16_t white_;
+  uint16_t color_temperature_;  ///< Color Temperature in 1/16 Mired
+  uint16_t cold_white_;
+  uint16_t warm_white_;
 };
 
 }  // namespace light
@@ -0,0 +1,113 @@
+#include "light_output_task.h"
+
+#ifndef ARDUINO_ARCH_ESP8266
+
+#include "esphome/core/esphal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace light {
+
+static const char *const TAG = "light.output_task";
+
+#ifdef ARDUINO_ARCH_ESP32
+/// Room for the FastLED RMT/I2S drivers plus a log call from the transmit callback, the remaining stack is shown by
+/// the dump_config() of the light.
+static const uint32_t OUTPUT_TASK_STACK_SIZE = 4096;
+static const UBaseType_t OUTPUT_TASK_PRIORITY = 5;
+/// The Arduino loop runs on core 1, the output task on the other one.
+static const BaseType_t OUTPUT_TASK_CORE = 0;
+#endif
+
+void LightFrameBuffer::init(size_t frame_size) {
+  this->frame_size_ = frame_size;
+  this->buffers_.reset(new uint8_t[3 * frame_size]);  // NOLINT(cppcoreguidelines-owning-memory)
+  memset(this->buffers_.get(), 0, 3 * frame_size);
+}
+void LightFrameBuffer::publish(const uint8_t *frame) {
+  memcpy(&this->buffers_[this->back_ * this->frame_size_], frame, this->frame_size_);
+  const uint8_t previous = this->middle_.exchange(this->back_ | FRESH);
+  if (previous & FRESH)
+    // the output did not take the previous frame
+    this->dropped_++;
+  this->back_ = previous & INDEX_MASK;
+  this->published_++;
+}
+bool LightFrameBuffer::take() {
+  if (!this->has_new())
+    return false;
+  // Only the output clears FRESH, so the middle buffer still holds a new frame (possibly an even newer one)
+  this->front_ = this->middle_.exchange(this->front_) & INDEX_MASK;
+  return true;
+}
+
+void LightOutputTask::init(size_t frame_size, uint32_t min_interval_us, transmit_t &&transmit) {
+  this->frame_buffer_.init(frame_size);
+  this->min_interval_us_ = min_interval_us;
+  this->transmit_ = std::move(transmit);
+}
+bool LightOutputTask::start_task() {
+#ifdef ARDUINO_ARCH_ESP32
+  const BaseType_t res = xTaskCreatePinnedToCore(&LightOutputTask::task_, "light_output", OUTPUT_TASK_STACK_SIZE, this,
+                                                 OUTPUT_TASK_PRIORITY, &this->task_handle_, OUTPUT_TASK_CORE);
+  if (res != pdPASS) {
+    ESP_LOGE(TAG, "Could not create the output task");
+    this->task_handle_ = nullptr;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+uint32_t LightOutputTask::get_stack_free() const {
+#ifdef ARDUINO_ARCH_ESP32
+  if (this->task_handle_ != nullptr)
+    return uxTaskGetStackHighWaterMark(this->task_handle_);
+#endif
+  return 0;
+}
+void LightOutputTask::submit(const uint8_t *frame) {
+  this->frame_buffer_.publish(frame);
+#ifdef ARDUINO_ARCH_ESP32
+  if (this->task_handle_ != nullptr)
+    xTaskNotifyGive(this->task_handle_);
+#endif
+}
+LightOutputTask::RunResult LightOutputTask::run_once(uint32_t now_us, uint32_t *wait_us) {
+  if (!this->frame_buffer_.has_new())
+    return RunResult::NO_FRAME;
+  const uint32_t since_last = now_us - this->last_transmit_us_;
+  if (this->transmitted_ != 0 && since_last < this->min_interval_us_) {
+    *wait_us = this->min_interval_us_ - since_last;
+    return RunResult::WAIT;
+  }
+
+  this->frame_buffer_.take();
+  this->last_transmit_us_ = now_us;
+  this->transmit_(this->frame_buffer_.front());
+  this->transmitted_++;
+  return RunResult::TRANSMITTED;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+void LightOutputTask::task_(void *arg) {
+  auto *task = reinterpret_cast<LightOutputTask *>(arg);
+  while (true) {
+    // Sleep until the loop submits a frame
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    uint32_t wait_us;
+    while (task->run_once(micros(), &wait_us) == RunResult::WAIT)
+      vTaskDelay(std::max<TickType_t>(1, pdMS_TO_TICKS((wait_us + 999) / 1000)));
+  }
+}
+#endif
+
+}  // namespace light
+}  // namespace esphome
+
+#endif  // ARDUINO_ARCH_ESP8266
@@ -0,0 +1,117 @@
+#pragma once
+
+// The ESP8266 has neither a second core nor the atomics used for the buffer swap
+#ifndef ARDUINO_ARCH_ESP8266
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace esphome {
+namespace light {
+
+/** Hands the frames of an addressable light from the main loop to an output task without locks.
+ *
+ * Three buffers are used: the loop copies a frame into the back buffer and swaps it with the middle buffer, the
+ * output task swaps the middle buffer with the front buffer it transmits. Neither side ever waits for the other.
+ * If the loop submits faster than the output transmits, only the newest frame is transmitted and the frames in
+ * between are counted as dropped.
+ */
+class LightFrameBuffer {
+ public:
+  void init(size_t frame_size);
+
+  /// Copy a frame into the back buffer and make it the newest frame, only called from the loop.
+  void publish(const uint8_t *frame);
+  /// Make the newest frame the front buffer, returns false if no new frame was published. Only called by the output.
+  bool take();
+  /// Whether a frame was published that was not taken yet.
+  bool has_new() const { return (this->middle_.load() & FRESH) != 0; }
+  const uint8_t *front() const { return &this->buffers_[this->front_ * this->frame_size_]; }
+
+  size_t get_frame_size() const { return this->frame_size_; }
+  uint32_t get_published() const { return this->published_; }
+  uint32_t get_dropped() const { return this->dropped_; }
+
+ protected:
+  /// Set in middle_ if the middle buffer holds a frame that was not taken yet.
+  static const uint8_t FRESH = 0x04;
+  static const uint8_t INDEX_MASK = 0x03;
+
+  std::unique_ptr<uint8_t[]> buffers_;
+  size_t frame_size_{0};
+  uint8_t back_{0};
+  uint8_t front_{1};
+  std::atomic<uint8_t> middle_{2};
+  uint32_t published_{0};
+  uint32_t dropped_{0};
+};
+
+/** Transmits the frames of an addressable light on a separate task, so that the main loop is not blocked while a
+ * long strip is written out.
+ *
+ * On the ESP32 the task is pinned to the core that does not run the main loop. The pacing of the frames (the
+ * maximum refresh rate of the LEDs) is done by the task as well.
+ */
+class LightOutputTask {
+ public:
+  using transmit_t = std::function<void(const uint8_t *frame)>;
+
+  enum class RunResult {
+    /// A frame was transmitted.
+    TRANSMITTED,
+    /// No new frame was submitted since the last transmission.
+    NO_FRAME,
+    /// A frame is waiting, but the minimum interval since the last transmission has not passed yet.
+    WAIT,
+  };
+
+  /** Set up the buffers for frames of frame_size bytes.
+   *
+   * @param min_interval_us Minimum time between the start of two transmissions, 0 for no limit.
+   * @param transmit Called from the output task to transmit a frame.
+   */
+  void init(size_t frame_size, uint32_t min_interval_us, transmit_t &&transmit);
+  /// Start the output task, returns false if this platform has no task support.
+  bool start_task();
+
+  /// Hand a frame to the output task: the frame is copied, this never blocks.
+  void submit(const uint8_t *frame);
+
+  /** Transmit the newest frame if the pacing allows it, the body of the output task.
+   *
+   * @param now_us The current time in microseconds.
+   * @param wait_us Set to the time until the next frame may be transmitted if the result is WAIT.
+   */
+  RunResult run_once(uint32_t now_us, uint32_t *wait_us);
+
+  const LightFrameBuffer &get_frame_buffer() const { return this->frame_buffer_; }
+  uint32_t get_transmitted() const { return this->transmitted_; }
+  /// The least free stack of the output task so far in bytes, 0 if no task runs.
+  uint32_t get_stack_free() const;
+
+ protected:
+#ifdef ARDUINO_ARCH_ESP32
+  static void task_(void *arg);
+
+  TaskHandle_t task_handle_{nullptr};
+#endif
+
+  LightFrameBuffer frame_buffer_;
+  transmit_t transmit_;
+  uint32_t min_interval_us_{0};
+  uint32_t last_transmit_us_{0};
+  uint32_t transmitted_{0};
+};
+
+}  // namespace light
+}  // namespace esphome
+
+#endif  // ARDUINO_ARCH_ESP8266
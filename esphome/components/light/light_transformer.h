@@ -18,7 +18,7 @@ class LightTransformer {
   }
 
   /// Indicates whether this transformation is finished.
-  virtual bool is_finished() { return this->get_progress_() >= 1.0f; }
+  virtual bool is_finished() { return millis() - this->start_time_ >= this->length_; }
 
   /// This will be called before the transition is started.
   virtual void start() {}
@@ -37,6 +37,16 @@ class LightTransformer {
  protected:
   /// The progress of this transition, on a scale of 0 to 1.
   float get_progress_() { return clamp((millis() - this->start_time_) / float(this->length_), 0.0f, 1.0f); }
+  /// The progress of this transition as a fixed point value, on a scale of 0 to PROGRESS_MAX.
+  uint16_t get_progress_fixed_() {
+    const uint32_t elapsed = millis() - this->start_time_;
+    if (elapsed >= this->length_)
+      return PROGRESS_MAX;
+    // 32 bit division for transitions up to two minutes, the intermediate value would overflow for longer ones
+    if (elapsed < (1UL << 17))
+      return (elapsed << 15) / this->length_;
+    return (uint64_t(elapsed) << 15) / this->length_;
+  }
 
   uint32_t start_time_;
   uint32_t length_;
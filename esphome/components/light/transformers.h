@@ -27,28 +27,38 @@ class LightTransitionTransformer : public LightTransformer {
   }
 
   optional<LightColorValues> apply() override {
-    float p = this->get_progress_();
+    uint16_t p = this->get_progress_fixed_();
+    const uint16_t half = PROGRESS_MAX / 2;
 
     // Halfway through, when intermediate state (off) is reached, flip it to the target, but remain off.
-    if (this->changing_color_mode_ && p > 0.5f &&
+    if (this->changing_color_mode_ && p > half &&
         this->intermediate_values_.get_color_mode() != this->target_values_.get_color_mode()) {
       this->intermediate_values_ = this->target_values_;
       this->intermediate_values_.set_state(false);
     }
 
-    LightColorValues &start = this->changing_color_mode_ && p > 0.5f ? this->intermediate_values_ : this->start_values_;
-    LightColorValues &end = this->changing_color_mode_ && p < 0.5f ? this->intermediate_values_ : this->target_values_;
+    LightColorValues &start = this->changing_color_mode_ && p > half ? this->intermediate_values_ : this->start_values_;
+    LightColorValues &end = this->changing_color_mode_ && p < half ? this->intermediate_values_ : this->target_values_;
     if (this->changing_color_mode_)
-      p = p < 0.5f ? p * 2 : (p - 0.5) * 2;
+      p = p < half ? p * 2 : (p - half) * 2;
 
-    float v = LightTransitionTransformer::smoothed_progress(p);
-    return LightColorValues::lerp(start, end, v);
+    uint16_t v = LightTransitionTransformer::smoothed_progress_fixed(p);
+    return LightColorValues::lerp_fixed(start, end, v);
   }
 
  protected:
   // This looks crazy, but it reduces to 6x^5 - 15x^4 + 10x^3 which is just a smooth sigmoid-like
   // transition from 0 to 1 on x = [0, 1]
   static float smoothed_progress(float x) { return x * x * x * (x * (x * 6.0f - 15.0f) + 10.0f); }
+  /// smoothed_progress() with x and the result as fixed point values from 0 to PROGRESS_MAX.
+  static uint16_t smoothed_progress_fixed(uint16_t x) {
+    // Evaluated with 30 fractional bits, so the result is monotonic and within half a step of the float version
+    const uint64_t x2 = uint32_t(x) * x;
+    const uint64_t x3 = (x2 * x) >> 15;
+    // 6x^2 - 15x + 10 falls from 10 to 1 on x = [0, 1], so x^3 times it fits in 64 bits
+    const uint64_t poly = 6 * x2 + (10ULL << 30) - (uint64_t(15UL * x) << 15);
+    return (x3 * poly + (1ULL << 44)) >> 45;
+  }
 
   bool changing_color_mode_{false};
   LightColorValues intermediate_values_{};
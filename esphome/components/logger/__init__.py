@@ -97,14 +97,19 @@ LoggerMessageTrigger = logger_ns.class_(
     "LoggerMessageTrigger",
     automation.Trigger.template(cg.int_, cg.const_char_ptr, cg.const_char_ptr),
 )
+LoggerSetLevelAction = logger_ns.class_("LoggerSetLevelAction", automation.Action)
 
 CONF_ESP8266_STORE_LOG_STRINGS_IN_FLASH = "esp8266_store_log_strings_in_flash"
+CONF_ASYNC_BUFFER_SIZE = "async_buffer_size"
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(Logger),
             cv.Optional(CONF_BAUD_RATE, default=115200): cv.positive_int,
             cv.Optional(CONF_TX_BUFFER_SIZE, default=512): cv.validate_bytes,
+            cv.Optional(CONF_ASYNC_BUFFER_SIZE, default=0): cv.All(
+                cv.validate_bytes, cv.int_range(max=32768)
+            ),
             cv.Optional(CONF_DEASSERT_RTS_DTR, default=False): cv.boolean,
             cv.Optional(CONF_HARDWARE_UART, default="UART0"): uart_selection,
             cv.Optional(CONF_LEVEL, default="DEBUG"): is_log_level,
@@ -139,8 +144,12 @@ async def to_code(config):
     log = cg.Pvariable(config[CONF_ID], rhs)
     cg.add(log.pre_setup())
 
+    if config[CONF_LOGS]:
+        cg.add_define("ESPHOME_LOG_TAG_LEVELS", len(config[CONF_LOGS]))
     for tag, level in config[CONF_LOGS].items():
         cg.add(log.set_log_level(tag, LOG_LEVELS[level]))
+    if config[CONF_ASYNC_BUFFER_SIZE] > 0:
+        cg.add(log.set_async_buffer_size(config[CONF_ASYNC_BUFFER_SIZE]))
 
     level = config[CONF_LEVEL]
     cg.add_define("USE_LOGGER")
@@ -251,3 +260,29 @@ async def logger_log_action_to_code(config, action_id, template_arg, args):
 
     lambda_ = await cg.process_lambda(Lambda(text), args, return_type=cg.void)
     return cg.new_Pvariable(action_id, template_arg, lambda_)
+
+
+@automation.register_action(
+    "logger.set_level",
+    LoggerSetLevelAction,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.use_id(Logger),
+            cv.Required(CONF_TAG): cv.templatable(cv.string),
+            cv.Required(CONF_LEVEL): cv.templatable(is_log_level),
+        }
+    ),
+)
+async def logger_set_level_to_code(config, action_id, template_arg, args):
+    cg.add_define("USE_LOGGER_SET_LEVEL")
+    paren = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, paren)
+    template_ = await cg.templatable(config[CONF_TAG], args, cg.std_string)
+    cg.add(var.set_tag(template_))
+    level = config[CONF_LEVEL]
+    if cg.is_template(level):
+        template_ = await cg.templatable(level, args, cg.int_)
+    else:
+        template_ = LOG_LEVELS[level]
+    cg.add(var.set_level(template_))
+    return var
@@ -0,0 +1,547 @@
+#include "log_ring_buffer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef ARDUINO_ARCH_ESP8266
+#include <pgmspace.h>
+#include "esphome/core/helpers.h"
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+#include <soc/soc.h>
+#endif
+
+namespace esphome {
+namespace logger {
+
+#ifdef ARDUINO_ARCH_ESP8266
+extern "C" char _rodata_start;  // NOLINT
+extern "C" char _rodata_end;    // NOLINT
+#endif
+
+/// Whether str is in the read-only data of the firmware, so that it outlives the message.
+static bool is_static_string(const char *str) {
+#if defined(ARDUINO_ARCH_ESP32)
+  auto address = reinterpret_cast<uintptr_t>(str);
+  return address >= SOC_DROM_LOW && address < SOC_DROM_HIGH;
+#elif defined(ARDUINO_ARCH_ESP8266)
+  return str >= &_rodata_start && str < &_rodata_end;
+#else
+  // String literals can't be told apart from other strings on the host
+  return true;
+#endif
+}
+
+static inline char read_char(const char *str, bool progmem) {
+#ifdef ARDUINO_ARCH_ESP8266
+  if (progmem)
+    return static_cast<char>(pgm_read_byte(str));
+#endif
+  return *str;
+}
+
+enum class ArgType : uint8_t {
+  INT,
+  LONG,
+  LONG_LONG,
+  SIZE,
+  INTMAX,
+  PTRDIFF,
+  DOUBLE,
+  LONG_DOUBLE,
+  STRING,
+  POINTER,
+  /// %n, the argument is consumed but nothing is written to it.
+  WRITE_COUNT,
+};
+
+struct FormatSpec {
+  ArgType type;
+  bool left_align;
+  /// Whether the width and precision are passed as arguments ('*').
+  bool width_star;
+  bool precision_star;
+  int width;
+  /// -1 if the spec has no precision.
+  int precision;
+  /// Length of the spec, from the '%' up to and including the conversion character.
+  size_t length;
+};
+
+/// Parse the conversion spec starting with the '%' at format, returns false for "%%" and invalid specs.
+static bool parse_spec(const char *format, bool progmem, FormatSpec *spec) {
+  const char *p = format + 1;
+  char c = read_char(p, progmem);
+  spec->left_align = false;
+  for (; c == '-' || c == '+' || c == ' ' || c == '#' || c == '0'; c = read_char(++p, progmem)) {
+    if (c == '-')
+      spec->left_align = true;
+  }
+
+  spec->width = 0;
+  spec->width_star = c == '*';
+  if (spec->width_star) {
+    c = read_char(++p, progmem);
+  } else {
+    for (; c >= '0' && c <= '9'; c = read_char(++p, progmem))
+      spec->width = spec->width * 10 + (c - '0');
+  }
+
+  spec->precision = -1;
+  spec->precision_star = false;
+  if (c == '.') {
+    spec->precision = 0;
+    c = read_char(++p, progmem);
+    spec->precision_star = c == '*';
+    if (spec->precision_star) {
+      c = read_char(++p, progmem);
+    } else {
+      for (; c >= '0' && c <= '9'; c = read_char(++p, progmem))
+        spec->precision = spec->precision * 10 + (c - '0');
+    }
+  }
+
+  // Length modifier, h and hh arguments are promoted to int
+  char modifier = 0;
+  if (c == 'h') {
+    c = read_char(++p, progmem);
+    if (c == 'h')
+      c = read_char(++p, progmem);
+  } else if (c == 'l') {
+    modifier = 'l';
+    c = read_char(++p, progmem);
+    if (c == 'l') {
+      modifier = 'q';
+      c = read_char(++p, progmem);
+    }
+  } else if (c == 'z' || c == 'j' || c == 't' || c == 'L') {
+    modifier = c;
+    c = read_char(++p, progmem);
+  }
+
+  switch (c) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+      switch (modifier) {
+        case 'l':
+          spec->type = ArgType::LONG;
+          break;
+        case 'q':
+          spec->type = ArgType::LONG_LONG;
+          break;
+        case 'z':
+          spec->type = ArgType::SIZE;
+          break;
+        case 'j':
+          spec->type = ArgType::INTMAX;
+          break;
+        case 't':
+          spec->type = ArgType::PTRDIFF;
+          break;
+        default:
+          spec->type = ArgType::INT;
+          break;
+      }
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      spec->type = modifier == 'L' ? ArgType::LONG_DOUBLE : ArgType::DOUBLE;
+      break;
+    case 's':
+      spec->type = ArgType::STRING;
+      break;
+    case 'p':
+      spec->type = ArgType::POINTER;
+      break;
+    case 'n':
+      spec->type = ArgType::WRITE_COUNT;
+      break;
+    default:
+      return false;
+  }
+  spec->length = p + 1 - format;
+  return true;
+}
+
+/// Advance format past the next conversion spec, returns false at the end of the format string.
+static bool next_spec(const char **format, bool progmem, FormatSpec *spec) {
+  for (const char *p = *format;; p++) {
+    const char c = read_char(p, progmem);
+    if (c == '\0')
+      return false;
+    if (c != '%')
+      continue;
+    if (parse_spec(p, progmem, spec)) {
+      *format = p + spec->length;
+      return true;
+    }
+    if (read_char(p + 1, progmem) == '%')
+      p++;
+  }
+}
+
+template<typename T> static size_t read_arg(va_list *args, uint8_t *value) {
+  T arg = va_arg(*args, T);
+  memcpy(value, &arg, sizeof(T));
+  return sizeof(T);
+}
+/// Read the next argument of type from args into value (at least 16 bytes), returns its size.
+static size_t read_arg(va_list *args, ArgType type, uint8_t *value) {
+  switch (type) {
+    case ArgType::INT:
+      return read_arg<int>(args, value);
+    case ArgType::LONG:
+      return read_arg<long>(args, value);  // NOLINT(google-runtime-int)
+    case ArgType::LONG_LONG:
+      return read_arg<long long>(args, value);  // NOLINT(google-runtime-int)
+    case ArgType::SIZE:
+      return read_arg<size_t>(args, value);
+    case ArgType::INTMAX:
+      return read_arg<intmax_t>(args, value);
+    case ArgType::PTRDIFF:
+      return read_arg<ptrdiff_t>(args, value);
+    case ArgType::DOUBLE:
+      return read_arg<double>(args, value);
+    case ArgType::LONG_DOUBLE:
+      return read_arg<long double>(args, value);
+    default:
+      return read_arg<const void *>(args, value);
+  }
+}
+
+/// The size of an argument of type in the buffer, as written by read_arg().
+static size_t arg_size(ArgType type) {
+  switch (type) {
+    case ArgType::INT:
+      return sizeof(int);
+    case ArgType::LONG:
+      return sizeof(long);  // NOLINT(google-runtime-int)
+    case ArgType::LONG_LONG:
+      return sizeof(long long);  // NOLINT(google-runtime-int)
+    case ArgType::SIZE:
+      return sizeof(size_t);
+    case ArgType::INTMAX:
+      return sizeof(intmax_t);
+    case ArgType::PTRDIFF:
+      return sizeof(ptrdiff_t);
+    case ArgType::DOUBLE:
+      return sizeof(double);
+    case ArgType::LONG_DOUBLE:
+      return sizeof(long double);
+    default:
+      return sizeof(const void *);
+  }
+}
+
+template<typename T>
+static int format_arg(char *out, size_t size, const char *spec, const int *stars, uint8_t num_stars,
+                      const uint8_t *value) {
+  T arg;
+  memcpy(&arg, value, sizeof(T));
+  switch (num_stars) {
+    case 0:
+      return snprintf(out, size, spec, arg);
+    case 1:
+      return snprintf(out, size, spec, stars[0], arg);
+    default:
+      return snprintf(out, size, spec, stars[0], stars[1], arg);
+  }
+}
+static int format_arg(char *out, size_t size, const char *spec, const int *stars, uint8_t num_stars, ArgType type,
+                      const uint8_t *value) {
+  switch (type) {
+    case ArgType::INT:
+      return format_arg<int>(out, size, spec, stars, num_stars, value);
+    case ArgType::LONG:
+      return format_arg<long>(out, size, spec, stars, num_stars, value);  // NOLINT(google-runtime-int)
+    case ArgType::LONG_LONG:
+      return format_arg<long long>(out, size, spec, stars, num_stars, value);  // NOLINT(google-runtime-int)
+    case ArgType::SIZE:
+      return format_arg<size_t>(out, size, spec, stars, num_stars, value);
+    case ArgType::INTMAX:
+      return format_arg<intmax_t>(out, size, spec, stars, num_stars, value);
+    case ArgType::PTRDIFF:
+      return format_arg<ptrdiff_t>(out, size, spec, stars, num_stars, value);
+    case ArgType::DOUBLE:
+      return format_arg<double>(out, size, spec, stars, num_stars, value);
+    case ArgType::LONG_DOUBLE:
+      return format_arg<long double>(out, size, spec, stars, num_stars, value);
+    case ArgType::POINTER:
+      return format_arg<const void *>(out, size, spec, stars, num_stars, value);
+    default:
+      return 0;
+  }
+}
+
+/// The number of characters of str printed with precision (-1 for none), at most max_length.
+static size_t string_length(const char *str, int precision, size_t max_length) {
+  if (precision >= 0 && static_cast<size_t>(precision) < max_length)
+    max_length = precision;
+  size_t length = 0;
+  while (length < max_length && str[length] != '\0')
+    length++;
+  return length;
+}
+
+LogRingBuffer::LogRingBuffer(size_t size, size_t max_string_length)
+    : max_string_length_(max_string_length < MAX_SIZE ? max_string_length : MAX_SIZE) {
+  uint32_t capacity = 64;
+  while (capacity < size && capacity < MAX_SIZE)
+    capacity <<= 1;
+  this->buffer_.reset(new uint8_t[capacity]());  // NOLINT(cppcoreguidelines-owning-memory)
+  this->mask_ = capacity - 1;
+}
+
+bool LogRingBuffer::record(uint8_t level, const char *tag, int line, const char *format, va_list args,
+                           bool format_in_progmem) {
+  static const char *const NULL_STRING = "(null)";
+  uint8_t flags = format_in_progmem ? FLAG_FORMAT_PROGMEM : 0;
+  uint16_t tag_length = 0, format_length = 0;
+  size_t size = sizeof(Header);
+  if (!is_static_string(tag)) {
+    flags |= FLAG_TAG_COPIED;
+    tag_length = string_length(tag, -1, sizeof(this->tag_) - 1);
+    size += sizeof(uint16_t) + tag_length;
+  }
+  if (!format_in_progmem && !is_static_string(format)) {
+    flags |= FLAG_FORMAT_COPIED;
+    format_length = string_length(format, -1, this->max_string_length_);
+    size += sizeof(uint16_t) + format_length;
+  }
+
+  // The arguments are read twice, first for the size of the message
+  uint8_t value[16];
+  FormatSpec spec{};
+  va_list args_copy;
+  va_copy(args_copy, args);
+  for (const char *p = format; next_spec(&p, format_in_progmem, &spec);) {
+    int precision = spec.precision;
+    if (spec.width_star)
+      size += read_arg(&args_copy, ArgType::INT, value);
+    if (spec.precision_star) {
+      size += read_arg(&args_copy, ArgType::INT, value);
+      memcpy(&precision, value, sizeof(int));
+    }
+    if (spec.type == ArgType::STRING) {
+      const char *str = va_arg(args_copy, const char *);
+      size += sizeof(uint16_t) + string_length(str != nullptr ? str : NULL_STRING, precision, this->max_string_length_);
+    } else {
+      size += read_arg(&args_copy, spec.type, value);
+    }
+  }
+  va_end(args_copy);
+
+  uint32_t position;
+  if (size > this->mask_ + 1 || !this->reserve_(size, &position))
+    return false;
+
+  uint32_t at = position + sizeof(Header);
+  if (flags & FLAG_TAG_COPIED) {
+    this->write_(at, &tag_length, sizeof(uint16_t));
+    this->write_(at + sizeof(uint16_t), tag, tag_length);
+    at += sizeof(uint16_t) + tag_length;
+  }
+  if (flags & FLAG_FORMAT_COPIED) {
+    this->write_(at, &format_length, sizeof(uint16_t));
+    this->write_(at + sizeof(uint16_t), format, format_length);
+    at += sizeof(uint16_t) + format_length;
+  }
+  va_copy(args_copy, args);
+  for (const char *p = format; next_spec(&p, format_in_progmem, &spec);) {
+    int precision = spec.precision;
+    if (spec.width_star) {
+      this->write_(at, value, read_arg(&args_copy, ArgType::INT, value));
+      at += sizeof(int);
+    }
+    if (spec.precision_star) {
+      this->write_(at, value, read_arg(&args_copy, ArgType::INT, value));
+      memcpy(&precision, value, sizeof(int));
+      at += sizeof(int);
+    }
+    if (spec.type == ArgType::STRING) {
+      const char *str = va_arg(args_copy, const char *);
+      if (str == nullptr)
+        str = NULL_STRING;
+      const uint16_t length = string_length(str, precision, this->max_string_length_);
+      this->write_(at, &length, sizeof(uint16_t));
+      this->write_(at + sizeof(uint16_t), str, length);
+      at += sizeof(uint16_t) + length;
+    } else {
+      const size_t length = read_arg(&args_copy, spec.type, value);
+      this->write_(at, value, length);
+      at += length;
+    }
+  }
+  va_end(args_copy);
+
+  const Header header{STATE_FREE, level, flags, static_cast<uint16_t>(size), static_cast<uint16_t>(line), tag, format};
+  this->write_(position, &header, sizeof(Header));
+  // Commit the message, the consumer only reads it once the state is set
+  __atomic_store_n(&this->buffer_[position & this->mask_], STATE_COMMITTED, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool LogRingBuffer::pop(uint8_t *level, const char **tag, int *line, char *message, size_t size) {
+  const uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+  if (tail == this->head_.load(std::memory_order_acquire))
+    return false;
+  // The oldest message may still be written by another task
+  if (__atomic_load_n(&this->buffer_[tail & this->mask_], __ATOMIC_ACQUIRE) != STATE_COMMITTED)
+    return false;
+
+  Header header;
+  this->read_(tail, &header, sizeof(Header));
+  *level = header.level;
+  *line = header.line;
+  *tag = header.tag;
+  uint32_t at = tail + sizeof(Header);
+  uint16_t length;
+  if (header.flags & FLAG_TAG_COPIED) {
+    this->read_(at, &length, sizeof(uint16_t));
+    this->read_(at + sizeof(uint16_t), this->tag_, length);
+    this->tag_[length] = '\0';
+    *tag = this->tag_;
+    at += sizeof(uint16_t) + length;
+  }
+  const char *format = header.format;
+  const bool progmem = header.flags & FLAG_FORMAT_PROGMEM;
+  if (header.flags & FLAG_FORMAT_COPIED) {
+    if (!this->format_)
+      this->format_.reset(new char[this->max_string_length_ + 1]);  // NOLINT(cppcoreguidelines-owning-memory)
+    this->read_(at, &length, sizeof(uint16_t));
+    this->read_(at + sizeof(uint16_t), this->format_.get(), length);
+    this->format_[length] = '\0';
+    format = this->format_.get();
+    at += sizeof(uint16_t) + length;
+  }
+
+  size_t out = 0;
+  uint8_t value[16];
+  FormatSpec spec{};
+  for (const char *p = format; out + 1 < size;) {
+    const char c = read_char(p, progmem);
+    if (c == '\0')
+      break;
+    if (c != '%') {
+      message[out++] = c;
+      p++;
+      continue;
+    }
+    if (!parse_spec(p, progmem, &spec)) {
+      // "%%", or an invalid spec printed as is
+      message[out++] = '%';
+      p += read_char(p + 1, progmem) == '%' ? 2 : 1;
+      continue;
+    }
+
+    int stars[2];
+    uint8_t num_stars = 0;
+    int width = spec.width;
+    if (spec.width_star) {
+      this->read_(at, &width, sizeof(int));
+      stars[num_stars++] = width;
+      at += sizeof(int);
+    }
+    if (spec.precision_star) {
+      this->read_(at, &stars[num_stars++], sizeof(int));
+      at += sizeof(int);
+    }
+
+    if (spec.type == ArgType::STRING) {
+      // The string was copied without terminator, pad it here
+      this->read_(at, &length, sizeof(uint16_t));
+      at += sizeof(uint16_t);
+      const bool left_align = spec.left_align || width < 0;
+      const size_t padding = std::max<int>(std::abs(width) - length, 0);
+      if (!left_align) {
+        const size_t n = std::min(padding, size - 1 - out);
+        memset(message + out, ' ', n);
+        out += n;
+      }
+      const size_t n = std::min<size_t>(length, size - 1 - out);
+      this->read_(at, message + out, n);
+      out += n;
+      at += length;
+      if (left_align) {
+        const size_t n = std::min(padding, size - 1 - out);
+        memset(message + out, ' ', n);
+        out += n;
+      }
+    } else {
+      const size_t value_size = arg_size(spec.type);
+      this->read_(at, value, value_size);
+      at += value_size;
+      char spec_string[24];
+      if (spec.type != ArgType::WRITE_COUNT && spec.length < sizeof(spec_string)) {
+        for (size_t i = 0; i < spec.length; i++)
+          spec_string[i] = read_char(p + i, progmem);
+        spec_string[spec.length] = '\0';
+        const int ret = format_arg(message + out, size - out, spec_string, stars, num_stars, spec.type, value);
+        if (ret > 0)
+          out += std::min<size_t>(ret, size - 1 - out);
+      }
+    }
+    p += spec.length;
+  }
+  message[out] = '\0';
+
+  // Free the space, a message reserving it later starts with a cleared state
+  const uint32_t start = tail & this->mask_;
+  const size_t first = std::min<size_t>(header.size, this->mask_ + 1 - start);
+  memset(&this->buffer_[start], 0, first);
+  memset(&this->buffer_[0], 0, header.size - first);
+  this->tail_.store(tail + header.size, std::memory_order_release);
+  return true;
+}
+
+bool LogRingBuffer::reserve_(size_t size, uint32_t *position) {
+  const uint32_t capacity = this->mask_ + 1;
+#ifdef ARDUINO_ARCH_ESP8266
+  // The ESP8266 has no compare-and-swap instruction, disabling interrupts is just as cheap
+  InterruptLock lock;
+  const uint32_t head = this->head_.load(std::memory_order_relaxed);
+  if (head - this->tail_.load(std::memory_order_acquire) + size > capacity) {
+    this->dropped_.store(this->dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return false;
+  }
+  this->head_.store(head + size, std::memory_order_relaxed);
+#else
+  uint32_t head = this->head_.load(std::memory_order_relaxed);
+  do {
+    if (head - this->tail_.load(std::memory_order_acquire) + size > capacity) {
+      this->dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  } while (!this->head_.compare_exchange_weak(head, head + size, std::memory_order_relaxed));
+#endif
+  *position = head;
+  return true;
+}
+
+void LogRingBuffer::write_(uint32_t position, const void *data, size_t length) {
+  const uint32_t start = position & this->mask_;
+  const size_t first = std::min<size_t>(length, this->mask_ + 1 - start);
+  memcpy(&this->buffer_[start], data, first);
+  memcpy(&this->buffer_[0], static_cast<const uint8_t *>(data) + first, length - first);
+}
+void LogRingBuffer::read_(uint32_t position, void *data, size_t length) const {
+  const uint32_t start = position & this->mask_;
+  const size_t first = std::min<size_t>(length, this->mask_ + 1 - start);
+  memcpy(data, &this->buffer_[start], first);
+  memcpy(static_cast<uint8_t *>(data) + first, &this->buffer_[0], length - first);
+}
+
+}  // namespace logger
+}  // namespace esphome
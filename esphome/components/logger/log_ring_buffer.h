@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace esphome {
+namespace logger {
+
+/** Ring buffer of log messages that are recorded unformatted and formatted later.
+ *
+ * record() only copies the level, tag, line, format string pointer and the raw arguments of the format string into
+ * the buffer, strings passed for %s are copied as they may not outlive the call. The tag and format string are
+ * copied too if they are not in the read-only data of the firmware. Any task can record messages: space is reserved
+ * with an atomic compare-and-swap (interrupts disabled on the ESP8266), then the message is written and committed.
+ * Messages that don't fit are dropped and counted. The record path is not in IRAM, so it must not be called from an
+ * ISR (which may run while the flash cache is disabled).
+ *
+ * A single consumer (the main loop) formats the committed messages in order with pop().
+ */
+class LogRingBuffer {
+ public:
+  /// Message sizes are stored in 16 bits, so neither the buffer nor a single message can be larger than this.
+  static const size_t MAX_SIZE = 32768;
+
+  /** Allocate the buffer.
+   *
+   * @param size Rounded up to a power of two, at most MAX_SIZE.
+   * @param max_string_length Strings passed for %s are truncated to this length (at most MAX_SIZE).
+   */
+  LogRingBuffer(size_t size, size_t max_string_length);
+
+  /// Record a message, returns false if it was dropped because the buffer is full.
+  bool record(uint8_t level, const char *tag, int line, const char *format, va_list args, bool format_in_progmem);
+
+  /** Format the oldest committed message into message (at most size - 1 characters) and remove it.
+   *
+   * @return false if there is no committed message. The tag pointer is valid until the next call.
+   */
+  bool pop(uint8_t *level, const char **tag, int *line, char *message, size_t size);
+
+  /// The number of messages dropped because the buffer was full.
+  uint32_t get_dropped() const { return this->dropped_.load(std::memory_order_relaxed); }
+  size_t get_size() const { return this->mask_ + 1; }
+
+ protected:
+  struct Header {
+    /// Written last, when the message is complete.
+    uint8_t state;
+    uint8_t level;
+    uint8_t flags;
+    uint16_t size;
+    uint16_t line;
+    const char *tag;
+    const char *format;
+  };
+  enum : uint8_t { STATE_FREE = 0, STATE_COMMITTED = 1 };
+  enum : uint8_t { FLAG_FORMAT_PROGMEM = 1 << 0, FLAG_TAG_COPIED = 1 << 1, FLAG_FORMAT_COPIED = 1 << 2 };
+
+  /// Reserve size bytes, returns false if they don't fit.
+  bool reserve_(size_t size, uint32_t *position);
+  void write_(uint32_t position, const void *data, size_t length);
+  void read_(uint32_t position, void *data, size_t length) const;
+
+  std::unique_ptr<uint8_t[]> buffer_;
+  uint32_t mask_;
+  size_t max_string_length_;
+  /// End of the reserved space, written by the producers.
+  std::atomic<uint32_t> head_{0};
+  /// Start of the oldest message, written by the consumer.
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+  /// Copies of the tag and format string of the popped message, if they were copied into the buffer.
+  char tag_[32];
+  std::unique_ptr<char[]> format_;
+};
+
+}  // namespace logger
+}  // namespace esphome
@@ -1,4 +1,5 @@
 #include "logger.h"
+#include "esphome/core/application.h"
 
 #ifdef ARDUINO_ARCH_ESP32
 #include <esp_log.h>
@@ -46,6 +47,12 @@ void HOT Logger::log_vprintf_(int level, const char *tag, int line, const char *
   if (level > this->level_for(tag))
     return;
 
+  if (this->async_) {
+    this->log_buffer_->record(level, tag, line, format, args, false);
+    App.wake_loop();
+    return;
+  }
+
   this->reset_buffer_();
   this->write_header_(level, tag, line);
   this->vprintf_to_buffer_(format, args);
@@ -58,6 +65,12 @@ void Logger::log_vprintf_(int level, const char *tag, int line, const __FlashStr
   if (level > this->level_for(tag))
     return;
 
+  if (this->async_) {
+    this->log_buffer_->record(level, tag, line, (PGM_P) format, args, true);
+    App.wake_loop();
+    return;
+  }
+
   this->reset_buffer_();
   // copy format string
   const char *format_pgm_p = (PGM_P) format;
@@ -81,17 +94,7 @@ void Logger::log_vprintf_(int level, const char *tag, int line, const __FlashStr
 }
 #endif
 
-int HOT Logger::level_for(const char *tag) {
-  // Uses std::vector<> for low memory footprint, though the vector
-  // could be sorted to minimize lookup times. This feature isn't used that
-  // much anyway so it doesn't matter too much.
-  for (auto &it : this->log_levels_) {
-    if (it.tag == tag) {
-      return it.level;
-    }
-  }
-  return ESPHOME_LOG_LEVEL;
-}
+int HOT Logger::level_for(const char *tag) { return this->log_levels_.get(tag); }
 void HOT Logger::log_message_(int level, const char *tag, int offset) {
   // remove trailing newline
   if (this->tx_buffer_[this->tx_buffer_at_ - 1] == '\n') {
@@ -116,6 +119,30 @@ void HOT Logger::log_message_(int level, const char *tag, int offset) {
 #endif
 }
 
+void Logger::drain_log_buffer_() {
+  uint8_t level;
+  const char *tag;
+  int line;
+  char *message = this->message_buffer_.get();
+  while (this->log_buffer_->pop(&level, &tag, &line, message, this->tx_buffer_size_ + 1)) {
+    this->reset_buffer_();
+    this->write_header_(level, tag, line);
+    this->write_to_buffer_(message, strlen(message));
+    this->write_footer_();
+    this->log_message_(level, tag);
+  }
+
+  const uint32_t dropped = this->log_buffer_->get_dropped();
+  if (dropped != this->dropped_reported_) {
+    this->reset_buffer_();
+    this->write_header_(ESPHOME_LOG_LEVEL_WARN, TAG, __LINE__);
+    this->printf_to_buffer_("Dropped %u log messages, the async buffer is full!", dropped - this->dropped_reported_);
+    this->write_footer_();
+    this->log_message_(ESPHOME_LOG_LEVEL_WARN, TAG);
+    this->dropped_reported_ = dropped;
+  }
+}
+
 Logger::Logger(uint32_t baud_rate, size_t tx_buffer_size, UARTSelection uart)
     : baud_rate_(baud_rate), tx_buffer_size_(tx_buffer_size), uart_(uart) {
   // add 1 to buffer size for null terminator
@@ -171,7 +198,38 @@ void Logger::pre_setup() {
 }
 void Logger::set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
 void Logger::set_log_level(const std::string &tag, int log_level) {
-  this->log_levels_.push_back(LogLevelOverride{tag, log_level});
+  if (log_level < ESPHOME_LOG_LEVEL_NONE || log_level > ESPHOME_LOG_LEVEL_VERY_VERBOSE) {
+    ESP_LOGW(TAG, "Invalid log level %d for '%s'", log_level, tag.c_str());
+    return;
+  }
+  // Messages above the global level aren't compiled in
+  if (!this->log_levels_.set(tag, std::min(log_level, ESPHOME_LOG_LEVEL)))
+    ESP_LOGW(TAG, "No room for the log level of '%s', at most %u tags can have a level", tag.c_str(),
+             this->log_levels_.get_max_overrides());
+}
+void Logger::set_async_buffer_size(size_t size) {
+  if (size == 0) {
+    this->log_buffer_.reset();
+    this->message_buffer_.reset();
+    return;
+  }
+  this->log_buffer_ = make_unique<LogRingBuffer>(size, this->tx_buffer_size_);
+  this->message_buffer_.reset(new char[this->tx_buffer_size_ + 1]);  // NOLINT(cppcoreguidelines-owning-memory)
+}
+void Logger::loop() {
+  if (this->log_buffer_ != nullptr) {
+    this->async_ = true;
+    this->drain_log_buffer_();
+  }
+  // Only woken up by new log messages
+  this->set_loop_wake_hint(WAKE_HINT_ON_EVENT);
+}
+void Logger::on_shutdown() {
+  if (this->log_buffer_ == nullptr)
+    return;
+  // Write the remaining messages, and everything logged while shutting down immediately
+  this->async_ = false;
+  this->drain_log_buffer_();
 }
 UARTSelection Logger::get_uart() const { return this->uart_; }
 void Logger::add_on_log_callback(std::function<void(int, const char *, const char *)> &&callback) {
@@ -190,8 +248,11 @@ void Logger::dump_config() {
   ESP_LOGCONFIG(TAG, "  Level: %s", LOG_LEVELS[ESPHOME_LOG_LEVEL]);
   ESP_LOGCONFIG(TAG, "  Log Baud Rate: %u", this->baud_rate_);
   ESP_LOGCONFIG(TAG, "  Hardware UART: %s", UART_SELECTIONS[this->uart_]);
-  for (auto &it : this->log_levels_) {
-    ESP_LOGCONFIG(TAG, "  Level for '%s': %s", it.tag.c_str(), LOG_LEVELS[it.level]);
+  if (this->log_buffer_ != nullptr)
+    ESP_LOGCONFIG(TAG, "  Async Buffer Size: %u bytes", this->log_buffer_->get_size());
+  for (size_t i = 0; i < this->log_levels_.get_override_count(); i++) {
+    ESP_LOGCONFIG(TAG, "  Level for '%s': %s", this->log_levels_.get_override_tag(i),
+                  LOG_LEVELS[this->log_levels_.get_override_level(i)]);
   }
 }
 void Logger::write_footer_() { this->write_to_buffer_(ESPHOME_LOG_RESET_COLOR, strlen(ESPHOME_LOG_RESET_COLOR)); }
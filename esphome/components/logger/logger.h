@@ -5,6 +5,8 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/defines.h"
+#include "log_ring_buffer.h"
+#include "tag_levels.h"
 
 namespace esphome {
 
@@ -25,6 +27,18 @@ enum UARTSelection {
 #endif
 };
 
+#ifdef ESPHOME_LOG_TAG_LEVELS
+static const size_t CONFIGURED_TAG_LEVELS = ESPHOME_LOG_TAG_LEVELS;
+#else
+static const size_t CONFIGURED_TAG_LEVELS = 0;
+#endif
+#ifdef USE_LOGGER_SET_LEVEL
+/// Tags without a configured level that logger.set_level can add at runtime.
+static const size_t RUNTIME_TAG_LEVELS = 8;
+#else
+static const size_t RUNTIME_TAG_LEVELS = 0;
+#endif
+
 class Logger : public Component {
  public:
   explicit Logger(uint32_t baud_rate, size_t tx_buffer_size, UARTSelection uart);
@@ -37,15 +51,28 @@ class Logger : public Component {
   /// Get the UART used by the logger.
   UARTSelection get_uart() const;
 
-  /// Set the log level of the specified tag.
+  /** Set the log level of the specified tag, also at runtime (from the main loop).
+   *
+   * Messages above the global log level are not compiled in, so they can't be enabled here. Room for the tags is
+   * reserved at compile time: the configured ones plus a few for logger.set_level.
+   */
   void set_log_level(const std::string &tag, int log_level);
 
+  /** Record log messages into a ring buffer of size bytes and format them in the main loop, 0 to disable.
+   *
+   * Messages logged before the first loop (during setup) are still written immediately.
+   */
+  void set_async_buffer_size(size_t size);
+
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
   /// Set up this component.
   void pre_setup();
   void dump_config() override;
+  void loop() override;
+  void on_shutdown() override;
 
+  /// The log level of tag, O(1) for tags that were logged before.
   int level_for(const char *tag);
 
   /// Register a callback that will be called for every log message sent
@@ -62,6 +89,8 @@ class Logger : public Component {
   void write_header_(int level, const char *tag, int line);
   void write_footer_();
   void log_message_(int level, const char *tag, int offset = 0);
+  /// Format and write the messages recorded in the async buffer.
+  void drain_log_buffer_();
 
   inline bool is_buffer_full_() const { return this->tx_buffer_at_ >= this->tx_buffer_size_; }
   inline int buffer_remaining_capacity_() const { return this->tx_buffer_size_ - this->tx_buffer_at_; }
@@ -107,11 +136,13 @@ class Logger : public Component {
   int tx_buffer_size_{0};
   UARTSelection uart_{UART_SELECTION_UART0};
   HardwareSerial *hw_serial_{nullptr};
-  struct LogLevelOverride {
-    std::string tag;
-    int level;
-  };
-  std::vector<LogLevelOverride> log_levels_;
+  TagLevels log_levels_{ESPHOME_LOG_LEVEL, CONFIGURED_TAG_LEVELS + RUNTIME_TAG_LEVELS};
+  std::unique_ptr<LogRingBuffer> log_buffer_;
+  /// Formatted message popped from the async buffer.
+  std::unique_ptr<char[]> message_buffer_;
+  /// Whether messages are recorded into the async buffer, set in the first loop.
+  bool async_{false};
+  uint32_t dropped_reported_{0};
   CallbackManager<void(int, const char *, const char *)> log_callback_{};
 };
 
@@ -132,6 +163,18 @@ class LoggerMessageTrigger : public Trigger<int, const char *, const char *> {
   int level_;
 };
 
+template<typename... Ts> class LoggerSetLevelAction : public Action<Ts...> {
+ public:
+  explicit LoggerSetLevelAction(Logger *logger) : logger_(logger) {}
+  TEMPLATABLE_VALUE(std::string, tag)
+  TEMPLATABLE_VALUE(int, level)
+
+  void play(Ts... x) override { this->logger_->set_log_level(this->tag_.value(x...), this->level_.value(x...)); }
+
+ protected:
+  Logger *logger_;
+};
+
 }  // namespace logger
 
 }  // namespace esphome
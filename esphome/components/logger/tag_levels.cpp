@@ -0,0 +1,89 @@
+#include "tag_levels.h"
+#include <cstring>
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace logger {
+
+TagLevels::TagLevels(int default_level, size_t max_overrides)
+    : default_level_(default_level), max_overrides_(max_overrides) {
+  if (max_overrides == 0)
+    return;
+  this->overrides_.reset(new Override[max_overrides]);  // NOLINT(cppcoreguidelines-owning-memory)
+  this->table_.reset(new Entry[TABLE_SIZE]);            // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+bool TagLevels::set(const std::string &tag, int level) {
+  const size_t count = this->count_.load(std::memory_order_relaxed);
+  size_t index = 0;
+  while (index < count && tag != this->overrides_[index].tag.get())
+    index++;
+  if (index == count) {
+    if (count == this->max_overrides_)
+      return false;
+    Override &over = this->overrides_[index];
+    over.tag.reset(new char[tag.size() + 1]);  // NOLINT(cppcoreguidelines-owning-memory)
+    memcpy(over.tag.get(), tag.c_str(), tag.size() + 1);
+    over.level.store(level, std::memory_order_relaxed);
+    // Publish the complete override
+    this->count_.store(count + 1, std::memory_order_release);
+  } else {
+    this->overrides_[index].level.store(level, std::memory_order_relaxed);
+  }
+
+  this->generation_.store((this->generation_.load(std::memory_order_relaxed) + 1) & 0xFFFFFF,
+                          std::memory_order_release);
+  return true;
+}
+
+int TagLevels::get(const char *tag) {
+  Entry *table = this->table_.get();
+  if (table == nullptr)
+    return this->default_level_;
+
+  const uint32_t generation = this->generation_.load(std::memory_order_acquire);
+  const auto address = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(tag));
+  uint32_t index = (address * 2654435761u) >> (32 - TABLE_BITS);
+  for (uint32_t probe = 0; probe < MAX_PROBES; probe++, index = (index + 1) % TABLE_SIZE) {
+    Entry &entry = table[index];
+    const char *entry_tag = entry.tag.load(std::memory_order_acquire);
+    if (entry_tag == nullptr) {
+      // Claim the free entry, tags can be looked up concurrently by other tasks
+#ifdef ARDUINO_ARCH_ESP8266
+      InterruptLock lock;
+      entry_tag = entry.tag.load(std::memory_order_relaxed);
+      if (entry_tag == nullptr) {
+        entry.tag.store(tag, std::memory_order_relaxed);
+        entry_tag = tag;
+      }
+#else
+      if (entry.tag.compare_exchange_strong(entry_tag, tag))
+        entry_tag = tag;
+#endif
+    }
+    if (entry_tag != tag)
+      continue;
+
+    const uint32_t word = entry.level.load(std::memory_order_acquire);
+    if (word != 0 && word >> 8 == generation)
+      return word & 0xFF;
+    const int level = this->find_(tag);
+    entry.level.store(generation << 8 | level, std::memory_order_release);
+    return level;
+  }
+  // Too many colliding tags
+  return this->find_(tag);
+}
+
+int TagLevels::find_(const char *tag) const {
+  const size_t count = this->count_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < count; i++) {
+    const Override &over = this->overrides_[i];
+    if (strcmp(over.tag.get(), tag) == 0)
+      return over.level.load(std::memory_order_relaxed);
+  }
+  return this->default_level_;
+}
+
+}  // namespace logger
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace esphome {
+namespace logger {
+
+/** Log level overrides by tag, with an O(1) lookup by tag pointer.
+ *
+ * Tags are string constants, so the first time a tag is looked up its address is interned into a small open
+ * addressing table that caches the level of the tag. The cached level word holds the generation of the overrides it
+ * was looked up with (generation << 8 | level), changing an override starts a new generation so that all tags are
+ * looked up again. get() can be called from any task (but not from an ISR, it is not in IRAM), set() only from the
+ * main loop.
+ *
+ * The overrides and the table are allocated in the constructor with room for a fixed number of tags, so that set()
+ * never moves memory get() may read: a new override is completed before it is published, after that only its level
+ * changes.
+ */
+class TagLevels {
+ public:
+  TagLevels(int default_level, size_t max_overrides);
+
+  /// Set the level of tag, returns false if there is no room for another tag.
+  bool set(const std::string &tag, int level);
+  /// The level of tag, default_level if it has no override.
+  int get(const char *tag);
+
+  size_t get_override_count() const { return this->count_.load(std::memory_order_acquire); }
+  const char *get_override_tag(size_t index) const { return this->overrides_[index].tag.get(); }
+  int get_override_level(size_t index) const { return this->overrides_[index].level.load(std::memory_order_relaxed); }
+  size_t get_max_overrides() const { return this->max_overrides_; }
+
+ protected:
+  static const uint32_t TABLE_BITS = 7;
+  static const uint32_t TABLE_SIZE = 1 << TABLE_BITS;
+  /// Linear probes before giving up and searching the overrides without caching.
+  static const uint32_t MAX_PROBES = 8;
+
+  struct Override {
+    /// Copy of the tag, never changes once the override is published.
+    std::unique_ptr<char[]> tag;
+    std::atomic<uint8_t> level{0};
+  };
+  struct Entry {
+    std::atomic<const char *> tag{nullptr};
+    std::atomic<uint32_t> level{0};
+  };
+
+  int find_(const char *tag) const;
+
+  int default_level_;
+  size_t max_overrides_;
+  std::unique_ptr<Override[]> overrides_;
+  /// The number of published overrides, only incremented once an override is complete.
+  std::atomic<size_t> count_{0};
+  /// Only allocated if there can be overrides.
+  std::unique_ptr<Entry[]> table_;
+  std::atomic<uint32_t> generation_{1};
+};
+
+}  // namespace logger
+}  // namespace esphome
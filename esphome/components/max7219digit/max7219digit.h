@@ -82,6 +82,8 @@ class MAX7219Component : public PollingComponent,
 #endif
 
  protected:
+  /// Text wider than the display extends the buffer, so that it can be scrolled.
+  int get_clip_width_() override { return INT16_MAX; }
   void send_byte_(uint8_t a_register, uint8_t data);
   void send_to_all_(uint8_t a_register, uint8_t data);
 
@@ -42,6 +42,10 @@ from esphome.core import coroutine_with_priority, CORE
 DEPENDENCIES = ["network"]
 AUTO_LOAD = ["json", "async_tcp"]
 
+CONF_DISCOVERY_QOS = "discovery_qos"
+CONF_DISCOVERY_SKIP_UNCHANGED = "discovery_skip_unchanged"
+CONF_DISCOVERY_PUBLISH_BUDGET = "discovery_publish_budget"
+
 
 def validate_message_just_topic(value):
     value = cv.publish_topic(value)
@@ -129,6 +133,15 @@ def validate_config(value):
     return out
 
 
+def validate_discovery_skip_unchanged(value):
+    # Unchanged discovery messages are only skipped because the broker still has the retained ones
+    if value[CONF_DISCOVERY_SKIP_UNCHANGED] and not value[CONF_DISCOVERY_RETAIN]:
+        raise cv.Invalid(
+            f"{CONF_DISCOVERY_SKIP_UNCHANGED} requires {CONF_DISCOVERY_RETAIN} to be enabled"
+        )
+    return value
+
+
 def validate_fingerprint(value):
     value = cv.string(value)
     if re.match(r"^[0-9a-f]{40}$", value) is None:
@@ -152,6 +165,11 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(
                 CONF_DISCOVERY_PREFIX, default="homeassistant"
             ): cv.publish_topic,
+            cv.Optional(CONF_DISCOVERY_QOS, default=0): cv.mqtt_qos,
+            cv.Optional(CONF_DISCOVERY_SKIP_UNCHANGED, default=False): cv.boolean,
+            cv.Optional(CONF_DISCOVERY_PUBLISH_BUDGET, default=4): cv.int_range(
+                min=1, max=255
+            ),
             cv.Optional(CONF_BIRTH_MESSAGE): MQTT_MESSAGE_SCHEMA,
             cv.Optional(CONF_WILL_MESSAGE): MQTT_MESSAGE_SCHEMA,
             cv.Optional(CONF_SHUTDOWN_MESSAGE): MQTT_MESSAGE_SCHEMA,
@@ -192,6 +210,7 @@ CONFIG_SCHEMA = cv.All(
         }
     ),
     validate_config,
+    validate_discovery_skip_unchanged,
 )
 
 
@@ -235,6 +254,10 @@ async def to_code(config):
         cg.add(var.set_discovery_info(discovery_prefix, discovery_retain, True))
     elif CONF_DISCOVERY_RETAIN in config or CONF_DISCOVERY_PREFIX in config:
         cg.add(var.set_discovery_info(discovery_prefix, discovery_retain))
+    if discovery:
+        cg.add(var.set_discovery_qos(config[CONF_DISCOVERY_QOS]))
+        cg.add(var.set_discovery_skip_unchanged(config[CONF_DISCOVERY_SKIP_UNCHANGED]))
+    cg.add(var.set_discovery_publish_budget(config[CONF_DISCOVERY_PUBLISH_BUDGET]))
 
     cg.add(var.set_topic_prefix(config[CONF_TOPIC_PREFIX]))
 
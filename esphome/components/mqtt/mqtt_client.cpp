@@ -4,6 +4,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "esphome/core/util.h"
+#include <algorithm>
 #include <utility>
 #ifdef USE_LOGGER
 #include "esphome/components/logger/logger.h"
@@ -17,6 +18,12 @@ namespace mqtt {
 
 static const char *const TAG = "mqtt";
 
+/// Time to wait for the acknowledgement of a discovery message before it's published again.
+static const uint32_t DISCOVERY_ACK_TIMEOUT = 10000;
+/// How often the connection is checked in tickless idle while there's nothing to send, a disconnect also wakes the
+/// loop.
+static const uint32_t IDLE_CHECK_INTERVAL = 1000;
+
 MQTTClientComponent::MQTTClientComponent() {
   global_mqtt_client = this;
   this->credentials_.client_id = App.get_name() + "-" + get_mac_address();
@@ -37,11 +44,15 @@ void MQTTClientComponent::setup() {
     if (len + index == total) {
       this->on_message(topic, this->payload_buffer_);
       this->payload_buffer_.clear();
+      // The message may have been deferred to the loop
+      App.wake_loop();
     }
   });
+  this->mqtt_client_.onPublish([this](uint16_t packet_id) { this->publish_tracker_.on_ack(packet_id); });
   this->mqtt_client_.onDisconnect([this](AsyncMqttClientDisconnectReason reason) {
     this->state_ = MQTT_CLIENT_DISCONNECTED;
     this->disconnect_reason_ = reason;
+    App.wake_loop();
   });
 #ifdef USE_LOGGER
   if (this->is_log_message_enabled() && logger::global_logger != nullptr) {
@@ -66,6 +77,9 @@ void MQTTClientComponent::dump_config() {
   if (!this->discovery_info_.prefix.empty()) {
     ESP_LOGCONFIG(TAG, "  Discovery prefix: '%s'", this->discovery_info_.prefix.c_str());
     ESP_LOGCONFIG(TAG, "  Discovery retain: %s", YESNO(this->discovery_info_.retain));
+    ESP_LOGCONFIG(TAG, "  Discovery QoS: %u", this->discovery_info_.qos);
+    ESP_LOGCONFIG(TAG, "  Discovery skip unchanged: %s", YESNO(this->discovery_info_.skip_unchanged));
+    ESP_LOGCONFIG(TAG, "  Discovery publish budget: %u", this->discovery_publish_budget_);
   }
   ESP_LOGCONFIG(TAG, "  Topic Prefix: '%s'", this->topic_prefix_.c_str());
   if (!this->log_message_.topic.empty()) {
@@ -215,6 +229,8 @@ void MQTTClientComponent::check_connected() {
 
   this->resubscribe_subscriptions_();
 
+  // Messages in flight on the previous connection won't be acknowledged anymore, everything is published again
+  this->publish_tracker_.clear();
   for (MQTTComponent *component : this->children_)
     component->schedule_resend_state();
 }
@@ -284,6 +300,7 @@ void MQTTClientComponent::loop() {
 
         this->last_connected_ = now;
         this->resubscribe_subscriptions_();
+        this->send_scheduled_states_();
       }
       break;
   }
@@ -292,6 +309,20 @@ void MQTTClientComponent::loop() {
     ESP_LOGE(TAG, "Can't connect to MQTT... Restarting...");
     App.reboot();
   }
+
+  if (this->state_ == MQTT_CLIENT_CONNECTED && this->is_idle_())
+    this->set_loop_wake_hint(IDLE_CHECK_INTERVAL);
+}
+bool MQTTClientComponent::is_idle_() const {
+  if (!this->birth_message_.topic.empty() && !this->sent_birth_message_)
+    return false;
+  if (this->resend_queue_head_ < this->resend_queue_.size() || this->publish_tracker_.size() != 0)
+    return false;
+  for (const auto &subscription : this->subscriptions_) {
+    if (!subscription.subscribed)
+      return false;
+  }
+  return true;
 }
 float MQTTClientComponent::get_setup_priority() const { return setup_priority::AFTER_WIFI; }
 
@@ -339,6 +370,7 @@ void MQTTClientComponent::subscribe(const std::string &topic, mqtt_callback_t ca
       .resubscribe_timeout = 0,
   };
   this->resubscribe_subscription_(&subscription);
+  this->subscription_trie_.insert(subscription.topic, this->subscriptions_.size());
   this->subscriptions_.push_back(subscription);
 }
 
@@ -354,6 +386,7 @@ void MQTTClientComponent::subscribe_json(const std::string &topic, const mqtt_js
       .resubscribe_timeout = 0,
   };
   this->resubscribe_subscription_(&subscription);
+  this->subscription_trie_.insert(subscription.topic, this->subscriptions_.size());
   this->subscriptions_.push_back(subscription);
 }
 
@@ -375,6 +408,10 @@ void MQTTClientComponent::unsubscribe(const std::string &topic) {
     else
       ++it;
   }
+  // The indices of the following subscriptions changed
+  this->subscription_trie_.clear();
+  for (size_t i = 0; i < this->subscriptions_.size(); i++)
+    this->subscription_trie_.insert(this->subscriptions_[i].topic, i);
 }
 
 // Publish
@@ -384,9 +421,13 @@ bool MQTTClientComponent::publish(const std::string &topic, const std::string &p
 
 bool MQTTClientComponent::publish(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
                                   bool retain) {
+  return this->publish_(topic, payload, payload_length, qos, retain) != 0;
+}
+uint16_t MQTTClientComponent::publish_(const std::string &topic, const char *payload, size_t payload_length,
+                                      uint8_t qos, bool retain) {
   if (!this->is_connected()) {
     // critical components will re-transmit their messages
-    return false;
+    return 0;
   }
   bool logging_topic = topic == this->log_message_.topic;
   uint16_t ret = this->mqtt_client_.publish(topic.c_str(), qos, retain, payload, payload_length);
@@ -406,7 +447,59 @@ bool MQTTClientComponent::publish(const std::string &topic, const char *payload,
       this->status_momentary_warning("publish", 1000);
     }
   }
-  return ret != 0;
+  return ret;
+}
+bool MQTTClientComponent::publish_discovery(MQTTComponent *component, const std::string &topic, const char *payload,
+                                            size_t payload_length, uint32_t hash) {
+  const uint8_t qos = this->discovery_info_.qos;
+  const uint16_t packet_id = this->publish_(topic, payload, payload_length, qos, this->discovery_info_.retain);
+  if (packet_id == 0)
+    return false;
+  if (qos == 0) {
+    // Not acknowledged by the broker, assume it was received
+    component->on_discovery_published_(hash);
+  } else {
+    this->publish_tracker_.track(packet_id, component, hash, millis());
+  }
+  return true;
+}
+
+void MQTTClientComponent::queue_resend_state(MQTTComponent *component) { this->resend_queue_.push_back(component); }
+void MQTTClientComponent::send_scheduled_states_() {
+  this->publish_tracker_.process(millis(), DISCOVERY_ACK_TIMEOUT,
+                                 [](const MQTTPublishTracker::Message &message, bool acknowledged) {
+                                   if (acknowledged) {
+                                     message.component->on_discovery_published_(message.hash);
+                                   } else {
+                                     ESP_LOGW(TAG, "Discovery message %u not acknowledged, publishing it again.",
+                                              message.packet_id);
+                                     message.component->schedule_resend_state();
+                                   }
+                                 });
+
+  // Drop the components that are done once they make up half of the queue
+  if (this->resend_queue_head_ != 0 && this->resend_queue_head_ * 2 >= this->resend_queue_.size()) {
+    this->resend_queue_.erase(this->resend_queue_.begin(), this->resend_queue_.begin() + this->resend_queue_head_);
+    this->resend_queue_head_ = 0;
+  }
+
+  // Resume with the component that ran out of budget last time
+  uint8_t budget = this->discovery_publish_budget_;
+  while (this->resend_queue_head_ < this->resend_queue_.size()) {
+    // Wait for acknowledgements before publishing more discovery messages
+    if (this->publish_tracker_.is_full())
+      return;
+    MQTTComponent *component = this->resend_queue_[this->resend_queue_head_];
+    const auto result = component->send_scheduled_state_(&budget);
+    if (result == MQTTComponent::ScheduledStateResult::BUDGET_EXHAUSTED)
+      return;
+    this->resend_queue_head_++;
+    if (result == MQTTComponent::ScheduledStateResult::FAILED)
+      // Retry it after the others, so that a component whose messages don't go through doesn't hold back the rest
+      this->resend_queue_.push_back(component);
+  }
+  this->resend_queue_.clear();
+  this->resend_queue_head_ = 0;
 }
 
 bool MQTTClientComponent::publish(const MQTTMessage &message) {
@@ -419,72 +512,18 @@ bool MQTTClientComponent::publish_json(const std::string &topic, const json::jso
   return this->publish(topic, message, len, qos, retain);
 }
 
-/** Check if the message topic matches the given subscription topic
- *
- * INFO: MQTT spec mandates that topics must not be empty and must be valid NULL-terminated UTF-8 strings.
- *
- * @param message The message topic that was received from the MQTT server. Note: this must not contain
- *                wildcard characters as mandated by the MQTT spec.
- * @param subscription The subscription topic we are matching against.
- * @param is_normal Is this a "normal" topic - Does the message topic not begin with a "$".
- * @param past_separator Are we past the first '/' topic separator.
- * @return true if the subscription topic matches the message topic, false otherwise.
- */
-static bool topic_match(const char *message, const char *subscription, bool is_normal, bool past_separator) {
-  // Reached end of both strings at the same time, this means we have a successful match
-  if (*message == '\0' && *subscription == '\0')
-    return true;
-
-  // Either the message or the subscribe are at the end. This means they don't match.
-  if (*message == '\0' || *subscription == '\0')
-    return false;
-
-  bool do_wildcards = is_normal || past_separator;
-
-  if (*subscription == '+' && do_wildcards) {
-    // single level wildcard
-    // consume + from subscription
-    subscription++;
-    // consume everything from message until '/' found or end of string
-    while (*message != '\0' && *message != '/') {
-      message++;
-    }
-    // after this, both pointers will point to a '/' or to the end of the string
-
-    return topic_match(message, subscription, is_normal, true);
-  }
-
-  if (*subscription == '#' && do_wildcards) {
-    // multilevel wildcard - MQTT mandates that this must be at end of subscribe topic
-    return true;
-  }
-
-  // this handles '/' and normal characters at the same time.
-  if (*message != *subscription)
-    return false;
-
-  past_separator = past_separator || *subscription == '/';
-
-  // consume characters
-  subscription++;
-  message++;
-
-  return topic_match(message, subscription, is_normal, past_separator);
-}
-
-static bool topic_match(const char *message, const char *subscription) {
-  return topic_match(message, subscription, *message != '\0' && *message != '$', false);
-}
-
 void MQTTClientComponent::on_message(const std::string &topic, const std::string &payload) {
 #ifdef ARDUINO_ARCH_ESP8266
   // on ESP8266, this is called in LWiP thread; some components do not like running
   // in an ISR.
   this->defer([this, topic, payload]() {
 #endif
-    for (auto &subscription : this->subscriptions_)
-      if (topic_match(topic.c_str(), subscription.topic.c_str()))
-        subscription.callback(topic, payload);
+    this->matching_subscriptions_.clear();
+    this->subscription_trie_.match(topic, &this->matching_subscriptions_);
+    // Call the callbacks in the order of subscription, like a scan over all subscriptions would
+    std::sort(this->matching_subscriptions_.begin(), this->matching_subscriptions_.end());
+    for (size_t index : this->matching_subscriptions_)
+      this->subscriptions_[index].callback(topic, payload);
 #ifdef ARDUINO_ARCH_ESP8266
   });
 #endif
@@ -5,6 +5,8 @@
 #include "esphome/core/automation.h"
 #include "esphome/core/log.h"
 #include "esphome/components/json/json_util.h"
+#include "mqtt_publish_tracker.h"
+#include "mqtt_topic_trie.h"
 #include <AsyncMqttClient.h>
 #include "lwip/ip_addr.h"
 
@@ -59,6 +61,8 @@ struct MQTTDiscoveryInfo {
   std::string prefix;  ///< The Home Assistant discovery prefix. Empty means disabled.
   bool retain;         ///< Whether to retain discovery messages.
   bool clean;
+  uint8_t qos;          ///< QoS of the discovery messages, above 0 they count as published once acknowledged.
+  bool skip_unchanged;  ///< Whether to skip discovery messages the broker already received, relies on retain.
 };
 
 enum MQTTClientState {
@@ -97,6 +101,12 @@ class MQTTClientComponent : public Component {
    * @param retain Whether to retain discovery messages.
    */
   void set_discovery_info(std::string &&prefix, bool retain, bool clean = false);
+  /// Set the QoS of the discovery messages.
+  void set_discovery_qos(uint8_t qos) { this->discovery_info_.qos = qos; }
+  /// Set whether to skip discovery messages that are unchanged since the broker received them on a reconnect.
+  void set_discovery_skip_unchanged(bool skip_unchanged) { this->discovery_info_.skip_unchanged = skip_unchanged; }
+  /// Set the number of discovery and initial state messages published per loop after a (re)connect.
+  void set_discovery_publish_budget(uint8_t budget) { this->discovery_publish_budget_ = budget; }
   /// Get Home Assistant discovery info.
   const MQTTDiscoveryInfo &get_discovery_info() const;
   /// Globally disable Home Assistant discovery.
@@ -142,7 +152,7 @@ class MQTTClientComponent : public Component {
 
   /** Subscribe to an MQTT topic and call callback when a message is received.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain the wildcards '+' and '#'.
    * @param callback The callback function.
    * @param qos The QoS of this subscription.
    */
@@ -152,7 +162,7 @@ class MQTTClientComponent : public Component {
    *
    * If an invalid JSON payload is received, the callback will not be called.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain the wildcards '+' and '#'.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
    * received.
    * @param qos The QoS of this subscription.
@@ -185,6 +195,14 @@ class MQTTClientComponent : public Component {
   bool publish(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos = 0,
                bool retain = false);
 
+  /** Publish the discovery message of a component with the discovery QoS and retain.
+   *
+   * Once the broker received it (for QoS 0 once it's sent), the hash is reported to the component with
+   * MQTTComponent::on_discovery_published_(). If it's not acknowledged in time, a resend is scheduled.
+   */
+  bool publish_discovery(MQTTComponent *component, const std::string &topic, const char *payload,
+                         size_t payload_length, uint32_t hash);
+
   /** Construct and send a JSON MQTT message.
    *
    * @param topic The topic.
@@ -211,6 +229,9 @@ class MQTTClientComponent : public Component {
 
   void register_mqtt_component(MQTTComponent *component);
 
+  /// Queue a component to publish its discovery and state, see MQTTComponent::schedule_resend_state().
+  void queue_resend_state(MQTTComponent *component);
+
   bool is_connected();
 
   void on_shutdown() override;
@@ -235,9 +256,16 @@ class MQTTClientComponent : public Component {
   /// Re-calculate the availability property.
   void recalculate_availability_();
 
+  /// Publish a message, returns the packet id (1 for QoS 0) or 0 if it couldn't be sent.
+  uint16_t publish_(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos, bool retain);
+  /// Publish the queued discovery and state messages, at most discovery_publish_budget_ per call.
+  void send_scheduled_states_();
+
   bool subscribe_(const char *topic, uint8_t qos);
   void resubscribe_subscription_(MQTTSubscription *sub);
   void resubscribe_subscriptions_();
+  /// Whether there's nothing to send or retry, so that the loop only needs to check the connection.
+  bool is_idle_() const;
 
   MQTTCredentials credentials_;
   /// The last will message. Disabled optional denotes it being default and
@@ -256,13 +284,25 @@ class MQTTClientComponent : public Component {
       .prefix = "homeassistant",
       .retain = true,
       .clean = false,
+      .qos = 0,
+      .skip_unchanged = false,
   };
+  /// Components waiting to publish their discovery and state, the ones before resend_queue_head_ are done.
+  std::vector<MQTTComponent *> resend_queue_;
+  size_t resend_queue_head_{0};
+  uint8_t discovery_publish_budget_{4};
+  /// The discovery messages published with QoS 1 or 2 that weren't acknowledged yet.
+  MQTTPublishTracker publish_tracker_;
   std::string topic_prefix_{};
   MQTTMessage log_message_;
   std::string payload_buffer_;
   int log_level_{ESPHOME_LOG_LEVEL};
 
   std::vector<MQTTSubscription> subscriptions_;
+  /// Index of subscriptions_ by topic, the values are the indices into subscriptions_.
+  MQTTTopicTrie subscription_trie_;
+  /// Subscriptions matching the topic of the message that is dispatched, kept to avoid allocating for every message.
+  std::vector<size_t> matching_subscriptions_;
   AsyncMqttClient mqtt_client_;
   MQTTClientState state_{MQTT_CLIENT_DISCONNECTED};
   IPAddress ip_;
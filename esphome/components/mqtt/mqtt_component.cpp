@@ -18,19 +18,22 @@ std::string MQTTComponent::get_discovery_topic_(const MQTTDiscoveryInfo &discove
 }
 
 std::string MQTTComponent::get_default_topic_for_(const std::string &suffix) const {
-  return global_mqtt_client->get_topic_prefix() + "/" + this->component_type() + "/" + this->get_default_object_id_() +
-         "/" + suffix;
+  if (this->default_topic_base_.empty()) {
+    this->default_topic_base_ = global_mqtt_client->get_topic_prefix() + "/" + this->component_type() + "/" +
+                                this->get_default_object_id_() + "/";
+  }
+  return this->default_topic_base_ + suffix;
 }
 
-const std::string MQTTComponent::get_state_topic_() const {
+const std::string &MQTTComponent::get_state_topic_() const {
   if (this->custom_state_topic_.empty())
-    return this->get_default_topic_for_("state");
+    this->custom_state_topic_ = this->get_default_topic_for_("state");
   return this->custom_state_topic_;
 }
 
-const std::string MQTTComponent::get_command_topic_() const {
+const std::string &MQTTComponent::get_command_topic_() const {
   if (this->custom_command_topic_.empty())
-    return this->get_default_topic_for_("command");
+    this->custom_command_topic_ = this->get_default_topic_for_("command");
   return this->custom_command_topic_;
 }
 
@@ -40,12 +43,75 @@ bool MQTTComponent::publish(const std::string &topic, const std::string &payload
   return global_mqtt_client->publish(topic, payload, 0, this->retain_);
 }
 
+bool MQTTComponent::publish_json(const std::string &topic, const json::json_write_t &f) {
+  if (topic.empty())
+    return false;
+  size_t len;
+  const char *message = json::write_json(f, &len);
+  return global_mqtt_client->publish(topic, message, len, 0, this->retain_);
+}
+
 bool MQTTComponent::publish_json(const std::string &topic, const json::json_build_t &f) {
   if (topic.empty())
     return false;
-  return global_mqtt_client->publish_json(topic, f, 0, this->retain_);
+  size_t len;
+  const char *message = json::build_json(f, &len);
+  return global_mqtt_client->publish(topic, message, len, 0, this->retain_);
+}
+
+template<typename T> static void write_legacy_json_leaf(json::JsonWriter &root, const char *key, T value) {
+  if (key == nullptr) {
+    root.add(value);
+  } else {
+    root.set(key, value);
+  }
+}
+/// Copy a value built with ArduinoJson, as member key of the current object or as array element if key is nullptr.
+static void write_legacy_json_value(json::JsonWriter &root, const char *key, const JsonVariant &value) {
+  if (value.is<JsonObject>()) {
+    if (key == nullptr) {
+      root.begin_object();
+    } else {
+      root.begin_object(key);
+    }
+    for (auto kv : value.as<JsonObject>())
+      write_legacy_json_value(root, kv.key, kv.value);
+    root.end_object();
+  } else if (value.is<JsonArray>()) {
+    if (key == nullptr) {
+      root.begin_array();
+    } else {
+      root.begin_array(key);
+    }
+    for (auto element : value.as<JsonArray>())
+      write_legacy_json_value(root, nullptr, element);
+    root.end_array();
+  } else if (value.is<bool>()) {
+    write_legacy_json_leaf(root, key, value.as<bool>());
+  } else if (value.is<long>()) {  // NOLINT(google-runtime-int)
+    // check integers first, they are floats as well
+    write_legacy_json_leaf(root, key, value.as<long>());  // NOLINT(google-runtime-int)
+  } else if (value.is<float>()) {
+    write_legacy_json_leaf(root, key, value.as<float>());
+  } else if (value.is<const char *>()) {
+    write_legacy_json_leaf(root, key, value.as<const char *>());
+  }
 }
 
+void MQTTComponent::send_discovery(json::JsonWriter &root, SendDiscoveryConfig &config) {
+  ESP_LOGW(TAG, "'%s': send_discovery(JsonObject &) is deprecated, override send_discovery(json::JsonWriter &)",
+           this->friendly_name().c_str());
+  json::global_json_buffer.clear();
+  JsonObject &object = json::global_json_buffer.createObject();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+  this->send_discovery(object, config);
+#pragma GCC diagnostic pop
+  for (auto kv : object)
+    write_legacy_json_value(root, kv.key, kv.value);
+}
+void MQTTComponent::send_discovery(JsonObject &root, SendDiscoveryConfig &config) {}
+
 bool MQTTComponent::send_discovery_() {
   const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
 
@@ -56,58 +122,66 @@ bool MQTTComponent::send_discovery_() {
 
   ESP_LOGV(TAG, "'%s': Sending discovery...", this->friendly_name().c_str());
 
-  return global_mqtt_client->publish_json(
-      this->get_discovery_topic_(discovery_info),
-      [this](JsonObject &root) {
+  // The payload is serialized while it's written, so the members added here come after the ones of the component
+  size_t len;
+  const char *message = json::write_json(
+      [this](json::JsonWriter &root) {
         SendDiscoveryConfig config;
         config.state_topic = true;
         config.command_topic = true;
 
         this->send_discovery(root, config);
 
-        std::string name = this->friendly_name();
-        root["name"] = name;
+        root.set("name", this->friendly_name());
         if (config.state_topic)
-          root["state_topic"] = this->get_state_topic_();
+          root.set("state_topic", this->get_state_topic_());
         if (config.command_topic)
-          root["command_topic"] = this->get_command_topic_();
+          root.set("command_topic", this->get_command_topic_());
 
         if (this->availability_ == nullptr) {
           if (!global_mqtt_client->get_availability().topic.empty()) {
-            root["availability_topic"] = global_mqtt_client->get_availability().topic;
+            root.set("availability_topic", global_mqtt_client->get_availability().topic);
             if (global_mqtt_client->get_availability().payload_available != "online")
-              root["payload_available"] = global_mqtt_client->get_availability().payload_available;
+              root.set("payload_available", global_mqtt_client->get_availability().payload_available);
             if (global_mqtt_client->get_availability().payload_not_available != "offline")
-              root["payload_not_available"] = global_mqtt_client->get_availability().payload_not_available;
+              root.set("payload_not_available", global_mqtt_client->get_availability().payload_not_available);
           }
         } else if (!this->availability_->topic.empty()) {
-          root["availability_topic"] = this->availability_->topic;
+          root.set("availability_topic", this->availability_->topic);
           if (this->availability_->payload_available != "online")
-            root["payload_available"] = this->availability_->payload_available;
+            root.set("payload_available", this->availability_->payload_available);
           if (this->availability_->payload_not_available != "offline")
-            root["payload_not_available"] = this->availability_->payload_not_available;
+            root.set("payload_not_available", this->availability_->payload_not_available);
         }
 
         const std::string &node_name = App.get_name();
         std::string unique_id = this->unique_id();
         if (!unique_id.empty()) {
-          root["unique_id"] = unique_id;
+          root.set("unique_id", unique_id);
         } else {
           // default to almost-unique ID. It's a hack but the only way to get that
           // gorgeous device registry view.
-          root["unique_id"] = "ESP" + this->component_type() + this->get_default_object_id_();
+          root.set("unique_id", "ESP" + this->component_type() + this->get_default_object_id_());
         }
 
-        JsonObject &device_info = root.createNestedObject("device");
-        device_info["identifiers"] = get_mac_address();
-        device_info["name"] = node_name;
-        device_info["sw_version"] = "esphome v" ESPHOME_VERSION " " + App.get_compilation_time();
+        root.begin_object("device");
+        root.set("identifiers", get_mac_address());
+        root.set("name", node_name);
+        root.set("sw_version", "esphome v" ESPHOME_VERSION " " + App.get_compilation_time());
 #ifdef ARDUINO_BOARD
-        device_info["model"] = ARDUINO_BOARD;
+        root.set("model", ARDUINO_BOARD);
 #endif
-        device_info["manufacturer"] = "espressif";
+        root.set("manufacturer", "espressif");
+        root.end_object();
       },
-      0, discovery_info.retain);
+      &len);
+
+  const uint32_t hash = fnv1_hash(message, len);
+  if (discovery_info.skip_unchanged && hash == this->discovery_hash_) {
+    ESP_LOGV(TAG, "'%s': Discovery unchanged, skipping", this->friendly_name().c_str());
+    return true;
+  }
+  return global_mqtt_client->publish_discovery(this, this->get_discovery_topic_(discovery_info), message, len, hash);
 }
 
 bool MQTTComponent::get_retain() const { return this->retain_; }
@@ -156,40 +230,48 @@ void MQTTComponent::call_setup() {
 
   global_mqtt_client->register_mqtt_component(this);
 
-  if (!this->is_connected_())
-    return;
-
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
-  if (!this->send_initial_state()) {
+  // On (re)connect the client schedules the resend itself
+  if (this->is_connected_())
     this->schedule_resend_state();
-  }
 }
 
 void MQTTComponent::call_loop() {
-  if (this->is_internal())
+  // The MQTT components only have work to do in callbacks, unless a subclass implements loop()
+  if (this->is_internal() || !this->is_loop_overridden_()) {
+    this->set_loop_wake_hint(WAKE_HINT_ON_EVENT);
     return;
+  }
 
   this->loop();
-
-  if (!this->resend_state_ || !this->is_connected_()) {
+}
+void MQTTComponent::schedule_resend_state() {
+  this->resend_discovery_ = true;
+  if (this->resend_state_)
     return;
+  this->resend_state_ = true;
+  global_mqtt_client->queue_resend_state(this);
+}
+MQTTComponent::ScheduledStateResult MQTTComponent::send_scheduled_state_(uint8_t *budget) {
+  if (this->resend_discovery_) {
+    if (this->is_discovery_enabled()) {
+      if (*budget == 0)
+        return ScheduledStateResult::BUDGET_EXHAUSTED;
+      (*budget)--;
+      if (!this->send_discovery_())
+        return ScheduledStateResult::FAILED;
+    }
+    this->resend_discovery_ = false;
   }
 
+  if (*budget == 0)
+    return ScheduledStateResult::BUDGET_EXHAUSTED;
+  (*budget)--;
+  if (!this->send_initial_state())
+    return ScheduledStateResult::FAILED;
   this->resend_state_ = false;
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
-  if (!this->send_initial_state()) {
-    this->schedule_resend_state();
-  }
+  return ScheduledStateResult::DONE;
 }
-void MQTTComponent::schedule_resend_state() { this->resend_state_ = true; }
+void MQTTComponent::on_discovery_published_(uint32_t hash) { this->discovery_hash_ = hash; }
 std::string MQTTComponent::unique_id() { return ""; }
 bool MQTTComponent::is_connected_() const { return global_mqtt_client->is_connected(); }
 
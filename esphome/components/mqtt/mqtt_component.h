@@ -20,15 +20,16 @@ struct SendDiscoveryConfig {
     ESP_LOGCONFIG(TAG, "  Command Topic: '%s'", this->get_command_topic_().c_str()); \
   }
 
+// The default topic is built on first use and kept in the custom topic.
 #define MQTT_COMPONENT_CUSTOM_TOPIC_(name, type) \
  protected: \
-  std::string custom_##name##_##type##_topic_{}; \
+  mutable std::string custom_##name##_##type##_topic_{}; \
 \
  public: \
   void set_custom_##name##_##type##_topic(const std::string &topic) { this->custom_##name##_##type##_topic_ = topic; } \
-  const std::string get_##name##_##type##_topic() const { \
+  const std::string &get_##name##_##type##_topic() const { \
     if (this->custom_##name##_##type##_topic_.empty()) \
-      return this->get_default_topic_for_(#name "/" #type); \
+      this->custom_##name##_##type##_topic_ = this->get_default_topic_for_(#name "/" #type); \
     return this->custom_##name##_##type##_topic_; \
   }
 
@@ -60,8 +61,18 @@ class MQTTComponent : public Component {
 
   void call_loop() override;
 
-  /// Send discovery info the Home Assistant, override this.
-  virtual void send_discovery(JsonObject &root, SendDiscoveryConfig &config) = 0;
+  /** Send discovery info the Home Assistant, override this.
+   *
+   * The default implementation falls back to the deprecated send_discovery(JsonObject &, SendDiscoveryConfig &) for
+   * components that haven't been ported yet.
+   */
+  virtual void send_discovery(json::JsonWriter &root, SendDiscoveryConfig &config);
+
+  /// Deprecated: only called if send_discovery(json::JsonWriter &, SendDiscoveryConfig &) isn't overridden.
+  ESPDEPRECATED("send_discovery(JsonObject &, SendDiscoveryConfig &) is deprecated, override "
+                "send_discovery(json::JsonWriter &, SendDiscoveryConfig &) instead",
+                "2021.9")
+  virtual void send_discovery(JsonObject &root, SendDiscoveryConfig &config);
 
   virtual bool send_initial_state() = 0;
 
@@ -93,9 +104,30 @@ class MQTTComponent : public Component {
   void set_availability(std::string topic, std::string payload_available, std::string payload_not_available);
   void disable_availability();
 
-  /// Internal method for the MQTT client base to schedule a resend of the state on reconnect.
+  /** Schedule a resend of the discovery and the state, e.g. on reconnect.
+   *
+   * The MQTT client publishes the scheduled messages of all components a few per loop, see send_scheduled_state_().
+   */
   void schedule_resend_state();
 
+  enum class ScheduledStateResult : uint8_t {
+    /// The discovery and the state were published.
+    DONE,
+    /// The budget ran out, the remaining messages are published by the next call.
+    BUDGET_EXHAUSTED,
+    /// A publish failed, the remaining messages are published by the next call.
+    FAILED,
+  };
+
+  /** Internal method for the MQTT client to publish the discovery and the initial state scheduled to be resent.
+   *
+   * @param budget The number of messages that may be published, decremented for every message published.
+   */
+  ScheduledStateResult send_scheduled_state_(uint8_t *budget);
+
+  /// Internal method for the MQTT client, called when the broker received the discovery payload with the given hash.
+  void on_discovery_published_(uint32_t hash);
+
   /** Send a MQTT message.
    *
    * @param topic The topic.
@@ -103,16 +135,23 @@ class MQTTComponent : public Component {
    */
   bool publish(const std::string &topic, const std::string &payload);
 
-  /** Construct and send a JSON MQTT message.
+  /** Construct and send a JSON MQTT message, the JSON is serialized while it's written.
+   *
+   * @param topic The topic.
+   * @param f Writes the members of the JSON object.
+   */
+  bool publish_json(const std::string &topic, const json::json_write_t &f);
+
+  /** Construct and send a JSON MQTT message from an ArduinoJson object.
    *
    * @param topic The topic.
-   * @param f The Json Message builder.
+   * @param f Builds the JSON object.
    */
   bool publish_json(const std::string &topic, const json::json_build_t &f);
 
   /** Subscribe to a MQTT topic.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain the wildcards '+' and '#'.
    * @param callback The callback that will be called when a message with matching topic is received.
    * @param qos The MQTT quality of service. Defaults to 0.
    */
@@ -122,7 +161,7 @@ class MQTTComponent : public Component {
    *
    * If an invalid JSON payload is received, the callback will not be called.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain the wildcards '+' and '#'.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
    * received.
    * @param qos The MQTT quality of service. Defaults to 0.
@@ -151,10 +190,10 @@ class MQTTComponent : public Component {
   virtual std::string unique_id();
 
   /// Get the MQTT topic that new states will be shared to.
-  const std::string get_state_topic_() const;
+  const std::string &get_state_topic_() const;
 
   /// Get the MQTT topic for listening to commands.
-  const std::string get_command_topic_() const;
+  const std::string &get_command_topic_() const;
 
   bool is_connected_() const;
 
@@ -167,12 +206,19 @@ class MQTTComponent : public Component {
   std::string get_default_object_id_() const;
 
  protected:
-  std::string custom_state_topic_{};
-  std::string custom_command_topic_{};
+  /// The custom topics, or the default topic once it was built.
+  mutable std::string custom_state_topic_{};
+  mutable std::string custom_command_topic_{};
+  /// "<topic prefix>/<component type>/<object id>/", built on first use.
+  mutable std::string default_topic_base_{};
   bool retain_{true};
   bool discovery_enabled_{true};
   Availability *availability_{nullptr};
+  /// Whether a resend of the discovery and the state is scheduled, and which of them is still pending.
   bool resend_state_{false};
+  bool resend_discovery_{false};
+  /// Hash of the last discovery payload received by the broker, to skip publishing it again if it didn't change.
+  uint32_t discovery_hash_{0};
 };
 
 }  // namespace mqtt
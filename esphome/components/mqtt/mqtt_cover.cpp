@@ -60,21 +60,21 @@ void MQTTCoverComponent::dump_config() {
     ESP_LOGCONFIG(TAG, "  Tilt Command Topic: '%s'", this->get_tilt_command_topic().c_str());
   }
 }
-void MQTTCoverComponent::send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) {
+void MQTTCoverComponent::send_discovery(json::JsonWriter &root, mqtt::SendDiscoveryConfig &config) {
   if (!this->cover_->get_device_class().empty())
-    root["device_class"] = this->cover_->get_device_class();
+    root.set("device_class", this->cover_->get_device_class());
 
   auto traits = this->cover_->get_traits();
   if (traits.get_is_assumed_state()) {
-    root["optimistic"] = true;
+    root.set("optimistic", true);
   }
   if (traits.get_supports_position()) {
-    root["position_topic"] = this->get_position_state_topic();
-    root["set_position_topic"] = this->get_position_command_topic();
+    root.set("position_topic", this->get_position_state_topic());
+    root.set("set_position_topic", this->get_position_command_topic());
   }
   if (traits.get_supports_tilt()) {
-    root["tilt_status_topic"] = this->get_tilt_state_topic();
-    root["tilt_command_topic"] = this->get_tilt_command_topic();
+    root.set("tilt_status_topic", this->get_tilt_state_topic());
+    root.set("tilt_command_topic", this->get_tilt_command_topic());
   }
   if (traits.get_supports_tilt() && !traits.get_supports_position()) {
     config.command_topic = false;
@@ -28,45 +28,47 @@ MQTTJSONLightComponent::MQTTJSONLightComponent(LightState *state) : MQTTComponen
 
 bool MQTTJSONLightComponent::publish_state_() {
   return this->publish_json(this->get_state_topic_(),
-                            [this](JsonObject &root) { LightJSONSchema::dump_json(*this->state_, root); });
+                            [this](json::JsonWriter &root) { LightJSONSchema::dump_json(*this->state_, root); });
 }
 LightState *MQTTJSONLightComponent::get_state() const { return this->state_; }
 std::string MQTTJSONLightComponent::friendly_name() const { return this->state_->get_name(); }
-void MQTTJSONLightComponent::send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) {
-  root["schema"] = "json";
+void MQTTJSONLightComponent::send_discovery(json::JsonWriter &root, mqtt::SendDiscoveryConfig &config) {
+  root.set("schema", "json");
   auto traits = this->state_->get_traits();
 
-  root["color_mode"] = true;
-  JsonArray &color_modes = root.createNestedArray("supported_color_modes");
+  root.set("color_mode", true);
+  root.begin_array("supported_color_modes");
   if (traits.supports_color_mode(ColorMode::COLOR_TEMPERATURE))
-    color_modes.add("color_temp");
+    root.add("color_temp");
   if (traits.supports_color_mode(ColorMode::RGB))
-    color_modes.add("rgb");
+    root.add("rgb");
   if (traits.supports_color_mode(ColorMode::RGB_WHITE))
-    color_modes.add("rgbw");
+    root.add("rgbw");
   if (traits.supports_color_mode(ColorMode::RGB_COLD_WARM_WHITE))
-    color_modes.add("rgbww");
+    root.add("rgbww");
   if (traits.supports_color_mode(ColorMode::BRIGHTNESS))
-    color_modes.add("brightness");
+    root.add("brightness");
   if (traits.supports_color_mode(ColorMode::ON_OFF))
-    color_modes.add("onoff");
+    root.add("onoff");
+  root.end_array();
 
   // legacy API
   if (traits.supports_color_capability(ColorCapability::BRIGHTNESS))
-    root["brightness"] = true;
+    root.set("brightness", true);
   if (traits.supports_color_capability(ColorCapability::RGB))
-    root["rgb"] = true;
+    root.set("rgb", true);
   if (traits.supports_color_capability(ColorCapability::COLOR_TEMPERATURE))
-    root["color_temp"] = true;
+    root.set("color_temp", true);
   if (traits.supports_color_capability(ColorCapability::WHITE))
-    root["white_value"] = true;
+    root.set("white_value", true);
 
   if (this->state_->supports_effects()) {
-    root["effect"] = true;
-    JsonArray &effect_list = root.createNestedArray("effect_list");
+    root.set("effect", true);
+    root.begin_array("effect_list");
     for (auto *effect : this->state_->get_effects())
-      effect_list.add(effect->get_name());
-    effect_list.add("None");
+      root.add(effect->get_name());
+    root.add("None");
+    root.end_array();
   }
 }
 bool MQTTJSONLightComponent::send_initial_state() { return this->publish_state_(); }
@@ -0,0 +1,65 @@
+#include "mqtt_publish_tracker.h"
+
+namespace esphome {
+namespace mqtt {
+
+void MQTTPublishTracker::track(uint16_t packet_id, MQTTComponent *component, uint32_t hash, uint32_t now) {
+  if (this->is_full())
+    return;
+  this->messages_[this->size_++] = Message{
+      .packet_id = packet_id,
+      .component = component,
+      .hash = hash,
+      .sent_at = now,
+  };
+}
+void MQTTPublishTracker::on_ack(uint16_t packet_id) {
+  const uint8_t head = this->ack_head_.load(std::memory_order_relaxed);
+  const uint8_t next = (head + 1) % ACK_QUEUE_SIZE;
+  if (next == this->ack_tail_.load(std::memory_order_acquire)) {
+    // The message will time out and be published again
+    this->dropped_acks_++;
+    return;
+  }
+  this->acks_[head] = packet_id;
+  this->ack_head_.store(next, std::memory_order_release);
+}
+void MQTTPublishTracker::process(uint32_t now, uint32_t timeout, const result_t &result) {
+  const uint8_t head = this->ack_head_.load(std::memory_order_acquire);
+  uint8_t tail = this->ack_tail_.load(std::memory_order_relaxed);
+  for (; tail != head; tail = (tail + 1) % ACK_QUEUE_SIZE) {
+    const uint16_t packet_id = this->acks_[tail];
+    for (uint8_t i = 0; i < this->size_; i++) {
+      if (this->messages_[i].packet_id != packet_id)
+        continue;
+      const Message message = this->messages_[i];
+      this->remove_(i);
+      result(message, true);
+      break;
+    }
+  }
+  this->ack_tail_.store(tail, std::memory_order_release);
+
+  for (uint8_t i = 0; i < this->size_;) {
+    if (now - this->messages_[i].sent_at < timeout) {
+      i++;
+      continue;
+    }
+    const Message message = this->messages_[i];
+    this->remove_(i);
+    result(message, false);
+  }
+}
+void MQTTPublishTracker::clear() {
+  this->size_ = 0;
+  this->ack_tail_.store(this->ack_head_.load(std::memory_order_acquire), std::memory_order_release);
+}
+void MQTTPublishTracker::remove_(uint8_t index) {
+  // Keep the order of publishing, so that the messages time out in order
+  for (uint8_t i = index + 1; i < this->size_; i++)
+    this->messages_[i - 1] = this->messages_[i];
+  this->size_--;
+}
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace esphome {
+namespace mqtt {
+
+class MQTTComponent;
+
+/** Tracks the messages published with QoS 1 or 2 until the broker acknowledges them.
+ *
+ * The acknowledgements are reported from the network task with on_ack(). They are handed to the loop through a
+ * single producer, single consumer queue and only matched against the tracked messages in process(), so the
+ * tracked messages are only ever touched by the loop.
+ */
+class MQTTPublishTracker {
+ public:
+  /// The maximum number of messages in flight, publishing more has to wait for acknowledgements.
+  static const uint8_t MAX_IN_FLIGHT = 16;
+
+  struct Message {
+    uint16_t packet_id;
+    /// The component that published the message.
+    MQTTComponent *component;
+    /// Hash of the payload of the message.
+    uint32_t hash;
+    /// Time of the publish in milliseconds.
+    uint32_t sent_at;
+  };
+  /// Called for each message that was acknowledged (true) or timed out (false).
+  using result_t = std::function<void(const Message &message, bool acknowledged)>;
+
+  void track(uint16_t packet_id, MQTTComponent *component, uint32_t hash, uint32_t now);
+  /// Report the acknowledgement of packet_id, may be called from any task.
+  void on_ack(uint16_t packet_id);
+  /// Report the messages acknowledged since the last call and the ones not acknowledged within timeout ms.
+  void process(uint32_t now, uint32_t timeout, const result_t &result);
+  /// Forget all tracked messages and pending acknowledgements, for example because the connection was lost.
+  void clear();
+
+  bool is_full() const { return this->size_ == MAX_IN_FLIGHT; }
+  size_t size() const { return this->size_; }
+  /// The number of acknowledgements dropped because the queue was full.
+  uint32_t get_dropped_acks() const { return this->dropped_acks_; }
+
+ protected:
+  /// Size of the acknowledgement queue, a power of two.
+  static const uint8_t ACK_QUEUE_SIZE = 32;
+
+  void remove_(uint8_t index);
+
+  Message messages_[MAX_IN_FLIGHT];
+  uint8_t size_{0};
+
+  uint16_t acks_[ACK_QUEUE_SIZE];
+  /// Written by the producer (on_ack()) only.
+  std::atomic<uint8_t> ack_head_{0};
+  /// Written by the consumer (process()) only.
+  std::atomic<uint8_t> ack_tail_{0};
+  uint32_t dropped_acks_{0};
+};
+
+}  // namespace mqtt
+}  // namespace esphome
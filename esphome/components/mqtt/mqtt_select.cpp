@@ -29,14 +29,15 @@ void MQTTSelectComponent::dump_config() {
 std::string MQTTSelectComponent::component_type() const { return "select"; }
 
 std::string MQTTSelectComponent::friendly_name() const { return this->select_->get_name(); }
-void MQTTSelectComponent::send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) {
+void MQTTSelectComponent::send_discovery(json::JsonWriter &root, mqtt::SendDiscoveryConfig &config) {
   const auto &traits = select_->traits;
   // https://www.home-assistant.io/integrations/select.mqtt/
   if (!traits.get_icon().empty())
-    root["icon"] = traits.get_icon();
-  JsonArray &options = root.createNestedArray("options");
+    root.set("icon", traits.get_icon());
+  root.begin_array("options");
   for (const auto &option : traits.get_options())
-    options.add(option);
+    root.add(option);
+  root.end_array();
 
   config.command_topic = true;
 }
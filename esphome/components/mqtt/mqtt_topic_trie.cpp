@@ -0,0 +1,91 @@
+#include "mqtt_topic_trie.h"
+#include <algorithm>
+
+namespace esphome {
+namespace mqtt {
+
+/// Compare the level of a node with a level of a topic, like std::string::compare.
+static int compare_level(const std::string &node_level, const char *level, size_t length) {
+  return node_level.compare(0, std::string::npos, level, length);
+}
+/// Find the first child in the sorted range [begin, end) whose level is not less than the given level.
+template<typename It> static It lower_bound_level(It begin, It end, const char *level, size_t length) {
+  return std::lower_bound(begin, end, 0, [level, length](const typename It::value_type &child, int) {
+    return compare_level(child->level, level, length) < 0;
+  });
+}
+
+void MQTTTopicTrie::insert(const std::string &filter, size_t value) {
+  Node *node = &this->root_;
+  const char *level = filter.c_str();
+  const char *end = level + filter.size();
+  while (true) {
+    const char *separator = std::find(level, end, '/');
+    const size_t length = separator - level;
+    if (length == 1 && *level == '#' && separator == end) {
+      node->multi_level_values.push_back(value);
+      break;
+    }
+    if (length == 1 && *level == '+') {
+      if (node->single_level == nullptr)
+        node->single_level.reset(new Node());  // NOLINT(cppcoreguidelines-owning-memory)
+      node = node->single_level.get();
+    } else {
+      node = find_or_add_child_(node, level, length);
+    }
+    if (separator == end) {
+      node->values.push_back(value);
+      break;
+    }
+    level = separator + 1;
+  }
+  this->size_++;
+}
+void MQTTTopicTrie::clear() {
+  this->root_ = Node();
+  this->size_ = 0;
+}
+void MQTTTopicTrie::match(const std::string &topic, std::vector<size_t> *values) const {
+  match_(this->root_, topic.c_str(), topic.c_str() + topic.size(), true, values);
+}
+
+void MQTTTopicTrie::match_(const Node &node, const char *level, const char *end, bool first_level,
+                           std::vector<size_t> *values) {
+  if (level == nullptr) {
+    // All levels consumed, "a/#" matches "a" as well
+    values->insert(values->end(), node.values.begin(), node.values.end());
+    values->insert(values->end(), node.multi_level_values.begin(), node.multi_level_values.end());
+    return;
+  }
+
+  const bool wildcards = !first_level || *level != '$';
+  if (wildcards)
+    values->insert(values->end(), node.multi_level_values.begin(), node.multi_level_values.end());
+
+  const char *separator = std::find(level, end, '/');
+  const char *next = separator == end ? nullptr : separator + 1;
+  const Node *child = find_child_(node, level, separator - level);
+  if (child != nullptr)
+    match_(*child, next, end, false, values);
+  if (wildcards && node.single_level != nullptr)
+    match_(*node.single_level, next, end, false, values);
+}
+
+MQTTTopicTrie::Node *MQTTTopicTrie::find_or_add_child_(Node *node, const char *level, size_t length) {
+  auto it = lower_bound_level(node->children.begin(), node->children.end(), level, length);
+  if (it != node->children.end() && compare_level((*it)->level, level, length) == 0)
+    return it->get();
+
+  std::unique_ptr<Node> child(new Node());  // NOLINT(cppcoreguidelines-owning-memory)
+  child->level.assign(level, length);
+  return node->children.insert(it, std::move(child))->get();
+}
+const MQTTTopicTrie::Node *MQTTTopicTrie::find_child_(const Node &node, const char *level, size_t length) {
+  auto it = lower_bound_level(node.children.begin(), node.children.end(), level, length);
+  if (it != node.children.end() && compare_level((*it)->level, level, length) == 0)
+    return it->get();
+  return nullptr;
+}
+
+}  // namespace mqtt
+}  // namespace esphome
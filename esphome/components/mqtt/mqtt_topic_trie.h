@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace mqtt {
+
+/** Index of the topic filters of the MQTT subscriptions, to find the subscriptions matching a received topic.
+ *
+ * The filters are stored as a trie over their topic levels. Matching a topic walks its levels once, following the
+ * literal child and the '+' child of each node and collecting the '#' filters on the way, instead of matching the
+ * topic against every filter.
+ *
+ * The semantics follow the MQTT specification:
+ * - '+' matches exactly one (possibly empty) level.
+ * - '#' matches any number of levels, including the parent level: "a/#" matches "a", "a/b" and "a/b/c".
+ * - Topics starting with '$' are not matched by a wildcard in the first level, "#" does not match "$SYS/info".
+ * A '+' or '#' that is not a whole level (or a '#' that is not the last level) is matched literally.
+ */
+class MQTTTopicTrie {
+ public:
+  /// Add a topic filter, match() reports value for every topic matching it.
+  void insert(const std::string &filter, size_t value);
+  /// Remove all filters.
+  void clear();
+  /// Append the values of all filters matching topic to values, in no particular order.
+  void match(const std::string &topic, std::vector<size_t> *values) const;
+
+  size_t size() const { return this->size_; }
+
+ protected:
+  struct Node {
+    std::string level;
+    /// Children for literal levels, sorted by level.
+    std::vector<std::unique_ptr<Node>> children;
+    /// Child for a '+' level.
+    std::unique_ptr<Node> single_level;
+    /// Values of the filters ending at this node.
+    std::vector<size_t> values;
+    /// Values of the filters ending with a '#' after this node.
+    std::vector<size_t> multi_level_values;
+  };
+
+  /** Match the levels starting at level against node and its children.
+   *
+   * @param level Start of the next level of the topic, nullptr if all levels were consumed.
+   */
+  static void match_(const Node &node, const char *level, const char *end, bool first_level,
+                     std::vector<size_t> *values);
+  static Node *find_or_add_child_(Node *node, const char *level, size_t length);
+  static const Node *find_child_(const Node &node, const char *level, size_t length);
+
+  Node root_;
+  size_t size_{0};
+};
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -125,6 +125,22 @@ class NeoPixelRGBLightOutput : public NeoPixelBusLightOutputBase<T_METHOD, T_COL
     return light::ESPColorView(base + this->rgb_offsets_[0], base + this->rgb_offsets_[1], base + this->rgb_offsets_[2],
                                nullptr, this->effect_data_ + index, &this->correction_);
   }
+  void fill_internal_(int32_t index, int32_t count, const Color &corrected) override {
+    uint8_t *base = this->controller_->Pixels() + 3ULL * index;
+    for (int32_t i = 0; i < count; i++, base += 3) {
+      base[this->rgb_offsets_[0]] = corrected.red;
+      base[this->rgb_offsets_[1]] = corrected.green;
+      base[this->rgb_offsets_[2]] = corrected.blue;
+    }
+  }
+  void write_internal_(int32_t index, const Color *colors, int32_t count, const uint8_t *table) override {
+    uint8_t *base = this->controller_->Pixels() + 3ULL * index;
+    for (int32_t i = 0; i < count; i++, base += 3) {
+      base[this->rgb_offsets_[0]] = table[colors[i].red];
+      base[this->rgb_offsets_[1]] = table[256 + colors[i].green];
+      base[this->rgb_offsets_[2]] = table[512 + colors[i].blue];
+    }
+  }
 };
 
 template<typename T_METHOD, typename T_COLOR_FEATURE = NeoRgbwFeature>
@@ -142,6 +158,24 @@ class NeoPixelRGBWLightOutput : public NeoPixelBusLightOutputBase<T_METHOD, T_CO
     return light::ESPColorView(base + this->rgb_offsets_[0], base + this->rgb_offsets_[1], base + this->rgb_offsets_[2],
                                base + this->rgb_offsets_[3], this->effect_data_ + index, &this->correction_);
   }
+  void fill_internal_(int32_t index, int32_t count, const Color &corrected) override {
+    uint8_t *base = this->controller_->Pixels() + 4ULL * index;
+    for (int32_t i = 0; i < count; i++, base += 4) {
+      base[this->rgb_offsets_[0]] = corrected.red;
+      base[this->rgb_offsets_[1]] = corrected.green;
+      base[this->rgb_offsets_[2]] = corrected.blue;
+      base[this->rgb_offsets_[3]] = corrected.white;
+    }
+  }
+  void write_internal_(int32_t index, const Color *colors, int32_t count, const uint8_t *table) override {
+    uint8_t *base = this->controller_->Pixels() + 4ULL * index;
+    for (int32_t i = 0; i < count; i++, base += 4) {
+      base[this->rgb_offsets_[0]] = table[colors[i].red];
+      base[this->rgb_offsets_[1]] = table[256 + colors[i].green];
+      base[this->rgb_offsets_[2]] = table[512 + colors[i].blue];
+      base[this->rgb_offsets_[3]] = table[768 + colors[i].white];
+    }
+  }
 };
 
 }  // namespace neopixelbus
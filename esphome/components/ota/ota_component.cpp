@@ -4,6 +4,7 @@
 #include "esphome/core/application.h"
 #include "esphome/core/util.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <MD5Builder.h>
 #ifdef ARDUINO_ARCH_ESP32
@@ -17,6 +18,8 @@ namespace ota {
 static const char *const TAG = "ota";
 
 static const uint8_t OTA_VERSION_1_0 = 1;
+/// How often the server is polled for a new client in tickless idle, the WiFiServer can't wake the loop.
+static const uint32_t ACCEPT_POLL_INTERVAL = 250;
 
 void OTAComponent::setup() {
   this->server_ = new WiFiServer(this->port_);
@@ -46,6 +49,11 @@ void OTAComponent::loop() {
     ESP_LOGI(TAG, "Boot seems successful, resetting boot loop counter.");
     this->clean_rtc();
   }
+
+  uint32_t wake_hint = ACCEPT_POLL_INTERVAL;
+  if (this->has_safe_mode_)
+    wake_hint = std::min<uint32_t>(wake_hint, this->safe_mode_enable_time_ - (millis() - this->safe_mode_start_time_));
+  this->set_loop_wake_hint(wake_hint);
 }
 
 void OTAComponent::handle_() {
@@ -0,0 +1,32 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.const import CONF_ID
+
+CODEOWNERS = ["@esphome/core"]
+
+CONF_FLASH_WRITE_INTERVAL = "flash_write_interval"
+CONF_FLASH_SECTORS = "flash_sectors"
+
+preferences_ns = cg.esphome_ns.namespace("preferences")
+IntervalSyncer = preferences_ns.class_("IntervalSyncer", cg.Component)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(IntervalSyncer),
+        cv.Optional(
+            CONF_FLASH_WRITE_INTERVAL, default="60s"
+        ): cv.positive_time_period_milliseconds,
+        # All sectors but the last one are taken from the end of the filesystem
+        cv.Optional(CONF_FLASH_SECTORS): cv.All(
+            cv.only_on_esp8266, cv.int_range(min=1, max=16)
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_write_interval(config[CONF_FLASH_WRITE_INTERVAL]))
+    if CONF_FLASH_SECTORS in config:
+        cg.add_define("ESPHOME_PREFERENCES_FLASH_SECTORS", config[CONF_FLASH_SECTORS])
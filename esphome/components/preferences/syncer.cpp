@@ -0,0 +1,25 @@
+#include "syncer.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace preferences {
+
+static const char *const TAG = "preferences";
+
+void IntervalSyncer::set_write_interval(uint32_t write_interval) {
+  this->write_interval_ = write_interval;
+  // Already defer the saves of the components set up before this one
+  global_preferences.set_deferred_sync(write_interval != 0);
+}
+void IntervalSyncer::setup() {
+  if (this->write_interval_ != 0)
+    this->set_interval(this->write_interval_, []() { global_preferences.sync(); });
+}
+void IntervalSyncer::dump_config() {
+  ESP_LOGCONFIG(TAG, "Preferences:");
+  ESP_LOGCONFIG(TAG, "  Flash Write Interval: %u ms", this->write_interval_);
+}
+void IntervalSyncer::on_shutdown() { global_preferences.sync(); }
+
+}  // namespace preferences
+}  // namespace esphome
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+namespace preferences {
+
+/// Writes the saved preferences to flash in intervals instead of on every save, and before shutting down.
+class IntervalSyncer : public Component {
+ public:
+  /// Write the preferences every write_interval ms, 0 writes them on every save.
+  void set_write_interval(uint32_t write_interval);
+
+  void setup() override;
+  void dump_config() override;
+  void on_shutdown() override;
+
+ protected:
+  uint32_t write_interval_;
+};
+
+}  // namespace preferences
+}  // namespace esphome
@@ -17,6 +17,8 @@ namespace esphome {
 namespace sntp {
 
 static const char *const TAG = "sntp";
+/// How often the time is checked in tickless idle until it was synchronized the first time.
+static const uint32_t SYNC_POLL_INTERVAL = 1000;
 
 void SNTPComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up SNTP...");
@@ -49,8 +51,12 @@ void SNTPComponent::dump_config() {
 }
 void SNTPComponent::update() {}
 void SNTPComponent::loop() {
-  if (this->has_time_)
+  if (this->has_time_) {
+    this->set_loop_wake_hint(WAKE_HINT_ON_EVENT);
     return;
+  }
+  // Poll for the first synchronization
+  this->set_loop_wake_hint(SYNC_POLL_INTERVAL);
 
   auto time = this->now();
   if (!time.is_valid())
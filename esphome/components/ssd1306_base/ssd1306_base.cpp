@@ -1,6 +1,7 @@
 #include "ssd1306_base.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
+#include <algorithm>
 
 namespace esphome {
 namespace ssd1306_base {
@@ -33,6 +34,7 @@ static const uint8_t SSD1306_NORMAL_DISPLAY = 0xA6;
 
 void SSD1306::setup() {
   this->init_internal_(this->get_buffer_length_());
+  this->init_dirty_area_();
 
   this->command(SSD1306_COMMAND_DISPLAY_OFF);
   this->command(SSD1306_COMMAND_SET_DISPLAY_CLOCK_DIV);
@@ -92,31 +94,43 @@ void SSD1306::setup() {
 
   this->turn_on();
 }
-void SSD1306::display() {
+void SSD1306::display() { this->flush_dirty_(); }
+void SSD1306::flush_window_(int x, int y, int width, int height) {
+  // dirty bands are exactly one page high
+  const uint8_t first_page = y / 8;
+  const uint8_t last_page = (y + height - 1) / 8;
+
   if (this->is_sh1106_()) {
-    this->write_display_data();
+    // SH1106 only supports page addressing, the column address is set for each page
+    const uint8_t column = x + 2;
+    for (uint8_t page = first_page; page <= last_page; page++) {
+      this->command(0xB0 + page);           // row
+      this->command(column & 0x0F);         // lower column
+      this->command(0x10 | (column >> 4));  // higher column
+      this->write_display_data(this->buffer_ + x + page * this->get_width_internal(), width);
+    }
     return;
   }
 
   this->command(SSD1306_COMMAND_COLUMN_ADDRESS);
   switch (this->model_) {
     case SSD1306_MODEL_64_48:
-      this->command(0x20);
-      this->command(0x20 + this->get_width_internal() - 1);
+      this->command(0x20 + x);
+      this->command(0x20 + x + width - 1);
       break;
     default:
-      this->command(0);  // Page start address, 0
-      this->command(this->get_width_internal() - 1);
+      this->command(x);  // Column start address
+      this->command(x + width - 1);
       break;
   }
 
   this->command(SSD1306_COMMAND_PAGE_ADDRESS);
-  // Page start address, 0
-  this->command(0);
-  // Page end address:
-  this->command((this->get_height_internal() / 8) - 1);
+  this->command(first_page);
+  this->command(last_page);
 
-  this->write_display_data();
+  // the address wraps to the next page at the end of the window, so the rows can be written one after another
+  for (uint8_t page = first_page; page <= last_page; page++)
+    this->write_display_data(this->buffer_ + x + page * this->get_width_internal(), width);
 }
 bool SSD1306::is_sh1106_() const {
   return this->model_ == SH1106_MODEL_96_16 || this->model_ == SH1106_MODEL_128_32 ||
@@ -186,16 +200,47 @@ void HOT SSD1306::draw_absolute_pixel_internal(int x, int y, Color color) {
 
   uint16_t pos = x + (y / 8) * this->get_width_internal();
   uint8_t subpos = y & 0x07;
+  uint8_t value = this->buffer_[pos];
   if (color.is_on()) {
-    this->buffer_[pos] |= (1 << subpos);
+    value |= (1 << subpos);
   } else {
-    this->buffer_[pos] &= ~(1 << subpos);
+    value &= ~(1 << subpos);
   }
+  if (value == this->buffer_[pos])
+    return;
+  this->buffer_[pos] = value;
+  this->mark_dirty_(x, y);
 }
 void SSD1306::fill(Color color) {
-  uint8_t fill = color.is_on() ? 0xFF : 0x00;
-  for (uint32_t i = 0; i < this->get_buffer_length_(); i++)
-    this->buffer_[i] = fill;
+  this->fill_rect_internal_(0, 0, this->get_width_internal(), this->get_height_internal(), color);
+}
+void HOT SSD1306::fill_rect_internal_(int x, int y, int width, int height, Color color) {
+  const bool on = color.is_on();
+  for (int page = y / 8; page <= (y + height - 1) / 8; page++) {
+    // the bits of the rows of the rectangle that are in this page
+    const int row_begin = std::max(y, page * 8) - page * 8;
+    const int row_end = std::min(y + height, page * 8 + 8) - page * 8;
+    const uint8_t mask = (0xFF << row_begin) & (0xFF >> (8 - row_end));
+    uint8_t *dst = this->buffer_ + x + page * this->get_width_internal();
+    for (int i = 0; i < width; i++) {
+      const uint8_t value = on ? (dst[i] | mask) : (dst[i] & ~mask);
+      if (value == dst[i])
+        continue;
+      dst[i] = value;
+      this->mark_dirty_(x + i, page * 8);
+    }
+  }
+}
+void HOT SSD1306::draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) {
+  for (int i = 0; i < length; i++, x += step_x, y += step_y) {
+    uint8_t *dst = this->buffer_ + x + (y / 8) * this->get_width_internal();
+    const uint8_t bit = 1 << (y & 0x07);
+    const uint8_t value = colors[i].is_on() ? (*dst | bit) : (*dst & ~bit);
+    if (value == *dst)
+      continue;
+    *dst = value;
+    this->mark_dirty_(x, y);
+  }
 }
 void SSD1306::init_reset_() {
   if (this->reset_pin_ != nullptr) {
@@ -39,12 +39,16 @@ class SSD1306 : public PollingComponent, public display::DisplayBuffer {
 
  protected:
   virtual void command(uint8_t value) = 0;
-  virtual void write_display_data() = 0;
+  /// Write display data, the display's address window is already set up.
+  virtual void write_display_data(const uint8_t *data, size_t len) = 0;
   void init_reset_();
 
   bool is_sh1106_() const;
 
   void draw_absolute_pixel_internal(int x, int y, Color color) override;
+  void fill_rect_internal_(int x, int y, int width, int height, Color color) override;
+  void draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) override;
+  void flush_window_(int x, int y, int width, int height) override;
 
   int get_height_internal() override;
   int get_width_internal() override;
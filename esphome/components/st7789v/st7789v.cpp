@@ -113,6 +113,9 @@ void ST7789V::setup() {
 
   this->init_internal_(this->get_buffer_length_());
   memset(this->buffer_, 0x00, this->get_buffer_length_());
+  // The display was cleared above, it matches the buffer
+  this->init_dirty_area_();
+  this->reset_dirty_area_();
 }
 
 void ST7789V::dump_config() {
@@ -133,11 +136,13 @@ void ST7789V::update() {
 
 void ST7789V::loop() {}
 
-void ST7789V::write_display_data() {
-  uint16_t x1 = 52;   // _offsetx
-  uint16_t x2 = 186;  // _offsetx
-  uint16_t y1 = 40;   // _offsety
-  uint16_t y2 = 279;  // _offsety
+void ST7789V::write_display_data() { this->flush_dirty_(); }
+
+void ST7789V::flush_window_(int x, int y, int width, int height) {
+  uint16_t x1 = 52 + x;  // _offsetx
+  uint16_t x2 = x1 + width - 1;
+  uint16_t y1 = 40 + y;  // _offsety
+  uint16_t y2 = y1 + height - 1;
 
   this->enable();
 
@@ -156,7 +161,9 @@ void ST7789V::write_display_data() {
   this->write_byte(ST7789_RAMWR);
   this->dc_pin_->digital_write(true);
 
-  this->write_array(this->buffer_, this->get_buffer_length_());
+  const size_t row_length = size_t(width) * 2;
+  for (int row = y; row < y + height; row++)
+    this->write_array(this->buffer_ + (x + row * this->get_width_internal()) * 2, row_length);
 
   this->disable();
 }
@@ -266,8 +273,43 @@ void HOT ST7789V::draw_absolute_pixel_internal(int x, int y, Color color) {
   auto color565 = display::ColorUtil::color_to_565(color);
 
   uint16_t pos = (x + y * this->get_width_internal()) * 2;
-  this->buffer_[pos++] = (color565 >> 8) & 0xff;
-  this->buffer_[pos] = color565 & 0xff;
+  const uint8_t high = (color565 >> 8) & 0xff;
+  const uint8_t low = color565 & 0xff;
+  if (this->buffer_[pos] == high && this->buffer_[pos + 1] == low)
+    return;
+  this->buffer_[pos++] = high;
+  this->buffer_[pos] = low;
+  this->mark_dirty_(x, y);
+}
+
+void HOT ST7789V::fill_rect_internal_(int x, int y, int width, int height, Color color) {
+  const uint16_t color565 = display::ColorUtil::color_to_565(color);
+  const uint8_t high = color565 >> 8;
+  const uint8_t low = color565 & 0xff;
+  for (int row = y; row < y + height; row++) {
+    uint8_t *dst = this->buffer_ + (x + row * this->get_width_internal()) * 2;
+    for (int i = 0; i < width; i++, dst += 2) {
+      if (dst[0] == high && dst[1] == low)
+        continue;
+      dst[0] = high;
+      dst[1] = low;
+      this->mark_dirty_(x + i, row);
+    }
+  }
+}
+
+void HOT ST7789V::draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) {
+  uint8_t *dst = this->buffer_ + (x + y * this->get_width_internal()) * 2;
+  const int step = (step_x + step_y * this->get_width_internal()) * 2;
+  for (int i = 0; i < length; i++) {
+    const uint16_t color565 = display::ColorUtil::color_to_565(colors[i]);
+    uint8_t *pixel = dst + i * step;
+    if (pixel[0] == (color565 >> 8) && pixel[1] == (color565 & 0xff))
+      continue;
+    pixel[0] = color565 >> 8;
+    pixel[1] = color565 & 0xff;
+    this->mark_dirty_(x + i * step_x, y + i * step_y);
+  }
 }
 
 }  // namespace st7789v
@@ -145,6 +145,9 @@ class ST7789V : public PollingComponent,
   void draw_filled_rect_(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
 
   void draw_absolute_pixel_internal(int x, int y, Color color) override;
+  void fill_rect_internal_(int x, int y, int width, int height, Color color) override;
+  void draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) override;
+  void flush_window_(int x, int y, int width, int height) override;
 };
 
 }  // namespace st7789v
@@ -1,6 +1,8 @@
 #include "automation.h"
 #include "esphome/core/log.h"
 
+#include <sys/time.h>
+
 namespace esphome {
 namespace time {
 
@@ -17,6 +19,11 @@ bool CronTrigger::matches(const ESPTime &time) {
          this->days_of_month_[time.day_of_month] && this->months_[time.month] && this->days_of_week_[time.day_of_week];
 }
 void CronTrigger::loop() {
+  // The time only has to be checked again at the next second
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  this->set_loop_wake_hint(1000 - tv.tv_usec / 1000);
+
   ESPTime time = this->rtc_->now();
   if (!time.is_valid())
     return;
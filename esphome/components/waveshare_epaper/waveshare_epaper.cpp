@@ -84,6 +84,7 @@ static const uint8_t PARTIAL_UPDATE_LUT_TTGO_B1[LUT_SIZE_TTGO_B1] = {
 
 void WaveshareEPaper::setup_pins_() {
   this->init_internal_(this->get_buffer_length_());
+  this->init_dirty_area_();
   this->dc_pin_->setup();  // OUTPUT
   this->dc_pin_->digital_write(false);
   if (this->reset_pin_ != nullptr) {
@@ -125,13 +126,22 @@ bool WaveshareEPaper::wait_until_idle_() {
 }
 void WaveshareEPaper::update() {
   this->do_update_();
+  // A refresh takes seconds and makes the screen flicker, skip it if the image did not change
+  if (!this->is_dirty_())
+    return;
   this->display();
+  this->reset_dirty_area_();
 }
 void WaveshareEPaper::fill(Color color) {
   // flip logic
   const uint8_t fill = color.is_on() ? 0x00 : 0xFF;
-  for (uint32_t i = 0; i < this->get_buffer_length_(); i++)
-    this->buffer_[i] = fill;
+  for (uint32_t i = 0; i < this->get_buffer_length_(); i++) {
+    if (this->buffer_[i] != fill) {
+      memset(this->buffer_ + i, fill, this->get_buffer_length_() - i);
+      this->mark_all_dirty_();
+      return;
+    }
+  }
 }
 void HOT WaveshareEPaper::draw_absolute_pixel_internal(int x, int y, Color color) {
   if (x >= this->get_width_internal() || y >= this->get_height_internal() || x < 0 || y < 0)
@@ -140,10 +150,15 @@ void HOT WaveshareEPaper::draw_absolute_pixel_internal(int x, int y, Color color
   const uint32_t pos = (x + y * this->get_width_internal()) / 8u;
   const uint8_t subpos = x & 0x07;
   // flip logic
+  uint8_t value = this->buffer_[pos];
   if (!color.is_on())
-    this->buffer_[pos] |= 0x80 >> subpos;
+    value |= 0x80 >> subpos;
   else
-    this->buffer_[pos] &= ~(0x80 >> subpos);
+    value &= ~(0x80 >> subpos);
+  if (value == this->buffer_[pos])
+    return;
+  this->buffer_[pos] = value;
+  this->mark_dirty_(x, y);
 }
 uint32_t WaveshareEPaper::get_buffer_length_() { return this->get_width_internal() * this->get_height_internal() / 8u; }
 void WaveshareEPaper::start_command_() {
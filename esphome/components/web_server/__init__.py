@@ -1,3 +1,7 @@
+import gzip
+import hashlib
+import io
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import web_server_base
@@ -13,10 +17,14 @@ from esphome.const import (
     CONF_USERNAME,
     CONF_PASSWORD,
 )
-from esphome.core import coroutine_with_priority
+from esphome.core import HexInt, coroutine_with_priority
 
 AUTO_LOAD = ["json", "web_server_base"]
 
+CONF_MAX_QUEUED_EVENTS = "max_queued_events"
+CONF_CSS_INCLUDE_DATA_ID = "css_include_data_id"
+CONF_JS_INCLUDE_DATA_ID = "js_include_data_id"
+
 web_server_ns = cg.esphome_ns.namespace("web_server")
 WebServer = web_server_ns.class_("WebServer", cg.Component, cg.Controller)
 
@@ -38,13 +46,32 @@ CONFIG_SCHEMA = cv.Schema(
                 cv.Required(CONF_PASSWORD): cv.string_strict,
             }
         ),
+        cv.Optional(CONF_MAX_QUEUED_EVENTS, default=16): cv.int_range(
+            min=2, max=255
+        ),
         cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(
             web_server_base.WebServerBase
         ),
+        cv.GenerateID(CONF_CSS_INCLUDE_DATA_ID): cv.declare_id(cg.uint8),
+        cv.GenerateID(CONF_JS_INCLUDE_DATA_ID): cv.declare_id(cg.uint8),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
 
+def gzip_asset(data_id, path):
+    """Compress the file at path into a progmem array, returns the array, its size and its entity tag."""
+    with open(path, "rb") as f:
+        data = f.read()
+    buffer = io.BytesIO()
+    # Without a timestamp the output and so the entity tag only change with the file
+    with gzip.GzipFile(fileobj=buffer, mode="wb", compresslevel=9, mtime=0) as f:
+        f.write(data)
+    compressed = buffer.getvalue()
+    etag = f'"{hashlib.sha256(compressed).hexdigest()[:16]}"'
+    arr = cg.progmem_array(data_id, [HexInt(x) for x in compressed])
+    return arr, len(compressed), etag
+
+
 @coroutine_with_priority(40.0)
 async def to_code(config):
     paren = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
@@ -56,14 +83,21 @@ async def to_code(config):
     cg.add_define("WEBSERVER_PORT", config[CONF_PORT])
     cg.add(var.set_css_url(config[CONF_CSS_URL]))
     cg.add(var.set_js_url(config[CONF_JS_URL]))
+    # Per client limit of the event source of the web server library, messages beyond it are dropped
+    cg.add_build_flag(f"-DSSE_MAX_QUEUED_MESSAGES={config[CONF_MAX_QUEUED_EVENTS]}")
+    cg.add(var.set_max_queued_events(config[CONF_MAX_QUEUED_EVENTS]))
     if CONF_AUTH in config:
         cg.add(var.set_username(config[CONF_AUTH][CONF_USERNAME]))
         cg.add(var.set_password(config[CONF_AUTH][CONF_PASSWORD]))
     if CONF_CSS_INCLUDE in config:
         cg.add_define("WEBSERVER_CSS_INCLUDE")
-        with open(config[CONF_CSS_INCLUDE], "r") as myfile:
-            cg.add(var.set_css_include(myfile.read()))
+        arr, size, etag = gzip_asset(
+            config[CONF_CSS_INCLUDE_DATA_ID], config[CONF_CSS_INCLUDE]
+        )
+        cg.add(var.set_css_include(arr, size, etag))
     if CONF_JS_INCLUDE in config:
         cg.add_define("WEBSERVER_JS_INCLUDE")
-        with open(config[CONF_JS_INCLUDE], "r") as myfile:
-            cg.add(var.set_js_include(myfile.read()))
+        arr, size, etag = gzip_asset(
+            config[CONF_JS_INCLUDE_DATA_ID], config[CONF_JS_INCLUDE]
+        )
+        cg.add(var.set_js_include(arr, size, etag))
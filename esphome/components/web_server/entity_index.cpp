@@ -0,0 +1,106 @@
+#include "entity_index.h"
+#include "esphome/core/helpers.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace web_server {
+
+static bool entry_less(EntityDomain domain_a, uint32_t hash_a, EntityDomain domain_b, uint32_t hash_b) {
+  return domain_a != domain_b ? domain_a < domain_b : hash_a < hash_b;
+}
+
+void EntityIndex::add(EntityDomain domain, Nameable *obj) {
+  if (obj->is_internal())
+    return;
+  const auto position = static_cast<uint16_t>(this->entries_.size());
+  this->entries_.push_back(Entry{obj->get_object_id_hash(), domain, false, position, obj});
+}
+
+void EntityIndex::build() {
+  std::stable_sort(this->entries_.begin(), this->entries_.end(), [](const Entry &a, const Entry &b) {
+    return entry_less(a.domain, a.hash, b.domain, b.hash);
+  });
+  this->order_.resize(this->entries_.size());
+  for (size_t i = 0; i < this->entries_.size(); i++)
+    this->order_[this->entries_[i].position] = i;
+  this->clear_pending();
+}
+
+std::vector<EntityIndex::Entry>::const_iterator EntityIndex::lower_bound_(EntityDomain domain, uint32_t hash) const {
+  return std::lower_bound(
+      this->entries_.begin(), this->entries_.end(), std::make_pair(domain, hash),
+      [](const Entry &entry, const std::pair<EntityDomain, uint32_t> &key) {
+        return entry_less(entry.domain, entry.hash, key.first, key.second);
+      });
+}
+
+Nameable *EntityIndex::find(EntityDomain domain, const std::string &object_id) const {
+  const uint32_t hash = fnv1_hash(object_id);
+  for (auto it = this->lower_bound_(domain, hash); it != this->entries_.end(); ++it) {
+    if (it->domain != domain || it->hash != hash)
+      break;
+    if (it->obj->get_object_id() == object_id)
+      return it->obj;
+  }
+  return nullptr;
+}
+
+Nameable *EntityIndex::get_in_order(size_t position, EntityDomain *domain) const {
+  if (position >= this->order_.size())
+    return nullptr;
+  const auto &entry = this->entries_[this->order_[position]];
+  *domain = entry.domain;
+  return entry.obj;
+}
+
+bool EntityIndex::mark_pending(EntityDomain domain, Nameable *obj) {
+  for (auto it = this->lower_bound_(domain, obj->get_object_id_hash()); it != this->entries_.end(); ++it) {
+    if (it->domain != domain || it->hash != obj->get_object_id_hash())
+      break;
+    if (it->obj != obj)
+      continue;
+    auto &entry = this->entries_[it - this->entries_.begin()];
+    if (!entry.pending) {
+      entry.pending = true;
+      this->pending_.push_back(it - this->entries_.begin());
+    }
+    return true;
+  }
+  return false;
+}
+
+bool EntityIndex::pop_pending(EntityDomain *domain, Nameable **obj) {
+  if (this->pending_head_ == this->pending_.size())
+    return false;
+  auto &entry = this->entries_[this->pending_[this->pending_head_++]];
+  entry.pending = false;
+  *domain = entry.domain;
+  *obj = entry.obj;
+  if (this->pending_head_ == this->pending_.size()) {
+    this->clear_pending();
+  } else if (this->pending_head_ * 2 >= this->pending_.size()) {
+    // The queue never ran empty, drop the popped indices so that it doesn't keep growing
+    this->pending_.erase(this->pending_.begin(), this->pending_.begin() + this->pending_head_);
+    this->pending_head_ = 0;
+  }
+  return true;
+}
+
+void EntityIndex::clear_pending() {
+  for (size_t i = this->pending_head_; i < this->pending_.size(); i++)
+    this->entries_[this->pending_[i]].pending = false;
+  this->pending_.clear();
+  this->pending_head_ = 0;
+}
+
+size_t get_state_event_budget(size_t avg_queued_events, size_t num_clients, size_t max_queued_events) {
+  const size_t limit = max_queued_events / 2;
+  if (num_clients == 0)
+    return limit;
+  const size_t worst_queued = (avg_queued_events + 1) * num_clients - 1;
+  return worst_queued >= limit ? 0 : limit - worst_queued;
+}
+
+}  // namespace web_server
+}  // namespace esphome
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace web_server {
+
+/// The domains of the entities served by the web server, the first level of their URLs.
+enum EntityDomain : uint8_t {
+  DOMAIN_SENSOR,
+  DOMAIN_SWITCH,
+  DOMAIN_BINARY_SENSOR,
+  DOMAIN_FAN,
+  DOMAIN_LIGHT,
+  DOMAIN_TEXT_SENSOR,
+  DOMAIN_COVER,
+  DOMAIN_NUMBER,
+  DOMAIN_SELECT,
+};
+
+/** The number of state events that can be sent without overflowing the event queue of any client.
+ *
+ * The event source only reports the number of queued events averaged over its clients. Times the number of clients
+ * (plus what its rounding may have cut off) that is at least the total, so it bounds the queue of the slowest client
+ * even if the others are empty.
+ * Events are only sent while that bound is below half of max_queued_events, the rest is left for logs and pings.
+ */
+size_t get_state_event_budget(size_t avg_queued_events, size_t num_clients, size_t max_queued_events);
+
+/** Index of the entities served by the web server, sorted by domain and object id hash.
+ *
+ * Routing a request looks the entity up with a binary search over the hashes (comparing the object id only for
+ * matching hashes) instead of comparing the object id of every entity of the domain.
+ *
+ * The index also holds the queue of entities with a pending state event: an entity is queued at most once, and its
+ * state is only serialized when the event is sent, so updates that arrive faster than the clients can take them are
+ * coalesced into one event with the latest state.
+ */
+class EntityIndex {
+ public:
+  /// Add an entity, lookups only find it after build().
+  void add(EntityDomain domain, Nameable *obj);
+  /// Sort the entities added so far.
+  void build();
+
+  /// The entity with object_id in domain, nullptr if there is none.
+  Nameable *find(EntityDomain domain, const std::string &object_id) const;
+  /// The entity at position in the order the entities were added, nullptr past the last one.
+  Nameable *get_in_order(size_t position, EntityDomain *domain) const;
+
+  /// Queue a state event for obj, returns false if it isn't indexed.
+  bool mark_pending(EntityDomain domain, Nameable *obj);
+  /// Remove the oldest pending entity from the queue, returns false if the queue is empty.
+  bool pop_pending(EntityDomain *domain, Nameable **obj);
+  void clear_pending();
+  size_t get_pending_count() const { return this->pending_.size() - this->pending_head_; }
+
+  size_t size() const { return this->entries_.size(); }
+
+ protected:
+  struct Entry {
+    uint32_t hash;
+    EntityDomain domain;
+    bool pending;
+    /// Position in the order the entities were added.
+    uint16_t position;
+    Nameable *obj;
+  };
+
+  /// The first entry of domain with hash, or the end of the entries.
+  std::vector<Entry>::const_iterator lower_bound_(EntityDomain domain, uint32_t hash) const;
+
+  std::vector<Entry> entries_;
+  /// Indices of the entries in the order they were added.
+  std::vector<uint16_t> order_;
+  /// Indices of the pending entries in the order they were queued, from pending_head_ on.
+  std::vector<uint16_t> pending_;
+  size_t pending_head_{0};
+};
+
+}  // namespace web_server
+}  // namespace esphome
@@ -0,0 +1,135 @@
+#include "index_page.h"
+#include "esphome/core/esphal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace esphome {
+namespace web_server {
+
+static const char INDEX_HEAD[] PROGMEM = "<!DOCTYPE html><html lang=\"en\"><head><meta charset=UTF-8><title>";
+static const char INDEX_CSS_INCLUDE[] PROGMEM = "<link rel=\"stylesheet\" href=\"/0.css\">";
+static const char INDEX_BODY[] PROGMEM = "</head><body><article class=\"markdown-body\"><h1>";
+static const char INDEX_TABLE[] PROGMEM =
+    "</h1><h2>States</h2><table id=\"states\"><thead><tr><th>Name<th>State<th>Actions<tbody>";
+static const char INDEX_FOOTER[] PROGMEM =
+    "</tbody></table><p>See <a href=\"https://esphome.io/web-api/index.html\">ESPHome Web API</a> for "
+    "REST API documentation.</p>"
+    "<h2>OTA Update</h2><form method=\"POST\" action=\"/update\" enctype=\"multipart/form-data\"><input "
+    "type=\"file\" name=\"update\"><input type=\"submit\" value=\"Update\"></form>"
+    "<h2>Debug Log</h2><pre id=\"log\"></pre>";
+static const char INDEX_JS_INCLUDE[] PROGMEM = "<script src=\"/0.js\"></script>";
+static const char INDEX_END[] PROGMEM = "</article></body></html>";
+
+/// The row class and the actions of the entities of each domain, indexed by EntityDomain.
+static const char *const DOMAIN_CLASSES[] = {"sensor",      "switch", "binary_sensor", "fan",   "light",
+                                             "text_sensor", "cover",  "number",        "select"};
+static const char *const DOMAIN_ACTIONS[] = {"",
+                                             "<button>Toggle</button>",
+                                             "",
+                                             "<button>Toggle</button>",
+                                             "<button>Toggle</button>",
+                                             "",
+                                             "<button>Open</button><button>Close</button>",
+                                             "",
+                                             ""};
+
+IndexPageWriter::IndexPageWriter(const EntityIndex *entities, std::string title, const char *css_url,
+                                 const char *js_url, bool css_include, bool js_include)
+    : entities_(entities),
+      title_(std::move(title)),
+      css_url_(css_url),
+      js_url_(js_url),
+      css_include_(css_include),
+      js_include_(js_include) {}
+
+size_t IndexPageWriter::fill(uint8_t *buffer, size_t max_len) {
+  size_t written = 0;
+  while (written < max_len) {
+    if (this->part_offset_ == this->part_.size()) {
+      // Keep the capacity of the string for the next part
+      this->part_.clear();
+      this->part_offset_ = 0;
+      if (!this->next_part_())
+        break;
+      continue;
+    }
+    const size_t length = std::min(max_len - written, this->part_.size() - this->part_offset_);
+    memcpy(buffer + written, this->part_.data() + this->part_offset_, length);
+    written += length;
+    this->part_offset_ += length;
+  }
+  return written;
+}
+
+bool IndexPageWriter::next_part_() {
+  switch (this->stage_) {
+    case STAGE_HEAD:
+      this->append_(INDEX_HEAD);
+      this->part_ += this->title_;
+      this->part_ += "</title>";
+      if (this->css_include_)
+        this->append_(INDEX_CSS_INCLUDE);
+      if (strlen(this->css_url_) > 0) {
+        this->part_ += "<link rel=\"stylesheet\" href=\"";
+        this->part_ += this->css_url_;
+        this->part_ += "\">";
+      }
+      this->append_(INDEX_BODY);
+      this->part_ += this->title_;
+      this->append_(INDEX_TABLE);
+      this->stage_ = STAGE_ROWS;
+      return true;
+    case STAGE_ROWS: {
+      EntityDomain domain;
+      Nameable *obj = this->entities_->get_in_order(this->row_++, &domain);
+      if (obj == nullptr) {
+        this->stage_ = STAGE_FOOTER;
+        return true;
+      }
+      const char *klass = DOMAIN_CLASSES[domain];
+      this->part_ += "<tr class=\"";
+      this->part_ += klass;
+      this->part_ += "\" id=\"";
+      this->part_ += klass;
+      this->part_ += "-";
+      this->part_ += obj->get_object_id();
+      this->part_ += "\"><td>";
+      this->part_ += obj->get_name();
+      this->part_ += "</td><td></td><td>";
+      this->part_ += DOMAIN_ACTIONS[domain];
+      this->part_ += "</td></tr>";
+      return true;
+    }
+    case STAGE_FOOTER:
+      this->append_(INDEX_FOOTER);
+      if (this->js_include_)
+        this->append_(INDEX_JS_INCLUDE);
+      if (strlen(this->js_url_) > 0) {
+        this->part_ += "<script src=\"";
+        this->part_ += this->js_url_;
+        this->part_ += "\"></script>";
+      }
+      this->append_(INDEX_END);
+      this->stage_ = STAGE_DONE;
+      return true;
+    case STAGE_DONE:
+    default:
+      return false;
+  }
+}
+
+void IndexPageWriter::append_(const char *text) {
+#ifdef ARDUINO_ARCH_ESP8266
+  const size_t length = strlen_P(text);
+  const size_t offset = this->part_.size();
+  this->part_.resize(offset + length);
+  memcpy_P(&this->part_[offset], text, length);
+#else
+  this->part_ += text;
+#endif
+}
+
+}  // namespace web_server
+}  // namespace esphome
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "entity_index.h"
+
+namespace esphome {
+namespace web_server {
+
+/** Writer of the index page of the web server, used as the filler of a chunked response.
+ *
+ * The page is rendered one part at a time (the head, a table row per entity, the footer) when the web server library
+ * asks for the next chunk, so only the current part is held in RAM instead of the whole page.
+ */
+class IndexPageWriter {
+ public:
+  IndexPageWriter(const EntityIndex *entities, std::string title, const char *css_url, const char *js_url,
+                  bool css_include, bool js_include);
+
+  /// Write the next at most max_len bytes of the page into buffer, returns 0 once the page is complete.
+  size_t fill(uint8_t *buffer, size_t max_len);
+
+ protected:
+  enum Stage : uint8_t { STAGE_HEAD, STAGE_ROWS, STAGE_FOOTER, STAGE_DONE };
+
+  /// Render the next part of the page into part_, returns false after the last one.
+  bool next_part_();
+  /// Append a string that may be in flash to part_.
+  void append_(const char *text);
+
+  const EntityIndex *entities_;
+  std::string title_;
+  const char *css_url_;
+  const char *js_url_;
+  bool css_include_;
+  bool js_include_;
+  Stage stage_{STAGE_HEAD};
+  /// The entity of the next row, in the order the entities were added to the index.
+  size_t row_{0};
+  std::string part_;
+  size_t part_offset_{0};
+};
+
+}  // namespace web_server
+}  // namespace esphome
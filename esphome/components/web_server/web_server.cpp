@@ -1,4 +1,5 @@
 #include "web_server.h"
+#include "index_page.h"
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
 #include "esphome/core/util.h"
@@ -7,6 +8,8 @@
 #include "StreamString.h"
 
 #include <cstdlib>
+#include <cstring>
+#include <memory>
 
 #ifdef USE_LIGHT
 #include "esphome/components/light/light_json_schema.h"
@@ -24,23 +27,8 @@ namespace esphome {
 namespace web_server {
 
 static const char *const TAG = "web_server";
-
-void write_row(AsyncResponseStream *stream, Nameable *obj, const std::string &klass, const std::string &action) {
-  if (obj->is_internal())
-    return;
-  stream->print("<tr class=\"");
-  stream->print(klass.c_str());
-  stream->print("\" id=\"");
-  stream->print(klass.c_str());
-  stream->print("-");
-  stream->print(obj->get_object_id().c_str());
-  stream->print("\"><td>");
-  stream->print(obj->get_name().c_str());
-  stream->print("</td><td></td><td>");
-  stream->print(action.c_str());
-  stream->print("</td>");
-  stream->print("</tr>");
-}
+/// How long to wait for the clients to send the queued events before trying again.
+static const uint32_t EVENT_RETRY_INTERVAL = 50;
 
 UrlMatch match_url(const std::string &url, bool only_domain = false) {
   UrlMatch match;
@@ -69,15 +57,57 @@ UrlMatch match_url(const std::string &url, bool only_domain = false) {
 }
 
 void WebServer::set_css_url(const char *css_url) { this->css_url_ = css_url; }
-void WebServer::set_css_include(const char *css_include) { this->css_include_ = css_include; }
+void WebServer::set_css_include(const uint8_t *data, size_t size, const char *etag) {
+  this->css_include_ = StaticAsset{data, size, etag};
+}
 void WebServer::set_js_url(const char *js_url) { this->js_url_ = js_url; }
-void WebServer::set_js_include(const char *js_include) { this->js_include_ = js_include; }
+void WebServer::set_js_include(const uint8_t *data, size_t size, const char *etag) {
+  this->js_include_ = StaticAsset{data, size, etag};
+}
 
 void WebServer::setup() {
   ESP_LOGCONFIG(TAG, "Setting up web server...");
   this->setup_controller();
   this->base_->init();
 
+#ifdef USE_SENSOR
+  for (auto *obj : App.get_sensors())
+    this->entities_.add(DOMAIN_SENSOR, obj);
+#endif
+#ifdef USE_SWITCH
+  for (auto *obj : App.get_switches())
+    this->entities_.add(DOMAIN_SWITCH, obj);
+#endif
+#ifdef USE_BINARY_SENSOR
+  for (auto *obj : App.get_binary_sensors())
+    this->entities_.add(DOMAIN_BINARY_SENSOR, obj);
+#endif
+#ifdef USE_FAN
+  for (auto *obj : App.get_fans())
+    this->entities_.add(DOMAIN_FAN, obj);
+#endif
+#ifdef USE_LIGHT
+  for (auto *obj : App.get_lights())
+    this->entities_.add(DOMAIN_LIGHT, obj);
+#endif
+#ifdef USE_TEXT_SENSOR
+  for (auto *obj : App.get_text_sensors())
+    this->entities_.add(DOMAIN_TEXT_SENSOR, obj);
+#endif
+#ifdef USE_COVER
+  for (auto *obj : App.get_covers())
+    this->entities_.add(DOMAIN_COVER, obj);
+#endif
+#ifdef USE_NUMBER
+  for (auto *obj : App.get_numbers())
+    this->entities_.add(DOMAIN_NUMBER, obj);
+#endif
+#ifdef USE_SELECT
+  for (auto *obj : App.get_selects())
+    this->entities_.add(DOMAIN_SELECT, obj);
+#endif
+  this->entities_.build();
+
   this->events_.onConnect([this](AsyncEventSourceClient *client) {
     // Configure reconnect timeout
     client->send("", "ping", millis(), 30000);
@@ -148,132 +178,163 @@ void WebServer::setup() {
 
   this->set_interval(10000, [this]() { this->events_.send("", "ping", millis(), 30000); });
 }
+void WebServer::loop() {
+  if (this->entities_.get_pending_count() != 0) {
+    if (this->events_.count() == 0) {
+      // Nobody is listening, clients get all states when they connect
+      this->entities_.clear_pending();
+    } else {
+      // Only send as many events as the slowest client can queue, until then updates of the same entity are
+      // coalesced
+      size_t budget = get_state_event_budget(this->events_.avgPacketsWaiting(), this->events_.count(),
+                                             this->max_queued_events_);
+      EntityDomain domain;
+      Nameable *obj;
+      for (; budget != 0 && this->entities_.pop_pending(&domain, &obj); budget--)
+        this->send_state_event_(domain, obj);
+      if (this->entities_.get_pending_count() != 0) {
+        this->set_loop_wake_hint(EVENT_RETRY_INTERVAL);
+        return;
+      }
+    }
+  }
+  // Woken up by the next state update
+  this->set_loop_wake_hint(WAKE_HINT_ON_EVENT);
+}
 void WebServer::dump_config() {
   ESP_LOGCONFIG(TAG, "Web Server:");
   ESP_LOGCONFIG(TAG, "  Address: %s:%u", network_get_address().c_str(), this->base_->get_port());
   if (this->using_auth()) {
     ESP_LOGCONFIG(TAG, "  Basic authentication enabled");
   }
+  ESP_LOGCONFIG(TAG, "  Max Queued Events: %u", this->max_queued_events_);
 }
-float WebServer::get_setup_priority() const { return setup_priority::WIFI - 1.0f; }
-
-void WebServer::handle_index_request(AsyncWebServerRequest *request) {
-  AsyncResponseStream *stream = request->beginResponseStream("text/html");
-  std::string title = App.get_name() + " Web Server";
-  stream->print(F("<!DOCTYPE html><html lang=\"en\"><head><meta charset=UTF-8><title>"));
-  stream->print(title.c_str());
-  stream->print(F("</title>"));
-#ifdef WEBSERVER_CSS_INCLUDE
-  stream->print(F("<link rel=\"stylesheet\" href=\"/0.css\">"));
-#endif
-  if (strlen(this->css_url_) > 0) {
-    stream->print(F("<link rel=\"stylesheet\" href=\""));
-    stream->print(this->css_url_);
-    stream->print(F("\">"));
-  }
-  stream->print(F("</head><body><article class=\"markdown-body\"><h1>"));
-  stream->print(title.c_str());
-  stream->print(F("</h1><h2>States</h2><table id=\"states\"><thead><tr><th>Name<th>State<th>Actions<tbody>"));
-  // All content is controlled and created by user - so allowing all origins is fine here.
-  stream->addHeader("Access-Control-Allow-Origin", "*");
 
+void WebServer::queue_state_event_(EntityDomain domain, Nameable *obj) {
+  if (this->entities_.mark_pending(domain, obj))
+    App.wake_loop();
+}
+void WebServer::send_state_event_(EntityDomain domain, Nameable *obj) {
+  std::string data;
+  switch (domain) {
 #ifdef USE_SENSOR
-  for (auto *obj : App.get_sensors())
-    write_row(stream, obj, "sensor", "");
+    case DOMAIN_SENSOR: {
+      auto *sensor = static_cast<sensor::Sensor *>(obj);
+      data = this->sensor_json(sensor, sensor->state);
+      break;
+    }
 #endif
-
 #ifdef USE_SWITCH
-  for (auto *obj : App.get_switches())
-    write_row(stream, obj, "switch", "<button>Toggle</button>");
+    case DOMAIN_SWITCH: {
+      auto *switch_obj = static_cast<switch_::Switch *>(obj);
+      data = this->switch_json(switch_obj, switch_obj->state);
+      break;
+    }
 #endif
-
 #ifdef USE_BINARY_SENSOR
-  for (auto *obj : App.get_binary_sensors())
-    write_row(stream, obj, "binary_sensor", "");
+    case DOMAIN_BINARY_SENSOR: {
+      auto *binary_sensor = static_cast<binary_sensor::BinarySensor *>(obj);
+      data = this->binary_sensor_json(binary_sensor, binary_sensor->state);
+      break;
+    }
 #endif
-
 #ifdef USE_FAN
-  for (auto *obj : App.get_fans())
-    write_row(stream, obj, "fan", "<button>Toggle</button>");
+    case DOMAIN_FAN:
+      data = this->fan_json(static_cast<fan::FanState *>(obj));
+      break;
 #endif
-
 #ifdef USE_LIGHT
-  for (auto *obj : App.get_lights())
-    write_row(stream, obj, "light", "<button>Toggle</button>");
+    case DOMAIN_LIGHT:
+      data = this->light_json(static_cast<light::LightState *>(obj));
+      break;
 #endif
-
 #ifdef USE_TEXT_SENSOR
-  for (auto *obj : App.get_text_sensors())
-    write_row(stream, obj, "text_sensor", "");
+    case DOMAIN_TEXT_SENSOR: {
+      auto *text_sensor = static_cast<text_sensor::TextSensor *>(obj);
+      data = this->text_sensor_json(text_sensor, text_sensor->state);
+      break;
+    }
 #endif
-
 #ifdef USE_COVER
-  for (auto *obj : App.get_covers())
-    write_row(stream, obj, "cover", "<button>Open</button><button>Close</button>");
+    case DOMAIN_COVER:
+      data = this->cover_json(static_cast<cover::Cover *>(obj));
+      break;
 #endif
-
 #ifdef USE_NUMBER
-  for (auto *obj : App.get_numbers())
-    write_row(stream, obj, "number", "");
+    case DOMAIN_NUMBER: {
+      auto *number = static_cast<number::Number *>(obj);
+      data = this->number_json(number, number->state);
+      break;
+    }
 #endif
-
 #ifdef USE_SELECT
-  for (auto *obj : App.get_selects())
-    write_row(stream, obj, "select", "");
+    case DOMAIN_SELECT: {
+      auto *select = static_cast<select::Select *>(obj);
+      data = this->select_json(select, select->state);
+      break;
+    }
 #endif
+    default:
+      return;
+  }
+  this->events_.send(data.c_str(), "state");
+}
+float WebServer::get_setup_priority() const { return setup_priority::WIFI - 1.0f; }
 
-  stream->print(F("</tbody></table><p>See <a href=\"https://esphome.io/web-api/index.html\">ESPHome Web API</a> for "
-                  "REST API documentation.</p>"
-                  "<h2>OTA Update</h2><form method=\"POST\" action=\"/update\" enctype=\"multipart/form-data\"><input "
-                  "type=\"file\" name=\"update\"><input type=\"submit\" value=\"Update\"></form>"
-                  "<h2>Debug Log</h2><pre id=\"log\"></pre>"));
+void WebServer::handle_index_request(AsyncWebServerRequest *request) {
+  bool css_include = false;
+  bool js_include = false;
+#ifdef WEBSERVER_CSS_INCLUDE
+  css_include = true;
+#endif
 #ifdef WEBSERVER_JS_INCLUDE
-  if (this->js_include_ != nullptr) {
-    stream->print(F("<script src=\"/0.js\"></script>"));
-  }
+  js_include = true;
 #endif
-  if (strlen(this->js_url_) > 0) {
-    stream->print(F("<script src=\""));
-    stream->print(this->js_url_);
-    stream->print(F("\"></script>"));
-  }
-  stream->print(F("</article></body></html>"));
+  auto writer = std::make_shared<IndexPageWriter>(&this->entities_, App.get_name() + " Web Server", this->css_url_,
+                                                  this->js_url_, css_include, js_include);
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      "text/html", [writer](uint8_t *buffer, size_t max_len, size_t index) { return writer->fill(buffer, max_len); });
+  // All content is controlled and created by user - so allowing all origins is fine here.
+  response->addHeader("Access-Control-Allow-Origin", "*");
+  request->send(response);
+}
 
-  request->send(stream);
+void WebServer::send_static_asset_(AsyncWebServerRequest *request, const char *content_type,
+                                   const StaticAsset &asset) {
+  AsyncWebHeader *if_none_match = request->getHeader("If-None-Match");
+  if (if_none_match != nullptr && strstr(if_none_match->value().c_str(), asset.etag) != nullptr) {
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", asset.etag);
+    request->send(response);
+    return;
+  }
+  AsyncWebServerResponse *response = request->beginResponse_P(200, content_type, asset.data, asset.size);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", asset.etag);
+  // Revalidate on every load, which is answered with the entity tag alone while the file is unchanged
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
 }
 
 #ifdef WEBSERVER_CSS_INCLUDE
 void WebServer::handle_css_request(AsyncWebServerRequest *request) {
-  AsyncResponseStream *stream = request->beginResponseStream("text/css");
-  if (this->css_include_ != nullptr) {
-    stream->print(this->css_include_);
-  }
-
-  request->send(stream);
+  this->send_static_asset_(request, "text/css", this->css_include_);
 }
 #endif
 
 #ifdef WEBSERVER_JS_INCLUDE
 void WebServer::handle_js_request(AsyncWebServerRequest *request) {
-  AsyncResponseStream *stream = request->beginResponseStream("text/javascript");
-  if (this->js_include_ != nullptr) {
-    stream->print(this->js_include_);
-  }
-
-  request->send(stream);
+  this->send_static_asset_(request, "text/javascript", this->js_include_);
 }
 #endif
 
 #ifdef USE_SENSOR
 void WebServer::on_sensor_update(sensor::Sensor *obj, float state) {
-  this->events_.send(this->sensor_json(obj, state).c_str(), "state");
+  this->queue_state_event_(DOMAIN_SENSOR, obj);
 }
 void WebServer::handle_sensor_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (sensor::Sensor *obj : App.get_sensors()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
+  auto *obj = static_cast<sensor::Sensor *>(this->entities_.find(DOMAIN_SENSOR, match.id));
+  if (obj != nullptr) {
     std::string data = this->sensor_json(obj, obj->state);
     request->send(200, "text/json", data.c_str());
     return;
@@ -281,27 +342,24 @@ void WebServer::handle_sensor_request(AsyncWebServerRequest *request, const UrlM
   request->send(404);
 }
 std::string WebServer::sensor_json(sensor::Sensor *obj, float value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "sensor-" + obj->get_object_id();
+  return json::write_json([obj, value](json::JsonWriter &root) {
+    root.set("id", "sensor-" + obj->get_object_id());
     std::string state = value_accuracy_to_string(value, obj->get_accuracy_decimals());
     if (!obj->get_unit_of_measurement().empty())
       state += " " + obj->get_unit_of_measurement();
-    root["state"] = state;
-    root["value"] = value;
+    root.set("state", state);
+    root.set("value", value);
   });
 }
 #endif
 
 #ifdef USE_TEXT_SENSOR
 void WebServer::on_text_sensor_update(text_sensor::TextSensor *obj, const std::string &state) {
-  this->events_.send(this->text_sensor_json(obj, state).c_str(), "state");
+  this->queue_state_event_(DOMAIN_TEXT_SENSOR, obj);
 }
 void WebServer::handle_text_sensor_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (text_sensor::TextSensor *obj : App.get_text_sensors()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
+  auto *obj = static_cast<text_sensor::TextSensor *>(this->entities_.find(DOMAIN_TEXT_SENSOR, match.id));
+  if (obj != nullptr) {
     std::string data = this->text_sensor_json(obj, obj->state);
     request->send(200, "text/json", data.c_str());
     return;
@@ -309,32 +367,28 @@ void WebServer::handle_text_sensor_request(AsyncWebServerRequest *request, const
   request->send(404);
 }
 std::string WebServer::text_sensor_json(text_sensor::TextSensor *obj, const std::string &value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "text_sensor-" + obj->get_object_id();
-    root["state"] = value;
-    root["value"] = value;
+  return json::write_json([obj, &value](json::JsonWriter &root) {
+    root.set("id", "text_sensor-" + obj->get_object_id());
+    root.set("state", value);
+    root.set("value", value);
   });
 }
 #endif
 
 #ifdef USE_SWITCH
 void WebServer::on_switch_update(switch_::Switch *obj, bool state) {
-  this->events_.send(this->switch_json(obj, state).c_str(), "state");
+  this->queue_state_event_(DOMAIN_SWITCH, obj);
 }
 std::string WebServer::switch_json(switch_::Switch *obj, bool value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "switch-" + obj->get_object_id();
-    root["state"] = value ? "ON" : "OFF";
-    root["value"] = value;
+  return json::write_json([obj, value](json::JsonWriter &root) {
+    root.set("id", "switch-" + obj->get_object_id());
+    root.set("state", value ? "ON" : "OFF");
+    root.set("value", value);
   });
 }
 void WebServer::handle_switch_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (switch_::Switch *obj : App.get_switches()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
-
+  auto *obj = static_cast<switch_::Switch *>(this->entities_.find(DOMAIN_SWITCH, match.id));
+  if (obj != nullptr) {
     if (request->method() == HTTP_GET) {
       std::string data = this->switch_json(obj, obj->state);
       request->send(200, "text/json", data.c_str());
@@ -360,21 +414,18 @@ void WebServer::handle_switch_request(AsyncWebServerRequest *request, const UrlM
 void WebServer::on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool state) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->binary_sensor_json(obj, state).c_str(), "state");
+  this->queue_state_event_(DOMAIN_BINARY_SENSOR, obj);
 }
 std::string WebServer::binary_sensor_json(binary_sensor::BinarySensor *obj, bool value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "binary_sensor-" + obj->get_object_id();
-    root["state"] = value ? "ON" : "OFF";
-    root["value"] = value;
+  return json::write_json([obj, value](json::JsonWriter &root) {
+    root.set("id", "binary_sensor-" + obj->get_object_id());
+    root.set("state", value ? "ON" : "OFF");
+    root.set("value", value);
   });
 }
 void WebServer::handle_binary_sensor_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (binary_sensor::BinarySensor *obj : App.get_binary_sensors()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
+  auto *obj = static_cast<binary_sensor::BinarySensor *>(this->entities_.find(DOMAIN_BINARY_SENSOR, match.id));
+  if (obj != nullptr) {
     std::string data = this->binary_sensor_json(obj, obj->state);
     request->send(200, "text/json", data.c_str());
     return;
@@ -387,39 +438,35 @@ void WebServer::handle_binary_sensor_request(AsyncWebServerRequest *request, con
 void WebServer::on_fan_update(fan::FanState *obj) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->fan_json(obj).c_str(), "state");
+  this->queue_state_event_(DOMAIN_FAN, obj);
 }
 std::string WebServer::fan_json(fan::FanState *obj) {
-  return json::build_json([obj](JsonObject &root) {
-    root["id"] = "fan-" + obj->get_object_id();
-    root["state"] = obj->state ? "ON" : "OFF";
-    root["value"] = obj->state;
+  return json::write_json([obj](json::JsonWriter &root) {
+    root.set("id", "fan-" + obj->get_object_id());
+    root.set("state", obj->state ? "ON" : "OFF");
+    root.set("value", obj->state);
     const auto traits = obj->get_traits();
     if (traits.supports_speed()) {
-      root["speed_level"] = obj->speed;
+      root.set("speed_level", obj->speed);
       switch (fan::speed_level_to_enum(obj->speed, traits.supported_speed_count())) {
         case fan::FAN_SPEED_LOW:
-          root["speed"] = "low";
+          root.set("speed", "low");
           break;
         case fan::FAN_SPEED_MEDIUM:
-          root["speed"] = "medium";
+          root.set("speed", "medium");
           break;
         case fan::FAN_SPEED_HIGH:
-          root["speed"] = "high";
+          root.set("speed", "high");
           break;
       }
     }
     if (obj->get_traits().supports_oscillation())
-      root["oscillation"] = obj->oscillating;
+      root.set("oscillation", obj->oscillating);
   });
 }
 void WebServer::handle_fan_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (fan::FanState *obj : App.get_fans()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
-
+  auto *obj = static_cast<fan::FanState *>(this->entities_.find(DOMAIN_FAN, match.id));
+  if (obj != nullptr) {
     if (request->method() == HTTP_GET) {
       std::string data = this->fan_json(obj);
       request->send(200, "text/json", data.c_str());
@@ -477,15 +524,11 @@ void WebServer::handle_fan_request(AsyncWebServerRequest *request, const UrlMatc
 void WebServer::on_light_update(light::LightState *obj) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->light_json(obj).c_str(), "state");
+  this->queue_state_event_(DOMAIN_LIGHT, obj);
 }
 void WebServer::handle_light_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (light::LightState *obj : App.get_lights()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
-
+  auto *obj = static_cast<light::LightState *>(this->entities_.find(DOMAIN_LIGHT, match.id));
+  if (obj != nullptr) {
     if (request->method() == HTTP_GET) {
       std::string data = this->light_json(obj);
       request->send(200, "text/json", data.c_str());
@@ -540,9 +583,11 @@ void WebServer::handle_light_request(AsyncWebServerRequest *request, const UrlMa
   request->send(404);
 }
 std::string WebServer::light_json(light::LightState *obj) {
-  return json::build_json([obj](JsonObject &root) {
-    root["id"] = "light-" + obj->get_object_id();
-    root["state"] = obj->remote_values.is_on() ? "ON" : "OFF";
+  return json::write_json([obj](json::JsonWriter &root) {
+    root.set("id", "light-" + obj->get_object_id());
+    // dump_json() already writes the state if the color mode has it
+    if (!(obj->remote_values.get_color_mode() & light::ColorCapability::ON_OFF))
+      root.set("state", obj->remote_values.is_on() ? "ON" : "OFF");
     light::LightJSONSchema::dump_json(*obj, root);
   });
 }
@@ -552,19 +597,15 @@ std::string WebServer::light_json(light::LightState *obj) {
 void WebServer::on_cover_update(cover::Cover *obj) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->cover_json(obj).c_str(), "state");
+  this->queue_state_event_(DOMAIN_COVER, obj);
 }
 void WebServer::handle_cover_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (cover::Cover *obj : App.get_covers()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
-
+  auto *obj = static_cast<cover::Cover *>(this->entities_.find(DOMAIN_COVER, match.id));
+  if (obj != nullptr) {
     if (request->method() == HTTP_GET) {
       std::string data = this->cover_json(obj);
       request->send(200, "text/json", data.c_str());
-      continue;
+      return;
     }
 
     auto call = obj->make_call();
@@ -598,28 +639,25 @@ void WebServer::handle_cover_request(AsyncWebServerRequest *request, const UrlMa
   request->send(404);
 }
 std::string WebServer::cover_json(cover::Cover *obj) {
-  return json::build_json([obj](JsonObject &root) {
-    root["id"] = "cover-" + obj->get_object_id();
-    root["state"] = obj->is_fully_closed() ? "CLOSED" : "OPEN";
-    root["value"] = obj->position;
-    root["current_operation"] = cover::cover_operation_to_str(obj->current_operation);
+  return json::write_json([obj](json::JsonWriter &root) {
+    root.set("id", "cover-" + obj->get_object_id());
+    root.set("state", obj->is_fully_closed() ? "CLOSED" : "OPEN");
+    root.set("value", obj->position);
+    root.set("current_operation", cover::cover_operation_to_str(obj->current_operation));
 
     if (obj->get_traits().get_supports_tilt())
-      root["tilt"] = obj->tilt;
+      root.set("tilt", obj->tilt);
   });
 }
 #endif
 
 #ifdef USE_NUMBER
 void WebServer::on_number_update(number::Number *obj, float state) {
-  this->events_.send(this->number_json(obj, state).c_str(), "state");
+  this->queue_state_event_(DOMAIN_NUMBER, obj);
 }
 void WebServer::handle_number_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (auto *obj : App.get_numbers()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
+  auto *obj = static_cast<number::Number *>(this->entities_.find(DOMAIN_NUMBER, match.id));
+  if (obj != nullptr) {
     std::string data = this->number_json(obj, obj->state);
     request->send(200, "text/json", data.c_str());
     return;
@@ -627,26 +665,23 @@ void WebServer::handle_number_request(AsyncWebServerRequest *request, const UrlM
   request->send(404);
 }
 std::string WebServer::number_json(number::Number *obj, float value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "number-" + obj->get_object_id();
+  return json::write_json([obj, value](json::JsonWriter &root) {
+    root.set("id", "number-" + obj->get_object_id());
     char buffer[64];
     snprintf(buffer, sizeof(buffer), "%f", value);
-    root["state"] = buffer;
-    root["value"] = value;
+    root.set("state", buffer);
+    root.set("value", value);
   });
 }
 #endif
 
 #ifdef USE_SELECT
 void WebServer::on_select_update(select::Select *obj, const std::string &state) {
-  this->events_.send(this->select_json(obj, state).c_str(), "state");
+  this->queue_state_event_(DOMAIN_SELECT, obj);
 }
 void WebServer::handle_select_request(AsyncWebServerRequest *request, const UrlMatch &match) {
-  for (auto *obj : App.get_selects()) {
-    if (obj->is_internal())
-      continue;
-    if (obj->get_object_id() != match.id)
-      continue;
+  auto *obj = static_cast<select::Select *>(this->entities_.find(DOMAIN_SELECT, match.id));
+  if (obj != nullptr) {
     std::string data = this->select_json(obj, obj->state);
     request->send(200, "text/json", data.c_str());
     return;
@@ -654,10 +689,10 @@ void WebServer::handle_select_request(AsyncWebServerRequest *request, const UrlM
   request->send(404);
 }
 std::string WebServer::select_json(select::Select *obj, const std::string &value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "select-" + obj->get_object_id();
-    root["state"] = value;
-    root["value"] = value;
+  return json::write_json([obj, &value](json::JsonWriter &root) {
+    root.set("id", "select-" + obj->get_object_id());
+    root.set("state", value);
+    root.set("value", value);
   });
 }
 #endif
@@ -667,13 +702,18 @@ bool WebServer::canHandle(AsyncWebServerRequest *request) {
     return true;
 
 #ifdef WEBSERVER_CSS_INCLUDE
-  if (request->url() == "/0.css")
+  if (request->url() == "/0.css") {
+    // Only the headers that a handler asked for are kept
+    request->addInterestingHeader("If-None-Match");
     return true;
+  }
 #endif
 
 #ifdef WEBSERVER_JS_INCLUDE
-  if (request->url() == "/0.js")
+  if (request->url() == "/0.js") {
+    request->addInterestingHeader("If-None-Match");
     return true;
+  }
 #endif
 
   UrlMatch match = match_url(request->url().c_str(), true);
@@ -3,6 +3,7 @@
 #include "esphome/core/component.h"
 #include "esphome/core/controller.h"
 #include "esphome/components/web_server_base/web_server_base.h"
+#include "entity_index.h"
 
 #include <vector>
 
@@ -17,6 +18,14 @@ struct UrlMatch {
   bool valid;          ///< Whether this match is valid
 };
 
+/// A gzip compressed file that's served from flash, generated by the code generator.
+struct StaticAsset {
+  const uint8_t *data;
+  size_t size;
+  /// Quoted entity tag of the data, used for conditional requests.
+  const char *etag;
+};
+
 /** This class allows users to create a web server with their ESP nodes.
  *
  * Behind the scenes it's using AsyncWebServer to set up the server. It exposes 3 things:
@@ -41,11 +50,13 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
    */
   void set_css_url(const char *css_url);
 
-  /** Set local path to the script that's embedded in the index page. Defaults to
+  /** Set the gzip compressed stylesheet that's served under '/0.css' and linked in the index page.
    *
-   * @param css_include Local path to web server script.
+   * @param data The compressed stylesheet, in flash.
+   * @param size The size of data.
+   * @param etag The quoted entity tag of data.
    */
-  void set_css_include(const char *css_include);
+  void set_css_include(const uint8_t *data, size_t size, const char *etag);
 
   /** Set the URL to the script that's embedded in the index page. Defaults to
    * https://esphome.io/_static/webserver-v1.min.js
@@ -54,23 +65,35 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
    */
   void set_js_url(const char *js_url);
 
-  /** Set local path to the script that's embedded in the index page. Defaults to
+  /** Set the gzip compressed script that's served under '/0.js' and embedded in the index page.
+   *
+   * @param data The compressed script, in flash.
+   * @param size The size of data.
+   * @param etag The quoted entity tag of data.
+   */
+  void set_js_include(const uint8_t *data, size_t size, const char *etag);
+
+  /** Set the number of events that can be queued for each client of the event source, which has to match the
+   * SSE_MAX_QUEUED_MESSAGES build flag of the web server library.
    *
-   * @param js_include Local path to web server script.
+   * State updates are only sent while every client has less than half of that queued, until then the updates of an
+   * entity are coalesced into one event with its latest state. The event source only reports the average queue of
+   * its clients, so the bound used for the slowest client is the average times the number of clients.
    */
-  void set_js_include(const char *js_include);
+  void set_max_queued_events(uint8_t max_queued_events) { this->max_queued_events_ = max_queued_events; }
 
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
   /// Setup the internal web server and register handlers.
   void setup() override;
+  void loop() override;
 
   void dump_config() override;
 
   /// MQTT setup priority.
   float get_setup_priority() const override;
 
-  /// Handle an index request under '/'.
+  /// Handle an index request under '/', the page is rendered into a chunked response while it's sent.
   void handle_index_request(AsyncWebServerRequest *request);
 
 #ifdef WEBSERVER_CSS_INCLUDE
@@ -180,14 +203,22 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
   bool isRequestHandlerTrivial() override;
 
  protected:
+  /// Queue a state event for obj, sent from the loop.
+  void queue_state_event_(EntityDomain domain, Nameable *obj);
+  void send_state_event_(EntityDomain domain, Nameable *obj);
+  /// Send asset, or only its entity tag if the client already has it.
+  void send_static_asset_(AsyncWebServerRequest *request, const char *content_type, const StaticAsset &asset);
+
   web_server_base::WebServerBase *base_;
   AsyncEventSource events_{"/events"};
+  EntityIndex entities_;
+  uint8_t max_queued_events_{16};
   const char *username_{nullptr};
   const char *password_{nullptr};
   const char *css_url_{nullptr};
-  const char *css_include_{nullptr};
+  StaticAsset css_include_{};
   const char *js_url_{nullptr};
-  const char *js_include_{nullptr};
+  StaticAsset js_include_{};
 };
 
 }  // namespace web_server
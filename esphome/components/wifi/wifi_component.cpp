@@ -30,6 +30,9 @@ namespace esphome {
 namespace wifi {
 
 static const char *const TAG = "wifi";
+/// How often loop() runs in tickless idle once there's no connection progress to poll (the WiFi events wake it),
+/// which also ticks mDNS on the ESP8266.
+static const uint32_t IDLE_CHECK_INTERVAL = 1000;
 
 float WiFiComponent::get_setup_priority() const { return setup_priority::WIFI; }
 
@@ -160,6 +163,10 @@ void WiFiComponent::loop() {
   }
 
   network_tick_mdns();
+
+  // The other states poll the connection progress and need the regular loop interval
+  if (!this->has_sta() || (this->state_ == WIFI_COMPONENT_STATE_STA_CONNECTED && this->is_connected()))
+    this->set_loop_wake_hint(IDLE_CHECK_INTERVAL);
 }
 
 WiFiComponent::WiFiComponent() { global_wifi_component = this; }
@@ -545,6 +545,8 @@ void WiFiComponent::wifi_event_callback_(system_event_id_t event, system_event_i
 #endif
     this->wifi_scan_done_callback_();
   }
+  // Called from the event task, let the loop handle the new state right away
+  App.wake_loop();
 }
 void WiFiComponent::wifi_pre_setup_() {
   auto f = std::bind(&WiFiComponent::wifi_event_callback_, this, std::placeholders::_1, std::placeholders::_2);
@@ -518,6 +518,8 @@ void WiFiComponent::wifi_event_callback(System_Event_t *event) {
   }
 
   WiFiMockClass::_event_callback(event);
+  // Let the loop handle the new state right away
+  App.wake_loop();
 }
 
 bool WiFiComponent::wifi_apply_output_power_(float output_power) {
@@ -1,6 +1,8 @@
 #include "wled_light_effect.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+
 #ifdef ARDUINO_ARCH_ESP32
 #include <WiFi.h>
 #endif
@@ -18,6 +20,8 @@ namespace wled {
 enum Protocol { WLED_NOTIFIER = 0, WARLS = 1, DRGB = 2, DRGBW = 3, DNRGB = 4 };
 
 const int DEFAULT_BLANK_TIME = 1000;
+/// Largest UDP payload that is not fragmented on ethernet/WiFi.
+static const uint16_t MAX_PAYLOAD_SIZE = 1472;
 
 static const char *const TAG = "wled_light_effect";
 
@@ -36,13 +40,10 @@ void WLEDLightEffect::stop() {
     udp_->stop();
     udp_.reset();
   }
+  payload_.reset();
 }
 
-void WLEDLightEffect::blank_all_leds_(light::AddressableLight &it) {
-  for (int led = it.size(); led-- > 0;) {
-    it[led].set(Color::BLACK);
-  }
-}
+void WLEDLightEffect::blank_all_leds_(light::AddressableLight &it) { it.all() = Color::BLACK; }
 
 void WLEDLightEffect::apply(light::AddressableLight &it, const Color &current_color) {
   // Init UDP lazily
@@ -55,16 +56,23 @@ void WLEDLightEffect::apply(light::AddressableLight &it, const Color &current_co
     }
   }
 
-  std::vector<uint8_t> payload;
+  if (!payload_) {
+    payload_.reset(new uint8_t[MAX_PAYLOAD_SIZE]);  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+
   while (uint16_t packet_size = udp_->parsePacket()) {
-    payload.resize(packet_size);
+    if (packet_size > MAX_PAYLOAD_SIZE) {
+      // the rest of the packet is discarded by the next parsePacket()
+      ESP_LOGD(TAG, "Frame: Too large (size=%u).", packet_size);
+      continue;
+    }
 
-    if (!udp_->read(&payload[0], payload.size())) {
+    if (!udp_->read(payload_.get(), packet_size)) {
       continue;
     }
 
-    if (!this->parse_frame_(it, &payload[0], payload.size())) {
-      ESP_LOGD(TAG, "Frame: Invalid (size=%zu, first=0x%02X).", payload.size(), payload[0]);
+    if (!this->parse_frame_(it, payload_.get(), packet_size)) {
+      ESP_LOGD(TAG, "Frame: Invalid (size=%u, first=0x%02X).", packet_size, payload_[0]);
       continue;
     }
   }
@@ -174,15 +182,7 @@ bool WLEDLightEffect::parse_drgb_frame_(light::AddressableLight &it, const uint8
   auto count = size / 3;
   auto max_leds = it.size();
 
-  for (uint16_t led = 0; led < count; ++led, payload += 3) {
-    uint8_t r = payload[0];
-    uint8_t g = payload[1];
-    uint8_t b = payload[2];
-
-    if (led < max_leds) {
-      it[led].set(Color(r, g, b));
-    }
-  }
+  it.write_rgb(0, payload, std::min<int32_t>(count, max_leds));
 
   return true;
 }
@@ -196,16 +196,7 @@ bool WLEDLightEffect::parse_drgbw_frame_(light::AddressableLight &it, const uint
   auto count = size / 4;
   auto max_leds = it.size();
 
-  for (uint16_t led = 0; led < count; ++led, payload += 4) {
-    uint8_t r = payload[0];
-    uint8_t g = payload[1];
-    uint8_t b = payload[2];
-    uint8_t w = payload[3];
-
-    if (led < max_leds) {
-      it[led].set(Color(r, g, b, w));
-    }
-  }
+  it.write_rgbw(0, payload, std::min<int32_t>(count, max_leds));
 
   return true;
 }
@@ -228,14 +219,8 @@ bool WLEDLightEffect::parse_dnrgb_frame_(light::AddressableLight &it, const uint
   auto count = size / 3;
   auto max_leds = it.size();
 
-  for (; count > 0; count--, payload += 3, led++) {
-    uint8_t r = payload[0];
-    uint8_t g = payload[1];
-    uint8_t b = payload[2];
-
-    if (led < max_leds) {
-      it[led].set(Color(r, g, b));
-    }
+  if (led < max_leds) {
+    it.write_rgb(led, payload, std::min<int32_t>(count, max_leds - led));
   }
 
   return true;
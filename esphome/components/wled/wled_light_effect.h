@@ -33,6 +33,8 @@ class WLEDLightEffect : public light::AddressableLightEffect {
  protected:
   uint16_t port_{0};
   std::unique_ptr<UDP> udp_;
+  /// Receive buffer, allocated together with udp_ and reused for every packet.
+  std::unique_ptr<uint8_t[]> payload_;
   uint32_t blank_at_{0};
   uint32_t dropped_{0};
 };
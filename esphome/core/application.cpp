@@ -11,6 +11,9 @@ namespace esphome {
 
 static const char *const TAG = "app";
 
+/// Upper bound for a single tickless sleep, so that the loop still runs if a wake_loop() call is missed.
+static const uint32_t MAX_TICKLESS_SLEEP = 60000;
+
 void Application::register_component_(Component *comp) {
   if (comp == nullptr) {
     ESP_LOGW(TAG, "Tried to register null component!");
@@ -66,23 +69,19 @@ void Application::setup() {
 }
 void Application::loop() {
   uint32_t new_app_state = 0;
-  const uint32_t start = millis();
 
   this->scheduler.call();
   for (Component *component : this->looping_components_) {
-    component->call();
+    {
+      WarnIfComponentBlockingGuard guard{component};
+      component->call();
+    }
     new_app_state |= component->get_component_state();
     this->app_state_ |= new_app_state;
     this->feed_wdt();
   }
   this->app_state_ = new_app_state;
 
-  const uint32_t end = millis();
-  if (end - start > 200) {
-    ESP_LOGV(TAG, "A component took a long time in a loop() cycle (%.2f s).", (end - start) / 1e3f);
-    ESP_LOGV(TAG, "Components should block for at most 20-30ms in loop().");
-  }
-
   const uint32_t now = millis();
 
   if (HighFrequencyLoopRequester::is_high_frequency()) {
@@ -92,12 +91,16 @@ void Application::loop() {
     if (now - this->last_loop_ < this->loop_interval_)
       delay_time = this->loop_interval_ - (now - this->last_loop_);
 
-    uint32_t next_schedule = this->scheduler.next_schedule_in().value_or(delay_time);
-    // next_schedule is max 0.5*delay_time
-    // otherwise interval=0 schedules result in constant looping with almost no sleep
-    next_schedule = std::max(next_schedule, delay_time / 2);
-    delay_time = std::min(next_schedule, delay_time);
-    delay(delay_time);
+    if (this->tickless_idle_) {
+      this->idle_sleep_arch_(this->calculate_tickless_sleep_(now, delay_time));
+    } else {
+      uint32_t next_schedule = this->scheduler.next_schedule_in().value_or(delay_time);
+      // next_schedule is max 0.5*delay_time
+      // otherwise interval=0 schedules result in constant looping with almost no sleep
+      next_schedule = std::max(next_schedule, delay_time / 2);
+      delay_time = std::min(next_schedule, delay_time);
+      delay(delay_time);
+    }
   }
   this->last_loop_ = now;
 
@@ -150,6 +153,39 @@ void Application::safe_reboot() {
   }
 }
 
+uint32_t Application::calculate_tickless_sleep_(uint32_t now, uint32_t delay_time) {
+  // dump_config() is called once per loop iteration, don't delay it
+  if (this->dump_config_at_ >= 0 && this->dump_config_at_ < this->components_.size())
+    return delay_time;
+
+  uint32_t sleep_time = MAX_TICKLESS_SLEEP;
+  for (auto *component : this->looping_components_) {
+    if (component->is_failed())
+      continue;
+    auto hint = component->get_loop_wake_hint(now);
+    if (!hint.has_value()) {
+      // This component needs to be looped regularly
+      if (component != this->tickless_blocker_) {
+        ESP_LOGV(TAG, "Component %s has no loop wake hint, using the loop interval", component->get_component_source());
+        this->tickless_blocker_ = component;
+      }
+      return delay_time;
+    }
+    sleep_time = std::min(sleep_time, *hint);
+  }
+
+  auto next_schedule = this->scheduler.next_schedule_in();
+  if (next_schedule.has_value()) {
+    // Same as in the regular loop: interval=0 schedules shouldn't result in constant looping
+    sleep_time = std::min(sleep_time, std::max(*next_schedule, delay_time / 2));
+  }
+  return sleep_time;
+}
+void ICACHE_RAM_ATTR Application::wake_loop() {
+  if (this->tickless_idle_)
+    this->wake_loop_arch_();
+}
+
 void Application::calculate_looping_components_() {
   for (auto *obj : this->components_) {
     if (obj->has_overridden_loop())
@@ -6,6 +6,7 @@
 #include "esphome/core/preferences.h"
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
+#include "esphome/core/profiler.h"
 #include "esphome/core/scheduler.h"
 
 #ifdef USE_BINARY_SENSOR
@@ -131,6 +132,22 @@ class Application {
    */
   void set_loop_interval(uint32_t loop_interval) { this->loop_interval_ = loop_interval; }
 
+  /** Enable tickless idle.
+   *
+   * Instead of waking up every loop interval, App.loop() sleeps until the next scheduled timeout/interval
+   * or the earliest wake hint declared by the looping components (see Component::set_loop_wake_hint()),
+   * or until wake_loop() is called. As long as one looping component doesn't declare a wake hint, the
+   * regular loop interval is used.
+   *
+   * The logger, wifi, api, ota, mqtt, web_server, captive_portal, sntp and the time triggers declare wake hints.
+   * Other looping components (for example ones that poll a UART) keep the regular loop interval, the component
+   * that does is logged at verbose level.
+   */
+  void set_tickless_idle(bool tickless_idle) { this->tickless_idle_ = tickless_idle; }
+
+  /// Wake up the main loop if it's sleeping in tickless idle, safe to call from ISRs.
+  void wake_loop();
+
   void schedule_dump_config() { this->dump_config_at_ = 0; }
 
   void feed_wdt();
@@ -242,6 +259,9 @@ class Application {
 #endif
 
   Scheduler scheduler;
+#ifdef USE_PROFILER
+  Profiler profiler;
+#endif
 
  protected:
   friend Component;
@@ -252,6 +272,12 @@ class Application {
 
   void feed_wdt_arch_();
 
+  /// Calculate how long the main loop can sleep in tickless idle.
+  uint32_t calculate_tickless_sleep_(uint32_t now, uint32_t delay_time);
+  /// Sleep for at most ms milliseconds, returning early if wake_loop() is called (where supported).
+  void idle_sleep_arch_(uint32_t ms);
+  void wake_loop_arch_();
+
   std::vector<Component *> components_{};
   std::vector<Component *> looping_components_{};
 
@@ -291,6 +317,9 @@ class Application {
   bool name_add_mac_suffix_;
   uint32_t last_loop_{0};
   uint32_t loop_interval_{16};
+  bool tickless_idle_{false};
+  /// The looping component without a wake hint that kept the regular loop interval last time, for logging.
+  Component *tickless_blocker_{nullptr};
   int dump_config_at_{-1};
   uint32_t app_state_{0};
 };
@@ -2,10 +2,15 @@
 
 #ifdef ARDUINO_ARCH_ESP32
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
 namespace esphome {
 
 static const char *const TAG = "app_esp32";
 
+static SemaphoreHandle_t wake_semaphore = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
 void ICACHE_RAM_ATTR HOT Application::feed_wdt_arch_() {
 #if CONFIG_ARDUINO_RUNNING_CORE == 0
 #ifdef CONFIG_TASK_WDT_CHECK_IDLE_TASK_CPU0
@@ -17,5 +22,24 @@ void ICACHE_RAM_ATTR HOT Application::feed_wdt_arch_() {
 #endif
 }
 
+void Application::idle_sleep_arch_(uint32_t ms) {
+  if (wake_semaphore == nullptr)
+    wake_semaphore = xSemaphoreCreateBinary();
+  // Blocking on the semaphore lets the idle task run, which enters light sleep if power management is enabled
+  xSemaphoreTake(wake_semaphore, pdMS_TO_TICKS(ms));
+}
+void ICACHE_RAM_ATTR Application::wake_loop_arch_() {
+  if (wake_semaphore == nullptr)
+    return;
+  if (xPortInIsrContext()) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(wake_semaphore, &higher_priority_task_woken);
+    if (higher_priority_task_woken)
+      portYIELD_FROM_ISR();
+  } else {
+    xSemaphoreGive(wake_semaphore);
+  }
+}
+
 }  // namespace esphome
 #endif
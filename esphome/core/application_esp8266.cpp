@@ -1,12 +1,61 @@
 #include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
 
 #ifdef ARDUINO_ARCH_ESP8266
 
+#include <osapi.h>
+#include <user_interface.h>
+
 namespace esphome {
 
 static const char *const TAG = "app_esp8266";
 
+/// Whether the loop is suspended in idle_sleep_arch_(), and whether wake_loop() was called while it wasn't.
+static volatile bool idle_sleeping = false;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+static volatile bool wake_pending = false;   // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+static os_timer_t idle_timer;                // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Resume the loop task, only once per sleep so that no wakeup is left over to cut a later delay() short.
+// Interrupts have to be disabled by the caller.
+static void ICACHE_RAM_ATTR resume_idle_loop() {
+  if (!idle_sleeping)
+    return;
+  idle_sleeping = false;
+  esp_schedule();
+}
+static void idle_timer_callback(void *arg) {
+  InterruptLock lock;
+  resume_idle_loop();
+}
+
 void ICACHE_RAM_ATTR HOT Application::feed_wdt_arch_() { ESP.wdtFeed(); }
 
+void Application::idle_sleep_arch_(uint32_t ms) {
+  {
+    InterruptLock lock;
+    if (wake_pending) {
+      wake_pending = false;
+      return;
+    }
+    idle_sleeping = true;
+  }
+  // Like delay(), but the loop task can also be resumed by wake_loop()
+  os_timer_setfn(&idle_timer, &idle_timer_callback, nullptr);
+  os_timer_arm(&idle_timer, ms, false);
+  esp_yield();
+  os_timer_disarm(&idle_timer);
+  InterruptLock lock;
+  idle_sleeping = false;
+  wake_pending = false;
+}
+void ICACHE_RAM_ATTR Application::wake_loop_arch_() {
+  InterruptLock lock;
+  if (idle_sleeping) {
+    resume_idle_loop();
+  } else {
+    wake_pending = true;
+  }
+}
+
 }  // namespace esphome
 #endif
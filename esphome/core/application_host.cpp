@@ -0,0 +1,16 @@
+#include "esphome/core/application.h"
+
+#ifdef USE_HOST
+
+namespace esphome {
+
+static const char *const TAG = "app_host";
+
+void ICACHE_RAM_ATTR HOT Application::feed_wdt_arch_() {}
+
+// Everything runs in a single thread, nothing can wake the loop while it sleeps
+void Application::idle_sleep_arch_(uint32_t ms) { delay(ms); }
+void Application::wake_loop_arch_() {}
+
+}  // namespace esphome
+#endif
@@ -36,6 +36,8 @@ const uint32_t STATUS_LED_OK = 0x0000;
 const uint32_t STATUS_LED_WARNING = 0x0100;
 const uint32_t STATUS_LED_ERROR = 0x0200;
 
+const uint32_t WAKE_HINT_ON_EVENT = 0xFFFFFFFF;
+
 uint32_t global_state = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 float Component::get_loop_priority() const { return 0.0f; }
@@ -68,12 +70,21 @@ void Component::call_setup() { this->setup(); }
 uint32_t Component::get_component_state() const { return this->component_state_; }
 void Component::call() {
   uint32_t state = this->component_state_ & COMPONENT_STATE_MASK;
+#ifdef USE_PROFILER
+  TimingStats *stats = nullptr;
+  const uint32_t start = micros();
+#endif
   switch (state) {
     case COMPONENT_STATE_CONSTRUCTION:
       // State Construction: Call setup and set state to setup
       this->component_state_ &= ~COMPONENT_STATE_MASK;
       this->component_state_ |= COMPONENT_STATE_SETUP;
       this->call_setup();
+#ifdef USE_PROFILER
+      if (this->setup_stats_ == nullptr)
+        this->setup_stats_ = App.profiler.get_stats(this, PROFILER_KIND_SETUP);
+      stats = this->setup_stats_;
+#endif
       break;
     case COMPONENT_STATE_SETUP:
       // State setup: Call first loop and set state to loop
@@ -82,15 +93,29 @@ void Component::call() {
       this->call_loop();
       break;
     case COMPONENT_STATE_LOOP:
-      // State loop: Call loop
+      // State loop: Call loop, the component has to renew its wake hint every time
+      this->has_wake_hint_ = false;
       this->call_loop();
       break;
     case COMPONENT_STATE_FAILED:
       // State failed: Do nothing
-      break;
+      return;
     default:
-      break;
+      return;
   }
+#ifdef USE_PROFILER
+  if (stats == nullptr) {
+    if (this->loop_stats_ == nullptr)
+      this->loop_stats_ = App.profiler.get_stats(this, PROFILER_KIND_LOOP);
+    stats = this->loop_stats_;
+  }
+  stats->record(micros() - start);
+#endif
+}
+const char *Component::get_component_source() const {
+  if (this->component_source_ == nullptr)
+    return "<unknown>";
+  return this->component_source_;
 }
 void Component::mark_failed() {
   ESP_LOGE(TAG, "Component was marked as failed.");
@@ -142,19 +167,53 @@ float Component::get_actual_setup_priority() const {
   return this->setup_priority_override_;
 }
 void Component::set_setup_priority(float priority) { this->setup_priority_override_ = priority; }
+void Component::set_loop_wake_hint(uint32_t ms) {
+  this->wake_hint_start_ = millis();
+  this->wake_hint_length_ = ms;
+  this->has_wake_hint_ = true;
+}
+optional<uint32_t> Component::get_loop_wake_hint(uint32_t now) const {
+  if (!this->has_wake_hint_)
+    return {};
+  if (this->wake_hint_length_ == WAKE_HINT_ON_EVENT)
+    return WAKE_HINT_ON_EVENT;
+  uint32_t elapsed = now - this->wake_hint_start_;
+  if (elapsed >= this->wake_hint_length_)
+    return 0;
+  return this->wake_hint_length_ - elapsed;
+}
 
 bool Component::has_overridden_loop() const {
 #ifdef CLANG_TIDY
-  bool loop_overridden = true;
   bool call_loop_overridden = true;
 #else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpmf-conversions"
-  bool loop_overridden = (void *) (this->*(&Component::loop)) != (void *) (&Component::loop);
   bool call_loop_overridden = (void *) (this->*(&Component::call_loop)) != (void *) (&Component::call_loop);
 #pragma GCC diagnostic pop
 #endif
-  return loop_overridden || call_loop_overridden;
+  return this->is_loop_overridden_() || call_loop_overridden;
+}
+bool Component::is_loop_overridden_() const {
+#ifdef CLANG_TIDY
+  return true;
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpmf-conversions"
+  return (void *) (this->*(&Component::loop)) != (void *) (&Component::loop);
+#pragma GCC diagnostic pop
+#endif
+}
+
+WarnIfComponentBlockingGuard::WarnIfComponentBlockingGuard(const Component *component)
+    : started_(millis()), component_(component) {}
+WarnIfComponentBlockingGuard::~WarnIfComponentBlockingGuard() {
+  const uint32_t blocked = millis() - this->started_;
+  if (blocked > 50) {
+    const char *src = this->component_ == nullptr ? "<null>" : this->component_->get_component_source();
+    ESP_LOGW(TAG, "Component %s took a long time for an operation (%.2f s).", src, blocked / 1e3f);
+    ESP_LOGW(TAG, "Components should block for at most 20-30ms.");
+  }
 }
 
 PollingComponent::PollingComponent(uint32_t update_interval) : Component(), update_interval_(update_interval) {}
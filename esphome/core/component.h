@@ -2,9 +2,11 @@
 
 #include <string>
 #include <functional>
-#include "Arduino.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/esphal.h"
 
 #include "esphome/core/optional.h"
+#include "esphome/core/profiler.h"
 
 namespace esphome {
 
@@ -55,6 +57,9 @@ extern const uint32_t STATUS_LED_OK;
 extern const uint32_t STATUS_LED_WARNING;
 extern const uint32_t STATUS_LED_ERROR;
 
+/// Wake hint for components that have no work to do until App.wake_loop() is called.
+extern const uint32_t WAKE_HINT_ON_EVENT;
+
 class Component {
  public:
   /** Where the component's initialization should happen.
@@ -130,9 +135,30 @@ class Component {
 
   bool has_overridden_loop() const;
 
+  /** Get the time in ms until this component's loop() has work to do again, as declared with set_loop_wake_hint().
+   *
+   * @return The remaining idle time, or an empty optional if the component did not declare a wake hint
+   *         and needs to be looped at the regular loop interval.
+   */
+  optional<uint32_t> get_loop_wake_hint(uint32_t now) const;
+
+  /** Get the integration where this component was declared as a string.
+   *
+   * Returns "<unknown>" if the source was not set.
+   */
+  const char *get_component_source() const;
+
+  /** Set where this component was loaded from for some debug messages.
+   *
+   * This is set by the ESPHome core, and should not be called manually.
+   */
+  void set_component_source(const char *source) { this->component_source_ = source; }
+
  protected:
   virtual void call_loop();
   virtual void call_setup();
+  /// Whether a subclass implements loop().
+  bool is_loop_overridden_() const;
   /** Set an interval function with a unique name. Empty name means no cancelling possible.
    *
    * This will call f every interval ms. Can be cancelled via CancelInterval().
@@ -199,8 +225,27 @@ class Component {
   /// Cancel a defer callback using the specified name, name must not be empty.
   bool cancel_defer(const std::string &name);  // NOLINT
 
+  /** Declare that loop() has no work to do for the next `ms` milliseconds.
+   *
+   * Only used when tickless idle is enabled: if all looping components declared a wake hint, the main loop
+   * sleeps until the earliest hint or scheduled timeout instead of waking up every loop interval. The hint
+   * is reset before every loop() call, so it has to be renewed from loop(). Pass WAKE_HINT_ON_EVENT if the
+   * component only has work to do after an event, which must then call App.wake_loop() (safe from ISRs).
+   *
+   * @param ms The time in ms until loop() needs to be called again.
+   */
+  void set_loop_wake_hint(uint32_t ms);
+
   uint32_t component_state_{0x0000};  ///< State of this component.
   float setup_priority_override_{NAN};
+  uint32_t wake_hint_start_{0};
+  uint32_t wake_hint_length_{0};
+  bool has_wake_hint_{false};
+  const char *component_source_{nullptr};
+#ifdef USE_PROFILER
+  TimingStats *setup_stats_{nullptr};
+  TimingStats *loop_stats_{nullptr};
+#endif
 };
 
 /** This class simplifies creating components that periodically check a state.
@@ -242,6 +287,20 @@ class PollingComponent : public Component {
   uint32_t update_interval_;
 };
 
+/** Log a warning with the component source if the guarded operation blocks the main loop for too long.
+ *
+ * Used around loop() calls and scheduler callbacks, so that a slow component can be identified from the logs.
+ */
+class WarnIfComponentBlockingGuard {
+ public:
+  explicit WarnIfComponentBlockingGuard(const Component *component);
+  ~WarnIfComponentBlockingGuard();
+
+ protected:
+  uint32_t started_;
+  const Component *component_;
+};
+
 /// Helper class that enables naming of objects so that it doesn't have to be re-implement every time.
 class Nameable {
  public:
@@ -48,6 +48,7 @@ LoopTrigger = cg.esphome_ns.class_(
 VERSION_REGEX = re.compile(r"^[0-9]+\.[0-9]+\.[0-9]+(?:[ab]\d+)?$")
 
 CONF_NAME_ADD_MAC_SUFFIX = "name_add_mac_suffix"
+CONF_TICKLESS_IDLE = "tickless_idle"
 
 
 def validate_board(value: str):
@@ -196,6 +197,7 @@ CONFIG_SCHEMA = cv.Schema(
         cv.Optional(CONF_INCLUDES, default=[]): cv.ensure_list(valid_include),
         cv.Optional(CONF_LIBRARIES, default=[]): cv.ensure_list(cv.string_strict),
         cv.Optional(CONF_NAME_ADD_MAC_SUFFIX, default=False): cv.boolean,
+        cv.Optional(CONF_TICKLESS_IDLE, default=False): cv.boolean,
         cv.Optional(CONF_PROJECT): cv.Schema(
             {
                 cv.Required(CONF_NAME): cv.All(cv.string_strict, valid_project_name),
@@ -322,6 +324,9 @@ async def to_code(config):
 
     CORE.add_job(_add_automations, config)
 
+    if config[CONF_TICKLESS_IDLE]:
+        cg.add(cg.App.set_tickless_idle(True))
+
     # Set LWIP build constants for ESP8266
     if CORE.is_esp8266:
         CORE.add_job(_esp8266_add_lwip_type)
@@ -1,13 +1,9 @@
 #pragma once
 // This file is auto-generated! Do not edit!
 
-#define USE_API
-#define USE_LOGGER
 #define USE_BINARY_SENSOR
 #define USE_SENSOR
 #define USE_SWITCH
-#define USE_WIFI
-#define USE_STATUS_LED
 #define USE_TEXT_SENSOR
 #define USE_FAN
 #define USE_COVER
@@ -15,6 +11,11 @@
 #define USE_CLIMATE
 #define USE_NUMBER
 #define USE_SELECT
+#ifndef USE_HOST
+#define USE_API
+#define USE_LOGGER
+#define USE_WIFI
+#define USE_STATUS_LED
 #define USE_MQTT
 #define USE_POWER_SUPPLY
 #define USE_HOMEASSISTANT_TIME
@@ -29,3 +30,5 @@
 #define USE_CAPTIVE_PORTAL
 #define ESPHOME_BOARD "dummy_board"
 #define USE_MDNS
+#define USE_PROFILER
+#endif
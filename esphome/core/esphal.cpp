@@ -38,6 +38,9 @@ GPIOPin::GPIOPin(uint8_t pin, uint8_t mode, bool inverted)
       gpio_read_(pin < 32 ? &GPIO.in : &GPIO.in1.val),
 #endif
       gpio_mask_(pin < 32 ? (1UL << pin) : (1UL << (pin - 32)))
+#elif defined(USE_HOST)
+      gpio_read_(&host::gpio_register),
+      gpio_mask_(1UL << (pin % 32))
 #endif
 {
 }
@@ -153,6 +156,13 @@ void ICACHE_RAM_ATTR HOT GPIOPin::digital_write(bool value) {
     (*this->gpio_clear_) = this->gpio_mask_;
   }
 #endif
+#ifdef USE_HOST
+  if (value != this->inverted_) {
+    (*this->gpio_read_) |= this->gpio_mask_;
+  } else {
+    (*this->gpio_read_) &= ~this->gpio_mask_;
+  }
+#endif
 }
 void ICACHE_RAM_ATTR HOT ISRInternalGPIOPin::digital_write(bool value) {
 #ifdef ARDUINO_ARCH_ESP8266
@@ -177,6 +187,13 @@ void ICACHE_RAM_ATTR HOT ISRInternalGPIOPin::digital_write(bool value) {
     (*this->gpio_clear_) = this->gpio_mask_;
   }
 #endif
+#ifdef USE_HOST
+  if (value != this->inverted_) {
+    (*this->gpio_read_) |= this->gpio_mask_;
+  } else {
+    (*this->gpio_read_) &= ~this->gpio_mask_;
+  }
+#endif
 }
 ISRInternalGPIOPin::ISRInternalGPIOPin(uint8_t pin,
 #ifdef ARDUINO_ARCH_ESP32
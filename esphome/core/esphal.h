@@ -1,6 +1,10 @@
 #pragma once
 
+#ifdef USE_HOST
+#include "esphome/core/esphal_host.h"
+#else
 #include "Arduino.h"
+#endif
 #ifdef ARDUINO_ARCH_ESP32
 #include <esp32-hal.h>
 #endif
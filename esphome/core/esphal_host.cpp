@@ -0,0 +1,53 @@
+#ifdef USE_HOST
+
+#include "esphome/core/esphal_host.h"
+#include <cstdio>
+
+namespace esphome {
+namespace host {
+
+void VirtualClock::sleep_micros(uint64_t us) {
+  this->now_us_ += us;
+  this->slept_us_ += us;
+  this->sleep_count_++;
+}
+void VirtualClock::reset_stats() {
+  this->sleep_count_ = 0;
+  this->slept_us_ = 0;
+}
+
+VirtualClock global_virtual_clock;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+volatile uint32_t gpio_register = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace host
+}  // namespace esphome
+
+using esphome::host::global_virtual_clock;
+
+uint32_t millis() { return global_virtual_clock.get_micros() / 1000ULL; }
+uint32_t micros() { return global_virtual_clock.get_micros(); }
+void delay(uint32_t ms) { global_virtual_clock.sleep_micros(uint64_t(ms) * 1000ULL); }
+void delayMicroseconds(uint32_t us) { global_virtual_clock.sleep_micros(us); }
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (val) {
+    esphome::host::gpio_register |= 1UL << (pin % 32);
+  } else {
+    esphome::host::gpio_register &= ~(1UL << (pin % 32));
+  }
+}
+int digitalRead(uint8_t pin) { return (esphome::host::gpio_register >> (pin % 32)) & 1; }
+
+char *dtostrf(double value, signed char width, unsigned char prec, char *s) {
+  sprintf(s, "%*.*f", width, prec, value);
+  return s;
+}
+
+void EspClass::restart() { std::exit(0); }
+uint32_t EspClass::getFreeHeap() { return UINT32_MAX; }
+
+EspClass ESP;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+#endif  // USE_HOST
@@ -0,0 +1,98 @@
+#pragma once
+
+#ifdef USE_HOST
+
+// Minimal stand-in for the parts of the Arduino core that esphome/core relies on, so that the core and
+// hardware-independent components can be compiled and run natively (for example for benchmarks).
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+#include <strings.h>
+
+#define ICACHE_RAM_ATTR
+#define ICACHE_RODATA_ATTR
+#define PROGMEM
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+
+static const uint8_t INPUT = 0x00;
+static const uint8_t OUTPUT = 0x01;
+static const uint8_t INPUT_PULLUP = 0x02;
+static const uint8_t OUTPUT_OPEN_DRAIN = 0x03;
+static const uint8_t SPECIAL = 0xF8;
+static const uint8_t FUNCTION_1 = 0x18;
+static const uint8_t FUNCTION_2 = 0x28;
+static const uint8_t FUNCTION_3 = 0x38;
+static const uint8_t FUNCTION_4 = 0x48;
+
+static const uint8_t LOW = 0x00;
+static const uint8_t HIGH = 0x01;
+
+static const uint8_t RISING = 0x01;
+static const uint8_t FALLING = 0x02;
+static const uint8_t CHANGE = 0x03;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+char *dtostrf(double value, signed char width, unsigned char prec, char *s);
+
+class EspClass {
+ public:
+  /// Terminates the host process, there is nothing to reboot into.
+  [[noreturn]] void restart();
+  uint32_t getFreeHeap();  // NOLINT(readability-identifier-naming)
+};
+
+extern EspClass ESP;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+namespace esphome {
+namespace host {
+
+/** Deterministic time source for host builds.
+ *
+ * millis() and micros() return the virtual time kept here and delay() advances it instead of actually
+ * sleeping. This way a simulated Application::loop() runs as fast as the host can execute it while all
+ * timeouts and intervals still fire in the same order as on a device. Code driving the simulation
+ * (like a benchmark) moves time forward explicitly with advance_micros()/advance_millis().
+ */
+class VirtualClock {
+ public:
+  uint64_t get_micros() const { return this->now_us_; }
+  void set_micros(uint64_t now_us) { this->now_us_ = now_us; }
+  void advance_micros(uint64_t us) { this->now_us_ += us; }
+  void advance_millis(uint32_t ms) { this->now_us_ += uint64_t(ms) * 1000ULL; }
+
+  /// Called by delay()/delayMicroseconds(): record the sleep and advance the clock by its duration.
+  void sleep_micros(uint64_t us);
+
+  /// Number of delay() calls (i.e. loop wakeups) since the last reset_stats().
+  uint32_t get_sleep_count() const { return this->sleep_count_; }
+  /// Total time spent in delay() since the last reset_stats().
+  uint64_t get_slept_micros() const { return this->slept_us_; }
+  void reset_stats();
+
+ protected:
+  uint64_t now_us_{0};
+  uint32_t sleep_count_{0};
+  uint64_t slept_us_{0};
+};
+
+extern VirtualClock global_virtual_clock;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/// Simulated GPIO register, pins configured as outputs are looped back to their inputs.
+extern volatile uint32_t gpio_register;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace host
+}  // namespace esphome
+
+#endif  // USE_HOST
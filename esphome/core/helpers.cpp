@@ -4,7 +4,8 @@
 
 #ifdef ARDUINO_ARCH_ESP8266
 #include <ESP8266WiFi.h>
-#else
+#endif
+#ifdef ARDUINO_ARCH_ESP32
 #include <Esp.h>
 #endif
 
@@ -15,6 +16,14 @@ namespace esphome {
 
 static const char *const TAG = "helpers";
 
+#ifdef USE_HOST
+static void host_get_mac_address(uint8_t *mac) {
+  // Locally administered address, stable so that generated names are reproducible
+  static const uint8_t HOST_MAC[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+  memcpy(mac, HOST_MAC, sizeof(HOST_MAC));
+}
+#endif
+
 std::string get_mac_address() {
   char tmp[20];
   uint8_t mac[6];
@@ -23,6 +32,9 @@ std::string get_mac_address() {
 #endif
 #ifdef ARDUINO_ARCH_ESP8266
   WiFi.macAddress(mac);
+#endif
+#ifdef USE_HOST
+  host_get_mac_address(mac);
 #endif
   sprintf(tmp, "%02x%02x%02x%02x%02x%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
   return std::string(tmp);
@@ -36,6 +48,9 @@ std::string get_mac_address_pretty() {
 #endif
 #ifdef ARDUINO_ARCH_ESP8266
   WiFi.macAddress(mac);
+#endif
+#ifdef USE_HOST
+  host_get_mac_address(mac);
 #endif
   sprintf(tmp, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
   return std::string(tmp);
@@ -46,6 +61,9 @@ std::string generate_hostname(const std::string &base) { return base + std::stri
 uint32_t random_uint32() {
 #ifdef ARDUINO_ARCH_ESP32
   return esp_random();
+#elif defined(USE_HOST)
+  // Deterministic (glibc random() is seeded with 1 unless srandom() is called)
+  return (uint32_t(random()) << 16) ^ uint32_t(random());
 #else
   return os_random();
 #endif
@@ -184,6 +202,11 @@ uint8_t crc8(uint8_t *data, uint8_t len) {
 void delay_microseconds_accurate(uint32_t usec) {
   if (usec == 0)
     return;
+#ifdef USE_HOST
+  // micros() only advances in delay() on host, busy waiting would never terminate
+  delayMicroseconds(usec);
+  return;
+#endif
   if (usec < 5000UL) {
     delayMicroseconds(usec);
     return;
@@ -264,11 +287,12 @@ optional<int> parse_int(const std::string &str) {
     return {};
   return value;
 }
-uint32_t fnv1_hash(const std::string &str) {
+uint32_t fnv1_hash(const std::string &str) { return fnv1_hash(str.data(), str.size()); }
+uint32_t fnv1_hash(const char *data, size_t length) {
   uint32_t hash = 2166136261UL;
-  for (char c : str) {
+  for (size_t i = 0; i < length; i++) {
     hash *= 16777619UL;
-    hash ^= c;
+    hash ^= data[i];
   }
   return hash;
 }
@@ -348,5 +372,10 @@ ICACHE_RAM_ATTR InterruptLock::~InterruptLock() { xt_wsr_ps(xt_state_); }
 ICACHE_RAM_ATTR InterruptLock::InterruptLock() { portDISABLE_INTERRUPTS(); }
 ICACHE_RAM_ATTR InterruptLock::~InterruptLock() { portENABLE_INTERRUPTS(); }
 #endif
+#ifdef USE_HOST
+// Everything runs in a single thread on host, there are no interrupts to disable
+InterruptLock::InterruptLock() {}
+InterruptLock::~InterruptLock() {}
+#endif
 
 }  // namespace esphome
@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <type_traits>
+#include <array>
 
 #include "esphome/core/optional.h"
 #include "esphome/core/esphal.h"
@@ -323,6 +324,7 @@ template<typename T> class Parented {
 };
 
 uint32_t fnv1_hash(const std::string &str);
+uint32_t fnv1_hash(const char *data, size_t length);
 
 template<typename T> T *new_buffer(size_t length) {
   T *buffer;
@@ -1,6 +1,7 @@
 #include "log.h"
 #include "defines.h"
 #include "helpers.h"
+#include <cstdio>
 
 #ifdef USE_LOGGER
 #include "esphome/components/logger/logger.h"
@@ -30,6 +31,10 @@ void HOT esp_log_vprintf_(int level, const char *tag, int line, const char *form
     return;
 
   log->log_vprintf_(level, tag, line, format, args);
+#elif defined(USE_HOST)
+  printf("[%s:%03u]: ", tag, line);
+  vprintf(format, args);
+  printf("\n");
 #endif
 }
 
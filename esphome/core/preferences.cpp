@@ -2,6 +2,7 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/application.h"
+#include <algorithm>
 
 #ifdef ARDUINO_ARCH_ESP8266
 extern "C" {
@@ -52,6 +53,85 @@ bool ESPPreferenceObject::save_() {
   return true;
 }
 
+#if defined(ARDUINO_ARCH_ESP8266) || defined(USE_HOST)
+
+#ifdef USE_HOST
+static const uint32_t FLASH_STORAGE_SIZE = 256;
+#elif defined(USE_ESP8266_PREFERENCES_FLASH)
+static const uint32_t FLASH_STORAGE_SIZE = 128;
+#else
+static const uint32_t FLASH_STORAGE_SIZE = 64;
+#endif
+
+#ifdef ESPHOME_PREFERENCES_FLASH_SECTORS
+static const uint8_t FLASH_SECTORS = ESPHOME_PREFERENCES_FLASH_SECTORS;
+#else
+static const uint8_t FLASH_SECTORS = 1;
+#endif
+
+bool ESPPreferenceObject::save_flash_() {
+  if (global_preferences.flash_log_ == nullptr)
+    return false;
+  for (uint32_t i = 0; i <= this->length_words_; i++) {
+    uint32_t j = this->offset_ + i;
+    if (j >= FLASH_STORAGE_SIZE)
+      return false;
+    uint32_t v = this->data_[i];
+    uint32_t *ptr = &global_preferences.flash_storage_[j];
+    if (*ptr != v)
+      global_preferences.flash_dirty_[j] = true;
+    *ptr = v;
+  }
+  if (!global_preferences.deferred_sync_)
+    global_preferences.sync();
+  return true;
+}
+bool ESPPreferenceObject::load_flash_() {
+  if (global_preferences.flash_log_ == nullptr)
+    return false;
+  for (uint32_t i = 0; i <= this->length_words_; i++) {
+    uint32_t j = this->offset_ + i;
+    if (j >= FLASH_STORAGE_SIZE)
+      return false;
+    this->data_[i] = global_preferences.flash_storage_[j];
+  }
+  return true;
+}
+
+bool ESPPreferences::sync() {
+  if (this->flash_log_ == nullptr)
+    return true;
+
+  const uint32_t compactions = this->flash_log_->get_compactions();
+  uint32_t start = 0;
+  while (start < this->current_flash_offset_) {
+    if (!this->flash_dirty_[start]) {
+      start++;
+      continue;
+    }
+    // Changed words separated by fewer unchanged words than the overhead of a record go into the same record
+    uint32_t end = start + 1;
+    for (uint32_t i = end; i < this->current_flash_offset_ && i <= end + PreferencesLog::RECORD_OVERHEAD; i++) {
+      if (this->flash_dirty_[i])
+        end = i + 1;
+    }
+
+    if (!this->flash_log_->append(start, end - start)) {
+      ESP_LOGV(TAG, "Writing preferences to flash failed!");
+      return false;
+    }
+    if (this->flash_log_->get_compactions() != compactions) {
+      // The log was compacted, which wrote the whole image
+      std::fill(this->flash_dirty_.begin(), this->flash_dirty_.end(), false);
+      return true;
+    }
+    std::fill(this->flash_dirty_.begin() + start, this->flash_dirty_.begin() + end, false);
+    start = end;
+  }
+  return true;
+}
+#endif
+
 #ifdef ARDUINO_ARCH_ESP8266
 
 static const uint32_t ESP_RTC_USER_MEM_START = 0x60001200;
@@ -59,12 +139,6 @@ static const uint32_t ESP_RTC_USER_MEM_START = 0x60001200;
 static const uint32_t ESP_RTC_USER_MEM_SIZE_WORDS = 128;
 static const uint32_t ESP_RTC_USER_MEM_SIZE_BYTES = ESP_RTC_USER_MEM_SIZE_WORDS * 4;
 
-#ifdef USE_ESP8266_PREFERENCES_FLASH
-static const uint32_t ESP8266_FLASH_STORAGE_SIZE = 128;
-#else
-static const uint32_t ESP8266_FLASH_STORAGE_SIZE = 64;
-#endif
-
 static inline bool esp_rtc_user_mem_read(uint32_t index, uint32_t *dest) {
   if (index >= ESP_RTC_USER_MEM_SIZE_WORDS) {
     return false;
@@ -73,8 +147,6 @@ static inline bool esp_rtc_user_mem_read(uint32_t index, uint32_t *dest) {
   return true;
 }
 
-static bool esp8266_flash_dirty = false;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-
 static inline bool esp_rtc_user_mem_write(uint32_t index, uint32_t value) {
   if (index >= ESP_RTC_USER_MEM_SIZE_WORDS) {
     return false;
@@ -88,58 +160,44 @@ static inline bool esp_rtc_user_mem_write(uint32_t index, uint32_t value) {
   return true;
 }
 
-extern "C" uint32_t _SPIFFS_end;  // NOLINT
+extern "C" uint32_t _SPIFFS_start;  // NOLINT
+extern "C" uint32_t _SPIFFS_end;    // NOLINT
 
-static const uint32_t get_esp8266_flash_sector() {
+static uint32_t get_esp8266_flash_sector(uint32_t *symbol) {
   union {
     uint32_t *ptr;
     uint32_t uint;
   } data{};
-  data.ptr = &_SPIFFS_end;
+  data.ptr = symbol;
   return (data.uint - 0x40200000) / SPI_FLASH_SEC_SIZE;
 }
-static const uint32_t get_esp8266_flash_address() { return get_esp8266_flash_sector() * SPI_FLASH_SEC_SIZE; }
 
-void ESPPreferences::save_esp8266_flash_() {
-  if (!esp8266_flash_dirty)
-    return;
+class ESP8266PreferencesFlash : public PreferencesFlash {
+ public:
+  explicit ESP8266PreferencesFlash(uint32_t first_sector) : first_sector_(first_sector) {}
 
-  ESP_LOGVV(TAG, "Saving preferences to flash...");
-  SpiFlashOpResult erase_res, write_res = SPI_FLASH_RESULT_OK;
-  {
+  bool read(uint32_t address, uint32_t *data, size_t size) override {
     InterruptLock lock;
-    erase_res = spi_flash_erase_sector(get_esp8266_flash_sector());
-    if (erase_res == SPI_FLASH_RESULT_OK) {
-      write_res = spi_flash_write(get_esp8266_flash_address(), this->flash_storage_, ESP8266_FLASH_STORAGE_SIZE * 4);
-    }
+    return spi_flash_read(this->first_sector_ * SECTOR_SIZE + address, data, size) == SPI_FLASH_RESULT_OK;
   }
-  if (erase_res != SPI_FLASH_RESULT_OK) {
-    ESP_LOGV(TAG, "Erase ESP8266 flash failed!");
-    return;
+  bool write(uint32_t address, const uint32_t *data, size_t size) override {
+    InterruptLock lock;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    return spi_flash_write(this->first_sector_ * SECTOR_SIZE + address, const_cast<uint32_t *>(data), size) ==
+           SPI_FLASH_RESULT_OK;
   }
-  if (write_res != SPI_FLASH_RESULT_OK) {
-    ESP_LOGV(TAG, "Write ESP8266 flash failed!");
-    return;
+  bool erase_sector(uint32_t sector) override {
+    InterruptLock lock;
+    return spi_flash_erase_sector(this->first_sector_ + sector) == SPI_FLASH_RESULT_OK;
   }
 
-  esp8266_flash_dirty = false;
-}
+ protected:
+  uint32_t first_sector_;
+};
 
 bool ESPPreferenceObject::save_internal_() {
-  if (this->in_flash_) {
-    for (uint32_t i = 0; i <= this->length_words_; i++) {
-      uint32_t j = this->offset_ + i;
-      if (j >= ESP8266_FLASH_STORAGE_SIZE)
-        return false;
-      uint32_t v = this->data_[i];
-      uint32_t *ptr = &global_preferences.flash_storage_[j];
-      if (*ptr != v)
-        esp8266_flash_dirty = true;
-      *ptr = v;
-    }
-    global_preferences.save_esp8266_flash_();
-    return true;
-  }
+  if (this->in_flash_)
+    return this->save_flash_();
 
   for (uint32_t i = 0; i <= this->length_words_; i++) {
     if (!esp_rtc_user_mem_write(this->offset_ + i, this->data_[i]))
@@ -149,16 +207,8 @@ bool ESPPreferenceObject::save_internal_() {
   return true;
 }
 bool ESPPreferenceObject::load_internal_() {
-  if (this->in_flash_) {
-    for (uint32_t i = 0; i <= this->length_words_; i++) {
-      uint32_t j = this->offset_ + i;
-      if (j >= ESP8266_FLASH_STORAGE_SIZE)
-        return false;
-      this->data_[i] = global_preferences.flash_storage_[j];
-    }
-
-    return true;
-  }
+  if (this->in_flash_)
+    return this->load_flash_();
 
   for (uint32_t i = 0; i <= this->length_words_; i++) {
     if (!esp_rtc_user_mem_read(this->offset_ + i, &this->data_[i]))
@@ -173,12 +223,21 @@ ESPPreferences::ESPPreferences()
     : current_offset_(0) {}
 
 void ESPPreferences::begin() {
-  this->flash_storage_ = new uint32_t[ESP8266_FLASH_STORAGE_SIZE];
+  this->flash_storage_ = new uint32_t[FLASH_STORAGE_SIZE];  // NOLINT(cppcoreguidelines-owning-memory)
+  this->flash_dirty_.resize(FLASH_STORAGE_SIZE);
   ESP_LOGVV(TAG, "Loading preferences from flash...");
 
-  {
-    InterruptLock lock;
-    spi_flash_read(get_esp8266_flash_address(), this->flash_storage_, ESP8266_FLASH_STORAGE_SIZE * 4);
+  // The log ends with the sector after the filesystem, the other sectors are taken from the end of the filesystem
+  const uint32_t last_sector = get_esp8266_flash_sector(&_SPIFFS_end);
+  const uint32_t fs_sectors = last_sector - get_esp8266_flash_sector(&_SPIFFS_start);
+  const uint32_t num_sectors = std::min<uint32_t>(FLASH_SECTORS, fs_sectors + 1);
+  auto *flash = new ESP8266PreferencesFlash(last_sector + 1 - num_sectors);  // NOLINT(cppcoreguidelines-owning-memory)
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  this->flash_log_ = new PreferencesLog(flash, num_sectors, this->flash_storage_, FLASH_STORAGE_SIZE);
+  if (!this->flash_log_->load()) {
+    // Older versions stored the image as is in the sector after the filesystem, it is written to the log by the
+    // next save
+    flash->read((num_sectors - 1) * PreferencesFlash::SECTOR_SIZE, this->flash_storage_, FLASH_STORAGE_SIZE * 4);
   }
 }
 
@@ -186,7 +245,7 @@ ESPPreferenceObject ESPPreferences::make_preference(size_t length, uint32_t type
   if (in_flash) {
     uint32_t start = this->current_flash_offset_;
     uint32_t end = start + length + 1;
-    if (end > ESP8266_FLASH_STORAGE_SIZE)
+    if (end > FLASH_STORAGE_SIZE)
       return {};
     auto pref = ESPPreferenceObject(start, length, type);
     pref.in_flash_ = true;
@@ -227,21 +286,44 @@ bool ESPPreferences::is_prevent_write() { return this->prevent_write_; }
 #endif
 
 #ifdef ARDUINO_ARCH_ESP32
+static bool nvs_save(uint32_t nvs_handle, uint32_t key, const uint32_t *data, size_t length_words) {
+  char key_str[32];
+  sprintf(key_str, "%u", key);
+  uint32_t len = length_words * 4;
+  esp_err_t err = nvs_set_blob(nvs_handle, key_str, data, len);
+  if (err) {
+    ESP_LOGV(TAG, "nvs_set_blob('%s', len=%u) failed: %s", key_str, len, esp_err_to_name(err));
+    return false;
+  }
+  return true;
+}
 bool ESPPreferenceObject::save_internal_() {
   if (global_preferences.nvs_handle_ == 0)
     return false;
 
-  char key[32];
-  sprintf(key, "%u", this->offset_);
-  uint32_t len = (this->length_words_ + 1) * 4;
-  esp_err_t err = nvs_set_blob(global_preferences.nvs_handle_, key, this->data_, len);
-  if (err) {
-    ESP_LOGV(TAG, "nvs_set_blob('%s', len=%u) failed: %s", key, len, esp_err_to_name(err));
-    return false;
+  if (global_preferences.deferred_sync_) {
+    ESPPreferences::PendingSave *save = nullptr;
+    for (auto &pending : global_preferences.pending_saves_) {
+      if (pending.key == this->offset_) {
+        save = &pending;
+        break;
+      }
+    }
+    if (save == nullptr) {
+      global_preferences.pending_saves_.push_back({});
+      save = &global_preferences.pending_saves_.back();
+      save->key = this->offset_;
+    }
+    save->pending = true;
+    save->data.assign(this->data_, this->data_ + this->length_words_ + 1);
+    return true;
   }
-  err = nvs_commit(global_preferences.nvs_handle_);
+
+  if (!nvs_save(global_preferences.nvs_handle_, this->offset_, this->data_, this->length_words_ + 1))
+    return false;
+  esp_err_t err = nvs_commit(global_preferences.nvs_handle_);
   if (err) {
-    ESP_LOGV(TAG, "nvs_commit('%s', len=%u) failed: %s", key, len, esp_err_to_name(err));
+    ESP_LOGV(TAG, "nvs_commit('%u') failed: %s", this->offset_, esp_err_to_name(err));
     return false;
   }
   return true;
@@ -250,6 +332,15 @@ bool ESPPreferenceObject::load_internal_() {
   if (global_preferences.nvs_handle_ == 0)
     return false;
 
+  for (auto &pending : global_preferences.pending_saves_) {
+    if (pending.key != this->offset_ || !pending.pending)
+      continue;
+    if (pending.data.size() != this->length_words_ + 1)
+      return false;
+    std::copy(pending.data.begin(), pending.data.end(), this->data_);
+    return true;
+  }
+
   char key[32];
   sprintf(key, "%u", this->offset_);
   size_t len = (this->length_words_ + 1) * 4;
@@ -293,6 +384,57 @@ ESPPreferenceObject ESPPreferences::make_preference(size_t length, uint32_t type
   this->current_offset_++;
   return pref;
 }
+
+bool ESPPreferences::sync() {
+  if (this->nvs_handle_ == 0)
+    return false;
+
+  bool any_saved = false;
+  for (auto &save : this->pending_saves_) {
+    if (!save.pending)
+      continue;
+    if (!nvs_save(this->nvs_handle_, save.key, save.data.data(), save.data.size()))
+      return false;
+    save.pending = false;
+    any_saved = true;
+  }
+  if (!any_saved)
+    return true;
+  // A single commit for all saves since the last sync
+  esp_err_t err = nvs_commit(this->nvs_handle_);
+  if (err) {
+    ESP_LOGV(TAG, "nvs_commit failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  return true;
+}
+#endif
+
+#ifdef USE_HOST
+bool ESPPreferenceObject::save_internal_() { return this->save_flash_(); }
+bool ESPPreferenceObject::load_internal_() { return this->load_flash_(); }
+ESPPreferences::ESPPreferences() : current_offset_(0) {}
+void ESPPreferences::begin() { this->begin(FLASH_SECTORS, ""); }
+void ESPPreferences::begin(uint8_t num_sectors, const std::string &path) {
+  delete this->flash_log_;        // NOLINT(cppcoreguidelines-owning-memory)
+  delete[] this->flash_storage_;  // NOLINT(cppcoreguidelines-owning-memory)
+  this->flash_storage_ = new uint32_t[FLASH_STORAGE_SIZE]();  // NOLINT(cppcoreguidelines-owning-memory)
+  this->flash_dirty_.assign(FLASH_STORAGE_SIZE, false);
+  this->current_flash_offset_ = 0;
+  this->host_flash_ = esphome::make_unique<HostPreferencesFlash>(num_sectors, path);
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  this->flash_log_ = new PreferencesLog(this->host_flash_.get(), num_sectors, this->flash_storage_, FLASH_STORAGE_SIZE);
+  this->flash_log_->load();
+}
+
+ESPPreferenceObject ESPPreferences::make_preference(size_t length, uint32_t type, bool in_flash) {
+  uint32_t start = this->current_flash_offset_;
+  uint32_t end = start + length + 1;
+  if (end > FLASH_STORAGE_SIZE)
+    return {};
+  this->current_flash_offset_ = end;
+  return ESPPreferenceObject(start, length, type);
+}
 #endif
 uint32_t ESPPreferenceObject::calculate_crc_() const {
   uint32_t crc = this->type_;
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "esphome/core/esphal.h"
 #include "esphome/core/defines.h"
+#include "esphome/core/preferences_log.h"
 
 namespace esphome {
 
@@ -25,6 +27,10 @@ class ESPPreferenceObject {
   bool load_();
   bool save_internal_();
   bool load_internal_();
+#if defined(ARDUINO_ARCH_ESP8266) || defined(USE_HOST)
+  bool save_flash_();
+  bool load_flash_();
+#endif
 
   uint32_t calculate_crc_() const;
 
@@ -49,6 +55,10 @@ static const bool DEFAULT_IN_FLASH = false;
 static const bool DEFAULT_IN_FLASH = true;
 #endif
 
+#ifdef USE_HOST
+static const bool DEFAULT_IN_FLASH = true;
+#endif
+
 class ESPPreferences {
  public:
   ESPPreferences();
@@ -56,6 +66,18 @@ class ESPPreferences {
   ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash = DEFAULT_IN_FLASH);
   template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash = DEFAULT_IN_FLASH);
 
+  /** Write the saves of flash preferences delayed by set_deferred_sync() to flash.
+   *
+   * @return false if writing failed, the saves are kept and written again by the next sync.
+   */
+  bool sync();
+  /** Whether saving a flash preference only marks it as changed, instead of writing it to flash immediately.
+   *
+   * Consecutive saves of the same preference between two syncs are then coalesced into a single write, at the cost of
+   * losing them if the device loses power before the next sync().
+   */
+  void set_deferred_sync(bool deferred_sync) { this->deferred_sync_ = deferred_sync; }
+
 #ifdef ARDUINO_ARCH_ESP8266
   /** On the ESP8266, we can't override the first 128 bytes during OTA uploads
    * as the eboot parameters are stored there. Writing there during an OTA upload
@@ -75,12 +97,38 @@ class ESPPreferences {
 #ifdef ARDUINO_ARCH_ESP32
   uint32_t nvs_handle_;
 #endif
+#ifdef USE_HOST
+ public:
+  /** Store the preferences in num_sectors sectors of emulated flash, persisted to the file at path if it is not
+   * empty (otherwise they are lost when the process exits). Calling it again emulates a reboot of the device, the
+   * preferences have to be made again.
+   */
+  void begin(uint8_t num_sectors, const std::string &path);
+  HostPreferencesFlash *get_host_flash() { return this->host_flash_.get(); }
+
+ protected:
+  std::unique_ptr<HostPreferencesFlash> host_flash_;
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+  struct PendingSave {
+    uint32_t key;
+    bool pending;
+    std::vector<uint32_t> data;
+  };
+  /// Saves waiting for the next sync(), the entries are kept and reused by later saves of the same key.
+  std::vector<PendingSave> pending_saves_;
+#endif
+#if defined(ARDUINO_ARCH_ESP8266) || defined(USE_HOST)
+  uint32_t *flash_storage_{nullptr};
+  uint32_t current_flash_offset_{0};
+  /// The words of flash_storage_ changed since the last sync.
+  std::vector<bool> flash_dirty_;
+  PreferencesLog *flash_log_{nullptr};
+#endif
 #ifdef ARDUINO_ARCH_ESP8266
-  void save_esp8266_flash_();
   bool prevent_write_{false};
-  uint32_t *flash_storage_;
-  uint32_t current_flash_offset_;
 #endif
+  bool deferred_sync_{false};
 };
 
 extern ESPPreferences global_preferences;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
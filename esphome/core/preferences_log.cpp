@@ -0,0 +1,215 @@
+#include "esphome/core/preferences_log.h"
+#include "esphome/core/helpers.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace esphome {
+
+PreferencesLog::PreferencesLog(PreferencesFlash *flash, uint8_t num_sectors, uint32_t *image, size_t image_words)
+    : flash_(flash),
+      num_sectors_(num_sectors == 0 ? 1 : (num_sectors > MAX_SECTORS ? MAX_SECTORS : num_sectors)),
+      image_(image),
+      image_words_(image_words),
+      record_(new uint32_t[image_words + RECORD_OVERHEAD]) {}
+
+bool PreferencesLog::load() {
+  // The valid sectors, sorted by their sequence number (oldest first)
+  uint8_t sectors[MAX_SECTORS];
+  uint32_t sequences[MAX_SECTORS];
+  uint8_t count = 0;
+  for (uint8_t sector = 0; sector < this->num_sectors_; sector++) {
+    uint32_t header[HEADER_WORDS];
+    if (!this->flash_->read(sector * PreferencesFlash::SECTOR_SIZE, header, sizeof(header)))
+      continue;
+    if (header[0] != MAGIC || header[1] == ERASED)
+      continue;
+    uint8_t i = count++;
+    for (; i > 0 && sequences[i - 1] > header[1]; i--) {
+      sectors[i] = sectors[i - 1];
+      sequences[i] = sequences[i - 1];
+    }
+    sectors[i] = sector;
+    sequences[i] = header[1];
+  }
+  if (count == 0)
+    return false;
+
+  for (uint8_t i = 0; i < count; i++)
+    this->write_position_ = this->replay_sector_(sectors[i], &this->snapshot_complete_);
+  this->has_active_sector_ = true;
+  this->active_sector_ = sectors[count - 1];
+  this->sequence_ = sequences[count - 1];
+  return true;
+}
+
+uint32_t PreferencesLog::replay_sector_(uint8_t sector, bool *snapshot_complete) {
+  const uint32_t base = sector * SECTOR_WORDS;
+  uint32_t *record = this->record_.get();
+  uint32_t position = HEADER_WORDS;
+  *snapshot_complete = false;
+  while (position + RECORD_OVERHEAD <= SECTOR_WORDS) {
+    if (!this->flash_->read((base + position) * 4, record, 4))
+      return SECTOR_WORDS;
+    const uint32_t header = record[0];
+    if (header == ERASED)
+      return position;
+
+    const uint32_t offset = header >> 16;
+    const uint32_t length = header & 0xFFFF;
+    // A header damaged by a power loss, don't append anything after it
+    if (length == 0 || offset + length > this->image_words_ || position + length + RECORD_OVERHEAD > SECTOR_WORDS)
+      return SECTOR_WORDS;
+    if (!this->flash_->read((base + position + 1) * 4, record + 1, (length + 1) * 4))
+      return SECTOR_WORDS;
+    // Skip records torn by a power loss, the image keeps the value of the previous record
+    if (record[length + 1] == record_checksum_(record, length)) {
+      memcpy(this->image_ + offset, record + 1, length * 4);
+      if (position == HEADER_WORDS && offset == 0 && length == this->image_words_)
+        *snapshot_complete = true;
+    }
+    position += length + RECORD_OVERHEAD;
+  }
+  return position;
+}
+
+bool PreferencesLog::append(size_t offset, size_t length) {
+  if (length == 0)
+    return true;
+  if (!this->snapshot_complete_ || this->write_position_ + length + RECORD_OVERHEAD > SECTOR_WORDS)
+    return this->compact_();
+  return this->write_record_(offset, length);
+}
+
+bool PreferencesLog::compact_() {
+  // The other sectors may only be erased once the active sector holds a complete snapshot, otherwise the active
+  // sector is written again
+  uint8_t sector = 0;
+  if (this->has_active_sector_)
+    sector = this->snapshot_complete_ ? (this->active_sector_ + 1) % this->num_sectors_ : this->active_sector_;
+  this->has_active_sector_ = true;
+  this->active_sector_ = sector;
+  this->snapshot_complete_ = false;
+  this->sequence_++;
+  this->compactions_++;
+
+  if (!this->flash_->erase_sector(sector))
+    return false;
+  const uint32_t header[HEADER_WORDS] = {MAGIC, this->sequence_};
+  if (!this->flash_->write(sector * PreferencesFlash::SECTOR_SIZE, header, sizeof(header)))
+    return false;
+  this->write_position_ = HEADER_WORDS;
+  this->snapshot_complete_ = this->write_record_(0, this->image_words_);
+  return this->snapshot_complete_;
+}
+
+bool PreferencesLog::write_record_(size_t offset, size_t length) {
+  uint32_t *record = this->record_.get();
+  record[0] = (offset << 16) | length;
+  memcpy(record + 1, this->image_ + offset, length * 4);
+  record[length + 1] = record_checksum_(record, length);
+
+  const uint32_t address = (this->active_sector_ * SECTOR_WORDS + this->write_position_) * 4;
+  // Flash words can only be programmed once after an erase, so never reuse them, even if the write failed
+  this->write_position_ += length + RECORD_OVERHEAD;
+  return this->flash_->write(address, record, (length + RECORD_OVERHEAD) * 4);
+}
+
+uint32_t PreferencesLog::record_checksum_(const uint32_t *record, size_t length) {
+  return fnv1_hash(reinterpret_cast<const char *>(record), (length + 1) * 4);
+}
+
+#ifdef USE_HOST
+HostPreferencesFlash::HostPreferencesFlash(uint8_t num_sectors, std::string path)
+    : path_(std::move(path)),
+      memory_(num_sectors * PreferencesLog::SECTOR_WORDS, 0xFFFFFFFF),
+      sector_erases_(num_sectors) {
+  if (this->path_.empty())
+    return;
+
+  FILE *file = fopen(this->path_.c_str(), "rb");
+  if (file != nullptr) {
+    size_t read = fread(this->memory_.data(), 4, this->memory_.size(), file);
+    fclose(file);
+    if (read == this->memory_.size())
+      return;
+    std::fill(this->memory_.begin(), this->memory_.end(), 0xFFFFFFFF);
+  }
+  this->persist_(0, this->memory_.size() * 4);
+}
+
+bool HostPreferencesFlash::read(uint32_t address, uint32_t *data, size_t size) {
+  if (address % 4 != 0 || size % 4 != 0 || address + size > this->memory_.size() * 4)
+    return false;
+  memcpy(data, &this->memory_[address / 4], size);
+  return true;
+}
+
+bool HostPreferencesFlash::write(uint32_t address, const uint32_t *data, size_t size) {
+  if (this->power_loss_ || address % 4 != 0 || size % 4 != 0 || address + size > this->memory_.size() * 4)
+    return false;
+
+  bool programmed = true;
+  size_t words = size / 4;
+  if (this->power_loss_armed_) {
+    if (this->words_until_power_loss_ < words) {
+      words = this->words_until_power_loss_;
+      this->power_loss_ = true;
+    }
+    this->words_until_power_loss_ -= words;
+  }
+  for (size_t i = 0; i < words; i++) {
+    uint32_t &word = this->memory_[address / 4 + i];
+    // Programming can only clear bits
+    word &= data[i];
+    if (word != data[i])
+      programmed = false;
+  }
+  if (words != 0) {
+    this->pages_programmed_ += (address + words * 4 - 1) / PAGE_SIZE - address / PAGE_SIZE + 1;
+    this->bytes_written_ += words * 4;
+  }
+  return this->persist_(address, words * 4) && programmed && !this->power_loss_;
+}
+
+bool HostPreferencesFlash::erase_sector(uint32_t sector) {
+  if (this->power_loss_armed_ && this->words_until_power_loss_ == 0)
+    this->power_loss_ = true;
+  if (this->power_loss_ || sector >= this->sector_erases_.size())
+    return false;
+  auto begin = this->memory_.begin() + sector * PreferencesLog::SECTOR_WORDS;
+  std::fill(begin, begin + PreferencesLog::SECTOR_WORDS, 0xFFFFFFFF);
+  this->erases_++;
+  this->sector_erases_[sector]++;
+  return this->persist_(sector * SECTOR_SIZE, SECTOR_SIZE);
+}
+
+void HostPreferencesFlash::fail_after(uint32_t words) {
+  this->power_loss_armed_ = true;
+  this->words_until_power_loss_ = words;
+}
+void HostPreferencesFlash::restore_power() {
+  this->power_loss_armed_ = false;
+  this->power_loss_ = false;
+}
+
+uint32_t HostPreferencesFlash::get_max_sector_erases() const {
+  return *std::max_element(this->sector_erases_.begin(), this->sector_erases_.end());
+}
+
+bool HostPreferencesFlash::persist_(uint32_t address, size_t size) {
+  if (this->path_.empty() || size == 0)
+    return true;
+  FILE *file = fopen(this->path_.c_str(), "r+b");
+  if (file == nullptr)
+    file = fopen(this->path_.c_str(), "w+b");
+  if (file == nullptr)
+    return false;
+  bool ok = fseek(file, address, SEEK_SET) == 0 && fwrite(&this->memory_[address / 4], 1, size, file) == size;
+  fclose(file);
+  return ok;
+}
+#endif
+
+}  // namespace esphome
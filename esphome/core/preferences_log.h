@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+/// Flash sectors used by PreferencesLog, addresses are relative to the first sector of the store.
+class PreferencesFlash {
+ public:
+  static const uint32_t SECTOR_SIZE = 4096;
+
+  /// Read size bytes at address, address and size are multiples of 4.
+  virtual bool read(uint32_t address, uint32_t *data, size_t size) = 0;
+  /// Program size bytes at address, the words must have been erased before.
+  virtual bool write(uint32_t address, const uint32_t *data, size_t size) = 0;
+  /// Erase the sector with the given index, setting all its bits.
+  virtual bool erase_sector(uint32_t sector) = 0;
+};
+
+/** Append-only, log-structured storage of the flash preferences image over a ring of flash sectors.
+ *
+ * Saving a range of words of the image appends a record to the active sector instead of erasing and rewriting it, so
+ * a sector is only erased once it is full. Then the next sector of the ring (the one with the oldest records) is
+ * erased and starts with a snapshot of the whole image, which makes all other sectors obsolete.
+ *
+ * Each sector starts with a header (magic and sequence number), followed by records of a header word
+ * (offset << 16 | length), the data words and a checksum. Loading replays the records of all sectors in sequence
+ * order, records torn by a power loss fail the checksum and are skipped. Records are only appended after a complete
+ * snapshot, and the other sectors are only erased once there is one, so with two or more sectors a power loss during
+ * a compaction doesn't lose data either. With a single sector, the data saved before is lost if the power is lost
+ * between erasing the sector and writing the snapshot.
+ */
+class PreferencesLog {
+ public:
+  static const uint32_t SECTOR_WORDS = PreferencesFlash::SECTOR_SIZE / 4;
+  static const uint8_t MAX_SECTORS = 16;
+  /// Record header and checksum words.
+  static const uint32_t RECORD_OVERHEAD = 2;
+
+  /// The snapshot of the image has to fit into a sector: image_words <= SECTOR_WORDS - 4.
+  PreferencesLog(PreferencesFlash *flash, uint8_t num_sectors, uint32_t *image, size_t image_words);
+
+  /** Restore the image from the records in flash.
+   *
+   * @return false if no sector holds a valid log, the image is not modified then.
+   */
+  bool load();
+  /// Append the words [offset, offset + length) of the image to the log, compacting it if the active sector is full.
+  bool append(size_t offset, size_t length);
+
+  uint8_t get_num_sectors() const { return this->num_sectors_; }
+  uint8_t get_active_sector() const { return this->active_sector_; }
+  /// The number of words of the active sector in use.
+  uint32_t get_write_position() const { return this->write_position_; }
+  /// The number of times a sector was erased and started with a snapshot of the image.
+  uint32_t get_compactions() const { return this->compactions_; }
+
+ protected:
+  static const uint32_t MAGIC = 0x46455250;  // "PREF"
+  static const uint32_t HEADER_WORDS = 2;
+  static const uint32_t ERASED = 0xFFFFFFFF;
+
+  /** Replay the records of sector into the image.
+   *
+   * @param snapshot_complete Set to whether the sector starts with a complete snapshot.
+   * @return The number of words of the sector in use.
+   */
+  uint32_t replay_sector_(uint8_t sector, bool *snapshot_complete);
+  /// Erase the next sector of the ring and write a snapshot of the image to it.
+  bool compact_();
+  bool write_record_(size_t offset, size_t length);
+  static uint32_t record_checksum_(const uint32_t *record, size_t length);
+
+  PreferencesFlash *flash_;
+  uint8_t num_sectors_;
+  uint32_t *image_;
+  size_t image_words_;
+  /// Buffer for reading and writing one record, large enough for a snapshot of the whole image.
+  std::unique_ptr<uint32_t[]> record_;
+
+  bool has_active_sector_{false};
+  uint8_t active_sector_{0};
+  /// Whether the active sector starts with a complete snapshot of the image, and can take records.
+  bool snapshot_complete_{false};
+  uint32_t sequence_{0};
+  uint32_t write_position_{0};
+  uint32_t compactions_{0};
+};
+
+#ifdef USE_HOST
+/** Flash emulated in memory, and optionally persisted to a file, for running and benchmarking the preferences on
+ * the host.
+ *
+ * Emulates NOR flash: erasing sets all bits of a sector, programming can only clear bits. Counts the erases and
+ * programmed pages, so the flash wear and the time spent blocked in flash operations can be estimated.
+ */
+class HostPreferencesFlash : public PreferencesFlash {
+ public:
+  static const uint32_t PAGE_SIZE = 256;
+
+  /// Emulate num_sectors sectors, persisted to the file at path if it is not empty.
+  explicit HostPreferencesFlash(uint8_t num_sectors, std::string path = "");
+
+  bool read(uint32_t address, uint32_t *data, size_t size) override;
+  bool write(uint32_t address, const uint32_t *data, size_t size) override;
+  bool erase_sector(uint32_t sector) override;
+
+  /// Emulate a power loss after programming the next words words, all later writes and erases fail.
+  void fail_after(uint32_t words);
+  /// Power the emulated flash up again after fail_after().
+  void restore_power();
+
+  uint32_t get_erases() const { return this->erases_; }
+  uint32_t get_sector_erases(uint32_t sector) const { return this->sector_erases_[sector]; }
+  uint32_t get_max_sector_erases() const;
+  /// The number of flash pages programmed, a write spanning several pages programs each of them.
+  uint32_t get_pages_programmed() const { return this->pages_programmed_; }
+  uint32_t get_bytes_written() const { return this->bytes_written_; }
+
+ protected:
+  bool persist_(uint32_t address, size_t size);
+
+  std::string path_;
+  std::vector<uint32_t> memory_;
+  std::vector<uint32_t> sector_erases_;
+  uint32_t erases_{0};
+  uint32_t pages_programmed_{0};
+  uint32_t bytes_written_{0};
+  /// Whether a power loss is pending after words_until_power_loss_ more words.
+  bool power_loss_armed_{false};
+  uint32_t words_until_power_loss_{0};
+  bool power_loss_{false};
+};
+#endif
+
+}  // namespace esphome
@@ -0,0 +1,99 @@
+#include "esphome/core/profiler.h"
+
+#ifdef USE_PROFILER
+
+#include <cmath>
+#include <cstring>
+
+namespace esphome {
+
+/// Samples per histogram window, the buckets are uint8_t so this must not exceed 255.
+static const uint8_t PROFILER_WINDOW_SAMPLES = 250;
+
+void TimingStats::record(uint32_t us) {
+  this->count_++;
+  this->total_ += us;
+  if (us < this->min_)
+    this->min_ = us;
+  if (us > this->max_)
+    this->max_ = us;
+
+  if (this->window_count_ >= PROFILER_WINDOW_SAMPLES) {
+    // Current window is full, the oldest window becomes the current one
+    this->window_ = (this->window_ + 1) % HISTOGRAM_WINDOWS;
+    memset(this->histogram_[this->window_], 0, HISTOGRAM_BUCKETS);
+    this->window_count_ = 0;
+  }
+  // bucket = bit width of us
+  uint8_t bucket = us == 0 ? 0 : 32 - __builtin_clz(us);
+  if (bucket >= HISTOGRAM_BUCKETS)
+    bucket = HISTOGRAM_BUCKETS - 1;
+  this->histogram_[this->window_][bucket]++;
+  this->window_count_++;
+}
+void TimingStats::reset() { *this = TimingStats(); }
+uint32_t TimingStats::get_average() const {
+  if (this->count_ == 0)
+    return 0;
+  return this->total_ / this->count_;
+}
+uint32_t TimingStats::get_percentile(float percentile) const {
+  uint32_t samples = 0;
+  for (auto &window : this->histogram_) {
+    for (uint8_t count : window)
+      samples += count;
+  }
+  if (samples == 0)
+    return 0;
+
+  uint32_t rank = std::ceil(samples * percentile);
+  if (rank == 0)
+    rank = 1;
+  uint32_t seen = 0;
+  for (uint8_t bucket = 0; bucket < HISTOGRAM_BUCKETS - 1; bucket++) {
+    for (auto &window : this->histogram_)
+      seen += window[bucket];
+    if (seen >= rank) {
+      const uint32_t upper = bucket == 0 ? 0 : (1UL << bucket) - 1;
+      return upper < this->max_ ? upper : this->max_;
+    }
+  }
+  return this->max_;
+}
+
+const char *profiler_kind_to_string(ProfilerKind kind) {
+  switch (kind) {
+    case PROFILER_KIND_SETUP:
+      return "setup";
+    case PROFILER_KIND_LOOP:
+      return "loop";
+    case PROFILER_KIND_SCHEDULER:
+      return "scheduler";
+    default:
+      return "unknown";
+  }
+}
+
+TimingStats *Profiler::get_stats(const Component *component, ProfilerKind kind, const std::string &name,
+                                 uint32_t name_hash) {
+  const Key key{component, kind, name_hash};
+  auto it = this->lookup_.find(key);
+  if (it != this->lookup_.end())
+    return &it->second.stats;
+
+  // std::map never moves its elements, so the entry can be referenced from entries_
+  ProfilerEntry &entry = this->lookup_[key];
+  entry.component = component;
+  entry.kind = kind;
+  entry.name = name;
+  this->entries_.push_back(&entry);
+  return &entry.stats;
+}
+void Profiler::reset() {
+  for (auto *entry : this->entries_)
+    entry->stats.reset();
+}
+
+}  // namespace esphome
+
+#endif  // USE_PROFILER
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_PROFILER
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace esphome {
+
+class Component;
+
+/** Execution time statistics of a single profiled function, in microseconds.
+ *
+ * Besides count/min/max/total, samples are counted in a histogram with one bucket per power of two, from which
+ * percentiles are approximated. The histogram is a ring of two windows of PROFILER_WINDOW_SAMPLES samples each:
+ * when the current window is full, the oldest one is cleared and reused. Percentiles therefore always describe
+ * the most recent samples, while the memory used per function stays fixed and small.
+ */
+class TimingStats {
+ public:
+  void record(uint32_t us);
+  void reset();
+
+  uint32_t get_count() const { return this->count_; }
+  uint32_t get_min() const { return this->count_ == 0 ? 0 : this->min_; }
+  uint32_t get_max() const { return this->max_; }
+  uint32_t get_average() const;
+  /** Approximate the given percentile (0.0 - 1.0) of the recent samples.
+   *
+   * The result is the upper bound of the histogram bucket the percentile falls in, limited to the maximum.
+   */
+  uint32_t get_percentile(float percentile) const;
+
+ protected:
+  static const uint8_t HISTOGRAM_BUCKETS = 21;
+  static const uint8_t HISTOGRAM_WINDOWS = 2;
+
+  uint32_t count_{0};
+  uint32_t min_{UINT32_MAX};
+  uint32_t max_{0};
+  uint64_t total_{0};
+  /// Bucket b counts samples in [2^(b-1), 2^b), the last bucket also counts everything above.
+  uint8_t histogram_[HISTOGRAM_WINDOWS][HISTOGRAM_BUCKETS]{};
+  uint8_t window_{0};
+  uint8_t window_count_{0};
+};
+
+enum ProfilerKind : uint8_t {
+  PROFILER_KIND_SETUP = 0,
+  PROFILER_KIND_LOOP = 1,
+  PROFILER_KIND_SCHEDULER = 2,
+};
+
+const char *profiler_kind_to_string(ProfilerKind kind);
+
+struct ProfilerEntry {
+  const Component *component;
+  ProfilerKind kind;
+  /// Name of the timeout/interval for scheduler entries, empty otherwise.
+  std::string name;
+  TimingStats stats;
+};
+
+/** Registry of the timing statistics of all setup()/loop() calls and scheduler callbacks.
+ *
+ * Only compiled in with USE_PROFILER (enabled by the debug component). Entries are never removed, so pointers
+ * returned by get_stats() can be cached by the callers and iterating with get_entries() by index stays valid
+ * while new entries are added.
+ */
+class Profiler {
+ public:
+  /** Get (or create) the statistics of a profiled function.
+   *
+   * @param component The component the function belongs to, may be nullptr.
+   * @param kind Whether the function is setup(), loop() or a scheduler callback.
+   * @param name The name of the timeout/interval, scheduler callbacks without a name share one entry.
+   * @param name_hash fnv1_hash of name (0 for empty names).
+   */
+  TimingStats *get_stats(const Component *component, ProfilerKind kind, const std::string &name = "",
+                         uint32_t name_hash = 0);
+
+  const std::vector<ProfilerEntry *> &get_entries() const { return this->entries_; }
+
+  /// Reset the statistics of all entries, for example to start measuring after the boot is complete.
+  void reset();
+
+ protected:
+  using Key = std::tuple<const Component *, ProfilerKind, uint32_t>;
+
+  std::map<Key, ProfilerEntry> lookup_;
+  std::vector<ProfilerEntry *> entries_;
+};
+
+}  // namespace esphome
+
+#endif  // USE_PROFILER
@@ -1,4 +1,5 @@
 #include "scheduler.h"
+#include "esphome/core/application.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include <algorithm>
@@ -9,6 +10,8 @@ static const char *const TAG = "scheduler";
 
 static const uint32_t SCHEDULER_DONT_RUN = 4294967295UL;
 static const uint32_t MAX_LOGICALLY_DELETED_ITEMS = 10;
+static const uint32_t MAX_POOLED_ITEMS = 32;
+static const uint32_t MIN_INDEX_BUCKETS = 16;
 
 // Uncomment to debug scheduler
 // #define ESPHOME_DEBUG_SCHEDULER
@@ -16,35 +19,40 @@ static const uint32_t MAX_LOGICALLY_DELETED_ITEMS = 10;
 void HOT Scheduler::set_timeout(Component *component, const std::string &name, uint32_t timeout,
                                 std::function<void()> &&func) {
   const uint32_t now = this->millis_();
+  const uint32_t name_hash = name.empty() ? 0 : fnv1_hash(name);
 
   if (!name.empty())
-    this->cancel_timeout(component, name);
+    this->cancel_item_(component, name, name_hash, SchedulerItem::TIMEOUT);
 
   if (timeout == SCHEDULER_DONT_RUN)
     return;
 
   ESP_LOGVV(TAG, "set_timeout(name='%s', timeout=%u)", name.c_str(), timeout);
 
-  auto item = make_unique<SchedulerItem>();
+  auto item = this->acquire_item_();
   item->component = component;
   item->name = name;
+  item->name_hash = name_hash;
   item->type = SchedulerItem::TIMEOUT;
   item->timeout = timeout;
   item->last_execution = now;
   item->last_execution_major = this->millis_major_;
   item->f = std::move(func);
   item->remove = false;
+  if (!name.empty())
+    this->index_insert_(item.get());
   this->push_(std::move(item));
 }
 bool HOT Scheduler::cancel_timeout(Component *component, const std::string &name) {
-  return this->cancel_item_(component, name, SchedulerItem::TIMEOUT);
+  return this->cancel_item_(component, name, name.empty() ? 0 : fnv1_hash(name), SchedulerItem::TIMEOUT);
 }
 void HOT Scheduler::set_interval(Component *component, const std::string &name, uint32_t interval,
                                  std::function<void()> &&func) {
   const uint32_t now = this->millis_();
+  const uint32_t name_hash = name.empty() ? 0 : fnv1_hash(name);
 
   if (!name.empty())
-    this->cancel_interval(component, name);
+    this->cancel_item_(component, name, name_hash, SchedulerItem::INTERVAL);
 
   if (interval == SCHEDULER_DONT_RUN)
     return;
@@ -56,9 +64,10 @@ void HOT Scheduler::set_interval(Component *component, const std::string &name,
 
   ESP_LOGVV(TAG, "set_interval(name='%s', interval=%u, offset=%u)", name.c_str(), interval, offset);
 
-  auto item = make_unique<SchedulerItem>();
+  auto item = this->acquire_item_();
   item->component = component;
   item->name = name;
+  item->name_hash = name_hash;
   item->type = SchedulerItem::INTERVAL;
   item->interval = interval;
   item->last_execution = now - offset - interval;
@@ -67,10 +76,12 @@ void HOT Scheduler::set_interval(Component *component, const std::string &name,
     item->last_execution_major--;
   item->f = std::move(func);
   item->remove = false;
+  if (!name.empty())
+    this->index_insert_(item.get());
   this->push_(std::move(item));
 }
 bool HOT Scheduler::cancel_interval(Component *component, const std::string &name) {
-  return this->cancel_item_(component, name, SchedulerItem::INTERVAL);
+  return this->cancel_item_(component, name, name.empty() ? 0 : fnv1_hash(name), SchedulerItem::INTERVAL);
 }
 optional<uint32_t> HOT Scheduler::next_schedule_in() {
   if (this->empty_())
@@ -94,13 +105,12 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
     std::vector<std::unique_ptr<SchedulerItem>> old_items;
     ESP_LOGVV(TAG, "Items: count=%u, now=%u", this->items_.size(), now);
     while (!this->empty_()) {
-      auto item = std::move(this->items_[0]);
+      auto item = this->pop_raw_();
       const char *type = item->type == SchedulerItem::INTERVAL ? "interval" : "timeout";
       ESP_LOGVV(TAG, "  %s '%s' interval=%u last_execution=%u (%u) next=%u (%u)", type, item->name.c_str(),
                 item->interval, item->last_execution, item->last_execution_major, item->next_execution(),
                 item->next_execution_major());
 
-      this->pop_raw_();
       old_items.push_back(std::move(item));
     }
     ESP_LOGVV(TAG, "\n");
@@ -114,9 +124,7 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
   if (to_remove_ > MAX_LOGICALLY_DELETED_ITEMS) {
     std::vector<std::unique_ptr<SchedulerItem>> valid_items;
     while (!this->empty_()) {
-      auto item = std::move(this->items_[0]);
-      this->pop_raw_();
-      valid_items.push_back(std::move(item));
+      valid_items.push_back(this->pop_raw_());
     }
     this->items_ = std::move(valid_items);
 
@@ -142,7 +150,10 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
 
       // Don't run on failed components
       if (item->component != nullptr && item->component->is_failed()) {
-        this->pop_raw_();
+        auto failed = this->pop_raw_();
+        if (!failed->name.empty())
+          this->index_remove_(failed.get());
+        this->release_item_(std::move(failed));
         continue;
       }
 
@@ -152,23 +163,37 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
                 item->interval, item->last_execution, now);
 #endif
 
+#ifdef USE_PROFILER
+      if (item->profiler_stats == nullptr)
+        item->profiler_stats =
+            App.profiler.get_stats(item->component, PROFILER_KIND_SCHEDULER, item->name, item->name_hash);
+      TimingStats *stats = item->profiler_stats;
+      const uint32_t start = micros();
+#endif
+
       // Warning: During f(), a lot of stuff can happen, including:
       //  - timeouts/intervals get added, potentially invalidating vector pointers
       //  - timeouts/intervals get cancelled
-      item->f();
+      {
+        WarnIfComponentBlockingGuard guard{item->component};
+        item->f();
+      }
+
+#ifdef USE_PROFILER
+      stats->record(micros() - start);
+#endif
     }
 
     {
       // new scope, item from before might have been moved in the vector
-      auto item = std::move(this->items_[0]);
-
       // Only pop after function call, this ensures we were reachable
       // during the function call and know if we were cancelled.
-      this->pop_raw_();
+      auto item = this->pop_raw_();
 
       if (item->remove) {
         // We were removed/cancelled in the function call, stop
         to_remove_--;
+        this->release_item_(std::move(item));
         continue;
       }
 
@@ -181,6 +206,10 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
             item->last_execution_major++;
         }
         this->push_(std::move(item));
+      } else {
+        if (!item->name.empty())
+          this->index_remove_(item.get());
+        this->release_item_(std::move(item));
       }
     }
   }
@@ -190,6 +219,8 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
 void HOT Scheduler::process_to_add() {
   for (auto &it : this->to_add_) {
     if (it->remove) {
+      to_remove_--;
+      this->release_item_(std::move(it));
       continue;
     }
 
@@ -205,30 +236,115 @@ void HOT Scheduler::cleanup_() {
       return;
 
     to_remove_--;
-    this->pop_raw_();
+    this->release_item_(this->pop_raw_());
   }
 }
-void HOT Scheduler::pop_raw_() {
+std::unique_ptr<Scheduler::SchedulerItem> HOT Scheduler::pop_raw_() {
   std::pop_heap(this->items_.begin(), this->items_.end(), SchedulerItem::cmp);
+  auto item = std::move(this->items_.back());
   this->items_.pop_back();
+  return item;
 }
 void HOT Scheduler::push_(std::unique_ptr<Scheduler::SchedulerItem> item) { this->to_add_.push_back(std::move(item)); }
-bool HOT Scheduler::cancel_item_(Component *component, const std::string &name, Scheduler::SchedulerItem::Type type) {
+bool HOT Scheduler::cancel_item_(Component *component, const std::string &name, uint32_t name_hash,
+                                 Scheduler::SchedulerItem::Type type) {
+  if (!name.empty()) {
+    // Named items are unique per component and type, so at most one can be active
+    SchedulerItem *item = this->index_find_(component, name, name_hash, type);
+    if (item == nullptr)
+      return false;
+    this->index_remove_(item);
+    item->remove = true;
+    to_remove_++;
+    return true;
+  }
+
+  // Cancelling with an empty name removes all unnamed items of the component (see DelayAction::stop)
   bool ret = false;
   for (auto &it : this->items_)
-    if (it->component == component && it->name == name && it->type == type && !it->remove) {
+    if (it->component == component && it->name.empty() && it->type == type && !it->remove) {
       to_remove_++;
       it->remove = true;
       ret = true;
     }
   for (auto &it : this->to_add_)
-    if (it->component == component && it->name == name && it->type == type) {
+    if (it->component == component && it->name.empty() && it->type == type && !it->remove) {
+      to_remove_++;
       it->remove = true;
       ret = true;
     }
 
   return ret;
 }
+std::unique_ptr<Scheduler::SchedulerItem> HOT Scheduler::acquire_item_() {
+  if (this->pool_.empty())
+    return make_unique<SchedulerItem>();
+  auto item = std::move(this->pool_.back());
+  this->pool_.pop_back();
+  return item;
+}
+void HOT Scheduler::release_item_(std::unique_ptr<SchedulerItem> item) {
+  if (this->pool_.size() >= MAX_POOLED_ITEMS)
+    return;
+  // Destroy the callback now so that captured objects are not kept alive by the pool
+  item->f = nullptr;
+  item->index_next = nullptr;
+#ifdef USE_PROFILER
+  item->profiler_stats = nullptr;
+#endif
+  this->pool_.push_back(std::move(item));
+}
+size_t HOT Scheduler::index_bucket_(Component *component, uint32_t name_hash, SchedulerItem::Type type) const {
+  auto ptr = reinterpret_cast<uintptr_t>(component);
+  uint32_t hash = name_hash ^ (uint32_t(ptr ^ (ptr >> 16)) * 2654435769UL) ^ uint32_t(type);
+  return hash & (this->index_.size() - 1);
+}
+void HOT Scheduler::index_insert_(SchedulerItem *item) {
+  if (this->index_size_ >= this->index_.size()) {
+    // Grow (bucket count stays a power of two) and rehash the existing chains
+    std::vector<SchedulerItem *> old_index(std::max<size_t>(MIN_INDEX_BUCKETS, this->index_.size() * 2), nullptr);
+    std::swap(old_index, this->index_);
+    for (auto *head : old_index) {
+      while (head != nullptr) {
+        SchedulerItem *next = head->index_next;
+        auto &bucket = this->index_[this->index_bucket_(head->component, head->name_hash, head->type)];
+        head->index_next = bucket;
+        bucket = head;
+        head = next;
+      }
+    }
+  }
+
+  auto &bucket = this->index_[this->index_bucket_(item->component, item->name_hash, item->type)];
+  item->index_next = bucket;
+  bucket = item;
+  this->index_size_++;
+}
+void HOT Scheduler::index_remove_(SchedulerItem *item) {
+  if (this->index_.empty())
+    return;
+  SchedulerItem **it = &this->index_[this->index_bucket_(item->component, item->name_hash, item->type)];
+  while (*it != nullptr) {
+    if (*it == item) {
+      *it = item->index_next;
+      item->index_next = nullptr;
+      this->index_size_--;
+      return;
+    }
+    it = &(*it)->index_next;
+  }
+}
+Scheduler::SchedulerItem *HOT Scheduler::index_find_(Component *component, const std::string &name, uint32_t name_hash,
+                                                     SchedulerItem::Type type) {
+  if (this->index_.empty())
+    return nullptr;
+  SchedulerItem *it = this->index_[this->index_bucket_(component, name_hash, type)];
+  for (; it != nullptr; it = it->index_next) {
+    if (it->component == component && it->type == type && it->name_hash == name_hash && it->name == name)
+      return it;
+  }
+  return nullptr;
+}
 uint32_t Scheduler::millis_() {
   const uint32_t now = millis();
   if (now < this->last_millis_) {
@@ -25,6 +25,8 @@ class Scheduler {
   struct SchedulerItem {
     Component *component;
     std::string name;
+    /// fnv1_hash of name, used to look up named items without comparing strings.
+    uint32_t name_hash;
     enum Type { TIMEOUT, INTERVAL } type;
     union {
       uint32_t interval;
@@ -34,6 +36,12 @@ class Scheduler {
     std::function<void()> f;
     bool remove;
     uint8_t last_execution_major;
+    /// Next item in the same bucket of the name index (intrusive chain, only used for named items).
+    SchedulerItem *index_next;
+#ifdef USE_PROFILER
+    /// Statistics of this callback, looked up on its first run.
+    TimingStats *profiler_stats;
+#endif
 
     inline uint32_t next_execution() { return this->last_execution + this->timeout; }
     inline uint8_t next_execution_major() {
@@ -49,16 +57,32 @@ class Scheduler {
 
   uint32_t millis_();
   void cleanup_();
-  void pop_raw_();
+  std::unique_ptr<SchedulerItem> pop_raw_();
   void push_(std::unique_ptr<SchedulerItem> item);
-  bool cancel_item_(Component *component, const std::string &name, SchedulerItem::Type type);
+  bool cancel_item_(Component *component, const std::string &name, uint32_t name_hash, SchedulerItem::Type type);
   bool empty_() {
     this->cleanup_();
     return this->items_.empty();
   }
 
+  /// Take an item from the pool of released items, or allocate a new one if the pool is empty.
+  std::unique_ptr<SchedulerItem> acquire_item_();
+  /// Return an item that will not run anymore to the pool.
+  void release_item_(std::unique_ptr<SchedulerItem> item);
+
+  size_t index_bucket_(Component *component, uint32_t name_hash, SchedulerItem::Type type) const;
+  void index_insert_(SchedulerItem *item);
+  void index_remove_(SchedulerItem *item);
+  SchedulerItem *index_find_(Component *component, const std::string &name, uint32_t name_hash,
+                             SchedulerItem::Type type);
+
   std::vector<std::unique_ptr<SchedulerItem>> items_;
   std::vector<std::unique_ptr<SchedulerItem>> to_add_;
+  /// Released items kept for reuse, so re-arming timeouts does not hit the heap allocator.
+  std::vector<std::unique_ptr<SchedulerItem>> pool_;
+  /// Hash index of all named, not cancelled items in items_ and to_add_ (buckets are intrusive lists).
+  std::vector<SchedulerItem *> index_;
+  size_t index_size_{0};
   uint32_t last_millis_{0};
   uint8_t millis_major_{0};
   uint32_t to_remove_{0};
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#ifndef USE_HOST
 #include "IPAddress.h"
+#endif
 
 namespace esphome {
 
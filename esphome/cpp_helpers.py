@@ -1,3 +1,6 @@
+import inspect
+import logging
+
 from esphome.const import (
     CONF_INVERTED,
     CONF_MODE,
@@ -15,6 +18,9 @@ from esphome.cpp_types import App, GPIOPin
 from esphome.util import Registry, RegistryEntry
 
 
+_LOGGER = logging.getLogger(__name__)
+
+
 async def gpio_pin_expression(conf):
     """Generate an expression for the given pin option.
 
@@ -54,6 +60,29 @@ async def register_component(var, config):
         add(var.set_setup_priority(config[CONF_SETUP_PRIORITY]))
     if CONF_UPDATE_INTERVAL in config:
         add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+
+    # Set component source by inspecting the stack and getting the callee module
+    # https://stackoverflow.com/a/1095621
+    source = None
+    try:
+        for frm in inspect.stack(0)[1:]:
+            mod = inspect.getmodule(frm[0])
+            if mod is None:
+                continue
+            name = mod.__name__
+            if name.startswith("esphome.components."):
+                source = name[len("esphome.components.") :]
+                break
+            if name == "esphome.coroutine":
+                # Only works for async-await coroutine syntax
+                break
+    except (KeyError, AttributeError, IndexError) as e:
+        _LOGGER.warning(
+            "Error while finding name of component, please report this", exc_info=e
+        )
+    if source is not None:
+        add(var.set_component_source(source))
+
     add(App.register_component(var))
     return var
 
@@ -63,6 +63,12 @@ def camel_to_snake(name):
     return re.sub("([a-z0-9])([A-Z])", r"\1_\2", s1).lower()
 
 
+def get_opt(desc, opt, default=None):
+    if not desc.options.HasExtension(opt):
+        return default
+    return desc.options.Extensions[opt]
+
+
 class TypeInfo:
     def __init__(self, field):
         self._field = field
@@ -181,6 +187,16 @@ class TypeInfo:
 
     encode_func = None
 
+    @property
+    def size_func(self):
+        # encode_uint32 -> add_uint32_field, encode_message<T> -> add_message_field<T>
+        name, sep, template = self.encode_func.partition("<")
+        return name.replace("encode_", "add_", 1) + "_field" + sep + template
+
+    @property
+    def calculate_size_content(self):
+        return f"ProtoSize::{self.size_func}(total_size, {self.number}, this->{self.field_name});"
+
     @property
     def dump_content(self):
         o = f'out.append("  {self.name}: ");\n'
@@ -319,6 +335,19 @@ class StringType(TypeInfo):
         return o
 
 
+class StringViewType(StringType):
+    # Used instead of StringType for messages with the decode_views option
+    cpp_type = "ProtoStringView"
+    default_value = ""
+    reference_type = "ProtoStringView "
+    const_reference_type = "ProtoStringView "
+    decode_length = "value.as_string_view()"
+
+    def dump(self, name):
+        o = f'out.append("\'").append({name}.data(), {name}.size()).append("\'");'
+        return o
+
+
 @register_type(11)
 class MessageType(TypeInfo):
     @property
@@ -529,6 +558,13 @@ class RepeatedTypeInfo(TypeInfo):
         o += f"}}"
         return o
 
+    @property
+    def calculate_size_content(self):
+        o = f"for (const auto {'' if self._ti_is_bool else '&'}it : this->{self.field_name}) {{\n"
+        o += f"  ProtoSize::{self._ti.size_func}(total_size, {self.number}, it, true);\n"
+        o += f"}}"
+        return o
+
     @property
     def dump_content(self):
         o = f'for (const auto {"" if self._ti_is_bool else "&"}it : this->{self.field_name}) {{\n'
@@ -567,16 +603,21 @@ def build_message_type(desc):
     decode_32bit = []
     decode_64bit = []
     encode = []
+    calculate_size = []
     dump = []
+    decode_views = get_opt(desc, pb.decode_views, False)
 
     for field in desc.field:
         if field.label == 3:
             ti = RepeatedTypeInfo(field)
+        elif decode_views and field.type == 9:
+            ti = StringViewType(field)
         else:
             ti = TYPE_INFO[field.type](field)
         protected_content.extend(ti.protected_content)
         public_content.extend(ti.public_content)
         encode.append(ti.encode_content)
+        calculate_size.append(ti.calculate_size_content)
 
         if ti.decode_varint_content:
             decode_varint.append(ti.decode_varint_content)
@@ -643,6 +684,18 @@ def build_message_type(desc):
     prot = "void encode(ProtoWriteBuffer buffer) const override;"
     public_content.append(prot)
 
+    o = f"void {desc.name}::calculate_size(uint32_t &total_size) const {{"
+    if calculate_size:
+        if len(calculate_size) == 1 and len(calculate_size[0]) + len(o) + 3 < 120:
+            o += f" {calculate_size[0]} "
+        else:
+            o += "\n"
+            o += indent("\n".join(calculate_size)) + "\n"
+    o += "}\n"
+    cpp += o
+    prot = "void calculate_size(uint32_t &total_size) const override;"
+    public_content.append(prot)
+
     o = f"void {desc.name}::dump_to(std::string &out) const {{"
     if dump:
         if len(dump) == 1 and len(dump[0]) + len(o) + 3 < 120:
@@ -747,12 +800,6 @@ class_name = "APIServerConnectionBase"
 ifdefs = {}
 
 
-def get_opt(desc, opt, default=None):
-    if not desc.options.HasExtension(opt):
-        return default
-    return desc.options.Extensions[opt]
-
-
 def build_service_message_type(mt):
     snake = camel_to_snake(mt.name)
     id_ = get_opt(mt, pb.id)
@@ -407,6 +407,7 @@ ARDUINO_FORBIDDEN_RE = r"[^\w\d](" + r"|".join(ARDUINO_FORBIDDEN) + r")\(.*"
         "esphome/components/mqtt/custom_mqtt_device.h",
         "esphome/components/sun/sun.cpp",
         "esphome/core/esphal.*",
+        "esphome/core/esphal_host.*",
     ],
 )
 def lint_no_arduino_framework_functions(fname, match):
@@ -0,0 +1,2612 @@
+// Benchmarks for the core main loop, the native API encoder, MQTT dispatch and discovery payloads, display rendering,
+// lights, flash preferences, the async logger and web server routing, compiled natively by the "host" environment of
+// the PlatformIO project in the git repository:
+//
+//   pio run -e host && .pio/build/host/program
+//
+// Time as seen by the components (millis()/micros()) comes from host::global_virtual_clock, so
+// every run schedules exactly the same callbacks. Only the reported costs are measured with the
+// wall clock of the machine running the benchmark.
+// Add -DUSE_PROFILER to the build flags to measure the loop with the profiler of the debug component enabled.
+// Not used during runtime nor for CI.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <esphome/components/api/api_frame_buffer.h>
+#include <esphome/components/api/api_pb2_service.h>
+#include <esphome/components/display/display_buffer.h>
+#include <esphome/components/json/json_writer.h>
+#include <esphome/components/light/addressable_light.h>
+#include <esphome/components/light/addressable_light_effect.h>
+#include <esphome/components/light/light_output_task.h>
+#include <esphome/components/light/transformers.h>
+#include <esphome/components/logger/log_ring_buffer.h>
+#include <esphome/components/logger/tag_levels.h>
+#include <esphome/components/mqtt/mqtt_publish_tracker.h>
+#include <esphome/components/mqtt/mqtt_topic_trie.h>
+#include <esphome/components/sensor/sensor.h>
+#include <esphome/components/binary_sensor/binary_sensor.h>
+#include <esphome/components/web_server/entity_index.h>
+#include <esphome/components/web_server/index_page.h>
+#include <esphome/core/application.h>
+#include <esphome/core/component.h>
+#include <esphome/core/preferences.h>
+#include <esphome/core/scheduler.h>
+
+using namespace esphome;
+
+// Count heap allocations, for benchmarks that should not allocate at all, and the bytes in use for benchmarks of
+// the peak heap usage. The size of each block is kept in a header in front of it.
+static const size_t HEAP_HEADER_SIZE = 16;
+static size_t global_allocations = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+static size_t global_heap_used = 0;    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+static size_t global_heap_peak = 0;    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+void *operator new(size_t size) {
+  global_allocations++;
+  auto *block = static_cast<uint8_t *>(malloc(size + HEAP_HEADER_SIZE));  // NOLINT(cppcoreguidelines-no-malloc)
+  if (block == nullptr)
+    throw std::bad_alloc();
+  memcpy(block, &size, sizeof(size));
+  global_heap_used += size;
+  global_heap_peak = std::max(global_heap_peak, global_heap_used);
+  return block + HEAP_HEADER_SIZE;
+}
+void operator delete(void *ptr) noexcept {
+  if (ptr == nullptr)
+    return;
+  uint8_t *block = static_cast<uint8_t *>(ptr) - HEAP_HEADER_SIZE;
+  size_t size;
+  memcpy(&size, block, sizeof(size));
+  global_heap_used -= size;
+  free(block);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+void operator delete(void *ptr, size_t size) noexcept { operator delete(ptr); }
+// The other forms have to use the header as well, a runtime may provide its own versions that do not forward
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return operator new(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t size) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { operator delete(ptr); }
+
+namespace {
+
+class BenchComponent final : public Component {
+ public:
+  void loop() override { this->loops_++; }
+  uint32_t get_loops() const { return this->loops_; }
+
+ protected:
+  uint32_t loops_{0};
+};
+
+class EventComponent final : public Component {
+ public:
+  // Only has work to do when woken up by an event
+  void loop() override { this->set_loop_wake_hint(WAKE_HINT_ON_EVENT); }
+};
+
+class PollComponent final : public PollingComponent {
+ public:
+  PollComponent() : PollingComponent(1000) {}
+  void update() override {}
+};
+
+struct IntervalMix {
+  const char *name;
+  std::vector<uint32_t> intervals;
+};
+
+class Stopwatch {
+ public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+  double elapsed_ns() const {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - this->start_).count();
+  }
+
+ protected:
+  std::chrono::steady_clock::time_point start_;
+};
+
+void bench_app_loop(size_t num_components, uint32_t iterations) {
+  // The App global is only used for components that schedule work, a local instance
+  // starts every run from an empty component list.
+  Application app;
+  std::vector<BenchComponent *> components;
+  for (size_t i = 0; i < num_components; i++) {
+    auto *comp = new BenchComponent();
+    components.push_back(comp);
+    app.register_component(comp);
+  }
+  app.setup();
+
+  host::global_virtual_clock.reset_stats();
+  const uint64_t virtual_start = host::global_virtual_clock.get_micros();
+  Stopwatch watch;
+  for (uint32_t i = 0; i < iterations; i++)
+    app.loop();
+  const double ns = watch.elapsed_ns();
+  const uint64_t virtual_us = host::global_virtual_clock.get_micros() - virtual_start;
+
+  printf("app_loop        components=%-5zu ns/loop=%10.1f ns/component=%8.1f wakeups/min=%8.1f\n", num_components,
+         ns / iterations, num_components == 0 ? 0.0 : ns / iterations / num_components,
+         host::global_virtual_clock.get_sleep_count() * 60e6 / double(virtual_us));
+
+  for (auto *comp : components)
+    delete comp;
+}
+
+void bench_scheduler_call(size_t num_timers, const IntervalMix &mix, uint32_t virtual_ms) {
+  Scheduler scheduler;
+  BenchComponent owner;
+  uint32_t fired = 0;
+  for (size_t i = 0; i < num_timers; i++) {
+    uint32_t interval = mix.intervals[i % mix.intervals.size()];
+    scheduler.set_interval(&owner, "", interval, [&fired]() { fired++; });
+  }
+  scheduler.process_to_add();
+
+  Stopwatch watch;
+  for (uint32_t i = 0; i < virtual_ms; i++) {
+    host::global_virtual_clock.advance_millis(1);
+    scheduler.call();
+  }
+  const double ns = watch.elapsed_ns();
+
+  printf("scheduler_call  timers=%-9zu mix=%-7s ns/call=%10.1f ns/callback=%8.1f callbacks=%" PRIu32 "\n", num_timers,
+         mix.name, ns / virtual_ms, fired == 0 ? 0.0 : ns / fired, fired);
+}
+
+void bench_scheduler_rearm(size_t num_timers, uint32_t iterations) {
+  // Models debounce filters: every timer is cancelled and set again before it ever fires.
+  Scheduler scheduler;
+  BenchComponent owner;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < num_timers; i++)
+    names.push_back("timer_" + to_string(i));
+
+  Stopwatch watch;
+  for (uint32_t i = 0; i < iterations; i++) {
+    for (auto &name : names)
+      scheduler.set_timeout(&owner, name, 1000, []() {});
+    host::global_virtual_clock.advance_millis(1);
+    scheduler.call();
+  }
+  const double ns = watch.elapsed_ns();
+
+  printf("scheduler_rearm timers=%-9zu ns/set_timeout=%10.1f\n", num_timers, ns / (double(iterations) * num_timers));
+}
+
+void bench_tickless_wakeups() {
+  // Uses the global App, timeouts and intervals of components are always scheduled in App.scheduler
+  App.register_component(new EventComponent());
+  App.register_component(new PollComponent());
+  App.setup();
+
+  for (bool tickless : {false, true}) {
+    App.set_tickless_idle(tickless);
+    host::global_virtual_clock.reset_stats();
+    const uint64_t end = host::global_virtual_clock.get_micros() + 60ULL * 1000000ULL;
+    while (host::global_virtual_clock.get_micros() < end)
+      App.loop();
+
+    printf("tickless_idle   enabled=%-5s wakeups/min=%8" PRIu32 "\n", TRUEFALSE(tickless),
+           host::global_virtual_clock.get_sleep_count());
+  }
+}
+
+/// Sends messages like api::APIConnection does, but into memory instead of a TCP connection.
+class BenchAPIConnection : public api::APIServerConnectionBase {
+ public:
+  /// Encode like before the messages were sized up front: grow the buffer while encoding and build the header
+  /// in a separate vector.
+  void set_legacy(bool legacy) { this->legacy_ = legacy; }
+  size_t get_sent_bytes() const { return this->sent_bytes_; }
+
+ protected:
+  static const size_t HEADER_PADDING = 1 + 5 + 5;
+
+  bool is_authenticated() override { return true; }
+  bool is_connection_setup() override { return true; }
+  void on_fatal_error() override {}
+  void on_unauthenticated_access() override {}
+  void on_no_setup_connection() override {}
+  api::ProtoWriteBuffer create_buffer(uint32_t reserve_size) override {
+    this->buffer_.clear();
+    if (!this->legacy_) {
+      this->buffer_.reserve(HEADER_PADDING + reserve_size);
+      this->buffer_.resize(HEADER_PADDING);
+    }
+    return {&this->buffer_};
+  }
+  bool send_buffer(api::ProtoWriteBuffer buffer, uint32_t message_type) override {
+    if (this->legacy_) {
+      std::vector<uint8_t> header;
+      header.push_back(0x00);
+      api::ProtoVarInt(this->buffer_.size()).encode(header);
+      api::ProtoVarInt(message_type).encode(header);
+      this->sink_.assign(header.begin(), header.end());
+      this->sink_.insert(this->sink_.end(), this->buffer_.begin(), this->buffer_.end());
+    } else {
+      const uint32_t msg_size = this->buffer_.size() - HEADER_PADDING;
+      const uint32_t header_size = 1 + api::ProtoSize::varint(msg_size) + api::ProtoSize::varint(message_type);
+      uint8_t *header = this->buffer_.data() + HEADER_PADDING - header_size;
+      header[0] = 0x00;
+      api::ProtoVarInt(message_type).encode(api::ProtoVarInt(msg_size).encode(header + 1));
+      this->sink_.assign(header, header + header_size + msg_size);
+    }
+    this->sent_bytes_ += this->sink_.size();
+    return true;
+  }
+
+  bool legacy_{false};
+  std::vector<uint8_t> buffer_;
+  std::vector<uint8_t> sink_;
+  size_t sent_bytes_{0};
+};
+
+template<typename F> void bench_api_send(const char *name, bool legacy, uint32_t iterations, F &&send) {
+  BenchAPIConnection conn;
+  conn.set_legacy(legacy);
+  // Warm up, the buffers keep their capacity afterwards
+  send(conn);
+  const size_t bytes_before = conn.get_sent_bytes();
+  const size_t allocations_before = global_allocations;
+
+  Stopwatch watch;
+  for (uint32_t i = 0; i < iterations; i++)
+    send(conn);
+  const double ns = watch.elapsed_ns();
+  const size_t bytes = conn.get_sent_bytes() - bytes_before;
+
+  printf("api_send        msg=%-28s encoder=%-6s ns/msg=%8.1f MB/s=%7.1f allocs/msg=%5.2f\n", name,
+         legacy ? "legacy" : "sized", ns / iterations, bytes * 1e3 / ns,
+         double(global_allocations - allocations_before) / iterations);
+}
+
+void bench_api_encode(uint32_t iterations) {
+  api::SensorStateResponse state;
+  state.key = 0x12345678;
+  state.state = 21.5f;
+
+  api::ListEntitiesSensorResponse info;
+  info.object_id = "living_room_temperature";
+  info.key = 0x12345678;
+  info.name = "Living Room Temperature";
+  info.unique_id = "livingroomsensorliving_room_temperature";
+  info.unit_of_measurement = "°C";
+  info.accuracy_decimals = 1;
+  info.device_class = "temperature";
+
+  api::ListEntitiesServicesResponse service;
+  service.name = "set_brightness";
+  service.key = 0x87654321;
+  for (int i = 0; i < 4; i++) {
+    api::ListEntitiesServicesArgument arg;
+    arg.name = "arg_" + to_string(i);
+    arg.type = api::enums::SERVICE_ARG_TYPE_FLOAT;
+    service.args.push_back(arg);
+  }
+
+  for (bool legacy : {true, false}) {
+    bench_api_send("SensorStateResponse", legacy, iterations,
+                   [&state](BenchAPIConnection &conn) { conn.send_sensor_state_response(state); });
+    bench_api_send("ListEntitiesSensorResponse", legacy, iterations,
+                   [&info](BenchAPIConnection &conn) { conn.send_list_entities_sensor_response(info); });
+    bench_api_send("ListEntitiesServicesResponse", legacy, iterations,
+                   [&service](BenchAPIConnection &conn) { conn.send_list_entities_services_response(service); });
+  }
+}
+
+template<typename T> void bench_api_decode(const char *name, const T &msg, uint32_t iterations) {
+  std::vector<uint8_t> encoded;
+  msg.encode({&encoded});
+  const size_t allocations_before = global_allocations;
+
+  Stopwatch watch;
+  for (uint32_t i = 0; i < iterations; i++) {
+    T decoded;
+    decoded.decode(encoded.data(), encoded.size());
+  }
+  const double ns = watch.elapsed_ns();
+
+  printf("api_decode      msg=%-28s ns/msg=%8.1f allocs/msg=%5.2f\n", name, ns / iterations,
+         double(global_allocations - allocations_before) / iterations);
+}
+
+void bench_api_decode_commands(uint32_t iterations) {
+  api::LightCommandRequest light;
+  light.key = 0x12345678;
+  light.has_state = true;
+  light.state = true;
+  light.has_brightness = true;
+  light.brightness = 0.5f;
+  light.has_effect = true;
+  const std::string effect = "Random Twinkle Slow";
+  light.effect = api::ProtoStringView(effect.data(), effect.size());
+
+  api::SwitchCommandRequest switch_command;
+  switch_command.key = 0x12345678;
+  switch_command.state = true;
+
+  // Not decoded with views, for comparison
+  api::HomeAssistantStateResponse ha_state;
+  ha_state.entity_id = "sensor.outside_temperature";
+  ha_state.state = "12.5";
+
+  bench_api_decode("LightCommandRequest", light, iterations);
+  bench_api_decode("SwitchCommandRequest", switch_command, iterations);
+  bench_api_decode("HomeAssistantStateResponse", ha_state, iterations);
+}
+
+/// Deterministic pseudo random numbers, so that every run parses the same chunks.
+class BenchRandom {
+ public:
+  uint32_t next(uint32_t max) {
+    this->state_ = this->state_ * 1103515245 + 12345;
+    return (this->state_ >> 8) % max;
+  }
+
+ protected:
+  uint32_t state_{1};
+};
+
+void append_frame(std::vector<uint8_t> &stream, uint32_t type, uint32_t size) {
+  stream.push_back(0x00);
+  api::ProtoVarInt(size).encode(stream);
+  api::ProtoVarInt(type).encode(stream);
+  for (uint32_t i = 0; i < size; i++)
+    stream.push_back(uint8_t(type + i));
+}
+
+bool check_frame(const api::APIFrameBuffer::Frame &frame) {
+  for (uint32_t i = 0; i < frame.size; i++) {
+    if (frame.data[i] != uint8_t(frame.type + i))
+      return false;
+  }
+  return true;
+}
+
+void bench_api_frame_parse(uint32_t num_frames) {
+  // A burst of mostly small commands with an occasional large one (like an execute_service), as Home Assistant
+  // sends them when replaying commands, received in full TCP segments
+  BenchRandom random;
+  std::vector<uint8_t> stream;
+  for (uint32_t i = 0; i < num_frames; i++)
+    append_frame(stream, 1 + random.next(60), random.next(32) == 0 ? 200 + random.next(800) : 4 + random.next(24));
+  std::vector<size_t> chunks;
+  for (size_t pos = 0; pos < stream.size();) {
+    const size_t chunk = std::min<size_t>(random.next(4) == 0 ? 1 + random.next(1460) : 1460, stream.size() - pos);
+    chunks.push_back(chunk);
+    pos += chunk;
+  }
+
+  for (bool legacy : {true, false}) {
+    uint32_t frames = 0;
+    bool valid = true;
+    uint32_t overflows = 0;
+    std::vector<uint8_t> recv_buffer;
+    api::APIFrameBuffer frame_buffer;
+    frame_buffer.init(1024);
+    const size_t allocations_before = global_allocations;
+
+    Stopwatch watch;
+    size_t pos = 0;
+    for (size_t chunk : chunks) {
+      if (legacy) {
+        // What APIConnection did before: append with insert, erase parsed frames from the front
+        recv_buffer.insert(recv_buffer.end(), &stream[pos], &stream[pos] + chunk);
+        while (!recv_buffer.empty()) {
+          uint32_t i = 1;
+          uint32_t consumed;
+          auto msg_size = api::ProtoVarInt::parse(&recv_buffer[i], recv_buffer.size() - i, &consumed);
+          if (!msg_size.has_value())
+            break;
+          i += consumed;
+          auto msg_type = api::ProtoVarInt::parse(&recv_buffer[i], recv_buffer.size() - i, &consumed);
+          if (!msg_type.has_value())
+            break;
+          i += consumed;
+          if (recv_buffer.size() - i < msg_size->as_uint32())
+            break;
+          api::APIFrameBuffer::Frame frame{msg_type->as_uint32(), msg_size->as_uint32(), &recv_buffer[i]};
+          valid &= check_frame(frame);
+          frames++;
+          recv_buffer.erase(recv_buffer.begin(), recv_buffer.begin() + i + frame.size);
+        }
+      } else {
+        if (!frame_buffer.write(&stream[pos], chunk))
+          overflows++;
+        api::APIFrameBuffer::Frame frame{};
+        while (frame_buffer.next_frame(&frame) == api::APIFrameBuffer::FrameStatus::FRAME_READY) {
+          valid &= check_frame(frame);
+          frames++;
+          frame_buffer.consume_frame();
+        }
+      }
+      pos += chunk;
+    }
+    const double ns = watch.elapsed_ns();
+
+    printf("api_frame_parse buffer=%-6s ns/frame=%7.1f MB/s=%7.1f allocs=%-4zu frames=%" PRIu32 " %s\n",
+           legacy ? "vector" : "ring", ns / frames, stream.size() * 1e3 / ns, global_allocations - allocations_before,
+           frames, valid && frames == num_frames && overflows == 0 ? "ok" : "MISMATCH");
+  }
+}
+
+/** Receive frames from another thread while the main thread parses them, like the TCP task and the main loop on the
+ * ESP32. Every frame has to come out complete and in order (build with -fsanitize=thread to catch data races).
+ */
+void check_api_frame_buffer_threads(uint32_t num_frames) {
+  api::APIFrameBuffer frame_buffer;
+  frame_buffer.init(256);
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> retries{0};
+  std::thread producer([&frame_buffer, &done, &retries, num_frames]() {
+    BenchRandom random;
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0; i < num_frames; i++)
+      append_frame(stream, i, random.next(257));
+    for (size_t pos = 0; pos < stream.size();) {
+      const size_t len = std::min<size_t>(1 + random.next(64), stream.size() - pos);
+      if (!frame_buffer.write(&stream[pos], len)) {
+        retries++;
+        std::this_thread::yield();
+        continue;
+      }
+      pos += len;
+    }
+    done = true;
+  });
+
+  uint32_t frames = 0;
+  bool valid = true;
+  api::APIFrameBuffer::Frame frame{};
+  while (frames < num_frames) {
+    auto status = frame_buffer.next_frame(&frame);
+    if (status == api::APIFrameBuffer::FrameStatus::FRAME_READY) {
+      valid &= frame.type == frames && check_frame(frame);
+      frames++;
+      frame_buffer.consume_frame();
+    } else if (status != api::APIFrameBuffer::FrameStatus::NEED_MORE_DATA) {
+      valid = false;
+      break;
+    } else if (done && frame_buffer.available() == 0) {
+      break;
+    }
+  }
+  producer.join();
+
+  printf("api_frame_threads frames=%-7" PRIu32 " parsed=%-7" PRIu32 " retries=%-7" PRIu32 " %s\n", num_frames,
+         frames, retries.load(), valid && frames == num_frames ? "ok" : "MISMATCH");
+}
+
+/** A peer that sends a full TCP window per round trip while loop() only runs every few round trips, like Home
+ * Assistant sending the initial commands while the node is busy. Acknowledging data right away lets several windows
+ * pile up in the ring, holding the acknowledgement back while the ring has no room for another window (as
+ * APIConnection does) must never overflow nor stall.
+ */
+void check_api_frame_buffer_window(uint32_t num_frames) {
+  const size_t window = api::APIFrameBuffer::RECEIVE_WINDOW;
+  BenchRandom random;
+  std::vector<uint8_t> stream;
+  for (uint32_t i = 0; i < num_frames; i++)
+    append_frame(stream, i, random.next(8) == 0 ? random.next(1025) : random.next(64));
+
+  for (bool hold_back : {false, true}) {
+    api::APIFrameBuffer frame_buffer;
+    frame_buffer.init(1024);
+    uint32_t frames = 0, overflows = 0, stalls = 0;
+    bool valid = true;
+    // Sent by the peer but not acknowledged yet
+    size_t unacked = 0;
+    size_t pos = 0;
+    while (frames < num_frames) {
+      bool progress = false;
+      for (uint32_t rtt = 1 + random.next(3); rtt > 0 && overflows == 0; rtt--) {
+        for (size_t sent = 0; pos < stream.size() && unacked + sent < window;) {
+          const size_t len = std::min<size_t>({1460, window - unacked - sent, stream.size() - pos});
+          if (!frame_buffer.write(&stream[pos], len)) {
+            overflows++;
+            break;
+          }
+          if (hold_back && !frame_buffer.should_ack()) {
+            unacked += len;
+          } else {
+            sent += len;
+          }
+          pos += len;
+          progress = true;
+        }
+      }
+      if (overflows != 0)
+        break;
+
+      api::APIFrameBuffer::Frame frame{};
+      while (frame_buffer.next_frame(&frame) == api::APIFrameBuffer::FrameStatus::FRAME_READY) {
+        valid &= frame.type == frames && check_frame(frame);
+        frames++;
+        frame_buffer.consume_frame();
+        progress = true;
+      }
+      if (unacked != 0 && frame_buffer.should_ack())
+        unacked = 0;
+      if (!progress) {
+        stalls++;
+        break;
+      }
+    }
+
+    printf("api_frame_window ack=%-6s capacity=%-5zu window=%-5zu frames=%-7" PRIu32 " overflows=%-3" PRIu32
+           " stalls=%" PRIu32 " %s\n",
+           hold_back ? "held" : "direct", frame_buffer.get_capacity(), window, frames, overflows, stalls,
+           !hold_back || (valid && frames == num_frames && overflows == 0 && stalls == 0) ? "ok" : "MISMATCH");
+  }
+}
+
+void fuzz_api_frame_buffer(uint32_t iterations) {
+  // Random, partly valid input in random chunks: the parser must never return frames it does not hold
+  // (build with -fsanitize=address to catch out of bounds accesses).
+  BenchRandom random;
+  api::APIFrameBuffer frame_buffer;
+  frame_buffer.init(64);
+  uint32_t frames = 0, too_large = 0, invalid = 0, overflows = 0;
+  bool valid = true;
+  std::vector<uint8_t> chunk;
+  for (uint32_t i = 0; i < iterations; i++) {
+    chunk.clear();
+    switch (random.next(4)) {
+      case 0:
+        // Garbage
+        for (uint32_t j = random.next(20); j > 0; j--)
+          chunk.push_back(random.next(256));
+        break;
+      case 1:
+        // Frame that may be larger than the maximum frame size
+        append_frame(chunk, random.next(300), random.next(100));
+        break;
+      default:
+        append_frame(chunk, random.next(300), random.next(64));
+        break;
+    }
+    // Split the chunk up like TCP might
+    for (size_t pos = 0; pos < chunk.size();) {
+      const size_t len = std::min<size_t>(1 + random.next(32), chunk.size() - pos);
+      if (!frame_buffer.write(&chunk[pos], len)) {
+        overflows++;
+        frame_buffer.init(64);
+      }
+      pos += len;
+
+      api::APIFrameBuffer::Frame frame{};
+      while (true) {
+        auto status = frame_buffer.next_frame(&frame);
+        if (status == api::APIFrameBuffer::FrameStatus::FRAME_READY) {
+          valid &= frame.size <= frame_buffer.get_max_frame_size() && frame.size <= frame_buffer.available();
+          frames++;
+          frame_buffer.consume_frame();
+        } else if (status == api::APIFrameBuffer::FrameStatus::FRAME_TOO_LARGE) {
+          too_large++;
+        } else if (status == api::APIFrameBuffer::FrameStatus::INVALID_FRAME) {
+          // The connection would be closed, start over
+          invalid++;
+          frame_buffer.init(64);
+          break;
+        } else {
+          break;
+        }
+      }
+    }
+  }
+
+  printf("api_frame_fuzz  iterations=%-7" PRIu32 " frames=%" PRIu32 " too_large=%" PRIu32 " invalid=%" PRIu32
+         " overflows=%" PRIu32 " %s\n",
+         iterations, frames, too_large, invalid, overflows, valid ? "ok" : "INVALID FRAME RETURNED");
+}
+
+/// The recursive matcher that MQTTClientComponent::on_message ran against every subscription before the topic trie.
+bool linear_topic_match(const char *message, const char *subscription, bool is_normal, bool past_separator) {
+  if (*message == '\0' && *subscription == '\0')
+    return true;
+  if (*message == '\0' || *subscription == '\0')
+    return false;
+  bool do_wildcards = is_normal || past_separator;
+  if (*subscription == '+' && do_wildcards) {
+    subscription++;
+    while (*message != '\0' && *message != '/')
+      message++;
+    return linear_topic_match(message, subscription, is_normal, true);
+  }
+  if (*subscription == '#' && do_wildcards)
+    return true;
+  if (*message != *subscription)
+    return false;
+  past_separator = past_separator || *subscription == '/';
+  return linear_topic_match(message + 1, subscription + 1, is_normal, past_separator);
+}
+bool linear_topic_match(const char *message, const char *subscription) {
+  return linear_topic_match(message, subscription, *message != '\0' && *message != '$', false);
+}
+
+void check_mqtt_topic_trie() {
+  struct Case {
+    const char *filter;
+    const char *topic;
+    bool match;
+  };
+  static const Case CASES[] = {
+      {"a/b", "a/b", true},
+      {"a/b", "a/b/c", false},
+      {"a/b", "a", false},
+      {"a/+", "a/b", true},
+      {"a/+", "a/", true},
+      {"a/+", "a/b/c", false},
+      {"a/+", "a", false},
+      {"+/+", "a/b", true},
+      {"+", "/a", false},
+      {"+/a", "/a", true},
+      {"a/+/c", "a/b/c", true},
+      {"a/+/c", "a/b/d", false},
+      {"a/+/c", "a//c", true},
+      {"a//c", "a//c", true},
+      {"a/#", "a", true},
+      {"a/#", "a/b/c", true},
+      {"a/#", "ab", false},
+      {"#", "a/b", true},
+      {"#", "$SYS/info", false},
+      {"+/info", "$SYS/info", false},
+      {"$SYS/#", "$SYS/info", true},
+      {"$SYS/+", "$SYS/info", true},
+      {"a/$b/#", "a/$b/c", true},
+      {"a/b#", "a/b#", true},
+      {"a/#/c", "a/#/c", true},
+      {"a/#/c", "a/b/c", false},
+      {"", "", true},
+  };
+  uint32_t failures = 0;
+  std::vector<size_t> values;
+  for (const auto &c : CASES) {
+    mqtt::MQTTTopicTrie trie;
+    trie.insert(c.filter, 7);
+    values.clear();
+    trie.match(c.topic, &values);
+    const bool match = values.size() == 1 && values[0] == 7;
+    if (match != c.match || values.size() > 1) {
+      printf("  filter='%s' topic='%s' expected %d\n", c.filter, c.topic, c.match);
+      failures++;
+    }
+  }
+  printf("mqtt_topic_trie cases=%zu %s\n", sizeof(CASES) / sizeof(CASES[0]), failures == 0 ? "ok" : "MISMATCH");
+}
+
+void check_mqtt_publish_tracker() {
+  mqtt::MQTTPublishTracker tracker;
+  std::vector<std::pair<uint16_t, bool>> results;
+  const mqtt::MQTTPublishTracker::result_t record = [&results](const mqtt::MQTTPublishTracker::Message &message,
+                                                                bool acknowledged) {
+    results.emplace_back(message.packet_id, acknowledged);
+  };
+  bool ok = true;
+
+  // Acknowledgements in any order, unknown packet ids are ignored
+  for (uint16_t id = 1; id <= 3; id++)
+    tracker.track(id, nullptr, id * 100, 0);
+  tracker.on_ack(2);
+  tracker.on_ack(99);
+  tracker.on_ack(1);
+  tracker.process(500, 1000, record);
+  ok &= results == std::vector<std::pair<uint16_t, bool>>{{2, true}, {1, true}} && tracker.size() == 1;
+  // Messages time out in the order they were published
+  results.clear();
+  tracker.track(4, nullptr, 400, 600);
+  tracker.process(1000, 1000, record);
+  ok &= results == std::vector<std::pair<uint16_t, bool>>{{3, false}} && tracker.size() == 1;
+
+  // No more messages than MAX_IN_FLIGHT are tracked
+  tracker.clear();
+  for (uint16_t id = 1; id <= mqtt::MQTTPublishTracker::MAX_IN_FLIGHT + 4; id++)
+    tracker.track(id, nullptr, 0, 0);
+  ok &= tracker.is_full() && tracker.size() == mqtt::MQTTPublishTracker::MAX_IN_FLIGHT;
+
+  // A full acknowledgement queue drops the acknowledgements, clear() drops the pending ones
+  results.clear();
+  for (uint16_t id = 1; id <= 40; id++)
+    tracker.on_ack(id);
+  ok &= tracker.get_dropped_acks() == 40 - 31;
+  tracker.process(0, 1000, record);
+  ok &= results.size() == mqtt::MQTTPublishTracker::MAX_IN_FLIGHT && tracker.size() == 0;
+  tracker.track(5, nullptr, 0, 0);
+  tracker.on_ack(5);
+  tracker.clear();
+  results.clear();
+  tracker.track(5, nullptr, 0, 0);
+  tracker.process(0, 1000, record);
+  ok &= results.empty() && tracker.size() == 1;
+
+  printf("mqtt_publish_tracker %s\n", ok ? "ok" : "MISMATCH");
+}
+
+/// Dispatch of received messages to the subscriptions of num_entities entities with a command topic each, plus a
+/// few wildcard subscriptions: linear scan over all subscriptions versus the topic trie.
+void bench_mqtt_dispatch(uint32_t num_entities, uint32_t messages) {
+  static const char *const TYPES[] = {"switch", "light", "fan", "cover", "climate"};
+  std::vector<std::string> filters = {"homeassistant/status", "livingroom/+/+/set", "livingroom/debug/#", "$SYS/#",
+                                      "+/broadcast"};
+  for (uint32_t i = 0; i < num_entities; i++)
+    filters.push_back(std::string("livingroom/") + TYPES[i % 5] + "/entity_" + to_string(i) + "/command");
+  mqtt::MQTTTopicTrie trie;
+  for (size_t i = 0; i < filters.size(); i++)
+    trie.insert(filters[i], i);
+
+  BenchRandom random;
+  std::vector<std::string> topics;
+  for (uint32_t i = 0; i < 256; i++) {
+    const uint32_t entity = random.next(num_entities + num_entities / 4);
+    switch (random.next(8)) {
+      case 0:
+        topics.push_back("livingroom/debug/" + to_string(entity));
+        break;
+      case 1:
+        topics.push_back(i % 2 ? "$SYS/broker/uptime" : "homeassistant/status");
+        break;
+      case 2:
+        topics.push_back(std::string("livingroom/") + TYPES[entity % 5] + "/entity_" + to_string(entity) + "/set");
+        break;
+      default:
+        topics.push_back(std::string("livingroom/") + TYPES[entity % 5] + "/entity_" + to_string(entity) + "/command");
+        break;
+    }
+  }
+
+  std::vector<size_t> linear_matches, trie_matches;
+  size_t linear_total = 0, trie_total = 0;
+  bool same = true;
+  Stopwatch linear_watch;
+  for (uint32_t m = 0; m < messages; m++) {
+    const std::string &topic = topics[m % topics.size()];
+    linear_matches.clear();
+    for (size_t i = 0; i < filters.size(); i++) {
+      if (linear_topic_match(topic.c_str(), filters[i].c_str()))
+        linear_matches.push_back(i);
+    }
+    linear_total += linear_matches.size();
+  }
+  const double linear_ns = linear_watch.elapsed_ns();
+  Stopwatch trie_watch;
+  for (uint32_t m = 0; m < messages; m++) {
+    trie_matches.clear();
+    trie.match(topics[m % topics.size()], &trie_matches);
+    std::sort(trie_matches.begin(), trie_matches.end());
+    trie_total += trie_matches.size();
+  }
+  const double trie_ns = trie_watch.elapsed_ns();
+  for (const auto &topic : topics) {
+    linear_matches.clear();
+    trie_matches.clear();
+    for (size_t i = 0; i < filters.size(); i++) {
+      if (linear_topic_match(topic.c_str(), filters[i].c_str()))
+        linear_matches.push_back(i);
+    }
+    trie.match(topic, &trie_matches);
+    std::sort(trie_matches.begin(), trie_matches.end());
+    same &= linear_matches == trie_matches;
+  }
+
+  printf("mqtt_dispatch subscriptions=%5zu ns/message: linear=%8.1f trie=%6.1f matches=%zu %s\n", filters.size(),
+         linear_ns / messages, trie_ns / messages, trie_total, same && linear_total == trie_total ? "ok" : "MISMATCH");
+}
+
+void check_json_writer() {
+  struct Case {
+    json::json_write_t write;
+    const char *expected;
+  };
+  const Case cases[] = {
+      {[](json::JsonWriter &root) {}, "{}"},
+      {[](json::JsonWriter &root) { root.set("s", "a\"b\\c\n\t\x01/\xc3\xa9"); },
+       "{\"s\":\"a\\\"b\\\\c\\n\\t\\u0001/\xc3\xa9\"}"},
+      {[](json::JsonWriter &root) {
+         root.set("i", -42);
+         root.set("min", INT32_MIN);
+         root.set("u", 4000000000u);
+         root.set("byte", uint8_t(255));
+         root.set("t", true);
+         root.set("f", false);
+       },
+       "{\"i\":-42,\"min\":-2147483648,\"u\":4000000000,\"byte\":255,\"t\":true,\"f\":false}"},
+      {[](json::JsonWriter &root) {
+         root.set("half", 21.5f);
+         root.set("whole", 10.0f);
+         root.set("tenth", 0.1f);
+         root.set("negative", -0.25f);
+         root.set("big", 1e10f);
+         root.set("nan", NAN);
+         root.set("inf", -INFINITY);
+       },
+       "{\"half\":21.5,\"whole\":10,\"tenth\":0.1,\"negative\":-0.25,\"big\":1e+10,\"nan\":null,\"inf\":null}"},
+      {[](json::JsonWriter &root) {
+         root.begin_array("a");
+         root.add(1);
+         root.add("x");
+         root.begin_object();
+         root.set("k", std::string("v"));
+         root.end_object();
+         root.begin_array();
+         root.end_array();
+         root.add(0.5f);
+         root.end_array();
+         root.begin_object("o");
+         root.end_object();
+         root.set("last", false);
+       },
+       "{\"a\":[1,\"x\",{\"k\":\"v\"},[],0.5],\"o\":{},\"last\":false}"},
+  };
+  size_t failures = 0;
+  for (const auto &c : cases) {
+    const std::string result = json::write_json(c.write);
+    if (result != c.expected) {
+      printf("  got '%s' expected '%s'\n", result.c_str(), c.expected);
+      failures++;
+    }
+  }
+  printf("json_writer cases=%zu %s\n", sizeof(cases) / sizeof(cases[0]), failures == 0 ? "ok" : "MISMATCH");
+}
+
+/** Stand-in for the object tree that json::build_json() builds with ArduinoJson before serializing: every member is
+ * a node holding a copy of its value, and the finished tree is serialized into the output string.
+ */
+class JsonTreeBuilder {
+ public:
+  struct Node {
+    enum Type { OBJECT, ARRAY, STRING, NUMBER, BOOLEAN } type;
+    std::string key;
+    std::string string;
+    float number;
+    bool boolean;
+    std::vector<Node> children;
+  };
+
+  JsonTreeBuilder() {
+    this->root_.type = Node::OBJECT;
+    this->stack_.push_back(&this->root_);
+  }
+
+  void begin_object(const char *key) { this->stack_.push_back(&this->add_node_(key, Node::OBJECT)); }
+  void end_object() { this->stack_.pop_back(); }
+  void begin_array(const char *key) { this->stack_.push_back(&this->add_node_(key, Node::ARRAY)); }
+  void end_array() { this->stack_.pop_back(); }
+  void set(const char *key, const std::string &value) { this->add_node_(key, Node::STRING).string = value; }
+  void set(const char *key, const char *value) { this->add_node_(key, Node::STRING).string = value; }
+  void set(const char *key, float value) { this->add_node_(key, Node::NUMBER).number = value; }
+  void set(const char *key, bool value) { this->add_node_(key, Node::BOOLEAN).boolean = value; }
+  void add(const char *value) { this->add_node_("", Node::STRING).string = value; }
+
+  void serialize(json::JsonWriter &writer) const {
+    writer.begin_object();
+    for (const auto &child : this->root_.children)
+      serialize_(writer, child);
+    writer.end_object();
+  }
+
+ protected:
+  Node &add_node_(const char *key, Node::Type type) {
+    Node *parent = this->stack_.back();
+    parent->children.emplace_back();
+    Node &node = parent->children.back();
+    node.type = type;
+    node.key = key;
+    return node;
+  }
+  static void serialize_(json::JsonWriter &writer, const Node &node) {
+    const char *key = node.key.c_str();
+    const bool member = !node.key.empty();
+    switch (node.type) {
+      case Node::OBJECT:
+      case Node::ARRAY:
+        if (node.type == Node::OBJECT)
+          member ? writer.begin_object(key) : writer.begin_object();
+        else
+          member ? writer.begin_array(key) : writer.begin_array();
+        for (const auto &child : node.children)
+          serialize_(writer, child);
+        node.type == Node::OBJECT ? writer.end_object() : writer.end_array();
+        break;
+      case Node::STRING:
+        member ? writer.set(key, node.string) : writer.add(node.string);
+        break;
+      case Node::NUMBER:
+        member ? writer.set(key, node.number) : writer.add(node.number);
+        break;
+      case Node::BOOLEAN:
+        member ? writer.set(key, node.boolean) : writer.add(node.boolean);
+        break;
+    }
+  }
+
+  Node root_;
+  std::vector<Node *> stack_;
+};
+
+struct DiscoveryEntity {
+  std::string name;
+  std::string unique_id;
+  std::string current_temperature_topic;
+  std::string mode_command_topic;
+  std::string mode_state_topic;
+  std::string temperature_command_topic;
+  std::string temperature_state_topic;
+};
+
+/// The Home Assistant discovery payload of a climate entity, like MQTTClimateComponent and MQTTComponent write it.
+template<typename Writer> void write_climate_discovery(Writer &root, const DiscoveryEntity &entity) {
+  static const std::string AVAILABILITY_TOPIC = "livingroom/status";
+  static const std::string MAC_ADDRESS = "a4cf12b3c4d5";
+  root.set("curr_temp_t", entity.current_temperature_topic);
+  root.set("mode_cmd_t", entity.mode_command_topic);
+  root.set("mode_stat_t", entity.mode_state_topic);
+  root.begin_array("modes");
+  for (const char *mode : {"auto", "off", "cool", "heat", "fan_only", "dry"})
+    root.add(mode);
+  root.end_array();
+  root.set("temp_cmd_t", entity.temperature_command_topic);
+  root.set("temp_stat_t", entity.temperature_state_topic);
+  root.set("min_temp", 7.0f);
+  root.set("max_temp", 35.0f);
+  root.set("temp_step", 0.5f);
+  root.set("name", entity.name);
+  root.set("availability_topic", AVAILABILITY_TOPIC);
+  root.set("unique_id", entity.unique_id);
+  root.begin_object("device");
+  root.set("identifiers", MAC_ADDRESS);
+  root.set("name", "livingroom");
+  root.set("sw_version", "esphome v2021.8.0 Aug 18 2021, 12:00:00");
+  root.set("model", "esp32dev");
+  root.set("manufacturer", "espressif");
+  root.end_object();
+}
+
+/// Discovery payloads of num_entities entities after a reconnect: building an object tree and serializing it versus
+/// serializing while writing. The peak is the most heap in use at once during all payloads, output buffer included.
+void bench_json_discovery(uint32_t num_entities) {
+  std::vector<DiscoveryEntity> entities;
+  for (uint32_t i = 0; i < num_entities; i++) {
+    const std::string base = "livingroom/climate/thermostat_" + to_string(i) + "/";
+    entities.push_back({"Thermostat " + to_string(i), "ESPclimatethermostat_" + to_string(i),
+                        base + "current_temperature/state", base + "mode/command", base + "mode/state",
+                        base + "target_temperature/command", base + "target_temperature/state"});
+  }
+
+  std::vector<std::string> tree_payloads;
+  size_t tree_allocations, tree_peak;
+  double tree_ns;
+  {
+    std::string output;
+    const size_t heap_before = global_heap_used;
+    global_heap_peak = heap_before;
+    const size_t allocations_before = global_allocations;
+    Stopwatch watch;
+    for (const auto &entity : entities) {
+      JsonTreeBuilder tree;
+      write_climate_discovery(tree, entity);
+      output.clear();
+      json::JsonWriter writer(&output);
+      tree.serialize(writer);
+    }
+    tree_ns = watch.elapsed_ns();
+    tree_allocations = global_allocations - allocations_before;
+    tree_peak = global_heap_peak - heap_before;
+
+    for (const auto &entity : entities) {
+      JsonTreeBuilder tree;
+      write_climate_discovery(tree, entity);
+      std::string payload;
+      json::JsonWriter writer(&payload);
+      tree.serialize(writer);
+      tree_payloads.push_back(payload);
+    }
+  }
+
+  std::vector<std::string> writer_payloads;
+  size_t writer_allocations, writer_peak, payload_bytes = 0;
+  double writer_ns;
+  {
+    std::string output;
+    const size_t heap_before = global_heap_used;
+    global_heap_peak = heap_before;
+    const size_t allocations_before = global_allocations;
+    Stopwatch watch;
+    for (const auto &entity : entities) {
+      output.clear();
+      json::JsonWriter writer(&output);
+      writer.begin_object();
+      write_climate_discovery(writer, entity);
+      writer.end_object();
+    }
+    writer_ns = watch.elapsed_ns();
+    writer_allocations = global_allocations - allocations_before;
+    writer_peak = global_heap_peak - heap_before;
+
+    for (const auto &entity : entities) {
+      writer_payloads.push_back(json::write_json([&entity](json::JsonWriter &root) {
+        write_climate_discovery(root, entity);
+      }));
+      payload_bytes += writer_payloads.back().size();
+    }
+  }
+
+  printf("json_discovery  entities=%-4u bytes/payload=%5.1f ns/payload: tree=%8.1f writer=%7.1f "
+         "allocations/payload: tree=%5.1f writer=%4.2f peak_heap: tree=%6zu writer=%5zu %s\n",
+         num_entities, double(payload_bytes) / num_entities, tree_ns / num_entities, writer_ns / num_entities,
+         double(tree_allocations) / num_entities, double(writer_allocations) / num_entities, tree_peak, writer_peak,
+         tree_payloads == writer_payloads ? "ok" : "MISMATCH");
+}
+
+/// 320x240 display with one byte per pixel like the ILI9341 driver, "transfers" the buffer into a copy of the panel
+/// memory and counts the bytes a SPI transfer of 16bit pixels would take.
+class MemoryDisplay : public display::DisplayBuffer {
+ public:
+  static const int WIDTH = 320;
+  static const int HEIGHT = 240;
+  /// Column address, page address and memory write commands with their parameters
+  static const size_t WINDOW_OVERHEAD = 3 + 8;
+
+  /// With span_hooks false, primitives fall back to the per pixel default implementations of DisplayBuffer.
+  explicit MemoryDisplay(bool flush_dirty, bool span_hooks = true)
+      : flush_dirty_only_(flush_dirty), span_hooks_(span_hooks), panel_(WIDTH * HEIGHT) {
+    this->init_internal_(WIDTH * HEIGHT);
+    this->init_dirty_area_();
+  }
+  ~MemoryDisplay() { delete[] this->buffer_; }  // NOLINT(cppcoreguidelines-owning-memory)
+
+  void update() {
+    this->do_update_();
+    if (this->flush_dirty_only_) {
+      this->flush_dirty_();
+    } else {
+      this->flush_window_(0, 0, WIDTH, HEIGHT);
+      this->reset_dirty_area_();
+    }
+  }
+  bool panel_matches_buffer() const { return memcmp(this->panel_.data(), this->buffer_, WIDTH * HEIGHT) == 0; }
+  bool buffer_matches(const MemoryDisplay &other) const {
+    return memcmp(this->buffer_, other.buffer_, WIDTH * HEIGHT) == 0;
+  }
+  void reset_stats() {
+    this->bytes_ = 0;
+    this->windows_ = 0;
+  }
+  size_t get_bytes() const { return this->bytes_; }
+  size_t get_windows() const { return this->windows_; }
+
+ protected:
+  void draw_absolute_pixel_internal(int x, int y, Color color) override {
+    if (x >= WIDTH || x < 0 || y >= HEIGHT || y < 0)
+      return;
+    const uint8_t value = display::ColorUtil::color_to_332(color);
+    uint8_t &pixel = this->buffer_[y * WIDTH + x];
+    if (pixel == value)
+      return;
+    pixel = value;
+    this->mark_dirty_(x, y);
+  }
+  void fill_rect_internal_(int x, int y, int width, int height, Color color) override {
+    if (!this->span_hooks_) {
+      DisplayBuffer::fill_rect_internal_(x, y, width, height, color);
+      return;
+    }
+    const uint8_t value = display::ColorUtil::color_to_332(color);
+    for (int row = y; row < y + height; row++) {
+      uint8_t *dst = &this->buffer_[row * WIDTH + x];
+      for (int i = 0; i < width; i++) {
+        if (dst[i] == value)
+          continue;
+        dst[i] = value;
+        this->mark_dirty_(x + i, row);
+      }
+    }
+  }
+  void draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) override {
+    if (!this->span_hooks_) {
+      DisplayBuffer::draw_pixels_internal_(x, y, step_x, step_y, colors, length);
+      return;
+    }
+    uint8_t *dst = &this->buffer_[y * WIDTH + x];
+    const int step = step_x + step_y * WIDTH;
+    for (int i = 0; i < length; i++) {
+      const uint8_t value = display::ColorUtil::color_to_332(colors[i]);
+      if (dst[i * step] == value)
+        continue;
+      dst[i * step] = value;
+      this->mark_dirty_(x + i * step_x, y + i * step_y);
+    }
+  }
+  void flush_window_(int x, int y, int width, int height) override {
+    for (int row = y; row < y + height; row++)
+      memcpy(&this->panel_[row * WIDTH + x], &this->buffer_[row * WIDTH + x], width);
+    this->bytes_ += WINDOW_OVERHEAD + size_t(width) * height * 2;
+    this->windows_++;
+  }
+  int get_width_internal() override { return WIDTH; }
+  int get_height_internal() override { return HEIGHT; }
+
+  bool flush_dirty_only_;
+  bool span_hooks_;
+  std::vector<uint8_t> panel_;
+  size_t bytes_{0};
+  size_t windows_{0};
+};
+
+/// A dashboard: static frames and labels, a bar graph and a small "clock" that change with every frame.
+void draw_dashboard_page(display::DisplayBuffer &it, uint32_t frame) {
+  it.rectangle(0, 0, 320, 240);
+  for (int i = 0; i < 4; i++) {
+    it.rectangle(10, 10 + i * 40, 140, 30);
+    it.filled_rectangle(15, 15 + i * 40, 60, 20, Color(0, 0, 255));
+  }
+  // bar graph, its background is drawn as well so that the page also works without auto clear
+  const int bar = 10 + (frame * 37) % 120;
+  it.filled_rectangle(170, 20, bar, 20, Color(0, 255, 0));
+  it.filled_rectangle(170 + bar, 20, 130 - bar, 20, display::COLOR_OFF);
+  // "clock" digits
+  for (int digit = 0; digit < 4; digit++) {
+    const int value = (frame >> (digit * 2)) % 10;
+    it.filled_rectangle(180 + digit * 30, 200, 20, value * 2, display::COLOR_OFF);
+    it.filled_rectangle(180 + digit * 30, 200 + value * 2, 20, 30 - value * 2);
+  }
+}
+
+void bench_display_update(const char *name, bool flush_dirty, bool auto_clear, bool animated, uint32_t frames) {
+  MemoryDisplay display(flush_dirty);
+  display.set_auto_clear(auto_clear);
+  uint32_t frame = 0;
+  display.set_writer([&frame, animated](display::DisplayBuffer &it) { draw_dashboard_page(it, animated ? frame : 0); });
+  // The first frame draws the static parts
+  display.update();
+  display.reset_stats();
+
+  Stopwatch watch;
+  for (frame = 1; frame <= frames; frame++)
+    display.update();
+  const double ns = watch.elapsed_ns();
+
+  printf("display_update %-8s flush=%-5s auto_clear=%-3s bytes/frame=%8.0f windows/frame=%5.1f us/frame=%8.1f %s\n",
+         name, flush_dirty ? "dirty" : "full", auto_clear ? "on" : "off", double(display.get_bytes()) / frames,
+         double(display.get_windows()) / frames, ns / frames / 1000.0,
+         display.panel_matches_buffer() ? "ok" : "PANEL DIFFERS FROM BUFFER");
+}
+
+void bench_display_updates(uint32_t frames) {
+  for (bool animated : {true, false}) {
+    const char *name = animated ? "animated" : "static";
+    bench_display_update(name, false, true, animated, frames);
+    bench_display_update(name, true, true, animated, frames);
+    bench_display_update(name, true, false, animated, frames);
+  }
+}
+
+/// Synthetic fixed width font and images for the test page, the pixel data is pseudo random.
+class TestPageAssets {
+ public:
+  static const int GLYPH_WIDTH = 12;
+  static const int GLYPH_HEIGHT = 20;
+  static const int NUM_GLYPHS = 95;
+  static const int IMAGE_SIZE = 100;
+
+  TestPageAssets() {
+    BenchRandom random;
+    std::vector<size_t> glyph_offsets;
+    for (int i = 0; i < NUM_GLYPHS; i++) {
+      glyph_offsets.push_back(this->glyph_runs_.size());
+      // Run length encoded like the font codegen does, about a quarter of the pixels set
+      for (int y = 0; y < GLYPH_HEIGHT; y++) {
+        bool on = false;
+        uint8_t run = 0;
+        for (int x = 0; x < GLYPH_WIDTH; x++) {
+          const bool pixel = (random.next(4) == 0);
+          if (pixel != on) {
+            this->glyph_runs_.push_back(run);
+            run = 0;
+            on = pixel;
+          }
+          run++;
+        }
+        this->glyph_runs_.push_back(run);
+      }
+    }
+    for (int i = 0; i < NUM_GLYPHS; i++) {
+      this->glyph_chars_[i][0] = char(' ' + i);
+      this->glyph_chars_[i][1] = '\0';
+      this->glyph_data_[i] = display::GlyphData{
+          this->glyph_chars_[i], uint32_t(' ' + i), &this->glyph_runs_[glyph_offsets[i]], 0, 0, GLYPH_WIDTH,
+          GLYPH_HEIGHT};
+      // The same glyphs without code points, looked up by string prefix matching
+      this->prefix_glyph_data_[i] = this->glyph_data_[i];
+      this->prefix_glyph_data_[i].codepoint = 0;
+    }
+    this->font.reset(new display::Font(this->glyph_data_, NUM_GLYPHS, 16, GLYPH_HEIGHT));
+    this->prefix_font.reset(new display::Font(this->prefix_glyph_data_, NUM_GLYPHS, 16, GLYPH_HEIGHT));
+
+    this->rgb_data_.resize(IMAGE_SIZE * IMAGE_SIZE * 3);
+    for (int i = 0; i < IMAGE_SIZE * IMAGE_SIZE * 3; i++)
+      this->rgb_data_[i] = (i * 7) ^ (i >> 5);
+    this->rgb_image.reset(
+        new display::Image(this->rgb_data_.data(), IMAGE_SIZE, IMAGE_SIZE, display::IMAGE_TYPE_RGB24));
+    this->binary_data_.resize((IMAGE_SIZE + 7) / 8 * IMAGE_SIZE);
+    for (auto &byte : this->binary_data_)
+      byte = random.next(256);
+    this->binary_image.reset(
+        new display::Image(this->binary_data_.data(), IMAGE_SIZE, IMAGE_SIZE, display::IMAGE_TYPE_BINARY));
+  }
+
+  std::unique_ptr<display::Font> font;
+  std::unique_ptr<display::Font> prefix_font;
+  std::unique_ptr<display::Image> rgb_image;
+  std::unique_ptr<display::Image> binary_image;
+
+ protected:
+  char glyph_chars_[NUM_GLYPHS][2];
+  display::GlyphData glyph_data_[NUM_GLYPHS];
+  display::GlyphData prefix_glyph_data_[NUM_GLYPHS];
+  std::vector<uint8_t> glyph_runs_;
+  std::vector<uint8_t> rgb_data_;
+  std::vector<uint8_t> binary_data_;
+};
+
+/// Background, frames, five lines of text and two images, partially outside of the screen.
+void draw_test_page(display::DisplayBuffer &it, const TestPageAssets &assets) {
+  it.fill(Color(0, 0, 64));
+  it.filled_rectangle(-10, -10, 60, 40, Color(255, 0, 0));
+  it.rectangle(5, 5, it.get_width() - 10, it.get_height() - 10, Color(255, 255, 0));
+  for (int line = 0; line < 5; line++)
+    it.print(10, 30 + line * 24, assets.font.get(), Color(255, 255, 255), "The quick brown fox jumps");
+  it.image(it.get_width() - 80, 20, assets.rgb_image.get());
+  it.image(it.get_width() - 120, it.get_height() - 60, assets.binary_image.get(), Color(0, 255, 0), Color(0, 0, 0));
+}
+
+/// The same page drawn pixel by pixel through draw_pixel_at, like the primitives did before the span API.
+void draw_test_page_per_pixel(display::DisplayBuffer &it, const TestPageAssets &assets) {
+  auto rect = [&it](int x1, int y1, int width, int height, Color color) {
+    for (int y = y1; y < y1 + height; y++) {
+      for (int x = x1; x < x1 + width; x++)
+        it.draw_pixel_at(x, y, color);
+    }
+  };
+  auto bitmap = [&it](int x1, int y1, const display::Image *image, Color color_on, const Color *color_off) {
+    for (int y = 0; y < image->get_height(); y++) {
+      for (int x = 0; x < image->get_width(); x++) {
+        if (image->get_pixel(x, y)) {
+          it.draw_pixel_at(x1 + x, y1 + y, color_on);
+        } else if (color_off != nullptr) {
+          it.draw_pixel_at(x1 + x, y1 + y, *color_off);
+        }
+      }
+    }
+  };
+  rect(0, 0, it.get_width(), it.get_height(), Color(0, 0, 64));
+  rect(-10, -10, 60, 40, Color(255, 0, 0));
+  const Color yellow(255, 255, 0);
+  rect(5, 5, it.get_width() - 10, 1, yellow);
+  rect(5, it.get_height() - 6, it.get_width() - 10, 1, yellow);
+  rect(5, 5, 1, it.get_height() - 10, yellow);
+  rect(it.get_width() - 6, 5, 1, it.get_height() - 10, yellow);
+  const char *text = "The quick brown fox jumps";
+  for (int line = 0; line < 5; line++) {
+    for (int i = 0; text[i] != '\0'; i++) {
+      int match_length;
+      const display::Glyph &glyph = assets.font->get_glyphs()[assets.font->match_next_glyph(text + i, &match_length)];
+      for (int y = 0; y < TestPageAssets::GLYPH_HEIGHT; y++) {
+        for (int x = 0; x < TestPageAssets::GLYPH_WIDTH; x++) {
+          if (glyph.get_pixel(x, y))
+            it.draw_pixel_at(10 + i * TestPageAssets::GLYPH_WIDTH + x, 30 + line * 24 + y, Color(255, 255, 255));
+        }
+      }
+    }
+  }
+  const display::Image *rgb = assets.rgb_image.get();
+  for (int y = 0; y < rgb->get_height(); y++) {
+    for (int x = 0; x < rgb->get_width(); x++)
+      it.draw_pixel_at(it.get_width() - 80 + x, 20 + y, rgb->get_color_pixel(x, y));
+  }
+  const Color black(0, 0, 0);
+  bitmap(it.get_width() - 120, it.get_height() - 60, assets.binary_image.get(), Color(0, 255, 0), &black);
+}
+
+void bench_display_test_page(const TestPageAssets &assets, display::DisplayRotation rotation, uint32_t iterations) {
+  MemoryDisplay per_pixel(true, false);
+  MemoryDisplay fallback(true, false);
+  MemoryDisplay span(true, true);
+  per_pixel.set_rotation(rotation);
+  fallback.set_rotation(rotation);
+  span.set_rotation(rotation);
+
+  auto measure = [iterations](const std::function<void()> &draw) {
+    Stopwatch watch;
+    for (uint32_t i = 0; i < iterations; i++)
+      draw();
+    return watch.elapsed_ns() / iterations / 1000.0;
+  };
+  const double per_pixel_us = measure([&] { draw_test_page_per_pixel(per_pixel, assets); });
+  const double fallback_us = measure([&] { draw_test_page(fallback, assets); });
+  const double span_us = measure([&] { draw_test_page(span, assets); });
+  const bool ok = span.buffer_matches(per_pixel) && fallback.buffer_matches(per_pixel);
+
+  printf("display_test_page rotation=%3d us/page: per_pixel=%8.1f default_hooks=%8.1f span_hooks=%8.1f %s\n",
+         int(rotation), per_pixel_us, fallback_us, span_us, ok ? "ok" : "BUFFERS DIFFER");
+}
+
+void bench_font_measure(const TestPageAssets &assets, uint32_t iterations) {
+  const char *text = "Temperature: 21.5 C, Humidity: 45 %, Pressure: 1013 hPa";
+  auto measure = [text, iterations](display::Font *font, int *width) {
+    int x_offset, baseline, height;
+    Stopwatch watch;
+    for (uint32_t i = 0; i < iterations; i++)
+      font->measure(text, width, &x_offset, &baseline, &height);
+    return watch.elapsed_ns() / iterations / 1000.0;
+  };
+  int codepoint_width, prefix_width;
+  const double codepoint_us = measure(assets.font.get(), &codepoint_width);
+  const double prefix_us = measure(assets.prefix_font.get(), &prefix_width);
+  printf("font_measure us/call: prefix_match=%6.2f codepoint_index=%6.2f %s\n", prefix_us, codepoint_us,
+         codepoint_width == prefix_width ? "ok" : "WIDTHS DIFFER");
+}
+
+/// Renders in strips into a buffer with 16bit colors like the strip mode of the ILI9341 driver, the strips are
+/// "transferred" into a copy of the panel memory.
+class StripDisplay : public display::DisplayBuffer {
+ public:
+  static const int WIDTH = 320;
+  static const int HEIGHT = 240;
+
+  explicit StripDisplay(int strip_height)
+      : strip_height_(strip_height), strip_(WIDTH * strip_height), panel_(WIDTH * HEIGHT) {}
+
+  void update() { this->do_update_strips_(this->strip_height_); }
+  bool panel_matches(const StripDisplay &other) const { return this->panel_ == other.panel_; }
+  size_t get_buffer_size() const { return this->strip_.size() * sizeof(uint16_t); }
+
+ protected:
+  uint16_t *strip_pixel_(int x, int y) {
+    if (y < this->strip_y_ || y >= this->strip_y_ + this->strip_rows_)
+      return nullptr;
+    return &this->strip_[(y - this->strip_y_) * WIDTH + x];
+  }
+  void draw_absolute_pixel_internal(int x, int y, Color color) override {
+    if (x >= WIDTH || x < 0 || y >= HEIGHT || y < 0)
+      return;
+    uint16_t *pixel = this->strip_pixel_(x, y);
+    if (pixel != nullptr)
+      *pixel = display::ColorUtil::color_to_565(color);
+  }
+  void fill_rect_internal_(int x, int y, int width, int height, Color color) override {
+    const uint16_t color565 = display::ColorUtil::color_to_565(color);
+    for (int row = y; row < y + height; row++) {
+      uint16_t *dst = this->strip_pixel_(x, row);
+      // Everything outside of the strip must have been clipped away already
+      if (dst == nullptr)
+        abort();
+      std::fill(dst, dst + width, color565);
+    }
+  }
+  void draw_pixels_internal_(int x, int y, int step_x, int step_y, const Color *colors, int length) override {
+    for (int i = 0; i < length; i++) {
+      uint16_t *dst = this->strip_pixel_(x + i * step_x, y + i * step_y);
+      if (dst == nullptr)
+        abort();
+      *dst = display::ColorUtil::color_to_565(colors[i]);
+    }
+  }
+  void begin_strip_(int y, int height) override {
+    this->strip_y_ = y;
+    this->strip_rows_ = height;
+  }
+  void end_strip_(int y, int height) override {
+    std::copy(this->strip_.begin(), this->strip_.begin() + WIDTH * height, this->panel_.begin() + y * WIDTH);
+  }
+  int get_width_internal() override { return WIDTH; }
+  int get_height_internal() override { return HEIGHT; }
+
+  int strip_height_;
+  int strip_y_{0};
+  int strip_rows_{0};
+  std::vector<uint16_t> strip_;
+  std::vector<uint16_t> panel_;
+};
+
+void bench_display_strips(const TestPageAssets &assets, display::DisplayRotation rotation, uint32_t iterations) {
+  // A single strip of the whole screen is the reference
+  StripDisplay reference(StripDisplay::HEIGHT);
+  reference.set_rotation(rotation);
+  reference.set_writer([&assets](display::DisplayBuffer &it) { draw_test_page(it, assets); });
+  reference.update();
+
+  for (int strip_height : {240, 40, 16, 8}) {
+    StripDisplay display(strip_height);
+    display.set_rotation(rotation);
+    display.set_writer([&assets](display::DisplayBuffer &it) { draw_test_page(it, assets); });
+    Stopwatch watch;
+    for (uint32_t i = 0; i < iterations; i++)
+      display.update();
+    const double us = watch.elapsed_ns() / iterations / 1000.0;
+    printf("display_strips rotation=%3d strip_height=%3d buffer=%6zu bytes us/frame=%8.1f %s\n", int(rotation),
+           strip_height, display.get_buffer_size(), us, display.panel_matches(reference) ? "ok" : "PANEL DIFFERS");
+  }
+}
+
+/// 32x8 display with a column buffer that grows with the pixels drawn right of the screen, like the MAX7219 dot
+/// matrix driver that scrolls text wider than the display.
+class ScrollingDisplay : public display::DisplayBuffer {
+ public:
+  static const int WIDTH = 32;
+  static const int HEIGHT = 8;
+
+  const std::vector<uint8_t> &get_columns() const { return this->columns_; }
+
+ protected:
+  void draw_absolute_pixel_internal(int x, int y, Color color) override {
+    if (x + 1 > int(this->columns_.size()))
+      this->columns_.resize(x + 1, 0);
+    if (y >= HEIGHT || y < 0 || x < 0)
+      return;
+    if (color.is_on()) {
+      this->columns_[x] |= 1 << y;
+    } else {
+      this->columns_[x] &= ~(1 << y);
+    }
+  }
+  int get_clip_width_() override { return INT16_MAX; }
+  int get_width_internal() override { return WIDTH; }
+  int get_height_internal() override { return HEIGHT; }
+
+  std::vector<uint8_t> columns_;
+};
+
+/// Text wider than a scrolling display has to reach the driver completely, not cut off at the width of the screen.
+void check_display_scrolling_text(const TestPageAssets &assets) {
+  const char *text = "Scrolling text";
+  const int text_width = int(strlen(text)) * TestPageAssets::GLYPH_WIDTH;
+  ScrollingDisplay printed;
+  printed.print(0, 0, assets.font.get(), Color(255, 255, 255), text);
+
+  ScrollingDisplay reference;
+  for (int i = 0; text[i] != '\0'; i++) {
+    int match_length;
+    const display::Glyph &glyph = assets.font->get_glyphs()[assets.font->match_next_glyph(text + i, &match_length)];
+    for (int y = 0; y < ScrollingDisplay::HEIGHT; y++) {
+      for (int x = 0; x < TestPageAssets::GLYPH_WIDTH; x++) {
+        if (glyph.get_pixel(x, y))
+          reference.draw_pixel_at(i * TestPageAssets::GLYPH_WIDTH + x, y, Color(255, 255, 255));
+      }
+    }
+  }
+  // The reference may end with empty columns the glyph spans never reach
+  std::vector<uint8_t> expected = reference.get_columns();
+  std::vector<uint8_t> columns = printed.get_columns();
+  expected.resize(text_width, 0);
+  const bool reached_end = columns.size() > size_t(ScrollingDisplay::WIDTH);
+  columns.resize(text_width, 0);
+
+  printf("display_scrolling_text width=%d text_width=%d buffer=%zu %s\n", ScrollingDisplay::WIDTH, text_width,
+         printed.get_columns().size(), reached_end && columns == expected ? "ok" : "TEXT CUT OFF");
+}
+
+void bench_display_test_pages(uint32_t iterations) {
+  const TestPageAssets assets;
+  for (auto rotation : {display::DISPLAY_ROTATION_0_DEGREES, display::DISPLAY_ROTATION_90_DEGREES,
+                        display::DISPLAY_ROTATION_180_DEGREES, display::DISPLAY_ROTATION_270_DEGREES})
+    bench_display_test_page(assets, rotation, iterations);
+  for (auto rotation : {display::DISPLAY_ROTATION_0_DEGREES, display::DISPLAY_ROTATION_90_DEGREES})
+    bench_display_strips(assets, rotation, iterations);
+  check_display_scrolling_text(assets);
+  bench_font_measure(assets, iterations * 100);
+}
+
+/// An RGB LED strip in memory, with or without overrides of the bulk write hooks (like the FastLED output).
+class MemoryAddressableLight : public light::AddressableLight {
+ public:
+  MemoryAddressableLight(int32_t size, bool bulk_hooks)
+      : leds_(size * 3), effect_data_(size), bulk_hooks_(bulk_hooks) {}
+
+  int32_t size() const override { return this->effect_data_.size(); }
+  void clear_effect_data() override { std::fill(this->effect_data_.begin(), this->effect_data_.end(), 0); }
+  light::LightTraits get_traits() override {
+    auto traits = light::LightTraits();
+    traits.set_supported_color_modes({light::ColorMode::RGB});
+    return traits;
+  }
+  bool leds_match(const MemoryAddressableLight &other) const { return this->leds_ == other.leds_; }
+
+ protected:
+  light::ESPColorView get_view_internal(int32_t index) const override {
+    auto *led = const_cast<uint8_t *>(&this->leds_[index * 3]);
+    return {led, led + 1, led + 2, nullptr, const_cast<uint8_t *>(&this->effect_data_[index]), &this->correction_};
+  }
+  void fill_internal_(int32_t index, int32_t count, const Color &corrected) override {
+    if (!this->bulk_hooks_) {
+      AddressableLight::fill_internal_(index, count, corrected);
+      return;
+    }
+    for (uint8_t *led = &this->leds_[index * 3]; count > 0; count--, led += 3) {
+      led[0] = corrected.red;
+      led[1] = corrected.green;
+      led[2] = corrected.blue;
+    }
+  }
+  void write_internal_(int32_t index, const Color *colors, int32_t count, const uint8_t *table) override {
+    if (!this->bulk_hooks_) {
+      AddressableLight::write_internal_(index, colors, count, table);
+      return;
+    }
+    uint8_t *led = &this->leds_[index * 3];
+    for (int32_t i = 0; i < count; i++, led += 3) {
+      led[0] = table[colors[i].red];
+      led[1] = table[256 + colors[i].green];
+      led[2] = table[512 + colors[i].blue];
+    }
+  }
+
+  std::vector<uint8_t> leds_;
+  std::vector<uint8_t> effect_data_;
+  bool bulk_hooks_;
+};
+
+/// The rainbow effect as it was written before the bulk API: one color view per LED.
+void rainbow_per_view(light::AddressableLight &it, uint32_t now) {
+  light::ESPHSVColor hsv;
+  hsv.value = 255;
+  hsv.saturation = 240;
+  uint16_t hue = (now * 10) % 0xFFFF;
+  const uint16_t add = 0xFFFF / 50;
+  for (auto var : it) {
+    hsv.hue = hue >> 8;
+    var = hsv;
+    hue += add;
+  }
+}
+
+void bench_addressable_light(int32_t num_leds, uint32_t frames) {
+  MemoryAddressableLight per_view(num_leds, false);
+  MemoryAddressableLight default_hooks(num_leds, false);
+  MemoryAddressableLight bulk_hooks(num_leds, true);
+  light::LightState state("bench", &bulk_hooks);
+  state.set_gamma_correct(2.8f);
+  light::AddressableRainbowLightEffect rainbow("Rainbow");
+  for (MemoryAddressableLight *light : {&per_view, &default_hooks, &bulk_hooks}) {
+    light->setup_state(&state);
+    light->set_correction(1.0f, 0.8f, 0.6f);
+  }
+
+  auto measure = [frames](const std::function<void(uint32_t)> &draw) {
+    Stopwatch watch;
+    for (uint32_t frame = 0; frame < frames; frame++)
+      draw(frame * 16);
+    return watch.elapsed_ns() / frames / 1000.0;
+  };
+  // The rainbow effect reads millis(), which is the same virtual time for all of them
+  const uint32_t now = millis();
+  const double per_view_us = measure([&](uint32_t frame) { rainbow_per_view(per_view, now); });
+  const double default_us = measure([&](uint32_t frame) { rainbow.apply(default_hooks, Color::BLACK); });
+  const double bulk_us = measure([&](uint32_t frame) { rainbow.apply(bulk_hooks, Color::BLACK); });
+  bool ok = per_view.leds_match(bulk_hooks) && default_hooks.leds_match(bulk_hooks);
+  printf("addressable_rainbow leds=%5d us/frame: per_view=%8.1f default_hooks=%8.1f bulk_hooks=%8.1f %s\n", num_leds,
+         per_view_us, default_us, bulk_us, ok ? "ok" : "LEDS DIFFER");
+
+  const Color color(200, 100, 50);
+  const double fill_per_view_us = measure([&](uint32_t frame) {
+    for (auto led : per_view)
+      led = color;
+  });
+  const double fill_default_us = measure([&](uint32_t frame) { default_hooks.all() = color; });
+  const double fill_bulk_us = measure([&](uint32_t frame) { bulk_hooks.all() = color; });
+  ok = per_view.leds_match(bulk_hooks) && default_hooks.leds_match(bulk_hooks);
+  printf("addressable_fill    leds=%5d us/frame: per_view=%8.1f default_hooks=%8.1f bulk_hooks=%8.1f %s\n", num_leds,
+         fill_per_view_us, fill_default_us, fill_bulk_us, ok ? "ok" : "LEDS DIFFER");
+}
+
+/// The light color values as floats, like LightColorValues stored them before the fixed point representation.
+struct FloatColorValues {
+  float state, brightness, color_brightness, red, green, blue, white, color_temperature, cold_white, warm_white;
+};
+
+FloatColorValues to_float_values(const light::LightColorValues &v) {
+  return {v.get_state(), v.get_brightness(), v.get_color_brightness(), v.get_red(),        v.get_green(),
+          v.get_blue(),  v.get_white(),      v.get_color_temperature(), v.get_cold_white(), v.get_warm_white()};
+}
+
+/// One step of the transition as LightTransitionTransformer computed it with floats.
+FloatColorValues float_transition_step(const FloatColorValues &start, const FloatColorValues &end, float progress) {
+  const float x = progress;
+  const float v = x * x * x * (x * (x * 6.0f - 15.0f) + 10.0f);
+  auto channel = [v](float from, float to) { return clamp(esphome::lerp(v, from, to), 0.0f, 1.0f); };
+  return {channel(start.state, end.state),
+          channel(start.brightness, end.brightness),
+          channel(start.color_brightness, end.color_brightness),
+          channel(start.red, end.red),
+          channel(start.green, end.green),
+          channel(start.blue, end.blue),
+          channel(start.white, end.white),
+          esphome::lerp(v, start.color_temperature, end.color_temperature),
+          channel(start.cold_white, end.cold_white),
+          channel(start.warm_white, end.warm_white)};
+}
+
+/** Runs light transitions with the (fixed point) LightTransitionTransformer and with the previous float math.
+ *
+ * Compares the cost of a transition step and the outputs: the RGBW levels after gamma correction of both paths,
+ * as floats and as the 8 bit values most outputs end up with.
+ */
+void bench_light_transition(uint32_t transitions, uint32_t steps) {
+  const float gamma = 2.8f;
+  const uint32_t length_ms = 1000;
+  uint32_t seed = 1;
+  auto random_level = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    // Mix 8 bit values (what Home Assistant sends) with arbitrary floats
+    return (seed & 0x80000000) ? ((seed >> 16) & 0xFF) / 255.0f : ((seed >> 8) & 0xFFFF) / 65536.0f;
+  };
+
+  double fixed_ns = 0, float_ns = 0, max_error = 0;
+  uint32_t byte_mismatches = 0, outputs = 0, end_mismatches = 0;
+  for (uint32_t t = 0; t < transitions; t++) {
+    const light::LightColorValues start(light::ColorMode::RGB_WHITE, 1.0f, random_level(), random_level(),
+                                        random_level(), random_level(), random_level(), random_level(),
+                                        153 + random_level() * 347, random_level(), random_level());
+    const light::LightColorValues end(light::ColorMode::RGB_WHITE, 1.0f, random_level(), random_level(),
+                                      random_level(), random_level(), random_level(), random_level(),
+                                      153 + random_level() * 347, random_level(), random_level());
+    const FloatColorValues float_start = to_float_values(start), float_end = to_float_values(end);
+
+    light::LightTransitionTransformer transformer;
+    transformer.setup(start, end, length_ms);
+    const uint32_t start_ms = millis();
+    light::LightColorValues values;
+    for (uint32_t step = 1; step <= steps; step++) {
+      delay(length_ms / steps);
+      const float progress = clamp((millis() - start_ms) / float(length_ms), 0.0f, 1.0f);
+
+      Stopwatch fixed_watch;
+      values = *transformer.apply();
+      fixed_ns += fixed_watch.elapsed_ns();
+      Stopwatch float_watch;
+      const FloatColorValues expected = float_transition_step(float_start, float_end, progress);
+      float_ns += float_watch.elapsed_ns();
+
+      float fixed_out[4], float_out[4];
+      values.as_rgbw(&fixed_out[0], &fixed_out[1], &fixed_out[2], &fixed_out[3], gamma);
+      const float level = expected.state * expected.brightness;
+      float_out[0] = gamma_correct(level * expected.color_brightness * expected.red, gamma);
+      float_out[1] = gamma_correct(level * expected.color_brightness * expected.green, gamma);
+      float_out[2] = gamma_correct(level * expected.color_brightness * expected.blue, gamma);
+      float_out[3] = gamma_correct(level * expected.white, gamma);
+      for (int i = 0; i < 4; i++) {
+        max_error = std::max(max_error, double(std::fabs(fixed_out[i] - float_out[i])));
+        if (light::to_uint8_scale(fixed_out[i]) != light::to_uint8_scale(float_out[i]))
+          byte_mismatches++;
+        outputs++;
+      }
+    }
+    if (values != end)
+      end_mismatches++;
+  }
+
+  const uint32_t total_steps = transitions * steps;
+  // Off by one in an 8 bit output can only happen when the float value is within rounding of a step boundary
+  const bool ok = end_mismatches == 0 && max_error < 1e-3 && byte_mismatches * 100 < outputs;
+  printf("light_transition steps=%6u ns/step: fixed=%7.1f float=%7.1f max_error=%.6f byte_mismatches=%u/%u %s\n",
+         total_steps, fixed_ns / total_steps, float_ns / total_steps, max_error, byte_mismatches, outputs,
+         ok ? "ok" : "OUTPUTS DIFFER");
+}
+
+/** Simulates a WS2812 strip fed by the main loop, with show() inline in the loop versus an output task.
+ *
+ * Runs on virtual time: the loop renders a frame every 16ms (plus the time it is blocked), the transmission of a
+ * frame takes 30us per LED plus the 50us reset. The output task is driven as its own timeline by calling
+ * run_once() whenever it would wake up on the other core.
+ */
+void bench_light_output_task(uint32_t num_leds, uint32_t frames) {
+  const uint32_t loop_interval_us = 16000;
+  const uint32_t transmit_us = num_leds * 30 + 50;
+  const uint32_t min_interval_us = 10000;
+  const size_t frame_size = num_leds * 3;
+
+  // Inline: the loop waits for the transmission, every rendered frame that passes the refresh limit is shown
+  uint32_t inline_time = 0, inline_shown = 0, inline_last = 0;
+  for (uint32_t frame = 0; frame < frames; frame++) {
+    uint32_t blocked = 0;
+    if (inline_shown == 0 || inline_time - inline_last >= min_interval_us) {
+      inline_last = inline_time;
+      inline_shown++;
+      blocked = transmit_us;
+    }
+    inline_time += loop_interval_us + blocked;
+  }
+
+  std::vector<uint8_t> leds(frame_size);
+  uint32_t last_frame_id = 0, corrupt = 0, out_of_order = 0;
+  uint32_t first_start = 0, last_start = 0;
+  uint32_t now = 0;
+  light::LightOutputTask task;
+  task.init(frame_size, min_interval_us, [&](const uint8_t *frame) {
+    uint32_t id;
+    memcpy(&id, frame, sizeof(id));
+    for (size_t i = sizeof(id); i < frame_size; i++) {
+      if (frame[i] != uint8_t(id + i)) {
+        corrupt++;
+        break;
+      }
+    }
+    if (id <= last_frame_id)
+      out_of_order++;
+    last_frame_id = id;
+    if (task.get_transmitted() == 0)
+      first_start = now;
+    last_start = now;
+  });
+
+  const uint32_t never = UINT32_MAX;
+  uint32_t next_loop = 0, next_output = never;
+  uint32_t frame = 0;
+  double submit_ns = 0;
+  while (frame < frames || next_output != never) {
+    if (frame < frames && next_loop <= next_output) {
+      now = next_loop;
+      const uint32_t id = ++frame;
+      memcpy(leds.data(), &id, sizeof(id));
+      for (size_t i = sizeof(id); i < frame_size; i++)
+        leds[i] = uint8_t(id + i);
+      Stopwatch watch;
+      task.submit(leds.data());
+      submit_ns += watch.elapsed_ns();
+      next_loop = now + loop_interval_us;
+      // Submitting notifies a sleeping output task
+      if (next_output == never)
+        next_output = now;
+      continue;
+    }
+    now = next_output;
+    uint32_t wait_us = 0;
+    switch (task.run_once(now, &wait_us)) {
+      case light::LightOutputTask::RunResult::TRANSMITTED:
+        next_output = now + transmit_us;
+        break;
+      case light::LightOutputTask::RunResult::WAIT:
+        next_output = now + wait_us;
+        break;
+      case light::LightOutputTask::RunResult::NO_FRAME:
+        next_output = never;
+        break;
+    }
+  }
+
+  const auto &buffer = task.get_frame_buffer();
+  const uint32_t transmitted = task.get_transmitted();
+  const double task_fps = transmitted > 1 ? (transmitted - 1) * 1e6 / (last_start - first_start) : 0;
+  const bool ok = corrupt == 0 && out_of_order == 0 && last_frame_id == frames &&
+                  buffer.get_published() == transmitted + buffer.get_dropped();
+  printf("light_output_task leds=%4u inline: loop_fps=%5.1f shown=%5u blocked_us/frame=%6u task: loop_fps=%5.1f "
+         "shown=%5u fps=%5.1f dropped=%4u ns/submit=%7.1f %s\n",
+         num_leds, frames * 1e6 / inline_time, inline_shown, transmit_us, 1e6 / loop_interval_us, transmitted,
+         task_fps, buffer.get_dropped(), submit_ns / frames, ok ? "ok" : "FRAMES CORRUPT");
+}
+
+// Typical timings of the SPI flash of ESP8266 modules (W25Q32: 45ms sector erase, 0.7ms page program), used to
+// estimate how long the loop is blocked by writing preferences to the emulated flash.
+static const double FLASH_ERASE_MS = 45.0;
+static const double FLASH_PAGE_PROGRAM_MS = 0.7;
+
+double flash_busy_ms(const HostPreferencesFlash &flash) {
+  return flash.get_erases() * FLASH_ERASE_MS + flash.get_pages_programmed() * FLASH_PAGE_PROGRAM_MS;
+}
+
+void check_preferences_log(uint8_t num_sectors, uint32_t iterations, bool power_losses_enabled) {
+  // Random records, optionally with a power loss in the middle of every 16th write, after which the image loaded from
+  // flash has to match the image of the records that were written completely. A single sector can't survive a power
+  // loss during compactions.
+  const size_t image_words = 64;
+  HostPreferencesFlash flash(num_sectors);
+  std::vector<uint32_t> image(image_words), committed(image_words);
+  auto log = make_unique<PreferencesLog>(&flash, num_sectors, image.data(), image_words);
+  log->load();
+
+  uint32_t random = 1;
+  auto next_random = [&random]() {
+    random = random * 1103515245 + 12345;
+    return random >> 8;
+  };
+  uint32_t power_losses = 0, compactions = 0, failed = 0, corrupt = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    const size_t offset = next_random() % image_words;
+    const size_t length = 1 + next_random() % std::min<size_t>(12, image_words - offset);
+    for (size_t j = offset; j < offset + length; j++)
+      image[j] = next_random();
+    const bool power_loss = power_losses_enabled && next_random() % 16 == 0;
+    if (power_loss)
+      flash.fail_after(next_random() % (length + PreferencesLog::RECORD_OVERHEAD + 2));
+
+    const uint32_t compactions_before = log->get_compactions();
+    if (log->append(offset, length)) {
+      if (log->get_compactions() != compactions_before) {
+        committed = image;
+      } else {
+        std::copy(image.begin() + offset, image.begin() + offset + length, committed.begin() + offset);
+      }
+    } else if (!power_loss) {
+      failed++;
+    }
+    if (!power_loss)
+      continue;
+
+    // Reboot
+    power_losses++;
+    compactions += log->get_compactions();
+    flash.restore_power();
+    std::fill(image.begin(), image.end(), 0);
+    log = make_unique<PreferencesLog>(&flash, num_sectors, image.data(), image_words);
+    log->load();
+    if (image != committed) {
+      corrupt++;
+      committed = image;
+    }
+  }
+  compactions += log->get_compactions();
+
+  printf("preferences_log sectors=%u appends=%6u power_losses=%4u compactions=%4u max_sector_erases=%4u %s\n",
+         num_sectors, iterations, power_losses, compactions, flash.get_max_sector_erases(),
+         failed == 0 && corrupt == 0 ? "ok" : "CORRUPT");
+}
+
+/** Preference saves of dimming sweeps: a light with restore_mode saving its state on every brightness step (every
+ * 50ms), a number changed four times and a switch toggled once per sweep, and a climate saved at the end of it.
+ *
+ * Calls save(index, value) for each save of preference index (light, climate, number, switch) and tick(now) after
+ * every step.
+ */
+void preferences_dimming_sweeps(uint32_t sweeps, const std::function<void(size_t, uint32_t)> &save,
+                                const std::function<void(uint32_t)> &tick) {
+  const uint32_t steps = 100, step_ms = 50;
+  uint32_t now = 0;
+  for (uint32_t sweep = 0; sweep < sweeps; sweep++) {
+    for (uint32_t step = 0; step < steps; step++) {
+      save(0, sweep * steps + step);
+      if (step % 25 == 0)
+        save(2, sweep * 4 + step / 25);
+      if (step == steps / 2)
+        save(3, sweep % 2);
+      now += step_ms;
+      tick(now);
+    }
+    save(1, sweep);
+  }
+}
+
+struct LightPreference {
+  uint32_t words[8];
+};
+struct EntityPreference {
+  uint32_t words[2];
+};
+template<typename T> bool save_preference(ESPPreferenceObject &pref, uint32_t value) {
+  T data{};
+  for (auto &word : data.words)
+    word = value++;
+  return pref.save(&data);
+}
+template<typename T> bool check_preference(ESPPreferenceObject &pref, uint32_t value) {
+  T data{};
+  return pref.load(&data) && data.words[0] == value;
+}
+
+void print_preferences_result(const char *store, const HostPreferencesFlash &flash, uint32_t saves, double worst_ms,
+                              bool ok) {
+  printf("preferences %-22s saves=%5u erases=%4u max_sector_erases=%4u kB_written=%6.1f busy_ms=%8.1f "
+         "worst_blocking_ms=%5.1f %s\n",
+         store, saves, flash.get_erases(), flash.get_max_sector_erases(), flash.get_bytes_written() / 1024.0,
+         flash_busy_ms(flash), worst_ms, ok ? "ok" : "RESTORE MISMATCH");
+}
+
+void bench_preferences_legacy(uint32_t sweeps) {
+  // Erasing and rewriting the whole image on every save, like the flash preferences of the ESP8266 before the log
+  HostPreferencesFlash flash(1);
+  std::vector<uint32_t> image(128);
+  uint32_t saves = 0;
+  double worst_ms = 0;
+  preferences_dimming_sweeps(
+      sweeps,
+      [&](size_t index, uint32_t value) {
+        saves++;
+        image[index * 10] = value;
+        const double before = flash_busy_ms(flash);
+        flash.erase_sector(0);
+        flash.write(0, image.data(), image.size() * 4);
+        worst_ms = std::max(worst_ms, flash_busy_ms(flash) - before);
+      },
+      [](uint32_t now) {});
+  print_preferences_result("legacy", flash, saves, worst_ms, true);
+}
+
+void bench_preferences(uint8_t num_sectors, uint32_t write_interval, uint32_t sweeps) {
+  // The flash is emulated in a file, so the preferences are also restored by a new instance reading it
+  const char *path = "/tmp/esphome_host_preferences.bin";
+  remove(path);
+  global_preferences.set_deferred_sync(write_interval != 0);
+  global_preferences.begin(num_sectors, path);
+  std::vector<ESPPreferenceObject> prefs = {
+      global_preferences.make_preference<LightPreference>(0x1001),
+      global_preferences.make_preference<EntityPreference>(0x1002),
+      global_preferences.make_preference<EntityPreference>(0x1003),
+      global_preferences.make_preference<EntityPreference>(0x1004),
+  };
+  HostPreferencesFlash &flash = *global_preferences.get_host_flash();
+
+  std::vector<uint32_t> saved(prefs.size());
+  uint32_t saves = 0, last_sync = 0;
+  double worst_ms = 0;
+  auto measure = [&](const std::function<void()> &f) {
+    const double before = flash_busy_ms(flash);
+    f();
+    worst_ms = std::max(worst_ms, flash_busy_ms(flash) - before);
+  };
+  preferences_dimming_sweeps(
+      sweeps,
+      [&](size_t index, uint32_t value) {
+        saves++;
+        saved[index] = value;
+        measure([&]() {
+          if (index == 0) {
+            save_preference<LightPreference>(prefs[index], value);
+          } else {
+            save_preference<EntityPreference>(prefs[index], value);
+          }
+        });
+      },
+      [&](uint32_t now) {
+        if (write_interval == 0 || now - last_sync < write_interval)
+          return;
+        last_sync = now;
+        measure([]() { global_preferences.sync(); });
+      });
+  // Shutdown
+  measure([]() { global_preferences.sync(); });
+  const HostPreferencesFlash written = flash;
+
+  // Reboot, the preferences are made again in the same order
+  global_preferences.begin(num_sectors, path);
+  bool ok = check_preference<LightPreference>(prefs[0] = global_preferences.make_preference<LightPreference>(0x1001),
+                                              saved[0]);
+  for (size_t i = 1; i < prefs.size(); i++) {
+    prefs[i] = global_preferences.make_preference<EntityPreference>(0x1001 + i);
+    ok = ok && check_preference<EntityPreference>(prefs[i], saved[i]);
+  }
+  remove(path);
+  global_preferences.set_deferred_sync(false);
+
+  char store[32];
+  snprintf(store, sizeof(store), "log sectors=%u sync=%us", num_sectors, write_interval / 1000);
+  print_preferences_result(store, written, saves, worst_ms, ok);
+}
+
+// Record a message into buffer and pop it again, the deferred formatting has to give the same output as vsnprintf().
+bool __attribute__((format(printf, 3, 4))) check_log_format(logger::LogRingBuffer *buffer, size_t size,
+                                                             const char *format, ...) {
+  char expected[256], actual[256];
+  va_list args;
+  va_start(args, format);
+  va_list args_copy;
+  va_copy(args_copy, args);
+  vsnprintf(expected, size, format, args_copy);
+  va_end(args_copy);
+  const bool recorded = buffer->record(ESPHOME_LOG_LEVEL_DEBUG, "bench", 42, format, args, false);
+  va_end(args);
+
+  uint8_t level;
+  const char *tag;
+  int line;
+  const bool popped = recorded && buffer->pop(&level, &tag, &line, actual, size);
+  if (popped && strcmp(expected, actual) == 0 && level == ESPHOME_LOG_LEVEL_DEBUG && strcmp(tag, "bench") == 0 &&
+      line == 42)
+    return true;
+  printf("  format '%s' got '%s' expected '%s'\n", format, popped ? actual : "(not popped)", expected);
+  return false;
+}
+
+void check_log_ring_buffer() {
+  logger::LogRingBuffer buffer(512, 64);
+  char changed[] = "before";
+  const char *null_string = nullptr;
+  size_t failures = 0;
+  auto check = [&failures](bool ok) { failures += ok ? 0 : 1; };
+  // Enough messages to wrap around the buffer several times. Null strings and invalid specs are tested on purpose.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat"
+#pragma GCC diagnostic ignored "-Wformat-overflow"
+  for (int i = 0; i < 20; i++) {
+    check(check_log_format(&buffer, 256, "plain text without arguments"));
+    check(check_log_format(&buffer, 256, "%d %i %u %x %X %o %c %%", -i, i * 1000, 4000000000u, 0xBEEF, 0xBEEF, 8, 'z'));
+    check(check_log_format(&buffer, 256, "%08X|%-6d|%+d|% d|%#x|%5.3d", 0x1234, i, i, i, i, i));
+    check(check_log_format(&buffer, 256, "%hhu %hd %ld %lld %llu %zu %jd %td", 300, -2, -3L, -4000000000000LL,
+                           18000000000000000000ULL, sizeof(buffer), intmax_t(-5), ptrdiff_t(6)));
+    check(check_log_format(&buffer, 256, "%.2f %f %e %g %G %10.1f %-8.3f| %a %Lf", 21.456, -1.0 / 3, 12345.678, 1e-7,
+                           1e20, 3.14159, 2.5, 0.5, 1.5L));
+    check(check_log_format(&buffer, 256, "'%s' [%10s] [%-10s] [%.3s] [%.*s] [%*s] [%-*s]", "sensor", "right", "left",
+                           "truncated", 2, "star", 6, "wide", 6, "left"));
+    check(check_log_format(&buffer, 256, "%*d|%-*d|%.*f|%*.*f|%*s", 5, i, -5, i, 3, 1.23456, 8, 2, 2.5, -4, "neg"));
+    check(check_log_format(&buffer, 256, "%s %s %p", null_string, "", &buffer));
+    // Truncated to the message buffer, and to the max string length
+    check(check_log_format(&buffer, 16, "%s and more text than fits %d", "long string", i));
+    check(check_log_format(&buffer, 256, "[%s]", "0123456789012345678901234567890123456789012345678901234567890123"));
+    // Invalid and incomplete specs are printed as is
+    check(check_log_format(&buffer, 256, "%y %"));
+  }
+#pragma GCC diagnostic pop
+
+  // %s arguments are copied when recording
+  uint8_t level;
+  const char *tag;
+  int line;
+  char message[64];
+  bool copied = false;
+  auto record = [&buffer](const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const bool recorded = buffer.record(ESPHOME_LOG_LEVEL_INFO, "bench", 1, format, args, false);
+    va_end(args);
+    return recorded;
+  };
+  if (record("state %s", changed)) {
+    strcpy(changed, "after");  // NOLINT
+    copied = buffer.pop(&level, &tag, &line, message, sizeof(message)) && strcmp(message, "state before") == 0;
+  }
+  check(copied);
+
+  // Messages that don't fit are dropped and counted, the recorded ones stay in order
+  logger::LogRingBuffer small(128, 32);
+  uint32_t recorded = 0, popped = 0;
+  auto record_small = [&small](const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const bool ok = small.record(ESPHOME_LOG_LEVEL_INFO, "bench", 1, format, args, false);
+    va_end(args);
+    return ok;
+  };
+  for (uint32_t i = 0; i < 20; i++)
+    recorded += record_small("message %u %s", i, "text") ? 1 : 0;
+  for (uint32_t i = 0; small.pop(&level, &tag, &line, message, sizeof(message)); i++) {
+    char expected[64];
+    snprintf(expected, sizeof(expected), "message %u text", i);
+    check(strcmp(message, expected) == 0);
+    popped++;
+  }
+  check(recorded > 0 && recorded == popped && small.get_dropped() == 20 - recorded);
+
+  // The size of the buffer and of each message is capped, a message that fills the whole buffer has to come out intact
+  logger::LogRingBuffer large(1 << 20, 1 << 20);
+  check(large.get_size() == logger::LogRingBuffer::MAX_SIZE);
+  std::string long_string(logger::LogRingBuffer::MAX_SIZE, 'x');
+  std::unique_ptr<char[]> long_message(new char[logger::LogRingBuffer::MAX_SIZE + 1]);
+  auto record_large = [&large](const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const bool ok = large.record(ESPHOME_LOG_LEVEL_INFO, "bench", 1, format, args, false);
+    va_end(args);
+    return ok;
+  };
+  // Larger than the buffer
+  check(!record_large("%s", long_string.c_str()));
+  // Shorten the string until the message fits, then it fills the whole buffer
+  size_t skip = 0;
+  while (skip < 64 && !record_large("%s", long_string.c_str() + skip))
+    skip++;
+  check(large.pop(&level, &tag, &line, long_message.get(), logger::LogRingBuffer::MAX_SIZE + 1) &&
+        strlen(long_message.get()) == logger::LogRingBuffer::MAX_SIZE - skip);
+  check(!large.pop(&level, &tag, &line, message, sizeof(message)));
+
+  printf("log_ring_buffer size=%zu dropped=%u/20 %s\n", buffer.get_size(), small.get_dropped(),
+         failures == 0 ? "ok" : "MISMATCH");
+}
+
+/** Log from several threads while the main thread formats the messages, like tasks logging on the ESP32. The threads
+ * retry dropped messages, so that all of them have to come out.
+ */
+void check_log_ring_buffer_threads(uint32_t num_threads, uint32_t messages) {
+  logger::LogRingBuffer buffer(4096, 64);
+  std::atomic<uint32_t> running{num_threads};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&buffer, &running, t, messages]() {
+      auto record = [&buffer](const char *format, ...) {
+        va_list args;
+        va_start(args, format);
+        const bool ok = buffer.record(ESPHOME_LOG_LEVEL_INFO, "thread", 1, format, args, false);
+        va_end(args);
+        return ok;
+      };
+      for (uint32_t i = 0; i < messages; i++) {
+        while (!record("%u:%u %s", t, i, "payload"))
+          std::this_thread::yield();
+      }
+      running--;
+    });
+  }
+
+  // Every message has to come out complete, and in order per thread
+  std::vector<uint32_t> next(num_threads), popped(num_threads);
+  uint32_t failures = 0;
+  uint8_t level;
+  const char *tag;
+  int line;
+  char message[64];
+  while (true) {
+    const bool done = running == 0;
+    while (buffer.pop(&level, &tag, &line, message, sizeof(message))) {
+      unsigned t, i;
+      char payload[16];
+      if (sscanf(message, "%u:%u %15s", &t, &i, payload) != 3 || t >= num_threads || i < next[t] ||
+          strcmp(payload, "payload") != 0) {
+        failures++;
+        continue;
+      }
+      next[t] = i + 1;
+      popped[t]++;
+    }
+    if (done)
+      break;
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  uint32_t total = 0;
+  for (uint32_t t = 0; t < num_threads; t++) {
+    total += popped[t];
+    if (popped[t] != messages)
+      failures++;
+  }
+  printf("log_ring_buffer threads=%u messages=%6u popped=%6u retries=%6u %s\n", num_threads, num_threads * messages,
+         total, buffer.get_dropped(), failures == 0 ? "ok" : "CORRUPT");
+}
+
+/// Time spent at the call site of a typical log message, formatted immediately or recorded for the loop.
+void bench_log_call_site(uint32_t iterations) {
+  static const char *const FORMAT = "'%s': Sending state %.5f %s with %d decimals of accuracy";
+  char message[512];
+  auto format_now = [&message](const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+  };
+  Stopwatch sync_watch;
+  for (uint32_t i = 0; i < iterations; i++)
+    format_now(FORMAT, "Living Room Temperature", 21.5 + i % 10, "°C", 1);
+  const double sync_ns = sync_watch.elapsed_ns();
+
+  logger::LogRingBuffer buffer(2048, 512);
+  auto record = [&buffer](const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    buffer.record(ESPHOME_LOG_LEVEL_DEBUG, "sensor", 1, format, args, false);
+    va_end(args);
+  };
+  uint8_t level;
+  const char *tag;
+  int line;
+  double record_ns = 0, pop_ns = 0;
+  for (uint32_t i = 0; i < iterations; i += 16) {
+    // Bursts of 16 messages between two loop iterations
+    Stopwatch record_watch;
+    for (uint32_t j = 0; j < 16; j++)
+      record(FORMAT, "Living Room Temperature", 21.5 + (i + j) % 10, "°C", 1);
+    record_ns += record_watch.elapsed_ns();
+    Stopwatch pop_watch;
+    while (buffer.pop(&level, &tag, &line, message, sizeof(message))) {
+    }
+    pop_ns += pop_watch.elapsed_ns();
+  }
+
+  // Once the UART FIFO is full, writing the ~90 characters at 115200 baud (10 bits per character) blocks the caller
+  const double uart_us = 90 * 10 * 1e6 / 115200;
+  printf("log_call_site ns/message sync_format=%6.1f (+ up to %.0fus uart) async_record=%6.1f loop_format=%6.1f "
+         "dropped=%u\n",
+         sync_ns / iterations, uart_us, record_ns / iterations, pop_ns / iterations, buffer.get_dropped());
+}
+
+/// Level lookups of num_tags tags (each a separate string constant) with num_overrides overrides configured.
+void bench_tag_levels(size_t num_overrides, size_t num_tags, uint32_t iterations) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < std::max(num_overrides, num_tags); i++)
+    names.push_back("component." + std::to_string(i));
+  std::vector<std::unique_ptr<char[]>> tags;
+  for (size_t i = 0; i < num_tags; i++) {
+    tags.emplace_back(new char[names[i].size() + 1]);
+    strcpy(tags.back().get(), names[i].c_str());  // NOLINT
+  }
+
+  // Previous implementation: linear scan comparing every override with the tag
+  struct Override {
+    std::string tag;
+    int level;
+  };
+  std::vector<Override> overrides;
+  logger::TagLevels levels(ESPHOME_LOG_LEVEL_DEBUG, num_overrides + 1);
+  for (size_t i = 0; i < num_overrides; i++) {
+    // Overrides for the tags that are logged last
+    const std::string &name = names[names.size() - 1 - i];
+    overrides.push_back({name, ESPHOME_LOG_LEVEL_WARN});
+    levels.set(name, ESPHOME_LOG_LEVEL_WARN);
+  }
+  auto scan = [&overrides](const char *tag) {
+    for (auto &over : overrides) {
+      if (over.tag == tag)
+        return over.level;
+    }
+    return ESPHOME_LOG_LEVEL_DEBUG;
+  };
+
+  bool ok = true;
+  volatile int sink = 0;
+  Stopwatch scan_watch;
+  for (uint32_t i = 0; i < iterations; i++)
+    sink = sink + scan(tags[i % num_tags].get());
+  const double scan_ns = scan_watch.elapsed_ns();
+  Stopwatch table_watch;
+  for (uint32_t i = 0; i < iterations; i++)
+    sink = sink + levels.get(tags[i % num_tags].get());
+  const double table_ns = table_watch.elapsed_ns();
+  for (size_t i = 0; i < num_tags; i++)
+    ok = ok && levels.get(tags[i].get()) == scan(tags[i].get());
+
+  // Changing a level at runtime applies to the tags that were cached before
+  levels.set(names[0], ESPHOME_LOG_LEVEL_ERROR);
+  ok = ok && levels.get(tags[0].get()) == ESPHOME_LOG_LEVEL_ERROR;
+  levels.set(names[0], ESPHOME_LOG_LEVEL_VERBOSE);
+  ok = ok && levels.get(tags[0].get()) == ESPHOME_LOG_LEVEL_VERBOSE;
+  // The room for overrides is fixed, the levels of existing tags can still be changed
+  logger::TagLevels full(ESPHOME_LOG_LEVEL_DEBUG, 1);
+  ok = ok && full.set("first", ESPHOME_LOG_LEVEL_WARN) && !full.set("second", ESPHOME_LOG_LEVEL_WARN) &&
+       full.set("first", ESPHOME_LOG_LEVEL_ERROR) && full.get("first") == ESPHOME_LOG_LEVEL_ERROR &&
+       full.get("second") == ESPHOME_LOG_LEVEL_DEBUG;
+
+  printf("tag_levels overrides=%3zu tags=%3zu ns/lookup scan=%7.1f table=%6.1f %s\n", num_overrides, num_tags,
+         scan_ns / iterations, table_ns / iterations, ok ? "ok" : "MISMATCH");
+}
+
+/** Web server requests and state events with num_entities sensors (every 10th internal): looking up the entity of a
+ * request URL, and the SSE events sent to one slow client that takes 4 events per loop iteration and three fast ones
+ * while 20 sensors update per iteration. Sending every update overflows the queue of the slow client (32 events, like
+ * SSE_MAX_QUEUED_MESSAGES) and drops events, and so does pacing by the average queue of all clients. Pacing by the
+ * bound of the slowest client lets the pending queue of the entity index coalesce the updates and always delivers
+ * the latest states.
+ */
+void bench_web_server_entities(uint32_t num_entities, uint32_t requests) {
+  std::vector<std::unique_ptr<sensor::Sensor>> sensors;
+  web_server::EntityIndex index;
+  for (uint32_t i = 0; i < num_entities; i++) {
+    sensors.push_back(esphome::make_unique<sensor::Sensor>("Sensor " + to_string(i)));
+    sensors.back()->set_internal(i % 10 == 9);
+    index.add(web_server::DOMAIN_SENSOR, sensors.back().get());
+  }
+  index.build();
+
+  BenchRandom random;
+  std::vector<std::string> ids;
+  for (uint32_t i = 0; i < 256; i++) {
+    if (random.next(8) == 0) {
+      ids.push_back("unknown_" + to_string(i));
+    } else {
+      ids.push_back(sensors[random.next(num_entities)]->get_object_id());
+    }
+  }
+
+  uint32_t linear_found = 0, index_found = 0;
+  Stopwatch linear_watch;
+  for (uint32_t r = 0; r < requests; r++) {
+    // Previous routing: compare the object id of every entity of the domain
+    for (auto &obj : sensors) {
+      if (obj->is_internal())
+        continue;
+      if (obj->get_object_id() != ids[r % ids.size()])
+        continue;
+      linear_found++;
+      break;
+    }
+  }
+  const double linear_ns = linear_watch.elapsed_ns();
+  Stopwatch index_watch;
+  for (uint32_t r = 0; r < requests; r++)
+    index_found += index.find(web_server::DOMAIN_SENSOR, ids[r % ids.size()]) != nullptr ? 1 : 0;
+  const double index_ns = index_watch.elapsed_ns();
+  bool ok = linear_found == index_found;
+  for (auto &id : ids) {
+    Nameable *expected = nullptr;
+    for (auto &obj : sensors) {
+      if (!obj->is_internal() && obj->get_object_id() == id)
+        expected = obj.get();
+    }
+    ok = ok && index.find(web_server::DOMAIN_SENSOR, id) == expected;
+  }
+
+  const uint32_t loops = 1000, updates_per_loop = 20, client_queue = 32;
+  // One slow client (4 events per loop iteration) among three fast ones
+  const std::vector<uint32_t> client_rates = {4, 32, 32, 32};
+  std::map<Nameable *, uint32_t> numbers;
+  for (uint32_t i = 0; i < num_entities; i++)
+    numbers[sensors[i].get()] = i;
+  std::vector<std::vector<uint32_t>> updates(loops);
+  for (auto &loop_updates : updates) {
+    for (uint32_t u = 0; u < updates_per_loop; u++) {
+      const uint32_t i = random.next(num_entities);
+      if (!sensors[i]->is_internal())
+        loop_updates.push_back(i);
+    }
+  }
+
+  enum class Pacing { DIRECT, AVERAGE, SLOWEST };
+  struct Result {
+    uint32_t sent, dropped, stale;
+  };
+  auto simulate = [&](Pacing pacing) {
+    // Events are (entity, version of its state when the event was serialized)
+    using Event = std::pair<uint32_t, uint32_t>;
+    std::vector<std::vector<Event>> queues(client_rates.size());
+    std::vector<std::vector<uint32_t>> delivered(client_rates.size(), std::vector<uint32_t>(num_entities));
+    std::vector<uint32_t> latest(num_entities);
+    uint32_t version = 0;
+    Result result{0, 0, 0};
+    auto send = [&](uint32_t i) {
+      result.sent++;
+      for (auto &queue : queues) {
+        // The web server library drops events for clients with a full queue
+        if (queue.size() < client_queue) {
+          queue.emplace_back(i, latest[i]);
+        } else {
+          result.dropped++;
+        }
+      }
+    };
+    // Run on until the queues are drained after the updates stopped
+    for (uint32_t loop = 0; loop < loops + num_entities; loop++) {
+      for (uint32_t i : loop < loops ? updates[loop] : std::vector<uint32_t>{}) {
+        latest[i] = ++version;
+        if (pacing == Pacing::DIRECT) {
+          // Previous behavior: an event for every update
+          send(i);
+        } else {
+          index.mark_pending(web_server::DOMAIN_SENSOR, sensors[i].get());
+        }
+      }
+      if (pacing != Pacing::DIRECT) {
+        size_t total = 0;
+        for (auto &queue : queues)
+          total += queue.size();
+        const size_t avg = (total + queues.size() / 2) / queues.size();
+        size_t budget;
+        if (pacing == Pacing::AVERAGE) {
+          // Previous pacing: send while the average queue is below half of the maximum
+          budget = avg >= client_queue / 2 ? 0 : client_queue / 2 - avg;
+        } else {
+          budget = web_server::get_state_event_budget(avg, queues.size(), client_queue);
+        }
+        web_server::EntityDomain domain;
+        Nameable *obj;
+        for (; budget != 0 && index.pop_pending(&domain, &obj); budget--)
+          send(numbers[obj]);
+      }
+      for (size_t c = 0; c < queues.size(); c++) {
+        auto &queue = queues[c];
+        const size_t n = std::min<size_t>(client_rates[c], queue.size());
+        for (size_t e = 0; e < n; e++)
+          delivered[c][queue[e].first] = std::max(delivered[c][queue[e].first], queue[e].second);
+        queue.erase(queue.begin(), queue.begin() + n);
+      }
+    }
+    for (auto &client : delivered) {
+      for (uint32_t i = 0; i < num_entities; i++)
+        result.stale += client[i] != latest[i] ? 1 : 0;
+    }
+    return result;
+  };
+  const Result direct = simulate(Pacing::DIRECT);
+  const Result average = simulate(Pacing::AVERAGE);
+  const Result slowest = simulate(Pacing::SLOWEST);
+  ok = ok && slowest.dropped == 0 && slowest.stale == 0 && index.get_pending_count() == 0;
+
+  printf("web_server entities=%4u ns/lookup linear=%7.1f index=%6.1f | events sent/dropped/stale: direct=%5u/%5u/%3u "
+         "average_paced=%5u/%5u/%3u slowest_paced=%5u/%5u/%3u %s\n",
+         num_entities, linear_ns / requests, index_ns / requests, direct.sent, direct.dropped, direct.stale,
+         average.sent, average.dropped, average.stale, slowest.sent, slowest.dropped, slowest.stale,
+         ok ? "ok" : "MISMATCH");
+}
+
+/// The index page as the web server rendered it before, into one buffer holding the whole page.
+std::string render_index_page(const std::vector<std::pair<Nameable *, const char *>> &rows, const std::string &title) {
+  std::string page = "<!DOCTYPE html><html lang=\"en\"><head><meta charset=UTF-8><title>" + title + "</title>";
+  page += "<link rel=\"stylesheet\" href=\"/0.css\">";
+  page += "<link rel=\"stylesheet\" href=\"https://esphome.io/_static/webserver-v1.min.css\">";
+  page += "</head><body><article class=\"markdown-body\"><h1>" + title;
+  page += "</h1><h2>States</h2><table id=\"states\"><thead><tr><th>Name<th>State<th>Actions<tbody>";
+  for (const auto &row : rows) {
+    if (row.first->is_internal())
+      continue;
+    page += std::string("<tr class=\"") + row.second + "\" id=\"" + row.second + "-" + row.first->get_object_id() +
+            "\"><td>" + row.first->get_name() + "</td><td></td><td></td></tr>";
+  }
+  page += "</tbody></table><p>See <a href=\"https://esphome.io/web-api/index.html\">ESPHome Web API</a> for "
+          "REST API documentation.</p>"
+          "<h2>OTA Update</h2><form method=\"POST\" action=\"/update\" enctype=\"multipart/form-data\"><input "
+          "type=\"file\" name=\"update\"><input type=\"submit\" value=\"Update\"></form>"
+          "<h2>Debug Log</h2><pre id=\"log\"></pre>";
+  page += "<script src=\"https://esphome.io/_static/webserver-v1.min.js\"></script></article></body></html>";
+  return page;
+}
+
+/** The index page with num_entities sensors and binary sensors (every 10th internal): rendered into one buffer like
+ * before, versus streamed by IndexPageWriter in chunks of a TCP segment, which only holds the current row in RAM.
+ * The streamed page has to be the same for any chunk size.
+ */
+void bench_web_server_index(uint32_t num_entities, uint32_t pages) {
+  std::vector<std::unique_ptr<Nameable>> entities;
+  std::vector<std::pair<Nameable *, const char *>> rows;
+  web_server::EntityIndex index;
+  for (uint32_t i = 0; i < num_entities; i++) {
+    if (i < num_entities / 2) {
+      entities.push_back(esphome::make_unique<sensor::Sensor>("Sensor " + to_string(i)));
+      rows.emplace_back(entities.back().get(), "sensor");
+    } else {
+      entities.push_back(esphome::make_unique<binary_sensor::BinarySensor>("Binary Sensor " + to_string(i)));
+      rows.emplace_back(entities.back().get(), "binary_sensor");
+    }
+    entities.back()->set_internal(i % 10 == 9);
+    index.add(i < num_entities / 2 ? web_server::DOMAIN_SENSOR : web_server::DOMAIN_BINARY_SENSOR,
+              entities.back().get());
+  }
+  index.build();
+  const std::string title = "livingroom Web Server";
+  const char *css_url = "https://esphome.io/_static/webserver-v1.min.css";
+  const char *js_url = "https://esphome.io/_static/webserver-v1.min.js";
+  auto stream_page = [&](size_t chunk_size, std::string *page) {
+    web_server::IndexPageWriter writer(&index, title, css_url, js_url, true, false);
+    std::unique_ptr<uint8_t[]> chunk(new uint8_t[chunk_size]);  // NOLINT(cppcoreguidelines-owning-memory)
+    while (size_t length = writer.fill(chunk.get(), chunk_size)) {
+      if (page != nullptr)
+        page->append(reinterpret_cast<const char *>(chunk.get()), length);
+    }
+  };
+
+  const std::string expected = render_index_page(rows, title);
+  bool ok = true;
+  for (size_t chunk_size : {1, 7, 64, 1460}) {
+    std::string page;
+    stream_page(chunk_size, &page);
+    ok = ok && page == expected;
+  }
+
+  size_t page_bytes = 0;
+  global_heap_peak = global_heap_used;
+  size_t heap_before = global_heap_used;
+  Stopwatch buffered_watch;
+  for (uint32_t p = 0; p < pages; p++)
+    page_bytes += render_index_page(rows, title).size();
+  const double buffered_ns = buffered_watch.elapsed_ns();
+  const size_t buffered_peak = global_heap_peak - heap_before;
+
+  global_heap_peak = global_heap_used;
+  heap_before = global_heap_used;
+  Stopwatch streamed_watch;
+  for (uint32_t p = 0; p < pages; p++)
+    stream_page(1460, nullptr);
+  const double streamed_ns = streamed_watch.elapsed_ns();
+  // Less the chunk buffer, which the web server library allocates for any response
+  const size_t streamed_peak = global_heap_peak - heap_before - 1460;
+
+  printf("web_server_index entities=%4u page=%6zu B us/page: buffered=%7.1f streamed=%7.1f | peak heap B: "
+         "buffered=%6zu streamed=%5zu %s\n",
+         num_entities, page_bytes / pages, buffered_ns / pages / 1000, streamed_ns / pages / 1000, buffered_peak,
+         streamed_peak, ok ? "ok" : "MISMATCH");
+}
+
+#ifdef USE_PROFILER
+void bench_profiler_record(uint32_t iterations) {
+  TimingStats stats;
+  uint32_t sample = 1;
+  Stopwatch watch;
+  for (uint32_t i = 0; i < iterations; i++) {
+    // Cheap pseudo random samples between 0 and 4095us
+    sample = sample * 1103515245 + 12345;
+    stats.record((sample >> 16) & 0xFFF);
+  }
+  const double ns = watch.elapsed_ns();
+
+  printf("profiler_record ns/record=%10.1f avg=%" PRIu32 " p99=%" PRIu32 " max=%" PRIu32 "\n", ns / iterations,
+         stats.get_average(), stats.get_percentile(0.99f), stats.get_max());
+}
+#endif
+
+}  // namespace
+
+int main() {
+  const std::vector<IntervalMix> mixes = {
+      {"fast", {0, 1, 16}},
+      {"mixed", {16, 100, 1000, 60000}},
+      {"slow", {60000}},
+  };
+
+  for (size_t num_components : {0, 1, 10, 50, 100})
+    bench_app_loop(num_components, 10000);
+
+  for (auto &mix : mixes) {
+    for (size_t num_timers : {1, 10, 100, 1000})
+      bench_scheduler_call(num_timers, mix, 10000);
+  }
+
+  for (size_t num_timers : {1, 10, 100})
+    bench_scheduler_rearm(num_timers, 1000);
+
+  bench_tickless_wakeups();
+
+  bench_api_encode(100000);
+  bench_api_decode_commands(100000);
+  bench_api_frame_parse(100000);
+  fuzz_api_frame_buffer(100000);
+  check_api_frame_buffer_threads(200000);
+  check_api_frame_buffer_window(100000);
+  check_mqtt_topic_trie();
+  check_mqtt_publish_tracker();
+  for (uint32_t num_entities : {10, 100, 500})
+    bench_mqtt_dispatch(num_entities, 100000);
+  check_json_writer();
+  for (uint32_t num_entities : {10, 100})
+    bench_json_discovery(num_entities);
+  bench_display_updates(100);
+  bench_display_test_pages(20);
+  for (int32_t num_leds : {100, 1000})
+    bench_addressable_light(num_leds, 100);
+  for (uint32_t num_leds : {60, 300, 1000})
+    bench_light_output_task(num_leds, 1000);
+  bench_light_transition(1000, 50);
+  check_preferences_log(1, 20000, false);
+  for (uint8_t num_sectors : {2, 4})
+    check_preferences_log(num_sectors, 20000, true);
+  bench_preferences_legacy(10);
+  for (uint8_t num_sectors : {1, 4}) {
+    for (uint32_t write_interval : {0, 1000, 60000})
+      bench_preferences(num_sectors, write_interval, 10);
+  }
+  check_log_ring_buffer();
+  for (uint32_t num_threads : {1, 4})
+    check_log_ring_buffer_threads(num_threads, 100000);
+  bench_log_call_site(100000);
+  for (size_t num_overrides : {0, 10, 50}) {
+    for (size_t num_tags : {10, 100})
+      bench_tag_levels(num_overrides, num_tags, 1000000);
+  }
+  for (uint32_t num_entities : {10, 100, 300})
+    bench_web_server_entities(num_entities, 100000);
+  for (uint32_t num_entities : {10, 100, 300})
+    bench_web_server_index(num_entities, 200);
+
+#ifdef USE_PROFILER
+  bench_profiler_record(1000000);
+#endif
+
+  return 0;
+}